@@ -0,0 +1,56 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <selene/base/Allocators.hpp>
+#include <selene/base/ImageBufferPool.hpp>
+
+#include <selene/img/pixel/PixelTypeAliases.hpp>
+#include <selene/img/typed/Image.hpp>
+
+#include <selene/img_ops/Fill.hpp>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+/* Allocates and fills an RGB frame plus a half-size and a quarter-size intermediate per iteration, emulating the
+ * per-frame temporaries of a processing pipeline. */
+
+template <typename Allocator>
+void allocate_frames(benchmark::State& state)
+{
+  const auto length = [&state](int arg, int divisor) {
+    return sln::PixelLength{static_cast<sln::PixelLength::value_type>(state.range(arg) / divisor)};
+  };
+
+  for (auto _ : state)
+  {
+    sln::Image<sln::PixelRGB_8u, Allocator> img({length(0, 1), length(1, 1)});
+    sln::Image<sln::PixelRGB_8u, Allocator> img_half({length(0, 2), length(1, 2)});
+    sln::Image<sln::PixelRGB_8u, Allocator> img_quarter({length(0, 4), length(1, 4)});
+    sln::fill(img, sln::PixelRGB_8u(1, 2, 3));
+    sln::fill(img_half, sln::PixelRGB_8u(1, 2, 3));
+    sln::fill(img_quarter, sln::PixelRGB_8u(1, 2, 3));
+    benchmark::DoNotOptimize(img.byte_ptr());
+    benchmark::DoNotOptimize(img_half.byte_ptr());
+    benchmark::DoNotOptimize(img_quarter.byte_ptr());
+  }
+}
+
+}  // namespace _
+
+void image_allocation_aligned_new(benchmark::State& state)
+{
+  allocate_frames<sln::AlignedNewAllocator>(state);
+}
+
+void image_allocation_pooled(benchmark::State& state)
+{
+  allocate_frames<sln::PooledAllocator>(state);
+}
+
+BENCHMARK(image_allocation_aligned_new)->Args({640, 480})->Args({1920, 1080});
+BENCHMARK(image_allocation_pooled)->Args({640, 480})->Args({1920, 1080});
+
+BENCHMARK_MAIN();
@@ -0,0 +1,94 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <selene/base/Assert.hpp>
+#include <selene/base/ThreadPool.hpp>
+#include <selene/base/io/FileReader.hpp>
+
+#include <selene/img/interop/DynImageToImage.hpp>
+#include <selene/img/interop/OpenCV.hpp>
+#include <selene/img/pixel/PixelTypeAliases.hpp>
+#include <selene/img/typed/ImageTypeAliases.hpp>
+
+#include <selene/img_io/IO.hpp>
+
+#include <selene/img_ops/Canny.hpp>
+#include <selene/img_ops/ImageConversions.hpp>
+
+#include <test/selene/Utils.hpp>
+
+#include <benchmark/benchmark.h>
+
+#if defined(SELENE_WITH_OPENCV)
+#include <opencv2/imgproc.hpp>
+#endif  // SELENE_IMG_OPENCV_HPP
+
+#include <algorithm>
+#include <thread>
+
+namespace {
+
+constexpr double low_threshold = 50.0;
+constexpr double high_threshold = 150.0;
+
+auto read_grayscale_image(const std::string& filename)
+{
+  const auto full_path = sln_test::full_data_path(filename.c_str());
+  auto dyn_img = sln::read_image(sln::FileReader(full_path.string()));
+  SELENE_FORCED_ASSERT(dyn_img.is_valid());
+  const auto img_rgb = sln::to_image<sln::PixelRGB_8u>(std::move(dyn_img));
+  return sln::convert_image<sln::PixelFormat::Y>(img_rgb);
+}
+
+}  // namespace _
+
+void image_canny_seq(benchmark::State& state)
+{
+  const auto img = read_grayscale_image("stickers.png");
+  sln::Image_8u1 img_dst;
+
+  for (auto _ : state)
+  {
+    sln::canny(img, img_dst, low_threshold, high_threshold);
+  }
+}
+
+void image_canny_par(benchmark::State& state)
+{
+  const auto img = read_grayscale_image("stickers.png");
+  sln::ThreadPool pool(std::max(std::thread::hardware_concurrency(), 1u));
+  sln::Image_8u1 img_dst;
+
+  for (auto _ : state)
+  {
+    sln::canny(pool, img, img_dst, low_threshold, high_threshold);
+  }
+}
+
+#if defined(SELENE_WITH_OPENCV)
+
+/* OpenCV is called with L2 gradient magnitudes and a 3x3 Sobel aperture, to match the Selene defaults. */
+
+void image_canny_opencv(benchmark::State& state)
+{
+  auto img = read_grayscale_image("stickers.png");
+  cv::Mat img_cv = sln::wrap_in_opencv_mat(img);
+  cv::Mat img_dst_cv(img_cv.rows, img_cv.cols, img_cv.type());  // pre-allocate
+
+  for (auto _ : state)
+  {
+    cv::Canny(img_cv, img_dst_cv, low_threshold, high_threshold, 3, true);
+  }
+}
+
+#endif  // SELENE_IMG_OPENCV_HPP
+
+BENCHMARK(image_canny_seq);
+BENCHMARK(image_canny_par)->UseRealTime();
+
+#if defined(SELENE_WITH_OPENCV)
+BENCHMARK(image_canny_opencv)->UseRealTime();
+#endif  // SELENE_IMG_OPENCV_HPP
+
+BENCHMARK_MAIN();
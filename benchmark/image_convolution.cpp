@@ -6,6 +6,8 @@
 #include <selene/base/Kernel.hpp>
 #include <selene/base/io/FileReader.hpp>
 
+#include <selene/img/common/StridePadding.hpp>
+
 #include <selene/img/interop/DynImageToImage.hpp>
 #include <selene/img/interop/OpenCV.hpp>
 #include <selene/img/pixel/PixelTypeAliases.hpp>
@@ -14,7 +16,9 @@
 
 #include <selene/img_io/IO.hpp>
 
+#include <selene/img_ops/Allocate.hpp>
 #include <selene/img_ops/Convolution.hpp>
+#include <selene/img_ops/Fill.hpp>
 #include <selene/img_ops/View.hpp>
 
 #include <test/selene/Utils.hpp>
@@ -97,6 +101,28 @@ void image_convolution_y_integer_kernel(benchmark::State& state)
   }
 }
 
+/* Vertical convolution of an image with a row stride of 4 KB (state.range(0) == 0), or the same image allocated with
+ * a stride padding policy avoiding cache set aliasing (state.range(0) == 1). */
+void image_convolution_y_critical_stride(benchmark::State& state)
+{
+  const auto policy = (state.range(0) == 0) ? sln::no_stride_padding() : sln::avoid_cache_set_aliasing();
+  sln::StridePaddingPolicyScope scope(policy);
+
+  sln::Image<sln::Pixel_8u4> img_src;
+  sln::allocate(img_src, {1024_px, 1040_px});
+  sln::fill(img_src, sln::Pixel_8u4(10, 20, 30, 40));
+  const auto src_view = sln::view(img_src, {0_idx, 8_idx, 1024_px, 1024_px});  // leaves room for unchecked access
+  const auto kernel = sln::gaussian_kernel<7, double>(1.0);
+  sln::Image<sln::Pixel_8u4> img_dst;
+
+  for (auto _ : state)
+  {
+    sln::convolution_y<sln::BorderAccessMode::Unchecked>(src_view, img_dst, kernel);
+  }
+
+  state.counters["stride_bytes"] = static_cast<double>(img_src.stride_bytes());
+}
+
 #if defined(SELENE_WITH_OPENCV)
 
 /* These functions use the more generic cv::filter2D function, and do not take into account the existence of a
@@ -135,6 +161,7 @@ BENCHMARK(image_convolution_x_floating_point_kernel);
 BENCHMARK(image_convolution_y_floating_point_kernel);
 BENCHMARK(image_convolution_x_integer_kernel);
 BENCHMARK(image_convolution_y_integer_kernel);
+BENCHMARK(image_convolution_y_critical_stride)->Arg(0)->Arg(1);
 
 #if defined(SELENE_WITH_OPENCV)
 BENCHMARK(image_convolution_x_opencv);
@@ -1,5 +1,9 @@
 # Centralized dependency handling
 
+# Threads
+
+find_package(Threads REQUIRED)
+
 # libjpeg-turbo (or libjpeg)
 
 if (NOT SELENE_NO_LIBJPEG)
@@ -0,0 +1,310 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <selene/base/AllocationTracking.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace sln {
+
+namespace {
+
+/// Counters of a single thread. Only the owning thread writes to them, so the mutex is uncontended, except while the
+/// statistics are being aggregated or reset.
+struct ThreadCounters
+{
+  std::mutex mutex;
+  std::uint64_t nr_allocations = 0;
+  std::uint64_t nr_deallocations = 0;
+  std::uint64_t bytes_allocated = 0;
+  std::array<std::uint64_t, AllocationStatistics::nr_histogram_bins> size_histogram = {};
+  std::unordered_map<const char*, AllocationTagStatistics> tags;
+};
+
+struct Registry
+{
+  std::mutex mutex;
+  std::vector<ThreadCounters*> threads;
+  ThreadCounters retired;  // Counters of threads that have exited.
+
+  // Peak tracking needs the exact global number of live bytes.
+  std::atomic<std::int64_t> live_bytes{0};
+  std::atomic<std::int64_t> peak_live_bytes{0};
+};
+
+Registry& registry()
+{
+  // Intentionally leaked, so that it outlives the thread-local counters of all threads.
+  static auto* registry = new Registry();
+  return *registry;
+}
+
+void add_counters(ThreadCounters& dst, const ThreadCounters& src)
+{
+  dst.nr_allocations += src.nr_allocations;
+  dst.nr_deallocations += src.nr_deallocations;
+  dst.bytes_allocated += src.bytes_allocated;
+
+  for (std::size_t i = 0; i < src.size_histogram.size(); ++i)
+  {
+    dst.size_histogram[i] += src.size_histogram[i];
+  }
+
+  for (const auto& tag : src.tags)
+  {
+    auto& dst_tag = dst.tags[tag.first];
+    dst_tag.nr_allocations += tag.second.nr_allocations;
+    dst_tag.bytes_allocated += tag.second.bytes_allocated;
+    dst_tag.live_bytes += tag.second.live_bytes;
+  }
+}
+
+void reset_counters(ThreadCounters& counters)
+{
+  counters.nr_allocations = 0;
+  counters.nr_deallocations = 0;
+  counters.bytes_allocated = 0;
+  counters.size_histogram.fill(0);
+
+  for (auto& tag : counters.tags)
+  {
+    tag.second.nr_allocations = 0;
+    tag.second.bytes_allocated = 0;  // live_bytes is not a cumulative count
+  }
+}
+
+// Set on thread exit; deallocations after that (e.g. by other thread-local objects) are recorded as retired.
+thread_local bool tl_counters_destroyed = false;
+
+class ThreadCountersHandle
+{
+public:
+  ThreadCountersHandle()
+  {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.threads.push_back(&counters_);
+  }
+
+  ~ThreadCountersHandle()
+  {
+    tl_counters_destroyed = true;
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.threads.erase(std::remove(reg.threads.begin(), reg.threads.end(), &counters_), reg.threads.end());
+    add_counters(reg.retired, counters_);
+  }
+
+  ThreadCounters& counters() noexcept
+  {
+    return counters_;
+  }
+
+private:
+  ThreadCounters counters_;
+};
+
+template <typename Function>
+void update_thread_counters(Function func)
+{
+  if (tl_counters_destroyed)
+  {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    func(reg.retired);
+    return;
+  }
+
+  thread_local ThreadCountersHandle handle;
+  auto& counters = handle.counters();
+  std::lock_guard<std::mutex> lock(counters.mutex);
+  func(counters);
+}
+
+std::size_t histogram_bin(std::size_t nr_bytes) noexcept
+{
+  std::size_t bin = 0;
+  while (nr_bytes >>= 1)
+  {
+    ++bin;
+  }
+
+  return bin;
+}
+
+thread_local const char* tl_allocation_tag = nullptr;
+
+}  // namespace
+
+/** \brief Enables or disables tracking of allocations made through the library's allocators.
+ *
+ * Tracking is disabled by default. While disabled, allocations are not recorded; deallocations of memory allocated
+ * while tracking was enabled are still recorded.
+ *
+ * \param enabled True to enable tracking; false to disable it.
+ */
+void set_allocation_tracking_enabled(bool enabled) noexcept
+{
+  impl::allocation_tracking_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+/** \brief Returns whether allocation tracking is enabled.
+ *
+ * \return True, if allocation tracking is enabled; false otherwise.
+ */
+bool is_allocation_tracking_enabled() noexcept
+{
+  return impl::allocation_tracking_enabled.load(std::memory_order_relaxed);
+}
+
+/** \brief Aggregates the allocation statistics of all threads.
+ *
+ * \return The current allocation statistics.
+ */
+AllocationStatistics allocation_statistics()
+{
+  auto& reg = registry();
+  ThreadCounters sum;
+
+  {
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    add_counters(sum, reg.retired);
+
+    for (auto counters : reg.threads)
+    {
+      std::lock_guard<std::mutex> thread_lock(counters->mutex);
+      add_counters(sum, *counters);
+    }
+  }
+
+  AllocationStatistics stats;
+  stats.nr_allocations = sum.nr_allocations;
+  stats.nr_deallocations = sum.nr_deallocations;
+  stats.bytes_allocated = sum.bytes_allocated;
+  stats.live_bytes = reg.live_bytes.load(std::memory_order_relaxed);
+  stats.peak_live_bytes = reg.peak_live_bytes.load(std::memory_order_relaxed);
+  stats.size_histogram = sum.size_histogram;
+
+  for (const auto& tag : sum.tags)
+  {
+    auto& stats_tag = stats.tags[(tag.first == nullptr) ? std::string{} : std::string{tag.first}];
+    stats_tag.nr_allocations += tag.second.nr_allocations;
+    stats_tag.bytes_allocated += tag.second.bytes_allocated;
+    stats_tag.live_bytes += tag.second.live_bytes;
+  }
+
+  return stats;
+}
+
+/** \brief Resets the cumulative allocation statistics of all threads.
+ *
+ * The number of live bytes is retained, and the peak number of live bytes is reset to it.
+ */
+void reset_allocation_statistics() noexcept
+{
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  reset_counters(reg.retired);
+
+  for (auto counters : reg.threads)
+  {
+    std::lock_guard<std::mutex> thread_lock(counters->mutex);
+    reset_counters(*counters);
+  }
+
+  reg.peak_live_bytes.store(reg.live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+/** \brief Sets the allocation tag of the calling thread.
+ *
+ * \param tag The allocation tag. Needs to outlive all allocations made with it.
+ */
+AllocationTagScope::AllocationTagScope(const char* tag) noexcept
+    : previous_tag_(tl_allocation_tag)
+{
+  tl_allocation_tag = tag;
+}
+
+/** \brief Restores the previous allocation tag of the calling thread.
+ */
+AllocationTagScope::~AllocationTagScope()
+{
+  tl_allocation_tag = previous_tag_;
+}
+
+/** \brief Returns the allocation tag of the calling thread.
+ *
+ * \return The current allocation tag, or nullptr outside of any `AllocationTagScope`.
+ */
+const char* current_allocation_tag() noexcept
+{
+  return tl_allocation_tag;
+}
+
+namespace impl {
+
+std::atomic<bool> allocation_tracking_enabled{false};
+
+AllocationRecord track_allocation_slow(std::size_t nr_bytes) noexcept
+{
+  if (nr_bytes == 0)
+  {
+    return AllocationRecord{0, nullptr};
+  }
+
+  const auto tag = tl_allocation_tag;
+
+  try
+  {
+    update_thread_counters([nr_bytes, tag](ThreadCounters& counters) {
+      counters.nr_allocations += 1;
+      counters.bytes_allocated += nr_bytes;
+      counters.size_histogram[histogram_bin(nr_bytes)] += 1;
+
+      auto& tag_counters = counters.tags[tag];
+      tag_counters.nr_allocations += 1;
+      tag_counters.bytes_allocated += nr_bytes;
+      tag_counters.live_bytes += static_cast<std::int64_t>(nr_bytes);
+    });
+  }
+  catch (...)
+  {
+    // Failure to allocate the bookkeeping data; the allocation itself is still valid.
+    return AllocationRecord{0, nullptr};
+  }
+
+  auto& reg = registry();
+  const auto live_bytes = reg.live_bytes.fetch_add(static_cast<std::int64_t>(nr_bytes), std::memory_order_relaxed)
+                          + static_cast<std::int64_t>(nr_bytes);
+  auto peak = reg.peak_live_bytes.load(std::memory_order_relaxed);
+  while (live_bytes > peak && !reg.peak_live_bytes.compare_exchange_weak(peak, live_bytes, std::memory_order_relaxed))
+  {
+  }
+
+  return AllocationRecord{nr_bytes, tag};
+}
+
+void track_deallocation_slow(const AllocationRecord& record) noexcept
+{
+  registry().live_bytes.fetch_sub(static_cast<std::int64_t>(record.nr_bytes), std::memory_order_relaxed);
+
+  try
+  {
+    update_thread_counters([&record](ThreadCounters& counters) {
+      counters.nr_deallocations += 1;
+      counters.tags[record.tag].live_bytes -= static_cast<std::int64_t>(record.nr_bytes);
+    });
+  }
+  catch (...)
+  {
+    // Failure to allocate the bookkeeping data; only the per-tag statistics are affected.
+  }
+}
+
+}  // namespace impl
+
+}  // namespace sln
@@ -0,0 +1,128 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_BASE_ALLOCATION_TRACKING_HPP
+#define SELENE_BASE_ALLOCATION_TRACKING_HPP
+
+/// @file
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace sln {
+
+/** \brief Allocation statistics for a single allocation tag; see `AllocationTagScope`.
+ */
+struct AllocationTagStatistics
+{
+  std::uint64_t nr_allocations = 0;  ///< Number of allocations with this tag.
+  std::uint64_t bytes_allocated = 0;  ///< Cumulative number of bytes allocated with this tag.
+  std::int64_t live_bytes = 0;  ///< Number of bytes allocated with this tag, and not deallocated yet.
+};
+
+/** \brief Statistics of the memory allocated through the library's allocators, while tracking was enabled.
+ *
+ * Cumulative counts refer to the time since tracking was first enabled, or since the last call to
+ * `reset_allocation_statistics()`.
+ */
+struct AllocationStatistics
+{
+  static constexpr std::size_t nr_histogram_bins = 64;
+
+  std::uint64_t nr_allocations = 0;  ///< Cumulative number of allocations.
+  std::uint64_t nr_deallocations = 0;  ///< Cumulative number of deallocations.
+  std::uint64_t bytes_allocated = 0;  ///< Cumulative number of bytes allocated.
+  std::int64_t live_bytes = 0;  ///< Number of bytes currently allocated.
+  std::int64_t peak_live_bytes = 0;  ///< Maximum of `live_bytes`.
+
+  /// Number of allocations per size; bin `i` counts allocations of `[2^i, 2^(i+1))` bytes.
+  std::array<std::uint64_t, nr_histogram_bins> size_histogram = {};
+
+  /// Statistics per allocation tag. Allocations outside of any `AllocationTagScope` are listed under the empty tag.
+  std::map<std::string, AllocationTagStatistics> tags;
+};
+
+void set_allocation_tracking_enabled(bool enabled) noexcept;
+bool is_allocation_tracking_enabled() noexcept;
+
+AllocationStatistics allocation_statistics();
+void reset_allocation_statistics() noexcept;
+
+/** \brief Tags all allocations made by the calling thread, for the lifetime of the scope object.
+ *
+ * Tags group allocation statistics by call site, e.g. `AllocationTagScope tag("convolution_x output");`.
+ * Scopes can be nested; at the end of a scope, the previous tag is restored.
+ *
+ * The tag string is not copied; it needs to outlive all allocations made with it (e.g. a string literal).
+ */
+class AllocationTagScope
+{
+public:
+  explicit AllocationTagScope(const char* tag) noexcept;
+  ~AllocationTagScope();
+
+  AllocationTagScope(const AllocationTagScope&) = delete;
+  AllocationTagScope& operator=(const AllocationTagScope&) = delete;
+  AllocationTagScope(AllocationTagScope&&) = delete;
+  AllocationTagScope& operator=(AllocationTagScope&&) = delete;
+
+private:
+  const char* previous_tag_;
+};
+
+const char* current_allocation_tag() noexcept;
+
+// ----------
+// Implementation:
+
+namespace impl {
+
+/// Per-allocation record, stored by the allocators alongside each memory block.
+struct AllocationRecord
+{
+  std::size_t nr_bytes;  ///< The number of bytes tracked; 0 if the allocation was made while tracking was disabled.
+  const char* tag;  ///< The allocation tag.
+};
+
+extern std::atomic<bool> allocation_tracking_enabled;
+
+AllocationRecord track_allocation_slow(std::size_t nr_bytes) noexcept;
+void track_deallocation_slow(const AllocationRecord& record) noexcept;
+
+/** \brief Records an allocation of the specified number of bytes, if allocation tracking is enabled.
+ *
+ * @param nr_bytes The number of bytes allocated.
+ * @return The allocation record, to be passed to `track_deallocation` on deallocation.
+ */
+inline AllocationRecord track_allocation(std::size_t nr_bytes) noexcept
+{
+  if (!allocation_tracking_enabled.load(std::memory_order_relaxed))
+  {
+    return AllocationRecord{0, nullptr};
+  }
+
+  return track_allocation_slow(nr_bytes);
+}
+
+/** \brief Records a deallocation, if the respective allocation was tracked.
+ *
+ * @param record The allocation record returned by `track_allocation`.
+ */
+inline void track_deallocation(const AllocationRecord& record) noexcept
+{
+  if (record.nr_bytes != 0)
+  {
+    track_deallocation_slow(record);
+  }
+}
+
+}  // namespace impl
+
+}  // namespace sln
+
+#endif  // SELENE_BASE_ALLOCATION_TRACKING_HPP
@@ -2,15 +2,96 @@
 // Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
 // Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
 
+#include <selene/base/AllocationTracking.hpp>
 #include <selene/base/Allocators.hpp>
 #include <selene/base/MemoryBlock.hpp>
 #include <selene/base/Utils.hpp>
 
+#include <atomic>
+#include <cstddef>
 #include <memory>
+#include <mutex>
 #include <new>
+#include <unordered_map>
 
 namespace sln {
 
+namespace {
+
+// The allocators do not store anything in-band for allocation tracking: the plain allocators hand out memory exactly
+// as returned by std::malloc or new, such that it can be released by std::free or delete[], and such that memory from
+// these functions can be adopted. Records of tracked allocations are therefore kept in a side table, which is only
+// accessed while tracking is enabled, or while it is non-empty.
+struct TrackedAllocations
+{
+  std::mutex mutex;
+  std::unordered_map<const std::uint8_t*, impl::AllocationRecord> records;
+  std::atomic<std::size_t> nr_records{0};
+};
+
+TrackedAllocations& tracked_allocations()
+{
+  // Intentionally leaked, so that it outlives deallocations by static or thread-local objects.
+  static auto* tracked = new TrackedAllocations();
+  return *tracked;
+}
+
+void untrack(std::uint8_t* data) noexcept
+{
+  auto& tracked = tracked_allocations();
+  if (tracked.nr_records.load(std::memory_order_relaxed) == 0)
+  {
+    return;
+  }
+
+  auto record = impl::AllocationRecord{0, nullptr};
+
+  {
+    std::lock_guard<std::mutex> lock(tracked.mutex);
+    const auto it = tracked.records.find(data);
+    if (it == tracked.records.end())
+    {
+      return;
+    }
+
+    record = it->second;
+    tracked.records.erase(it);
+    tracked.nr_records.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  impl::track_deallocation(record);
+}
+
+void track(std::uint8_t* data, std::size_t nr_bytes) noexcept
+{
+  const auto record = impl::track_allocation(nr_bytes);
+  if (record.nr_bytes == 0)
+  {
+    return;
+  }
+
+  auto& tracked = tracked_allocations();
+  bool inserted = false;
+
+  try
+  {
+    std::lock_guard<std::mutex> lock(tracked.mutex);
+    inserted = tracked.records.emplace(data, record).second;
+    tracked.nr_records.fetch_add(inserted ? 1 : 0, std::memory_order_relaxed);
+  }
+  catch (...)
+  {
+  }
+
+  // Allocations that cannot be recorded are not tracked at all
+  if (!inserted)
+  {
+    impl::track_deallocation(record);
+  }
+}
+
+}  // namespace
+
 /** \brief Allocates the specified number of bytes via `std::malloc` and returns a MemoryBlock.
  *
  * \param nr_bytes The number of bytes to allocate.
@@ -25,7 +106,13 @@ MemoryBlock<MallocAllocator> MallocAllocator::allocate(std::size_t nr_bytes) noe
   }
 
   auto ptr = static_cast<std::uint8_t*>(std::malloc(nr_bytes));
-  return construct_memory_block_from_existing_memory<MallocAllocator>(ptr, (ptr == nullptr) ? 0 : nr_bytes);
+  if (ptr == nullptr)
+  {
+    return construct_memory_block_from_existing_memory<MallocAllocator>(nullptr, 0);
+  }
+
+  track(ptr, nr_bytes);
+  return construct_memory_block_from_existing_memory<MallocAllocator>(ptr, nr_bytes);
 }
 
 /** \brief Deallocates the previously allocated memory block using `std::free`.
@@ -34,7 +121,12 @@ MemoryBlock<MallocAllocator> MallocAllocator::allocate(std::size_t nr_bytes) noe
  */
 void MallocAllocator::deallocate(std::uint8_t*& data) noexcept
 {
-  std::free(data);
+  if (data != nullptr)
+  {
+    untrack(data);
+    std::free(data);
+  }
+
   data = nullptr;
 }
 
@@ -84,6 +176,7 @@ MemoryBlock<AlignedMallocAllocator> AlignedMallocAllocator::allocate(std::size_t
   (reinterpret_cast<void**>(a_ptr))[-1] = m_ptr;
 
   auto ptr = reinterpret_cast<std::uint8_t*>(a_ptr);
+  track(ptr, nr_bytes);
   return construct_memory_block_from_existing_memory<AlignedMallocAllocator>(ptr, nr_bytes);
 }
 
@@ -95,6 +188,7 @@ void AlignedMallocAllocator::deallocate(std::uint8_t*& data) noexcept
 {
   if (data != nullptr)
   {
+    untrack(data);
     // Retrieve originally malloc'ed pointer from stored position
     std::uint8_t* data_ptr = data;
     void* m_ptr = (reinterpret_cast<void**>(data_ptr))[-1];
@@ -119,7 +213,13 @@ MemoryBlock<NewAllocator> NewAllocator::allocate(std::size_t nr_bytes) noexcept
   }
 
   const auto ptr = ::new (std::nothrow) std::uint8_t[nr_bytes];
-  return construct_memory_block_from_existing_memory<NewAllocator>(ptr, (ptr == nullptr) ? 0 : nr_bytes);
+  if (ptr == nullptr)
+  {
+    return construct_memory_block_from_existing_memory<NewAllocator>(nullptr, 0);
+  }
+
+  track(ptr, nr_bytes);
+  return construct_memory_block_from_existing_memory<NewAllocator>(ptr, nr_bytes);
 }
 
 /** \brief Deallocates the previously allocated memory block using `delete`.
@@ -128,7 +228,12 @@ MemoryBlock<NewAllocator> NewAllocator::allocate(std::size_t nr_bytes) noexcept
  */
 void NewAllocator::deallocate(std::uint8_t*& data) noexcept
 {
-  ::delete[] data;
+  if (data != nullptr)
+  {
+    untrack(data);
+    ::delete[] data;
+  }
+
   data = nullptr;
 }
 
@@ -176,6 +281,7 @@ MemoryBlock<AlignedNewAllocator> AlignedNewAllocator::allocate(std::size_t nr_by
   (reinterpret_cast<std::uint8_t**>(a_ptr))[-1] = n_ptr;
 
   auto ptr = reinterpret_cast<std::uint8_t*>(a_ptr);
+  track(ptr, nr_bytes);
   return construct_memory_block_from_existing_memory<AlignedNewAllocator>(ptr, nr_bytes);
 }
 
@@ -187,6 +293,7 @@ void AlignedNewAllocator::deallocate(std::uint8_t*& data) noexcept
 {
   if (data != nullptr)
   {
+    untrack(data);
     // Retrieve originally new'ed pointer from stored position
     std::uint8_t* data_ptr = data;
     std::uint8_t* n_ptr = (reinterpret_cast<std::uint8_t**>(data_ptr))[-1];
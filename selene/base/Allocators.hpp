@@ -18,6 +18,8 @@ class MemoryBlock;
 /** \brief Provides means for memory allocation and deallocation throughout the library.
  *
  * The MallocAllocator wraps `std::malloc` and `std::free` in a consistent interface.
+ * Allocated memory is returned exactly as obtained from `std::malloc`, so it can be released using `std::free`, and
+ * memory obtained from `std::malloc` can be handed to the allocator for release.
  *
  *  Used in various places inside the library. Not recommended for memory management outside of the library.
  */
@@ -43,6 +45,8 @@ struct AlignedMallocAllocator
 /** \brief Provides means for memory allocation and deallocation throughout the library.
  *
  * The NewAllocator wraps `new` and `delete` in a consistent interface.
+ * Allocated memory is returned exactly as obtained from `new[]`, so it can be released using `delete[]`, and memory
+ * obtained from `new[]` can be handed to the allocator for release.
  *
  *  Used in various places inside the library. Not recommended for memory management outside of the library.
  */
@@ -0,0 +1,182 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_BASE_EXECUTION_POLICY_HPP
+#define SELENE_BASE_EXECUTION_POLICY_HPP
+
+/// @file
+
+#include <selene/base/ThreadPool.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+/** \brief Hints to the compiler that the immediately following loop has no loop-carried dependencies, and may be
+ * vectorized.
+ *
+ * Expands to nothing on unsupported compilers.
+ */
+#if defined(__clang__)
+#define SELENE_VECTORIZE_LOOP _Pragma("clang loop vectorize(assume_safety) interleave(enable)")
+#elif defined(__GNUC__)
+#define SELENE_VECTORIZE_LOOP _Pragma("GCC ivdep")
+#elif defined(_MSC_VER)
+#define SELENE_VECTORIZE_LOOP __pragma(loop(ivdep))
+#else
+#define SELENE_VECTORIZE_LOOP
+#endif
+
+namespace sln {
+
+/// Execution policies, modeled after those in `std::execution`.
+namespace execution {
+
+/** \brief Execution policy: the operation is executed sequentially on the calling thread.
+ */
+struct SequencedPolicy
+{
+};
+
+/** \brief Execution policy: the operation may be executed in parallel, on the specified thread pool.
+ *
+ * If no thread pool is specified, the default thread pool (see `default_thread_pool()`) is used.
+ */
+struct ParallelPolicy
+{
+  ThreadPool* pool = nullptr;  ///< The thread pool to use; `nullptr` designates the default pool.
+
+  /** \brief Returns a copy of the execution policy, set to execute on the specified thread pool.
+   *
+   * @param thread_pool The thread pool to use.
+   * @return The execution policy.
+   */
+  constexpr ParallelPolicy on(ThreadPool& thread_pool) const noexcept { return ParallelPolicy{&thread_pool}; }
+};
+
+/** \brief Execution policy: the operation may be executed in parallel, on the specified thread pool, and the
+ * invocations on each image row may be interleaved (i.e. vectorized).
+ *
+ * If no thread pool is specified, the default thread pool (see `default_thread_pool()`) is used.
+ */
+struct ParallelUnsequencedPolicy
+{
+  ThreadPool* pool = nullptr;  ///< The thread pool to use; `nullptr` designates the default pool.
+
+  /** \brief Returns a copy of the execution policy, set to execute on the specified thread pool.
+   *
+   * @param thread_pool The thread pool to use.
+   * @return The execution policy.
+   */
+  constexpr ParallelUnsequencedPolicy on(ThreadPool& thread_pool) const noexcept
+  {
+    return ParallelUnsequencedPolicy{&thread_pool};
+  }
+};
+
+constexpr SequencedPolicy seq{};  ///< Sequenced execution.
+constexpr ParallelPolicy par{};  ///< Parallel execution on the default thread pool.
+constexpr ParallelUnsequencedPolicy par_unseq{};  ///< Parallel and unsequenced execution on the default thread pool.
+
+}  // namespace execution
+
+/** \brief Type trait determining whether a type is an execution policy.
+ *
+ * Besides the policies in namespace `sln::execution`, a `ThreadPool` is an execution policy, equivalent to
+ * `execution::par.on(pool)`.
+ *
+ * @tparam T The type to check.
+ */
+template <typename T>
+struct IsExecutionPolicy
+    : std::bool_constant<std::is_same_v<T, execution::SequencedPolicy> || std::is_same_v<T, execution::ParallelPolicy>
+                         || std::is_same_v<T, execution::ParallelUnsequencedPolicy> || std::is_same_v<T, ThreadPool>>
+{
+};
+
+template <typename T>
+constexpr bool is_execution_policy_v = IsExecutionPolicy<std::remove_cv_t<std::remove_reference_t<T>>>::value;
+
+/** \brief Type trait determining whether an execution policy allows unsequenced (i.e. vectorized) execution.
+ *
+ * @tparam T The execution policy type.
+ */
+template <typename T>
+constexpr bool is_unsequenced_policy_v =
+    std::is_same_v<std::remove_cv_t<std::remove_reference_t<T>>, execution::ParallelUnsequencedPolicy>;
+
+// ----------
+// Implementation:
+
+namespace impl {
+
+template <typename ExecutionPolicy>
+ThreadPool* get_thread_pool(const ExecutionPolicy& policy) noexcept
+{
+  using Policy = std::remove_cv_t<std::remove_reference_t<ExecutionPolicy>>;
+
+  if constexpr (std::is_same_v<Policy, execution::SequencedPolicy>)
+  {
+    static_cast<void>(policy);
+    return nullptr;
+  }
+  else if constexpr (std::is_same_v<Policy, ThreadPool>)
+  {
+    return const_cast<ThreadPool*>(&policy);
+  }
+  else
+  {
+    return (policy.pool != nullptr) ? policy.pool : &default_thread_pool();
+  }
+}
+
+/** \brief Executes `func(chunk_begin, chunk_end)` on consecutive sub-ranges of `[begin, end)`, according to the
+ * specified execution policy.
+ *
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam Func The function type.
+ * @param policy The execution policy.
+ * @param begin The beginning of the index range.
+ * @param end The end of the index range (exclusive).
+ * @param grain_size The minimum number of indices to be processed per call to `func`.
+ * @param func The function to call on each sub-range.
+ */
+template <typename ExecutionPolicy, typename Func>
+void parallel_for(ExecutionPolicy&& policy, std::ptrdiff_t begin, std::ptrdiff_t end, std::ptrdiff_t grain_size,
+                  Func&& func)
+{
+  static_assert(is_execution_policy_v<ExecutionPolicy>, "Not an execution policy");
+
+  auto pool = get_thread_pool(policy);
+
+  if (pool == nullptr)
+  {
+    if (begin < end)
+    {
+      func(begin, end);
+    }
+
+    return;
+  }
+
+  pool->parallel_for(begin, end, grain_size, std::forward<Func>(func));
+}
+
+/** \brief Returns a grain size, in rows, such that each parallel work item covers at least several thousand pixels.
+ *
+ * @param width The image width.
+ * @return The number of rows per work item.
+ */
+inline std::ptrdiff_t row_grain_size(std::ptrdiff_t width) noexcept
+{
+  constexpr std::ptrdiff_t min_pixels_per_work_item = 16384;
+  return std::max(std::ptrdiff_t{1}, min_pixels_per_work_item / std::max(width, std::ptrdiff_t{1}));
+}
+
+}  // namespace impl
+
+}  // namespace sln
+
+#endif  // SELENE_BASE_EXECUTION_POLICY_HPP
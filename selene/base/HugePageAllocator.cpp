@@ -0,0 +1,234 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <selene/base/AllocationTracking.hpp>
+#include <selene/base/Allocators.hpp>
+#include <selene/base/HugePageAllocator.hpp>
+#include <selene/base/Utils.hpp>
+
+#include <algorithm>
+
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace sln {
+
+namespace {
+
+/// The header stored immediately in front of each allocation's data.
+struct AllocationHeader
+{
+  std::uint8_t* base;
+  std::size_t mapping_size;
+  HugePageBacking backing;
+  impl::AllocationRecord record;  // Only used for memory mappings; heap memory is tracked by AlignedNewAllocator.
+};
+
+constexpr std::size_t min_alignment = 64;
+
+thread_local int tl_numa_node = -1;
+thread_local NumaPlacement tl_numa_placement = NumaPlacement::FirstTouch;
+
+AllocationHeader* header_of(const std::uint8_t* data) noexcept
+{
+  return reinterpret_cast<AllocationHeader*>(const_cast<std::uint8_t*>(data)) - 1;
+}
+
+#if defined(__linux__)
+
+std::uint8_t* map_explicit_huge_pages(std::size_t mapping_size) noexcept
+{
+#if defined(MAP_HUGETLB)
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+#if defined(MAP_HUGE_SHIFT)
+  flags |= (21 << MAP_HUGE_SHIFT);  // 2 MB pages, independent of the system's default huge page size
+#endif
+  void* ptr = ::mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, flags, -1, 0);
+  return (ptr == MAP_FAILED) ? nullptr : static_cast<std::uint8_t*>(ptr);
+#else
+  static_cast<void>(mapping_size);
+  return nullptr;
+#endif
+}
+
+std::uint8_t* map_transparent_huge_pages(std::size_t mapping_size) noexcept
+{
+  // Over-map by one huge page, and trim the excess, to obtain a mapping aligned to the huge page size.
+  const auto size = mapping_size + HugePageAllocator::huge_page_size;
+  void* ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ptr == MAP_FAILED)
+  {
+    return nullptr;
+  }
+
+  auto base = static_cast<std::uint8_t*>(ptr);
+  const auto misalignment = reinterpret_cast<std::uintptr_t>(base) % HugePageAllocator::huge_page_size;
+  const auto head = (misalignment == 0) ? std::size_t{0} : HugePageAllocator::huge_page_size - misalignment;
+  const auto tail = size - head - mapping_size;
+
+  if (head > 0)
+  {
+    ::munmap(base, head);
+  }
+
+  if (tail > 0)
+  {
+    ::munmap(base + head + mapping_size, tail);
+  }
+
+  base += head;
+#if defined(MADV_HUGEPAGE)
+  ::madvise(base, mapping_size, MADV_HUGEPAGE);  // Advisory only; ignore failure (e.g. if THP is disabled).
+#endif
+  return base;
+}
+
+void bind_to_numa_node(std::uint8_t* base, std::size_t mapping_size, int numa_node, NumaPlacement placement) noexcept
+{
+  constexpr int max_nr_nodes = 1024;
+  constexpr auto bits_per_word = static_cast<int>(8 * sizeof(unsigned long));
+
+  if (placement == NumaPlacement::FirstTouch || numa_node < 0 || numa_node >= max_nr_nodes)
+  {
+    return;
+  }
+
+  unsigned long node_mask[max_nr_nodes / bits_per_word] = {};
+  node_mask[numa_node / bits_per_word] = 1ul << (numa_node % bits_per_word);
+  const int mode = (placement == NumaPlacement::Bind) ? MPOL_BIND : MPOL_PREFERRED;
+  // Called via syscall() to avoid a dependency on libnuma. Failure (e.g. on non-NUMA kernels) leaves the memory to
+  // be placed by first touch.
+  ::syscall(SYS_mbind, base, mapping_size, mode, node_mask, static_cast<unsigned long>(max_nr_nodes), 0u);
+}
+
+#endif  // defined(__linux__)
+
+}  // namespace
+
+/** \brief Sets the NUMA node for allocations by `HugePageAllocator` on the calling thread.
+ *
+ * \param numa_node The NUMA node. A negative value designates first-touch placement.
+ * \param placement The NUMA placement mode.
+ */
+NumaNodeScope::NumaNodeScope(int numa_node, NumaPlacement placement) noexcept
+    : previous_numa_node_(tl_numa_node), previous_placement_(tl_numa_placement)
+{
+  tl_numa_node = numa_node;
+  tl_numa_placement = placement;
+}
+
+/** \brief Restores the previous NUMA node setting of the calling thread.
+ */
+NumaNodeScope::~NumaNodeScope()
+{
+  tl_numa_node = previous_numa_node_;
+  tl_numa_placement = previous_placement_;
+}
+
+/** \brief Allocates the specified number of bytes, backed by huge pages where possible, and returns a MemoryBlock.
+ *
+ * \param nr_bytes The number of bytes to allocate.
+ * \param alignment The required byte alignment. Needs to be a power of two (e.g. 8, 16, 32, ...).
+ * \return A MemoryBlock instance with a pointer to the allocated data. If no data could be allocated, the MemoryBlock
+ *         will point to nullptr.
+ */
+MemoryBlock<HugePageAllocator> HugePageAllocator::allocate(std::size_t nr_bytes, std::size_t alignment) noexcept
+{
+  if (nr_bytes == 0)
+  {
+    return construct_memory_block_from_existing_memory<HugePageAllocator>(nullptr, 0);
+  }
+
+  alignment = static_cast<std::size_t>(next_power_of_two(std::max(alignment, min_alignment)));
+  const auto header_bytes = (sizeof(AllocationHeader) + alignment - 1) / alignment * alignment;
+  const auto nr_total_bytes = header_bytes + nr_bytes;
+
+  std::uint8_t* base = nullptr;
+  std::size_t mapping_size = 0;
+  auto backing = HugePageBacking::None;
+
+#if defined(__linux__)
+  if (nr_total_bytes >= huge_page_size && alignment <= huge_page_size)
+  {
+    mapping_size = (nr_total_bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+
+    if ((base = map_explicit_huge_pages(mapping_size)) != nullptr)
+    {
+      backing = HugePageBacking::Explicit;
+    }
+    else if ((base = map_transparent_huge_pages(mapping_size)) != nullptr)
+    {
+      backing = HugePageBacking::Transparent;
+    }
+
+    if (base != nullptr)
+    {
+      bind_to_numa_node(base, mapping_size, tl_numa_node, tl_numa_placement);
+    }
+  }
+#endif
+
+  if (base == nullptr)
+  {
+    auto memory = AlignedNewAllocator::allocate(nr_total_bytes, alignment);
+    if (memory.data() == nullptr)
+    {
+      return construct_memory_block_from_existing_memory<HugePageAllocator>(nullptr, 0);
+    }
+
+    base = memory.transfer_data();
+    mapping_size = 0;
+  }
+
+  // Writing the header touches the first page, on the allocating thread (after binding it to the NUMA node, if any)
+  auto data = base + header_bytes;
+  const auto record = (backing == HugePageBacking::None) ? impl::AllocationRecord{0, nullptr}
+                                                          : impl::track_allocation(mapping_size);
+  *header_of(data) = AllocationHeader{base, mapping_size, backing, record};
+  return construct_memory_block_from_existing_memory<HugePageAllocator>(data, nr_bytes);
+}
+
+/** \brief Deallocates the previously allocated memory block.
+ *
+ * \param data A pointer to previously allocated data.
+ */
+void HugePageAllocator::deallocate(std::uint8_t*& data) noexcept
+{
+  if (data != nullptr)
+  {
+    const auto header = *header_of(data);
+    if (header.backing == HugePageBacking::None)
+    {
+      std::uint8_t* base = header.base;
+      AlignedNewAllocator::deallocate(base);
+    }
+#if defined(__linux__)
+    else
+    {
+      impl::track_deallocation(header.record);
+      ::munmap(header.base, header.mapping_size);
+    }
+#endif
+  }
+
+  data = nullptr;
+}
+
+/** \brief Returns which kind of pages back a memory block allocated by `HugePageAllocator`.
+ *
+ * For `HugePageBacking::Transparent`, the kernel may still decide not to use huge pages for (parts of) the block.
+ *
+ * \param data A pointer to previously allocated data.
+ * \return The kind of backing pages.
+ */
+HugePageBacking HugePageAllocator::backing(const std::uint8_t* data) noexcept
+{
+  return (data == nullptr) ? HugePageBacking::None : header_of(data)->backing;
+}
+
+}  // namespace sln
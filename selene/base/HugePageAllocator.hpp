@@ -0,0 +1,87 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_BASE_HUGE_PAGE_ALLOCATOR_HPP
+#define SELENE_BASE_HUGE_PAGE_ALLOCATOR_HPP
+
+/// @file
+
+#include <selene/base/MemoryBlock.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sln {
+
+/** \brief Describes how memory allocated by `HugePageAllocator` is placed on NUMA nodes.
+ */
+enum class NumaPlacement
+{
+  FirstTouch,  ///< No explicit placement; pages are placed on the node of the thread that first writes to them.
+  Preferred,  ///< Pages are preferably placed on the specified node, falling back to other nodes if it is full.
+  Bind,  ///< Pages are placed strictly on the specified node.
+};
+
+/** \brief Sets the NUMA node on which `HugePageAllocator` places memory allocated by the calling thread, for the
+ * lifetime of the scope object.
+ *
+ * Scopes can be nested; at the end of a scope, the previous setting is restored. Outside of any scope, memory is
+ * placed by first touch.
+ */
+class NumaNodeScope
+{
+public:
+  explicit NumaNodeScope(int numa_node, NumaPlacement placement = NumaPlacement::Preferred) noexcept;
+  ~NumaNodeScope();
+
+  NumaNodeScope(const NumaNodeScope&) = delete;
+  NumaNodeScope& operator=(const NumaNodeScope&) = delete;
+  NumaNodeScope(NumaNodeScope&&) = delete;
+  NumaNodeScope& operator=(NumaNodeScope&&) = delete;
+
+private:
+  int previous_numa_node_;
+  NumaPlacement previous_placement_;
+};
+
+/** \brief Describes which kind of pages back a memory block allocated by `HugePageAllocator`.
+ */
+enum class HugePageBacking
+{
+  None,  ///< Regular heap memory (small allocations, or if memory mapping is unavailable).
+  Transparent,  ///< Anonymous memory mapping, with transparent huge pages requested via `madvise(MADV_HUGEPAGE)`.
+  Explicit,  ///< Memory mapping from the explicit huge page pool (`MAP_HUGETLB`).
+};
+
+/** \brief Allocator for large images, backing memory by 2 MB huge pages where possible.
+ *
+ * Can be used as allocator type of `Image<PixelType, Allocator>` or `DynImageT<Allocator>`, e.g.
+ * `Image<PixelRGB_8u, HugePageAllocator>`, to reduce TLB misses when processing very large images.
+ *
+ * On Linux, allocations of at least one huge page are served by anonymous memory mappings. Pages from the explicit
+ * huge page pool (`MAP_HUGETLB`) are used if available; otherwise transparent huge pages are requested via
+ * `madvise(MADV_HUGEPAGE)`. Smaller allocations, and all allocations on other platforms, fall back to regular aligned
+ * heap memory.
+ *
+ * Mapped memory is not touched on allocation, except for the first page: it holds a small bookkeeping header, which
+ * is written by the allocating thread. Inside a `NumaNodeScope`, the mapping is bound to the respective NUMA node
+ * before this write; otherwise, pages are placed by first touch, and the first page ends up on the node of the
+ * allocating thread.
+ * Parallel operations hand out rows to threads dynamically, so first touch does not reliably place rows close to the
+ * threads processing them. To control placement, allocate images inside a `NumaNodeScope`, e.g. one image per node,
+ * to be processed by threads running on that node.
+ */
+struct HugePageAllocator
+{
+  static constexpr std::size_t huge_page_size = std::size_t{2} * 1024 * 1024;
+
+  static MemoryBlock<HugePageAllocator> allocate(std::size_t nr_bytes, std::size_t alignment) noexcept;
+  static void deallocate(std::uint8_t*& data) noexcept;
+
+  static HugePageBacking backing(const std::uint8_t* data) noexcept;
+};
+
+}  // namespace sln
+
+#endif  // SELENE_BASE_HUGE_PAGE_ALLOCATOR_HPP
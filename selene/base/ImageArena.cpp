@@ -0,0 +1,265 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <selene/base/Allocators.hpp>
+#include <selene/base/Assert.hpp>
+#include <selene/base/ImageArena.hpp>
+#include <selene/base/Utils.hpp>
+
+#include <algorithm>
+
+namespace sln {
+
+namespace {
+
+constexpr std::size_t slab_alignment = 64;
+
+thread_local ImageArena* tl_current_arena = nullptr;
+
+std::uint8_t* align_up(std::uint8_t* ptr, std::size_t alignment) noexcept
+{
+  const auto p = reinterpret_cast<std::uintptr_t>(ptr);
+  const auto a = static_cast<std::uintptr_t>(alignment);
+  return ptr + ((a - p % a) % a);
+}
+
+}  // namespace
+
+/** \brief Constructs an empty arena. No memory is allocated until the first allocation request.
+ *
+ * \param initial_slab_size The size of the first slab to be allocated. Later slabs grow geometrically.
+ */
+ImageArena::ImageArena(std::size_t initial_slab_size) : next_slab_size_(std::max(initial_slab_size, std::size_t{1}))
+{
+}
+
+/** \brief Destroys the arena, returning all memory to the system.
+ *
+ * All owning images allocated via `ArenaAllocator` need to have been destroyed before.
+ */
+ImageArena::~ImageArena()
+{
+  SELENE_ASSERT(nr_live_images_ == 0);
+  free_slabs();
+}
+
+/** \brief Allocates the specified number of bytes from the arena.
+ *
+ * The memory stays valid until the next call to `reset()` or `release()`, or until the arena is destroyed.
+ *
+ * \param nr_bytes The number of bytes to allocate.
+ * \param alignment The required byte alignment. Will be rounded up to a power of two.
+ * \return A pointer to the allocated memory, or nullptr if `nr_bytes` is zero or no memory could be allocated.
+ */
+std::uint8_t* ImageArena::allocate(std::size_t nr_bytes, std::size_t alignment) noexcept
+{
+  if (nr_bytes == 0)
+  {
+    return nullptr;
+  }
+
+  alignment = static_cast<std::size_t>(next_power_of_two(std::max(alignment, std::size_t{1})));
+  auto ptr = align_up(cursor_, alignment);
+
+  if (cursor_ == nullptr || ptr > end_ || static_cast<std::size_t>(end_ - ptr) < nr_bytes)
+  {
+    if (!add_slab(nr_bytes + alignment))
+    {
+      return nullptr;
+    }
+
+    ptr = align_up(cursor_, alignment);
+  }
+
+  bytes_used_ += static_cast<std::size_t>(ptr + nr_bytes - cursor_);
+  cursor_ = ptr + nr_bytes;
+  return ptr;
+}
+
+/** \brief Makes all memory of the arena available again, invalidating all previous allocations.
+ *
+ * If more than one slab is in use, all slabs are replaced by a single one of the combined size.
+ */
+void ImageArena::reset() noexcept
+{
+  SELENE_ASSERT(nr_live_images_ == 0);
+
+  if (slabs_.size() > 1)
+  {
+    std::size_t total_size = 0;
+    for (const auto& slab : slabs_)
+    {
+      total_size += slab.size;
+    }
+
+    free_slabs();
+    next_slab_size_ = total_size;
+    add_slab(total_size);
+  }
+
+  cursor_ = slabs_.empty() ? nullptr : slabs_.front().data;
+  end_ = slabs_.empty() ? nullptr : slabs_.front().data + slabs_.front().size;
+  bytes_used_ = 0;
+}
+
+/** \brief Invalidates all previous allocations and returns all memory to the system.
+ */
+void ImageArena::release() noexcept
+{
+  SELENE_ASSERT(nr_live_images_ == 0);
+  free_slabs();
+  bytes_used_ = 0;
+}
+
+/** \brief Returns the number of bytes allocated since the last reset, including alignment padding.
+ *
+ * \return The number of used bytes.
+ */
+std::size_t ImageArena::bytes_used() const noexcept
+{
+  return bytes_used_;
+}
+
+/** \brief Returns the combined size of all slabs currently held by the arena.
+ *
+ * \return The arena capacity in bytes.
+ */
+std::size_t ImageArena::capacity() const noexcept
+{
+  std::size_t total_size = 0;
+  for (const auto& slab : slabs_)
+  {
+    total_size += slab.size;
+  }
+
+  return total_size;
+}
+
+/** \brief Returns the number of slabs currently held by the arena.
+ *
+ * \return The number of slabs.
+ */
+std::size_t ImageArena::nr_slabs() const noexcept
+{
+  return slabs_.size();
+}
+
+/** \brief Returns the number of owning images allocated via `ArenaAllocator` that have not yet been destroyed.
+ *
+ * \return The number of live images.
+ */
+std::size_t ImageArena::nr_live_images() const noexcept
+{
+  return nr_live_images_;
+}
+
+bool ImageArena::add_slab(std::size_t min_size) noexcept
+{
+  const auto size = std::max(next_slab_size_, min_size);
+  auto memory = AlignedNewAllocator::allocate(size, slab_alignment);
+  if (memory.data() == nullptr)
+  {
+    return false;
+  }
+
+  try
+  {
+    slabs_.push_back(Slab{memory.data(), size});
+  }
+  catch (...)
+  {
+    return false;
+  }
+
+  cursor_ = memory.transfer_data();
+  end_ = cursor_ + size;
+  next_slab_size_ = 2 * size;
+  return true;
+}
+
+void ImageArena::free_slabs() noexcept
+{
+  for (auto& slab : slabs_)
+  {
+    AlignedNewAllocator::deallocate(slab.data);
+  }
+
+  slabs_.clear();
+  cursor_ = nullptr;
+  end_ = nullptr;
+}
+
+/** \brief Makes `arena` the current arena of the calling thread.
+ *
+ * \param arena The arena.
+ */
+ImageArenaScope::ImageArenaScope(ImageArena& arena) noexcept : previous_arena_(tl_current_arena)
+{
+  tl_current_arena = &arena;
+}
+
+/** \brief Restores the previously current arena of the calling thread.
+ */
+ImageArenaScope::~ImageArenaScope()
+{
+  tl_current_arena = previous_arena_;
+}
+
+/** \brief Returns the current arena of the calling thread.
+ *
+ * \return A pointer to the current arena, or nullptr if the calling thread is not inside an `ImageArenaScope`.
+ */
+ImageArena* current_image_arena() noexcept
+{
+  return tl_current_arena;
+}
+
+/** \brief Allocates the specified number of bytes from the current arena of the calling thread.
+ *
+ * A pointer to the arena is stored in front of the returned memory, to be able to account for its deallocation.
+ *
+ * \param nr_bytes The number of bytes to allocate.
+ * \param alignment The required byte alignment. Needs to be a power of two (e.g. 8, 16, 32, ...).
+ * \return A MemoryBlock instance with a pointer to the allocated data. If no data could be allocated, or if there is
+ *         no current arena, the MemoryBlock will point to nullptr.
+ */
+MemoryBlock<ArenaAllocator> ArenaAllocator::allocate(std::size_t nr_bytes, std::size_t alignment) noexcept
+{
+  auto arena = tl_current_arena;
+  if (arena == nullptr || nr_bytes == 0)
+  {
+    return construct_memory_block_from_existing_memory<ArenaAllocator>(nullptr, 0);
+  }
+
+  alignment = static_cast<std::size_t>(next_power_of_two(std::max(alignment, sizeof(ImageArena*))));
+  const auto header_bytes = (sizeof(ImageArena*) + alignment - 1) / alignment * alignment;
+  auto ptr = arena->allocate(header_bytes + nr_bytes, alignment);
+  if (ptr == nullptr)
+  {
+    return construct_memory_block_from_existing_memory<ArenaAllocator>(nullptr, 0);
+  }
+
+  ptr += header_bytes;
+  reinterpret_cast<ImageArena**>(ptr)[-1] = arena;
+  arena->nr_live_images_ += 1;
+  return construct_memory_block_from_existing_memory<ArenaAllocator>(ptr, nr_bytes);
+}
+
+/** \brief Marks previously allocated memory as no longer in use. The memory is reclaimed on the next arena reset.
+ *
+ * \param data A pointer to previously allocated data.
+ */
+void ArenaAllocator::deallocate(std::uint8_t*& data) noexcept
+{
+  if (data != nullptr)
+  {
+    auto arena = reinterpret_cast<ImageArena**>(data)[-1];
+    SELENE_ASSERT(arena->nr_live_images_ > 0);
+    arena->nr_live_images_ -= 1;
+  }
+
+  data = nullptr;
+}
+
+}  // namespace sln
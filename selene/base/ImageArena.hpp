@@ -0,0 +1,112 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_BASE_IMAGE_ARENA_HPP
+#define SELENE_BASE_IMAGE_ARENA_HPP
+
+/// @file
+
+#include <selene/base/MemoryBlock.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sln {
+
+/** \brief A monotonic arena for temporary image memory.
+ *
+ * Memory is handed out from large slabs by advancing a pointer; individual allocations are never freed. Instead, all
+ * memory is reclaimed at once by calling `reset()`. If more than one slab was needed since the last reset, `reset()`
+ * replaces all slabs by a single slab of the combined size, such that repeated use with similar memory requirements
+ * (e.g. once per request) will be served from a single slab without any system allocations.
+ *
+ * An `ImageArena` is not thread-safe; it is meant to be used by one thread at a time, e.g. one arena per worker.
+ *
+ * Memory can be obtained directly via `allocate()` (for example, to back image views; see `allocate_image_view()`),
+ * or through `ArenaAllocator` for owning `Image<>` or `DynImage` instances, from within an `ImageArenaScope`.
+ * Owning images allocated from an arena must not outlive it, and must be destroyed before the arena is reset; this is
+ * checked in debug builds.
+ */
+class ImageArena
+{
+public:
+  static constexpr std::size_t default_slab_size = std::size_t{4} * 1024 * 1024;
+
+  explicit ImageArena(std::size_t initial_slab_size = default_slab_size);
+  ~ImageArena();
+
+  ImageArena(const ImageArena&) = delete;
+  ImageArena& operator=(const ImageArena&) = delete;
+  ImageArena(ImageArena&&) = delete;
+  ImageArena& operator=(ImageArena&&) = delete;
+
+  std::uint8_t* allocate(std::size_t nr_bytes, std::size_t alignment) noexcept;
+
+  void reset() noexcept;
+  void release() noexcept;
+
+  std::size_t bytes_used() const noexcept;
+  std::size_t capacity() const noexcept;
+  std::size_t nr_slabs() const noexcept;
+  std::size_t nr_live_images() const noexcept;
+
+private:
+  struct Slab
+  {
+    std::uint8_t* data;
+    std::size_t size;
+  };
+
+  std::vector<Slab> slabs_;
+  std::size_t next_slab_size_;
+  std::uint8_t* cursor_ = nullptr;
+  std::uint8_t* end_ = nullptr;
+  std::size_t bytes_used_ = 0;
+  std::atomic<std::size_t> nr_live_images_{0};
+
+  bool add_slab(std::size_t min_size) noexcept;
+  void free_slabs() noexcept;
+
+  friend struct ArenaAllocator;
+};
+
+/** \brief Makes an `ImageArena` the current arena of the calling thread, for the lifetime of the scope object.
+ *
+ * Scopes can be nested; at the end of a scope, the previously current arena is restored.
+ */
+class ImageArenaScope
+{
+public:
+  explicit ImageArenaScope(ImageArena& arena) noexcept;
+  ~ImageArenaScope();
+
+  ImageArenaScope(const ImageArenaScope&) = delete;
+  ImageArenaScope& operator=(const ImageArenaScope&) = delete;
+  ImageArenaScope(ImageArenaScope&&) = delete;
+  ImageArenaScope& operator=(ImageArenaScope&&) = delete;
+
+private:
+  ImageArena* previous_arena_;
+};
+
+ImageArena* current_image_arena() noexcept;
+
+/** \brief Allocator serving memory from the current `ImageArena` of the calling thread.
+ *
+ * Can be used as allocator type of `Image<PixelType, Allocator>` or `DynImageT<Allocator>`, e.g.
+ * `Image<PixelRGB_8u, ArenaAllocator>`, inside an `ImageArenaScope`. Allocation fails (i.e. returns an empty memory
+ * block) if there is no current arena. Deallocation does not free any memory; it only marks the image as destroyed,
+ * so that the arena can verify that no owning image outlives it.
+ */
+struct ArenaAllocator
+{
+  static MemoryBlock<ArenaAllocator> allocate(std::size_t nr_bytes, std::size_t alignment) noexcept;
+  static void deallocate(std::uint8_t*& data) noexcept;
+};
+
+}  // namespace sln
+
+#endif  // SELENE_BASE_IMAGE_ARENA_HPP
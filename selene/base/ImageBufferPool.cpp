@@ -0,0 +1,284 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <selene/base/Allocators.hpp>
+#include <selene/base/Assert.hpp>
+#include <selene/base/ImageBufferPool.hpp>
+#include <selene/base/Utils.hpp>
+
+#include <algorithm>
+
+namespace sln {
+
+/// The header stored immediately in front of each buffer's data.
+struct ImageBufferPool::BufferHeader
+{
+  ImageBufferPool* pool;
+  std::uint8_t* base;
+  std::size_t capacity;
+  std::size_t alignment;
+};
+
+namespace {
+
+constexpr std::size_t min_size_class = 256;
+constexpr std::size_t min_buffer_alignment = 16;
+
+}  // namespace
+
+/** \brief Constructs an empty image buffer pool.
+ *
+ * \param max_cached_bytes The maximum number of bytes to hold for reuse. Unlimited by default.
+ */
+ImageBufferPool::ImageBufferPool(std::size_t max_cached_bytes) : max_cached_bytes_(max_cached_bytes)
+{
+}
+
+/** \brief Destroys the pool, returning all cached buffers to the system.
+ *
+ * All buffers acquired from the pool need to have been released before.
+ */
+ImageBufferPool::~ImageBufferPool()
+{
+  SELENE_ASSERT(stats_.nr_buffers_in_use == 0);
+  release_cached_memory();
+}
+
+/** \brief Acquires a buffer of at least the specified number of bytes.
+ *
+ * If a cached buffer of the same size class (and sufficient alignment) is available, it is reused; otherwise a new
+ * buffer is allocated.
+ *
+ * \param nr_bytes The number of bytes to acquire.
+ * \param alignment The required byte alignment. Will be rounded up to a power of two, and to at least 16 bytes.
+ * \return A pointer to the buffer data, or nullptr if `nr_bytes` is zero or no memory could be allocated.
+ */
+std::uint8_t* ImageBufferPool::acquire(std::size_t nr_bytes, std::size_t alignment) noexcept
+{
+  if (nr_bytes == 0)
+  {
+    return nullptr;
+  }
+
+  alignment = static_cast<std::size_t>(next_power_of_two(std::max(alignment, min_buffer_alignment)));
+  const auto capacity = size_class(nr_bytes);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = cached_buffers_.find(capacity);
+    if (it != cached_buffers_.end())
+    {
+      auto& buffers = it->second;
+      const auto it_buf = std::find_if(buffers.rbegin(), buffers.rend(),
+                                       [alignment](const BufferHeader* h) { return h->alignment >= alignment; });
+      if (it_buf != buffers.rend())
+      {
+        BufferHeader* header = *it_buf;
+        buffers.erase(std::next(it_buf).base());
+        stats_.nr_hits += 1;
+        stats_.nr_buffers_cached -= 1;
+        stats_.bytes_cached -= capacity;
+        stats_.nr_buffers_in_use += 1;
+        stats_.bytes_in_use += capacity;
+        update_high_water_marks();
+        return reinterpret_cast<std::uint8_t*>(header + 1);
+      }
+    }
+  }
+
+  // The header is stored in front of the data, padded to a multiple of the alignment.
+  const auto header_bytes = (sizeof(BufferHeader) + alignment - 1) / alignment * alignment;
+  auto memory = AlignedNewAllocator::allocate(header_bytes + capacity, alignment);
+  if (memory.data() == nullptr)
+  {
+    return nullptr;
+  }
+
+  std::uint8_t* base = memory.transfer_data();
+  std::uint8_t* data = base + header_bytes;
+  auto header = reinterpret_cast<BufferHeader*>(data) - 1;
+  *header = BufferHeader{this, base, capacity, alignment};
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.nr_misses += 1;
+  stats_.nr_buffers_in_use += 1;
+  stats_.bytes_in_use += capacity;
+  update_high_water_marks();
+  return data;
+}
+
+/** \brief Returns a buffer to the pool it was acquired from.
+ *
+ * \param data A pointer to buffer data previously returned by `acquire()`. May be nullptr.
+ */
+void ImageBufferPool::release(std::uint8_t* data) noexcept
+{
+  if (data == nullptr)
+  {
+    return;
+  }
+
+  auto header = reinterpret_cast<BufferHeader*>(data) - 1;
+  header->pool->release_buffer(header);
+}
+
+/** \brief Returns all currently cached buffers to the system.
+ *
+ * Buffers currently in use are not affected.
+ */
+void ImageBufferPool::release_cached_memory() noexcept
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& entry : cached_buffers_)
+  {
+    for (auto header : entry.second)
+    {
+      free_buffer(header);
+    }
+  }
+
+  cached_buffers_.clear();
+  stats_.nr_buffers_cached = 0;
+  stats_.bytes_cached = 0;
+}
+
+/** \brief Returns the maximum number of bytes the pool holds for reuse.
+ *
+ * \return The maximum number of cached bytes.
+ */
+std::size_t ImageBufferPool::max_cached_bytes() const noexcept
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return max_cached_bytes_;
+}
+
+/** \brief Sets the maximum number of bytes the pool holds for reuse.
+ *
+ * Already cached buffers are kept; the limit applies to buffers released from now on.
+ *
+ * \param max_cached_bytes The maximum number of cached bytes.
+ */
+void ImageBufferPool::set_max_cached_bytes(std::size_t max_cached_bytes) noexcept
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  max_cached_bytes_ = max_cached_bytes;
+}
+
+/** \brief Returns a snapshot of the pool's usage statistics.
+ *
+ * \return The usage statistics.
+ */
+ImageBufferPoolStatistics ImageBufferPool::statistics() const noexcept
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+/** \brief Resets the hit and miss counters, and sets the peak values to the current values.
+ */
+void ImageBufferPool::reset_statistics() noexcept
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.nr_hits = 0;
+  stats_.nr_misses = 0;
+  stats_.peak_bytes_in_use = stats_.bytes_in_use;
+  stats_.high_water_bytes = stats_.bytes_in_use + stats_.bytes_cached;
+}
+
+/** \brief Returns the size class, i.e. the buffer capacity, used for a request of the specified number of bytes.
+ *
+ * Sizes are rounded up to a multiple of 1/8 of the next power of two (i.e. there are four size classes per power of
+ * two), with a minimum of 256 bytes.
+ *
+ * \param nr_bytes The number of requested bytes.
+ * \return The buffer capacity used for the request.
+ */
+std::size_t ImageBufferPool::size_class(std::size_t nr_bytes) noexcept
+{
+  if (nr_bytes <= min_size_class)
+  {
+    return min_size_class;
+  }
+
+  const auto step = static_cast<std::size_t>(next_power_of_two(nr_bytes)) / 8;
+  return (nr_bytes + step - 1) / step * step;
+}
+
+void ImageBufferPool::release_buffer(BufferHeader* header) noexcept
+{
+  const auto capacity = header->capacity;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  SELENE_ASSERT(stats_.nr_buffers_in_use > 0);
+  stats_.nr_buffers_in_use -= 1;
+  stats_.bytes_in_use -= capacity;
+
+  if (stats_.bytes_cached + capacity <= max_cached_bytes_)
+  {
+    try
+    {
+      cached_buffers_[capacity].push_back(header);
+      stats_.nr_buffers_cached += 1;
+      stats_.bytes_cached += capacity;
+      return;
+    }
+    catch (...)
+    {
+      // Bookkeeping failed; return the buffer to the system instead.
+    }
+  }
+
+  lock.unlock();
+  free_buffer(header);
+}
+
+void ImageBufferPool::update_high_water_marks() noexcept
+{
+  stats_.peak_bytes_in_use = std::max(stats_.peak_bytes_in_use, stats_.bytes_in_use);
+  stats_.high_water_bytes = std::max(stats_.high_water_bytes, stats_.bytes_in_use + stats_.bytes_cached);
+}
+
+void ImageBufferPool::free_buffer(BufferHeader* header) noexcept
+{
+  std::uint8_t* base = header->base;
+  AlignedNewAllocator::deallocate(base);
+}
+
+/** \brief Returns the library-wide default image buffer pool.
+ *
+ * The pool is lazily constructed on first use, and never destroyed, such that images with static storage duration
+ * can safely return their memory to it.
+ *
+ * \return A reference to the default image buffer pool.
+ */
+ImageBufferPool& default_image_buffer_pool()
+{
+  static auto* pool = new ImageBufferPool();
+  return *pool;
+}
+
+/** \brief Acquires a buffer of the specified number of bytes from the default image buffer pool.
+ *
+ * \param nr_bytes The number of bytes to allocate.
+ * \param alignment The required byte alignment. Needs to be a power of two (e.g. 8, 16, 32, ...).
+ * \return A MemoryBlock instance with a pointer to the allocated data. If no data could be allocated, the MemoryBlock
+ *         will point to nullptr.
+ */
+MemoryBlock<PooledAllocator> PooledAllocator::allocate(std::size_t nr_bytes, std::size_t alignment) noexcept
+{
+  const auto ptr = default_image_buffer_pool().acquire(nr_bytes, alignment);
+  return construct_memory_block_from_existing_memory<PooledAllocator>(ptr, (ptr == nullptr) ? 0 : nr_bytes);
+}
+
+/** \brief Returns a previously allocated buffer to the pool it was acquired from.
+ *
+ * \param data A pointer to previously allocated data.
+ */
+void PooledAllocator::deallocate(std::uint8_t*& data) noexcept
+{
+  ImageBufferPool::release(data);
+  data = nullptr;
+}
+
+}  // namespace sln
@@ -0,0 +1,108 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_BASE_IMAGE_BUFFER_POOL_HPP
+#define SELENE_BASE_IMAGE_BUFFER_POOL_HPP
+
+/// @file
+
+#include <selene/base/MemoryBlock.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace sln {
+
+/** \brief Usage statistics of an `ImageBufferPool` instance.
+ *
+ * All byte counts refer to buffer capacities, i.e. to allocation sizes rounded up to the respective size class.
+ */
+struct ImageBufferPoolStatistics
+{
+  std::size_t nr_hits = 0;  ///< Number of acquisitions that were served by a cached buffer.
+  std::size_t nr_misses = 0;  ///< Number of acquisitions that required a new system allocation.
+  std::size_t nr_buffers_in_use = 0;  ///< Number of buffers currently handed out.
+  std::size_t nr_buffers_cached = 0;  ///< Number of buffers currently held for reuse.
+  std::size_t bytes_in_use = 0;  ///< Number of bytes currently handed out.
+  std::size_t bytes_cached = 0;  ///< Number of bytes currently held for reuse.
+  std::size_t peak_bytes_in_use = 0;  ///< Maximum of `bytes_in_use` since construction or the last reset.
+  std::size_t high_water_bytes = 0;  ///< Maximum of `bytes_in_use + bytes_cached` since construction or the last reset.
+};
+
+/** \brief A thread-safe pool of image buffers, keyed by byte size class.
+ *
+ * Buffers returned to the pool are cached and handed out again to later requests of the same size class, such that
+ * repeated allocation of equally sized images (e.g. one per video frame) does not cause any system allocations once
+ * the pool has warmed up.
+ *
+ * Requested sizes are rounded up to one of four size classes per power of two, i.e. the capacity overhead is at most
+ * 25%.
+ * The number of cached bytes can be limited; buffers that would exceed the limit are returned to the system instead.
+ *
+ * Each buffer remembers the pool it was acquired from, so `release()` can be called without reference to the pool.
+ * A pool must not be destroyed while any of its buffers are still in use.
+ *
+ * Use `PooledAllocator` to allocate `Image<>` or `DynImage` instances from the library-wide default pool.
+ */
+class ImageBufferPool
+{
+public:
+  explicit ImageBufferPool(std::size_t max_cached_bytes = std::numeric_limits<std::size_t>::max());
+  ~ImageBufferPool();
+
+  ImageBufferPool(const ImageBufferPool&) = delete;
+  ImageBufferPool& operator=(const ImageBufferPool&) = delete;
+  ImageBufferPool(ImageBufferPool&&) = delete;
+  ImageBufferPool& operator=(ImageBufferPool&&) = delete;
+
+  std::uint8_t* acquire(std::size_t nr_bytes, std::size_t alignment) noexcept;
+  static void release(std::uint8_t* data) noexcept;
+
+  void release_cached_memory() noexcept;
+
+  std::size_t max_cached_bytes() const noexcept;
+  void set_max_cached_bytes(std::size_t max_cached_bytes) noexcept;
+
+  ImageBufferPoolStatistics statistics() const noexcept;
+  void reset_statistics() noexcept;
+
+  static std::size_t size_class(std::size_t nr_bytes) noexcept;
+
+private:
+  struct BufferHeader;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::size_t, std::vector<BufferHeader*>> cached_buffers_;
+  std::size_t max_cached_bytes_;
+  ImageBufferPoolStatistics stats_;
+
+  void release_buffer(BufferHeader* header) noexcept;
+  void update_high_water_marks() noexcept;
+  static void free_buffer(BufferHeader* header) noexcept;
+};
+
+ImageBufferPool& default_image_buffer_pool();
+
+/** \brief Allocator serving memory from the library-wide default `ImageBufferPool`.
+ *
+ * Can be used as allocator type of `Image<PixelType, Allocator>` or `DynImageT<Allocator>`, e.g.
+ * `Image<PixelRGB_8u, PooledAllocator>`. Memory of destroyed or reallocated images is returned to the pool.
+ *
+ * Image operations returning a newly created image (e.g. `Image<PixelType> convolution_x(img_src, kernel)`) always
+ * use the default allocator. To serve their results from the pool, use the respective overloads taking a destination
+ * image, and pass an image with `PooledAllocator` as destination.
+ */
+struct PooledAllocator
+{
+  static MemoryBlock<PooledAllocator> allocate(std::size_t nr_bytes, std::size_t alignment) noexcept;
+  static void deallocate(std::uint8_t*& data) noexcept;
+};
+
+}  // namespace sln
+
+#endif  // SELENE_BASE_IMAGE_BUFFER_POOL_HPP
@@ -11,6 +11,7 @@
 
 #include <cstdint>
 #include <cstdlib>
+#include <type_traits>
 
 namespace sln {
 
@@ -75,19 +76,33 @@ inline MemoryBlock<Allocator>::~MemoryBlock()
   }
 }
 
-/** Move constructor. */
+/** Move constructor. The moved-from instance will be empty. */
 template <typename Allocator>
 inline MemoryBlock<Allocator>::MemoryBlock(MemoryBlock<Allocator>&& other) noexcept
     : data_(other.data_), size_(other.size_)
 {
+  other.data_ = nullptr;
+  other.size_ = 0;
 }
 
-/** Move assignment operator. */
+/** Move assignment operator. Previously held memory is deallocated; the moved-from instance will be empty. */
 template <typename Allocator>
 inline MemoryBlock<Allocator>& MemoryBlock<Allocator>::operator=(MemoryBlock<Allocator>&& other) noexcept
 {
+  if (this == &other)
+  {
+    return *this;
+  }
+
+  if (data_ != nullptr)
+  {
+    Allocator::deallocate(data_);
+  }
+
   data_ = other.data_;
   size_ = other.size_;
+  other.data_ = nullptr;
+  other.size_ = 0;
   return *this;
 }
 
@@ -144,6 +159,45 @@ inline MemoryBlock<Allocator> construct_memory_block_from_existing_memory(std::u
   return MemoryBlock<Allocator>(data, size);
 }
 
+namespace impl {
+
+template <typename Allocator, typename = void>
+struct SupportsAlignedAllocation : std::false_type
+{
+};
+
+template <typename Allocator>
+struct SupportsAlignedAllocation<Allocator,
+                                 std::void_t<decltype(Allocator::allocate(std::size_t{}, std::size_t{}))>>
+    : std::true_type
+{
+};
+
+}  // namespace impl
+
+/** \brief Allocates memory using the specified allocator, requesting the given alignment if the allocator supports it.
+ *
+ * Allocators providing `allocate(nr_bytes, alignment)` receive the alignment request; allocators only providing
+ * `allocate(nr_bytes)` return memory with their natural alignment (e.g. the alignment of `std::max_align_t`).
+ *
+ * @tparam Allocator The allocator type.
+ * @param nr_bytes The number of bytes to allocate.
+ * @param alignment The requested byte alignment.
+ * @return A `MemoryBlock<Allocator>` instance. If no data could be allocated, the instance will point to nullptr.
+ */
+template <typename Allocator>
+inline MemoryBlock<Allocator> allocate_memory_block(std::size_t nr_bytes, std::size_t alignment) noexcept
+{
+  if constexpr (impl::SupportsAlignedAllocation<Allocator>::value)
+  {
+    return Allocator::allocate(nr_bytes, alignment);
+  }
+  else
+  {
+    return Allocator::allocate(nr_bytes);
+  }
+}
+
 }  // namespace sln
 
 #endif  // SELENE_BASE_MEMORY_BLOCK_HPP
@@ -0,0 +1,193 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <selene/base/ThreadPool.hpp>
+
+namespace sln {
+
+namespace {
+
+thread_local bool inside_thread_pool_task = false;
+
+}  // namespace
+
+/** \brief Constructs a thread pool.
+ *
+ * \param nr_threads The number of threads to use for executing tasks, including the calling thread. Hence, a value of
+ *                   `nr_threads` will start `nr_threads - 1` worker threads. A value of 0 or 1 results in serial
+ *                   execution on the calling thread.
+ */
+ThreadPool::ThreadPool(std::size_t nr_threads)
+{
+  const auto nr_workers = (nr_threads > 1) ? nr_threads - 1 : std::size_t{0};
+  workers_.reserve(nr_workers);
+
+  for (std::size_t i = 0; i < nr_workers; ++i)
+  {
+    workers_.emplace_back([this]() { worker_loop(); });
+  }
+}
+
+/** \brief Destructor. Joins all worker threads.
+ */
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+
+  cv_work_.notify_all();
+
+  for (auto& worker : workers_)
+  {
+    worker.join();
+  }
+}
+
+/** \brief Returns the number of threads used for executing tasks, including the calling thread.
+ *
+ * \return The number of threads used for executing tasks.
+ */
+std::size_t ThreadPool::nr_threads() const noexcept
+{
+  return workers_.size() + 1;
+}
+
+/** \brief Executes `task(i)` for each `i` in `[0, nr_tasks)`, and blocks until all tasks have been completed.
+ *
+ * \param nr_tasks The number of tasks.
+ * \param task The task function; called once for each task index.
+ */
+void ThreadPool::run(std::size_t nr_tasks, const std::function<void(std::size_t)>& task)
+{
+  if (nr_tasks == 0)
+  {
+    return;
+  }
+
+  std::unique_lock<std::mutex> submit_lock(submit_mutex_, std::defer_lock);
+
+  if (workers_.empty() || nr_tasks == 1 || inside_thread_pool_task || !submit_lock.try_lock())
+  {
+    for (std::size_t i = 0; i < nr_tasks; ++i)
+    {
+      task(i);
+    }
+
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = &task;
+    nr_tasks_ = nr_tasks;
+    next_task_.store(0);
+    nr_active_workers_ = workers_.size();
+    exception_ = nullptr;
+    ++generation_;
+  }
+
+  cv_work_.notify_all();
+  execute_tasks();
+
+  std::exception_ptr exception;
+
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_done_.wait(lock, [this]() { return nr_active_workers_ == 0; });
+    task_ = nullptr;
+    exception = exception_;
+    exception_ = nullptr;
+  }
+
+  if (exception)
+  {
+    std::rethrow_exception(exception);
+  }
+}
+
+/** \brief Returns the default number of threads, i.e. the number of concurrent threads supported by the hardware.
+ *
+ * \return The default number of threads; at least 1.
+ */
+std::size_t ThreadPool::default_nr_threads() noexcept
+{
+  return std::max(std::size_t{std::thread::hardware_concurrency()}, std::size_t{1});
+}
+
+void ThreadPool::worker_loop()
+{
+  std::size_t generation = 0;
+
+  for (;;)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_work_.wait(lock, [this, generation]() { return stop_ || generation_ != generation; });
+
+      if (stop_)
+      {
+        return;
+      }
+
+      generation = generation_;
+    }
+
+    execute_tasks();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--nr_active_workers_ == 0)
+      {
+        cv_done_.notify_one();
+      }
+    }
+  }
+}
+
+void ThreadPool::execute_tasks()
+{
+  const auto was_inside_task = inside_thread_pool_task;
+  inside_thread_pool_task = true;
+
+  for (;;)
+  {
+    const auto i = next_task_.fetch_add(1);
+
+    if (i >= nr_tasks_)
+    {
+      break;
+    }
+
+    try
+    {
+      (*task_)(i);
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(exception_mutex_);
+      if (!exception_)
+      {
+        exception_ = std::current_exception();
+      }
+    }
+  }
+
+  inside_thread_pool_task = was_inside_task;
+}
+
+/** \brief Returns the library-wide default thread pool.
+ *
+ * The pool is lazily constructed on first use, with `ThreadPool::default_nr_threads()` threads.
+ *
+ * \return A reference to the default thread pool.
+ */
+ThreadPool& default_thread_pool()
+{
+  static ThreadPool pool;
+  return pool;
+}
+
+}  // namespace sln
@@ -0,0 +1,126 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_BASE_THREAD_POOL_HPP
+#define SELENE_BASE_THREAD_POOL_HPP
+
+/// @file
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sln {
+
+/** \brief A fixed-size pool of worker threads, used to execute data-parallel operations inside the library.
+ *
+ * A `ThreadPool` executes one batch of indexed tasks at a time; the calling thread participates in executing the
+ * tasks, and `run()` returns only after all tasks of the batch have been completed.
+ *
+ * Calls to `run()` (or `parallel_for()`) from inside a task of the same or another pool, or calls while the pool is
+ * busy executing a batch submitted by another thread, are executed serially on the calling thread. This avoids
+ * deadlocks and oversubscription on nested parallel operations.
+ *
+ * If a task throws an exception, the first exception thrown will be rethrown from `run()` after all tasks have
+ * finished.
+ */
+class ThreadPool
+{
+public:
+  explicit ThreadPool(std::size_t nr_threads = default_nr_threads());
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ThreadPool(ThreadPool&&) = delete;
+  ThreadPool& operator=(ThreadPool&&) = delete;
+
+  std::size_t nr_threads() const noexcept;
+
+  void run(std::size_t nr_tasks, const std::function<void(std::size_t)>& task);
+
+  template <typename Func>
+  void parallel_for(std::ptrdiff_t begin, std::ptrdiff_t end, std::ptrdiff_t grain_size, Func&& func);
+
+  static std::size_t default_nr_threads() noexcept;
+
+private:
+  std::vector<std::thread> workers_;
+
+  std::mutex submit_mutex_;
+  std::mutex mutex_;
+  std::condition_variable cv_work_;
+  std::condition_variable cv_done_;
+  std::size_t generation_ = 0;
+  std::size_t nr_active_workers_ = 0;
+  bool stop_ = false;
+
+  const std::function<void(std::size_t)>* task_ = nullptr;
+  std::size_t nr_tasks_ = 0;
+  std::atomic<std::size_t> next_task_{0};
+
+  std::mutex exception_mutex_;
+  std::exception_ptr exception_;
+
+  void worker_loop();
+  void execute_tasks();
+};
+
+ThreadPool& default_thread_pool();
+
+// ----------
+// Implementation:
+
+/** \brief Executes `func` on consecutive sub-ranges of the index range `[begin, end)`, in parallel.
+ *
+ * The range is split into at most `4 * nr_threads()` chunks, each of which contains at least `grain_size` indices
+ * (except possibly the last one).
+ * The function is called as `func(chunk_begin, chunk_end)`, once per chunk.
+ *
+ * @tparam Func The function type.
+ * @param begin The beginning of the index range.
+ * @param end The end of the index range (exclusive).
+ * @param grain_size The minimum number of indices to be processed per call to `func`.
+ * @param func The function to call on each sub-range. Its signature should be
+ *             `void func(std::ptrdiff_t, std::ptrdiff_t)`.
+ */
+template <typename Func>
+void ThreadPool::parallel_for(std::ptrdiff_t begin, std::ptrdiff_t end, std::ptrdiff_t grain_size, Func&& func)
+{
+  const auto nr_indices = end - begin;
+
+  if (nr_indices <= 0)
+  {
+    return;
+  }
+
+  grain_size = std::max(grain_size, std::ptrdiff_t{1});
+  const auto max_nr_chunks = static_cast<std::ptrdiff_t>(4 * nr_threads());
+  const auto nr_chunks = std::min((nr_indices + grain_size - 1) / grain_size, max_nr_chunks);
+
+  if (nr_chunks <= 1)
+  {
+    func(begin, end);
+    return;
+  }
+
+  const std::function<void(std::size_t)> task = [&](std::size_t chunk) {
+    const auto c = static_cast<std::ptrdiff_t>(chunk);
+    const auto chunk_begin = begin + (nr_indices * c) / nr_chunks;
+    const auto chunk_end = begin + (nr_indices * (c + 1)) / nr_chunks;
+    func(chunk_begin, chunk_end);
+  };
+
+  run(static_cast<std::size_t>(nr_chunks), task);
+}
+
+}  // namespace sln
+
+#endif  // SELENE_BASE_THREAD_POOL_HPP
@@ -0,0 +1,307 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <selene/base/io/MemoryMappedFile.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sln {
+
+/** \brief Maps the specified file into memory.
+ *
+ * If the file `filename` can not be opened or mapped, the function will throw a `std::runtime_error` exception.
+ * See also MemoryMappedFile::open.
+ *
+ * \param filename The name of the file to map.
+ * \param mode The mapping mode.
+ */
+MemoryMappedFile::MemoryMappedFile(const char* filename, MappingMode mode)
+{
+  if (!open(filename, mode))
+  {
+    throw std::runtime_error(std::strerror(errno));
+  }
+}
+
+/** \brief Maps the specified file into memory.
+ *
+ * If the file `filename` can not be opened or mapped, the function will throw a `std::runtime_error` exception.
+ * See also MemoryMappedFile::open.
+ *
+ * \param filename The name of the file to map.
+ * \param mode The mapping mode.
+ */
+MemoryMappedFile::MemoryMappedFile(const std::string& filename, MappingMode mode)
+    : MemoryMappedFile(filename.c_str(), mode)
+{
+}
+
+/** \brief Closes the mapping. */
+MemoryMappedFile::~MemoryMappedFile()
+{
+  close();
+}
+
+/** \brief Move constructor. The moved-from instance will be closed. */
+MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr))
+    , size_(std::exchange(other.size_, 0))
+    , mode_(other.mode_)
+    , is_open_(std::exchange(other.is_open_, false))
+{
+}
+
+/** \brief Move assignment operator. A previously open mapping is closed; the moved-from instance will be closed. */
+MemoryMappedFile& MemoryMappedFile::operator=(MemoryMappedFile&& other) noexcept
+{
+  if (this != &other)
+  {
+    close();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    mode_ = other.mode_;
+    is_open_ = std::exchange(other.is_open_, false);
+  }
+
+  return *this;
+}
+
+/** \brief Maps the specified file into memory.
+ *
+ * The whole file is mapped. A previously open mapping is closed first.
+ *
+ * \param filename The name of the file to map.
+ * \param mode The mapping mode. `MappingMode::ReadWrite` requires write permissions on the file.
+ * \return True, if the file was successfully mapped; false otherwise. In the latter case, `errno` describes the error.
+ */
+bool MemoryMappedFile::open(const char* filename, MappingMode mode) noexcept
+{
+  close();
+
+#if defined(_WIN32)
+  static_cast<void>(filename);
+  static_cast<void>(mode);
+  errno = ENOSYS;
+  return false;
+#else
+  const int fd = ::open(filename, (mode == MappingMode::ReadWrite) ? O_RDWR : O_RDONLY);
+  if (fd < 0)
+  {
+    return false;
+  }
+
+  struct stat file_stat;
+  if (::fstat(fd, &file_stat) != 0)
+  {
+    const auto saved_errno = errno;
+    ::close(fd);
+    errno = saved_errno;
+    return false;
+  }
+
+  const auto size = static_cast<std::size_t>(file_stat.st_size);
+  void* ptr = nullptr;
+
+  if (size > 0)
+  {
+    const int prot = (mode == MappingMode::ReadOnly) ? PROT_READ : (PROT_READ | PROT_WRITE);
+    const int flags = (mode == MappingMode::ReadWrite) ? MAP_SHARED : MAP_PRIVATE;
+    ptr = ::mmap(nullptr, size, prot, flags, fd, 0);
+    if (ptr == MAP_FAILED)
+    {
+      const auto saved_errno = errno;
+      ::close(fd);
+      errno = saved_errno;
+      return false;
+    }
+  }
+
+  // The mapping stays valid after closing the file descriptor.
+  ::close(fd);
+
+  data_ = static_cast<std::uint8_t*>(ptr);
+  size_ = size;
+  mode_ = mode;
+  is_open_ = true;
+  return true;
+#endif
+}
+
+/** \brief Maps the specified file into memory.
+ *
+ * See the overload taking a `const char*` for details.
+ *
+ * \param filename The name of the file to map.
+ * \param mode The mapping mode.
+ * \return True, if the file was successfully mapped; false otherwise.
+ */
+bool MemoryMappedFile::open(const std::string& filename, MappingMode mode) noexcept
+{
+  return open(filename.c_str(), mode);
+}
+
+/** \brief Closes the mapping. Changes to a `MappingMode::ReadWrite` mapping are carried through to the file. */
+void MemoryMappedFile::close() noexcept
+{
+#if !defined(_WIN32)
+  if (data_ != nullptr)
+  {
+    ::munmap(data_, size_);
+  }
+#endif
+
+  data_ = nullptr;
+  size_ = 0;
+  is_open_ = false;
+}
+
+/** \brief Returns whether a file is currently mapped.
+ *
+ * \return True, if a file is mapped; false otherwise.
+ */
+bool MemoryMappedFile::is_open() const noexcept
+{
+  return is_open_;
+}
+
+/** \brief Returns whether the mapping can be written to.
+ *
+ * \return True, if the mapping was opened in `MappingMode::ReadWrite` or `MappingMode::CopyOnWrite` mode.
+ */
+bool MemoryMappedFile::is_writable() const noexcept
+{
+  return is_open_ && mode_ != MappingMode::ReadOnly;
+}
+
+/** \brief Returns the mapping mode.
+ *
+ * \return The mapping mode.
+ */
+MappingMode MemoryMappedFile::mode() const noexcept
+{
+  return mode_;
+}
+
+/** \brief Returns the size of the mapping, i.e. the file size, in bytes.
+ *
+ * \return The size of the mapping.
+ */
+std::size_t MemoryMappedFile::size() const noexcept
+{
+  return size_;
+}
+
+/** \brief Returns a pointer to the mapped memory.
+ *
+ * \return A pointer to the mapped memory, or nullptr if no (non-empty) file is mapped.
+ */
+const std::uint8_t* MemoryMappedFile::data() const noexcept
+{
+  return data_;
+}
+
+/** \brief Returns a pointer to the writable mapped memory.
+ *
+ * \return A pointer to the mapped memory, or nullptr if no (non-empty) file is mapped, or the mapping is read-only.
+ */
+std::uint8_t* MemoryMappedFile::mutable_data() noexcept
+{
+  return is_writable() ? data_ : nullptr;
+}
+
+/** \brief Returns the mapped memory region.
+ *
+ * \return The mapped memory region.
+ */
+ConstantMemoryRegion MemoryMappedFile::region() const noexcept
+{
+  return ConstantMemoryRegion{data_, size_};
+}
+
+/** \brief Returns the writable mapped memory region.
+ *
+ * \return The mapped memory region; empty if the mapping is read-only.
+ */
+MutableMemoryRegion MemoryMappedFile::mutable_region() noexcept
+{
+  return is_writable() ? MutableMemoryRegion{data_, size_} : MutableMemoryRegion{};
+}
+
+/** \brief Advises the operating system about the expected access pattern to the whole mapping.
+ *
+ * \param hint The access pattern hint.
+ * \return True, if the advice was accepted; false otherwise.
+ */
+bool MemoryMappedFile::advise(MappingAccessHint hint) noexcept
+{
+  return advise(hint, 0, size_);
+}
+
+/** \brief Advises the operating system about the expected access pattern to a part of the mapping.
+ *
+ * \param hint The access pattern hint.
+ * \param offset The offset of the part, in bytes. Will be rounded down to the page size.
+ * \param length The length of the part, in bytes.
+ * \return True, if the advice was accepted; false otherwise.
+ */
+bool MemoryMappedFile::advise(MappingAccessHint hint, std::size_t offset, std::size_t length) noexcept
+{
+  if (data_ == nullptr || offset >= size_)
+  {
+    return false;
+  }
+
+#if defined(_WIN32)
+  static_cast<void>(hint);
+  static_cast<void>(length);
+  return false;
+#else
+  const auto page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+  const auto aligned_offset = offset / page_size * page_size;
+  length = std::min(length, size_ - offset) + (offset - aligned_offset);
+
+  int advice = MADV_NORMAL;
+  switch (hint)
+  {
+    case MappingAccessHint::Normal: advice = MADV_NORMAL; break;
+    case MappingAccessHint::Sequential: advice = MADV_SEQUENTIAL; break;
+    case MappingAccessHint::Random: advice = MADV_RANDOM; break;
+    case MappingAccessHint::WillNeed: advice = MADV_WILLNEED; break;
+    case MappingAccessHint::DontNeed: advice = MADV_DONTNEED; break;
+  }
+
+  return ::madvise(data_ + aligned_offset, length, advice) == 0;
+#endif
+}
+
+/** \brief Writes changes to a `MappingMode::ReadWrite` mapping through to the file, synchronously.
+ *
+ * \return True, if the mapping was flushed; false otherwise (including for other mapping modes).
+ */
+bool MemoryMappedFile::flush() noexcept
+{
+  if (data_ == nullptr || mode_ != MappingMode::ReadWrite)
+  {
+    return false;
+  }
+
+#if defined(_WIN32)
+  return false;
+#else
+  return ::msync(data_, size_, MS_SYNC) == 0;
+#endif
+}
+
+}  // namespace sln
@@ -0,0 +1,88 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IO_MEMORY_MAPPED_FILE_HPP
+#define SELENE_IO_MEMORY_MAPPED_FILE_HPP
+
+/// @file
+
+#include <selene/base/io/MemoryRegion.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace sln {
+
+/** \brief Describes how a file is mapped into memory.
+ */
+enum class MappingMode
+{
+  ReadOnly,  ///< The mapping can only be read.
+  ReadWrite,  ///< The mapping can be read and written; changes are carried through to the file.
+  CopyOnWrite,  ///< The mapping can be read and written; changes are private to the mapping (copy-on-write).
+};
+
+/** \brief Describes the expected access pattern to a memory mapping, as a hint to the operating system.
+ */
+enum class MappingAccessHint
+{
+  Normal,  ///< No particular access pattern.
+  Sequential,  ///< Pages will be accessed sequentially; aggressive read-ahead is beneficial.
+  Random,  ///< Pages will be accessed in random order; read-ahead is not beneficial.
+  WillNeed,  ///< Pages will be needed soon; they may be read in ahead of time.
+  DontNeed,  ///< Pages will not be needed soon and may be freed; discards private changes of copy-on-write mappings.
+};
+
+/** \brief Class for mapping the contents of a file into memory.
+ *
+ * Opening a mapping does not read any file contents; pages are read on first access. This makes it possible to
+ * access parts of very large files (e.g. images; see `mapped_image_view()`) without copying them.
+ *
+ * The mapped memory stays valid until the mapping is closed, or the instance is destroyed.
+ *
+ * Memory mapping is currently supported on POSIX platforms only.
+ */
+class MemoryMappedFile
+{
+public:
+  MemoryMappedFile() = default;
+  explicit MemoryMappedFile(const char* filename, MappingMode mode = MappingMode::ReadOnly);
+  explicit MemoryMappedFile(const std::string& filename, MappingMode mode = MappingMode::ReadOnly);
+  ~MemoryMappedFile();
+
+  MemoryMappedFile(const MemoryMappedFile&) = delete;
+  MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+  MemoryMappedFile(MemoryMappedFile&&) noexcept;
+  MemoryMappedFile& operator=(MemoryMappedFile&&) noexcept;
+
+  bool open(const char* filename, MappingMode mode = MappingMode::ReadOnly) noexcept;
+  bool open(const std::string& filename, MappingMode mode = MappingMode::ReadOnly) noexcept;
+  void close() noexcept;
+
+  bool is_open() const noexcept;
+  bool is_writable() const noexcept;
+  MappingMode mode() const noexcept;
+  std::size_t size() const noexcept;
+
+  const std::uint8_t* data() const noexcept;
+  std::uint8_t* mutable_data() noexcept;
+
+  ConstantMemoryRegion region() const noexcept;
+  MutableMemoryRegion mutable_region() noexcept;
+
+  bool advise(MappingAccessHint hint) noexcept;
+  bool advise(MappingAccessHint hint, std::size_t offset, std::size_t length) noexcept;
+  bool flush() noexcept;
+
+private:
+  std::uint8_t* data_ = nullptr;
+  std::size_t size_ = 0;
+  MappingMode mode_ = MappingMode::ReadOnly;
+  bool is_open_ = false;
+};
+
+}  // namespace sln
+
+#endif  // SELENE_IO_MEMORY_MAPPED_FILE_HPP
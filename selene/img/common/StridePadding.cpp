@@ -0,0 +1,74 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <selene/img/common/StridePadding.hpp>
+
+namespace sln {
+
+namespace {
+
+thread_local StridePaddingPolicy tl_stride_padding_policy = no_stride_padding();
+
+}  // namespace
+
+/** \brief Sets the stride padding policy of the calling thread.
+ *
+ * By default, strides are not padded. Allocations made by other threads are not affected.
+ *
+ * \param policy The stride padding policy.
+ */
+void set_stride_padding_policy(StridePaddingPolicy policy) noexcept
+{
+  tl_stride_padding_policy = policy;
+}
+
+/** \brief Returns the stride padding policy of the calling thread.
+ *
+ * \return The stride padding policy.
+ */
+StridePaddingPolicy stride_padding_policy() noexcept
+{
+  return tl_stride_padding_policy;
+}
+
+/** \brief Sets the stride padding policy of the calling thread.
+ *
+ * \param policy The stride padding policy.
+ */
+StridePaddingPolicyScope::StridePaddingPolicyScope(StridePaddingPolicy policy) noexcept
+    : previous_policy_(tl_stride_padding_policy)
+{
+  tl_stride_padding_policy = policy;
+}
+
+/** \brief Restores the previous stride padding policy of the calling thread.
+ */
+StridePaddingPolicyScope::~StridePaddingPolicyScope()
+{
+  tl_stride_padding_policy = previous_policy_;
+}
+
+/** \brief Pads the given row stride according to the stride padding policy.
+ *
+ * The padding is rounded up to a multiple of the row alignment, so that an aligned stride stays aligned.
+ *
+ * \param stride_bytes The row stride in bytes, e.g. as computed from the row length and alignment.
+ * \param row_alignment_bytes The row alignment in bytes.
+ * \param policy The stride padding policy.
+ * \return The padded row stride in bytes.
+ */
+Stride padded_stride_bytes(Stride stride_bytes,
+                           ImageRowAlignment row_alignment_bytes,
+                           StridePaddingPolicy policy) noexcept
+{
+  if (policy.critical_stride_bytes <= 0 || policy.padding_bytes <= 0 || stride_bytes == 0
+      || stride_bytes % policy.critical_stride_bytes != 0)
+  {
+    return stride_bytes;
+  }
+
+  return Stride{stride_bytes + impl::compute_stride_bytes(policy.padding_bytes, row_alignment_bytes)};
+}
+
+}  // namespace sln
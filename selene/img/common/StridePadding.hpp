@@ -0,0 +1,82 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_COMMON_STRIDE_PADDING_HPP
+#define SELENE_IMG_COMMON_STRIDE_PADDING_HPP
+
+/// @file
+
+#include <selene/img/common/Types.hpp>
+
+#include <cstddef>
+
+namespace sln {
+
+/** \brief Policy for padding the row stride of newly allocated images.
+ *
+ * If the row stride of an image is a multiple of a critical stride (typically 4 KB), all rows of a column map to the
+ * same cache sets, and column-wise operations (e.g. `convolution_y` or `transpose`) suffer from cache set aliasing.
+ * Unlike `ImageRowAlignment`, which only rounds the stride up, a padding policy adds `padding_bytes` (rounded up to
+ * the row alignment) to such critical strides.
+ *
+ * The policy is set per thread, and is honored by `allocate()`, and therefore by all image operations allocating their
+ * output on the calling thread.
+ */
+struct StridePaddingPolicy
+{
+  std::ptrdiff_t critical_stride_bytes = 0;  ///< Strides that are multiples of this value are padded; 0 disables.
+  std::ptrdiff_t padding_bytes = 0;  ///< Number of bytes added to a critical stride.
+};
+
+/** \brief Returns a policy that does not pad any strides.
+ *
+ * @return A stride padding policy.
+ */
+constexpr StridePaddingPolicy no_stride_padding() noexcept
+{
+  return StridePaddingPolicy{0, 0};
+}
+
+/** \brief Returns a policy that adds one cache line to strides that are multiples of the critical stride.
+ *
+ * @param critical_stride_bytes The critical stride in bytes.
+ * @param cache_line_bytes The cache line size in bytes.
+ * @return A stride padding policy.
+ */
+constexpr StridePaddingPolicy avoid_cache_set_aliasing(std::ptrdiff_t critical_stride_bytes = 4096,
+                                                       std::ptrdiff_t cache_line_bytes = 64) noexcept
+{
+  return StridePaddingPolicy{critical_stride_bytes, cache_line_bytes};
+}
+
+void set_stride_padding_policy(StridePaddingPolicy policy) noexcept;
+StridePaddingPolicy stride_padding_policy() noexcept;
+
+/** \brief Sets the stride padding policy of the calling thread for the lifetime of the scope object.
+ *
+ * At the end of the scope, the previous policy is restored. Like `ImageArenaScope` and `NumaNodeScope`, the scope only
+ * affects the calling thread.
+ */
+class StridePaddingPolicyScope
+{
+public:
+  explicit StridePaddingPolicyScope(StridePaddingPolicy policy) noexcept;
+  ~StridePaddingPolicyScope();
+
+  StridePaddingPolicyScope(const StridePaddingPolicyScope&) = delete;
+  StridePaddingPolicyScope& operator=(const StridePaddingPolicyScope&) = delete;
+  StridePaddingPolicyScope(StridePaddingPolicyScope&&) = delete;
+  StridePaddingPolicyScope& operator=(StridePaddingPolicyScope&&) = delete;
+
+private:
+  StridePaddingPolicy previous_policy_;
+};
+
+Stride padded_stride_bytes(Stride stride_bytes,
+                           ImageRowAlignment row_alignment_bytes,
+                           StridePaddingPolicy policy = stride_padding_policy()) noexcept;
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_COMMON_STRIDE_PADDING_HPP
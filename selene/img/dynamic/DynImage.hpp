@@ -30,10 +30,19 @@ namespace sln {
  *
  * The memory of a `DynImage` instance is always owned by the instance.
  * To express a non-owning relation to the underlying data, use a `DynImageView<modifiability>`.
+ *
+ * As for `Image<PixelType, Allocator>`, the capacity of the allocated memory is tracked separately from the layout.
+ *
+ * The memory is allocated and deallocated through the `Allocator_` type; see `Image<PixelType, Allocator>`.
+ * `DynImage` is an alias for `DynImageT<>`, i.e. for a dynamic image using the default allocator.
+ *
+ * @tparam Allocator_ The allocator type, e.g. `AlignedNewAllocator` (default) or `MallocAllocator`.
  */
-class DynImage
+template <typename Allocator_ = AlignedNewAllocator>
+class DynImageT
 {
 public:
+  using Allocator = Allocator_;
   using DataPtrType = DataPtr<ImageModifiability::Mutable>::Type;
   using ConstDataPtrType = DataPtr<ImageModifiability::Mutable>::ConstType;
 
@@ -49,29 +58,29 @@ public:
     return ImageModifiability::Mutable;
   }
 
-  DynImage() = default;  ///< Default constructor.
+  DynImageT() = default;  ///< Default constructor.
 
-  explicit DynImage(UntypedLayout layout, UntypedImageSemantics semantics = UntypedImageSemantics{});
+  explicit DynImageT(UntypedLayout layout, UntypedImageSemantics semantics = UntypedImageSemantics{});
 
-  DynImage(UntypedLayout layout,
-           ImageRowAlignment row_alignment_bytes,
-           UntypedImageSemantics semantics = UntypedImageSemantics{});
+  DynImageT(UntypedLayout layout,
+            ImageRowAlignment row_alignment_bytes,
+            UntypedImageSemantics semantics = UntypedImageSemantics{});
 
-  DynImage(MemoryBlock<AlignedNewAllocator>&& memory,
-           UntypedLayout layout,
-           UntypedImageSemantics semantics = UntypedImageSemantics{});
+  DynImageT(MemoryBlock<Allocator>&& memory,
+            UntypedLayout layout,
+            UntypedImageSemantics semantics = UntypedImageSemantics{});
 
-  ~DynImage();
+  ~DynImageT();
 
-  DynImage(const DynImage&);
-  DynImage& operator=(const DynImage&);
+  DynImageT(const DynImageT&);
+  DynImageT& operator=(const DynImageT&);
 
-  DynImage(DynImage&&) noexcept;
-  DynImage& operator=(DynImage&&) noexcept;
+  DynImageT(DynImageT&&) noexcept;
+  DynImageT& operator=(DynImageT&&) noexcept;
 
-  template <ImageModifiability modifiability> explicit DynImage(const DynImageView<modifiability>&);
+  template <ImageModifiability modifiability> explicit DynImageT(const DynImageView<modifiability>&);
 
-  template <ImageModifiability modifiability> DynImage& operator=(const DynImageView<modifiability>&);
+  template <ImageModifiability modifiability> DynImageT& operator=(const DynImageView<modifiability>&);
 
   const UntypedLayout& layout() const noexcept;
   const UntypedImageSemantics& semantics() const noexcept;
@@ -83,6 +92,7 @@ public:
   Stride stride_bytes() const noexcept;
   std::ptrdiff_t row_bytes() const noexcept;
   std::ptrdiff_t total_bytes() const noexcept;
+  std::ptrdiff_t capacity_bytes() const noexcept;
   PixelFormat pixel_format() const noexcept;
   SampleFormat sample_format() const noexcept;
 
@@ -131,16 +141,19 @@ public:
   bool reallocate(UntypedLayout layout,
                   ImageRowAlignment row_alignment_bytes,
                   UntypedImageSemantics semantics = UntypedImageSemantics{},
-                  bool shrink_to_fit = true);
+                  bool shrink_to_fit = false);
+  bool shrink_to_fit();
 
-  MemoryBlock<AlignedNewAllocator> relinquish_data_ownership();
+  MemoryBlock<Allocator> relinquish_data_ownership();
 
 private:
   constexpr static auto default_base_alignment_bytes = ImageRowAlignment{16ul};
 
   DynImageView<ImageModifiability::Mutable> view_;
+  std::ptrdiff_t capacity_bytes_ = 0;
 
-  void copy_rows_from(const DynImage& src);
+  template <typename DynImageOrView>
+  void copy_rows_from(const DynImageOrView& src);
 
   DynImageView<ImageModifiability::Mutable> allocate_memory(
       UntypedLayout layout,
@@ -151,17 +164,22 @@ private:
   void deallocate_memory();
 };
 
-bool operator==(const DynImage& img0, const DynImage& img1);
+using DynImage = DynImageT<>;  ///< Dynamically typed image class, using the default allocator.
 
-bool operator!=(const DynImage& img0, const DynImage& img1);
+template <typename Allocator0, typename Allocator1>
+bool operator==(const DynImageT<Allocator0>& img0, const DynImageT<Allocator1>& img1);
 
-inline bool equal(const DynImage& dyn_img_0, const DynImage& dyn_img_1);
+template <typename Allocator0, typename Allocator1>
+bool operator!=(const DynImageT<Allocator0>& img0, const DynImageT<Allocator1>& img1);
 
-template <ImageModifiability modifiability>
-bool equal(const DynImage& dyn_img_0, const DynImageView<modifiability>& dyn_img_view_1);
+template <typename Allocator0, typename Allocator1>
+bool equal(const DynImageT<Allocator0>& dyn_img_0, const DynImageT<Allocator1>& dyn_img_1);
 
-template <ImageModifiability modifiability>
-bool equal(const DynImageView<modifiability>& dyn_img_view_0, const DynImage& dyn_img_1);
+template <typename Allocator0, ImageModifiability modifiability>
+bool equal(const DynImageT<Allocator0>& dyn_img_0, const DynImageView<modifiability>& dyn_img_view_1);
+
+template <typename Allocator1, ImageModifiability modifiability>
+bool equal(const DynImageView<modifiability>& dyn_img_view_0, const DynImageT<Allocator1>& dyn_img_1);
 
 // ----------
 // Implementation:
@@ -171,8 +189,10 @@ bool equal(const DynImageView<modifiability>& dyn_img_view_0, const DynImage& dy
  * @param layout The image layout.
  * @param semantics The pixel semantics.
  */
-inline DynImage::DynImage(UntypedLayout layout, UntypedImageSemantics semantics)
+template <typename Allocator_>
+DynImageT<Allocator_>::DynImageT(UntypedLayout layout, UntypedImageSemantics semantics)
     : view_(this->allocate_memory(layout, default_base_alignment_bytes, 0, semantics))
+    , capacity_bytes_(view_.total_bytes())
 {
 }
 
@@ -182,8 +202,12 @@ inline DynImage::DynImage(UntypedLayout layout, UntypedImageSemantics semantics)
  * @param row_alignment_bytes The row alignment in bytes.
  * @param semantics The pixel semantics.
  */
-inline DynImage::DynImage(UntypedLayout layout, ImageRowAlignment row_alignment_bytes, UntypedImageSemantics semantics)
+template <typename Allocator_>
+DynImageT<Allocator_>::DynImageT(UntypedLayout layout,
+                                 ImageRowAlignment row_alignment_bytes,
+                                 UntypedImageSemantics semantics)
     : view_(this->allocate_memory(layout, default_base_alignment_bytes, row_alignment_bytes, semantics))
+    , capacity_bytes_(view_.total_bytes())
 {
 }
 
@@ -195,11 +219,13 @@ inline DynImage::DynImage(UntypedLayout layout, ImageRowAlignment row_alignment_
  * @param layout The image layout.
  * @param semantics The pixel semantics.
  */
-inline DynImage::DynImage(
-    MemoryBlock<AlignedNewAllocator>&& memory,
+template <typename Allocator_>
+DynImageT<Allocator_>::DynImageT(
+    MemoryBlock<Allocator>&& memory,
     UntypedLayout layout,
     UntypedImageSemantics semantics)
     : view_(memory.transfer_data(), layout, semantics)
+    , capacity_bytes_(view_.total_bytes())
 {
 }
 
@@ -207,7 +233,8 @@ inline DynImage::DynImage(
  *
  * All owned memory will be deallocated.
  */
-inline DynImage::~DynImage()
+template <typename Allocator_>
+DynImageT<Allocator_>::~DynImageT()
 {
   this->deallocate_memory();
 }
@@ -216,12 +243,14 @@ inline DynImage::~DynImage()
  *
  * @param other The image to be copied from.
  */
-inline DynImage::DynImage(const DynImage& other)
+template <typename Allocator_>
+DynImageT<Allocator_>::DynImageT(const DynImageT& other)
     : view_(allocate_memory(other.layout(),
                             default_base_alignment_bytes,
                             impl::guess_row_alignment(reinterpret_cast<std::uintptr_t>(other.byte_ptr()),
                                                       other.stride_bytes()),
                             other.semantics()))
+    , capacity_bytes_(view_.total_bytes())
 {
   copy_rows_from(other);
 }
@@ -231,7 +260,8 @@ inline DynImage::DynImage(const DynImage& other)
  * @param other The image to be assigned from.
  * @return A reference to this image.
  */
-inline DynImage& DynImage::operator=(const DynImage& other)
+template <typename Allocator_>
+DynImageT<Allocator_>& DynImageT<Allocator_>::operator=(const DynImageT& other)
 {
   // Check for self-assignment
   if (this == & other)
@@ -239,20 +269,10 @@ inline DynImage& DynImage::operator=(const DynImage& other)
     return *this;
   }
 
-  const auto equal_size = (total_bytes() == other.total_bytes());
-
-  if (!equal_size)
-  {
-    // Clean up own memory
-    this->deallocate_memory();
-
-    // Allocate new memory
-    view_ = allocate_memory(
-        other.layout(), default_base_alignment_bytes,
-        impl::guess_row_alignment(reinterpret_cast<std::uintptr_t>(other.byte_ptr()), other.stride_bytes()),
-        other.semantics());
-  }
-
+  // Reuses the allocated memory, if the layout of `other` fits
+  this->reallocate(other.layout(),
+                   impl::guess_row_alignment(reinterpret_cast<std::uintptr_t>(other.byte_ptr()), other.stride_bytes()),
+                   other.semantics());
   copy_rows_from(other);
 
   return * this;
@@ -262,10 +282,12 @@ inline DynImage& DynImage::operator=(const DynImage& other)
  *
  * @param other The image to be moved from.
  */
-inline DynImage::DynImage(DynImage&& other) noexcept
-    : view_(other.view_)
+template <typename Allocator_>
+DynImageT<Allocator_>::DynImageT(DynImageT&& other) noexcept
+    : view_(other.view_), capacity_bytes_(other.capacity_bytes_)
 {
   other.view_ = DynImageView<ImageModifiability::Mutable>{{nullptr}, UntypedLayout{}, UntypedImageSemantics{}};
+  other.capacity_bytes_ = 0;
 }
 
 /** \brief Move assignment operator.
@@ -273,7 +295,8 @@ inline DynImage::DynImage(DynImage&& other) noexcept
  * @param other The image to be move-assigned from.
  * @return A reference to this image.
  */
-inline DynImage& DynImage::operator=(DynImage&& other) noexcept
+template <typename Allocator_>
+DynImageT<Allocator_>& DynImageT<Allocator_>::operator=(DynImageT&& other) noexcept
 {
   // Check for self-assignment
   if (this == & other)
@@ -285,7 +308,9 @@ inline DynImage& DynImage::operator=(DynImage&& other) noexcept
   this->deallocate_memory();
 
   view_ = other.view_;
+  capacity_bytes_ = other.capacity_bytes_;
   other.view_ = DynImageView<ImageModifiability::Mutable>{{nullptr}, UntypedLayout{}, UntypedImageSemantics{}};
+  other.capacity_bytes_ = 0;
 
   return * this;
 }
@@ -295,13 +320,15 @@ inline DynImage& DynImage::operator=(DynImage&& other) noexcept
  * @tparam modifiability_ The modifiability value of the other image.
  * @param other The image to be copied from.
  */
+template <typename Allocator_>
 template <ImageModifiability modifiability_>
-DynImage::DynImage(const DynImageView<modifiability_>& other)
+DynImageT<Allocator_>::DynImageT(const DynImageView<modifiability_>& other)
     : view_(allocate_memory(other.layout(),
                             default_base_alignment_bytes,
                             impl::guess_row_alignment(reinterpret_cast<std::uintptr_t>(other.byte_ptr()),
                                                       other.stride_bytes()),
                             other.semantics()))
+    , capacity_bytes_(view_.total_bytes())
 {
   copy_rows_from(other);
 }
@@ -311,8 +338,9 @@ DynImage::DynImage(const DynImageView<modifiability_>& other)
  * @tparam modifiability_ The modifiability value of the other image.
  * @param other The image to be copied from.
  */
+template <typename Allocator_>
 template <ImageModifiability modifiability_>
-DynImage& DynImage::operator=(const DynImageView<modifiability_>& other)
+DynImageT<Allocator_>& DynImageT<Allocator_>::operator=(const DynImageView<modifiability_>& other)
 {
   // Check for self-assignment
   if (& this->view_ == & other)
@@ -320,20 +348,10 @@ DynImage& DynImage::operator=(const DynImageView<modifiability_>& other)
     return * this;
   }
 
-  const auto equal_size = (total_bytes() == other.total_bytes());
-
-  if (!equal_size)
-  {
-    // Clean up own memory
-    this->deallocate_memory();
-
-    // Allocate new memory
-    view_ = allocate_memory(
-        other.layout(), default_base_alignment_bytes,
-        impl::guess_row_alignment(reinterpret_cast<std::uintptr_t>(other.byte_ptr()), other.stride_bytes()),
-        other.semantics());
-  }
-
+  // Reuses the allocated memory, if the layout of `other` fits
+  this->reallocate(other.layout(),
+                   impl::guess_row_alignment(reinterpret_cast<std::uintptr_t>(other.byte_ptr()), other.stride_bytes()),
+                   other.semantics());
   copy_rows_from(other);
 
   return * this;
@@ -344,7 +362,8 @@ DynImage& DynImage::operator=(const DynImageView<modifiability_>& other)
  * @tparam modifiability_ Determines whether image contents are constant or mutable.
  * @return The untyped image layout.
  */
-inline const UntypedLayout& DynImage::layout() const noexcept
+template <typename Allocator_>
+const UntypedLayout& DynImageT<Allocator_>::layout() const noexcept
 {
   return view_.layout();
 }
@@ -354,7 +373,8 @@ inline const UntypedLayout& DynImage::layout() const noexcept
  * @tparam modifiability_ Determines whether image contents are constant or mutable.
  * @return The pixel semantics.
  */
-inline const UntypedImageSemantics& DynImage::semantics() const noexcept
+template <typename Allocator_>
+const UntypedImageSemantics& DynImageT<Allocator_>::semantics() const noexcept
 {
   return view_.semantics();
 }
@@ -363,7 +383,8 @@ inline const UntypedImageSemantics& DynImage::semantics() const noexcept
  *
  * @return The image width.
  */
-inline PixelLength DynImage::width() const noexcept
+template <typename Allocator_>
+PixelLength DynImageT<Allocator_>::width() const noexcept
 {
   return view_.width();
 }
@@ -372,7 +393,8 @@ inline PixelLength DynImage::width() const noexcept
  *
  * @return The image height.
  */
-inline PixelLength DynImage::height() const noexcept
+template <typename Allocator_>
+PixelLength DynImageT<Allocator_>::height() const noexcept
 {
   return view_.height();
 }
@@ -381,7 +403,8 @@ inline PixelLength DynImage::height() const noexcept
  *
  * @return The number of channels.
  */
-inline std::int16_t DynImage::nr_channels() const noexcept
+template <typename Allocator_>
+std::int16_t DynImageT<Allocator_>::nr_channels() const noexcept
 {
   return view_.nr_channels();
 }
@@ -390,7 +413,8 @@ inline std::int16_t DynImage::nr_channels() const noexcept
  *
  * @return The number of bytes per channel.
  */
-inline std::int16_t DynImage::nr_bytes_per_channel() const noexcept
+template <typename Allocator_>
+std::int16_t DynImageT<Allocator_>::nr_bytes_per_channel() const noexcept
 {
   return view_.nr_bytes_per_channel();
 }
@@ -404,7 +428,8 @@ inline std::int16_t DynImage::nr_bytes_per_channel() const noexcept
  *
  * @return The row stride of the image in bytes.
  */
-inline Stride DynImage::stride_bytes() const noexcept
+template <typename Allocator_>
+Stride DynImageT<Allocator_>::stride_bytes() const noexcept
 {
   return view_.stride_bytes();
 }
@@ -416,7 +441,8 @@ inline Stride DynImage::stride_bytes() const noexcept
  *
  * @return The number of data bytes occupied by each image row.
  */
-inline std::ptrdiff_t DynImage::row_bytes() const noexcept
+template <typename Allocator_>
+std::ptrdiff_t DynImageT<Allocator_>::row_bytes() const noexcept
 {
   return view_.row_bytes();
 }
@@ -427,17 +453,31 @@ inline std::ptrdiff_t DynImage::row_bytes() const noexcept
  *
  * @return The total number of bytes occupied by the image data in memory.
  */
-inline std::ptrdiff_t DynImage::total_bytes() const noexcept
+template <typename Allocator_>
+std::ptrdiff_t DynImageT<Allocator_>::total_bytes() const noexcept
 {
   return view_.total_bytes();
 }
 
+/** \brief Returns the number of bytes of allocated memory owned by the dynamic image.
+ *
+ * The value returned is greater than or equal to `total_bytes()`.
+ *
+ * @return The number of bytes of allocated memory.
+ */
+template <typename Allocator_>
+std::ptrdiff_t DynImageT<Allocator_>::capacity_bytes() const noexcept
+{
+  return capacity_bytes_;
+}
+
 /** \brief Returns the specified pixel format of the dynamic image.
  *
  * @tparam modifiability_ Determines whether image contents are constant or mutable.
  * @return The pixel format.
  */
-inline PixelFormat DynImage::pixel_format() const noexcept
+template <typename Allocator_>
+PixelFormat DynImageT<Allocator_>::pixel_format() const noexcept
 {
   return view_.pixel_format();
 }
@@ -447,7 +487,8 @@ inline PixelFormat DynImage::pixel_format() const noexcept
  * @tparam modifiability_ Determines whether image contents are constant or mutable.
  * @return The sample format.
  */
-inline SampleFormat DynImage::sample_format() const noexcept
+template <typename Allocator_>
+SampleFormat DynImageT<Allocator_>::sample_format() const noexcept
 {
   return view_.sample_format();
 }
@@ -458,7 +499,8 @@ inline SampleFormat DynImage::sample_format() const noexcept
  *
  * @return True, if the image view data is stored packed; false otherwise.
  */
-inline bool DynImage::is_packed() const noexcept
+template <typename Allocator_>
+bool DynImageT<Allocator_>::is_packed() const noexcept
 {
   return view_.is_packed();
 }
@@ -470,7 +512,8 @@ inline bool DynImage::is_packed() const noexcept
  *
  * @return True, if the image is empty; false if it is non-empty.
  */
-inline bool DynImage::is_empty() const noexcept
+template <typename Allocator_>
+bool DynImageT<Allocator_>::is_empty() const noexcept
 {
   return view_.is_empty();
 }
@@ -481,7 +524,8 @@ inline bool DynImage::is_empty() const noexcept
  *
  * @return True, if the image is valid; false otherwise.
  */
-inline bool DynImage::is_valid() const noexcept
+template <typename Allocator_>
+bool DynImageT<Allocator_>::is_valid() const noexcept
 {
   return view_.is_valid();
 }
@@ -490,8 +534,9 @@ inline bool DynImage::is_valid() const noexcept
  *
  * @return Iterator to the first image row.
  */
+template <typename Allocator_>
 template <typename PixelType>
-auto DynImage::begin() noexcept -> iterator<PixelType>
+auto DynImageT<Allocator_>::begin() noexcept -> iterator<PixelType>
 {
   return view_.begin<PixelType>();
 }
@@ -501,8 +546,9 @@ auto DynImage::begin() noexcept -> iterator<PixelType>
  * @tparam PixelType The pixel type.
  * @return Constant iterator to the first image row.
  */
+template <typename Allocator_>
 template <typename PixelType>
-auto DynImage::begin() const noexcept -> const_iterator<PixelType>
+auto DynImageT<Allocator_>::begin() const noexcept -> const_iterator<PixelType>
 {
   return view_.begin<PixelType>();
 }
@@ -512,8 +558,9 @@ auto DynImage::begin() const noexcept -> const_iterator<PixelType>
  * @tparam PixelType The pixel type.
  * @return Constant iterator to the first image row.
  */
+template <typename Allocator_>
 template <typename PixelType>
-auto DynImage::cbegin() const noexcept -> const_iterator<PixelType>
+auto DynImageT<Allocator_>::cbegin() const noexcept -> const_iterator<PixelType>
 {
   return view_.cbegin<PixelType>();
 }
@@ -523,8 +570,9 @@ auto DynImage::cbegin() const noexcept -> const_iterator<PixelType>
  * @tparam PixelType The pixel type.
  * @return Iterator to the image row after the last row.
  */
+template <typename Allocator_>
 template <typename PixelType>
-auto DynImage::end() noexcept -> iterator<PixelType>
+auto DynImageT<Allocator_>::end() noexcept -> iterator<PixelType>
 {
   return view_.end<PixelType>();
 }
@@ -534,8 +582,9 @@ auto DynImage::end() noexcept -> iterator<PixelType>
  * @tparam PixelType The pixel type.
  * @return Constant iterator to the image row after the last row.
  */
+template <typename Allocator_>
 template <typename PixelType>
-auto DynImage::end() const noexcept -> const_iterator<PixelType>
+auto DynImageT<Allocator_>::end() const noexcept -> const_iterator<PixelType>
 {
   return view_.end<PixelType>();
 }
@@ -545,8 +594,9 @@ auto DynImage::end() const noexcept -> const_iterator<PixelType>
  * @tparam PixelType The pixel type.
  * @return Constant iterator to the image row after the last row.
  */
+template <typename Allocator_>
 template <typename PixelType>
-auto DynImage::cend() const noexcept -> const_iterator<PixelType>
+auto DynImageT<Allocator_>::cend() const noexcept -> const_iterator<PixelType>
 {
   return view_.cend<PixelType>();
 }
@@ -555,7 +605,8 @@ auto DynImage::cend() const noexcept -> const_iterator<PixelType>
  *
  * @return Pointer to the first image data byte.
  */
-inline auto DynImage::byte_ptr() noexcept -> DataPtrType
+template <typename Allocator_>
+auto DynImageT<Allocator_>::byte_ptr() noexcept -> DataPtrType
 {
   return view_.byte_ptr();
 }
@@ -564,7 +615,8 @@ inline auto DynImage::byte_ptr() noexcept -> DataPtrType
  *
  * @return Constant pointer to the first image data byte.
  */
-inline auto DynImage::byte_ptr() const noexcept -> ConstDataPtrType
+template <typename Allocator_>
+auto DynImageT<Allocator_>::byte_ptr() const noexcept -> ConstDataPtrType
 {
   return view_.byte_ptr();
 }
@@ -574,7 +626,8 @@ inline auto DynImage::byte_ptr() const noexcept -> ConstDataPtrType
  * @param y Row index.
  * @return Pointer to the first image data byte of row `y`.
  */
-inline auto DynImage::byte_ptr(PixelIndex y) noexcept -> DataPtrType
+template <typename Allocator_>
+auto DynImageT<Allocator_>::byte_ptr(PixelIndex y) noexcept -> DataPtrType
 {
   return view_.byte_ptr(y);
 }
@@ -584,7 +637,8 @@ inline auto DynImage::byte_ptr(PixelIndex y) noexcept -> DataPtrType
  * @param y Row index.
  * @return Constant pointer to the first image data byte of row `y`.
  */
-inline auto DynImage::byte_ptr(PixelIndex y) const noexcept -> ConstDataPtrType
+template <typename Allocator_>
+auto DynImageT<Allocator_>::byte_ptr(PixelIndex y) const noexcept -> ConstDataPtrType
 {
   return view_.byte_ptr(y);
 }
@@ -595,7 +649,8 @@ inline auto DynImage::byte_ptr(PixelIndex y) const noexcept -> ConstDataPtrType
  * @param y Row index.
  * @return Pointer to the first byte of the pixel element at location `(x, y)`.
  */
-inline auto DynImage::byte_ptr(PixelIndex x, PixelIndex y) noexcept -> DataPtrType
+template <typename Allocator_>
+auto DynImageT<Allocator_>::byte_ptr(PixelIndex x, PixelIndex y) noexcept -> DataPtrType
 {
   return view_.byte_ptr(x, y);
 }
@@ -606,7 +661,8 @@ inline auto DynImage::byte_ptr(PixelIndex x, PixelIndex y) noexcept -> DataPtrTy
  * @param y Row index.
  * @return Constant pointer to the first byte of the pixel element at location `(x, y)`.
  */
-inline auto DynImage::byte_ptr(PixelIndex x, PixelIndex y) const noexcept -> ConstDataPtrType
+template <typename Allocator_>
+auto DynImageT<Allocator_>::byte_ptr(PixelIndex x, PixelIndex y) const noexcept -> ConstDataPtrType
 {
   return view_.byte_ptr(x, y);
 }
@@ -616,8 +672,9 @@ inline auto DynImage::byte_ptr(PixelIndex x, PixelIndex y) const noexcept -> Con
  * @tparam PixelType The pixel type.
  * @return Pointer to the first pixel element.
  */
+template <typename Allocator_>
 template <typename PixelType>
-PixelType* DynImage::data() noexcept
+PixelType* DynImageT<Allocator_>::data() noexcept
 {
   return view_.data<PixelType>();
 }
@@ -627,8 +684,9 @@ PixelType* DynImage::data() noexcept
  * @tparam PixelType The pixel type.
  * @return Constant pointer to the first pixel element.
  */
+template <typename Allocator_>
 template <typename PixelType>
-const PixelType* DynImage::data() const noexcept
+const PixelType* DynImageT<Allocator_>::data() const noexcept
 {
   return view_.data<PixelType>();
 }
@@ -639,8 +697,9 @@ const PixelType* DynImage::data() const noexcept
  * @param y Row index.
  * @return Pointer to the first pixel element of the y-th row.
  */
+template <typename Allocator_>
 template <typename PixelType>
-PixelType* DynImage::data(PixelIndex y) noexcept
+PixelType* DynImageT<Allocator_>::data(PixelIndex y) noexcept
 {
   return view_.data<PixelType>(y);
 }
@@ -651,8 +710,9 @@ PixelType* DynImage::data(PixelIndex y) noexcept
  * @param y Row index.
  * @return Constant pointer to the first pixel element of the y-th row.
  */
+template <typename Allocator_>
 template <typename PixelType>
-const PixelType* DynImage::data(PixelIndex y) const noexcept
+const PixelType* DynImageT<Allocator_>::data(PixelIndex y) const noexcept
 {
   return view_.data<PixelType>(y);
 }
@@ -663,8 +723,9 @@ const PixelType* DynImage::data(PixelIndex y) const noexcept
  * @param y Row index.
  * @return Pointer to the one-past-the-last pixel element of the y-th row.
  */
+template <typename Allocator_>
 template <typename PixelType>
-PixelType* DynImage::data_row_end(PixelIndex y) noexcept
+PixelType* DynImageT<Allocator_>::data_row_end(PixelIndex y) noexcept
 {
   return view_.data_row_end<PixelType>(y);
 }
@@ -675,8 +736,9 @@ PixelType* DynImage::data_row_end(PixelIndex y) noexcept
  * @param y Row index.
  * @return Constant pointer to the one-past-the-last pixel element of the y-th row.
  */
+template <typename Allocator_>
 template <typename PixelType>
-const PixelType* DynImage::data_row_end(PixelIndex y) const noexcept
+const PixelType* DynImageT<Allocator_>::data_row_end(PixelIndex y) const noexcept
 {
   return view_.data_row_end<PixelType>(y);
 }
@@ -688,8 +750,9 @@ const PixelType* DynImage::data_row_end(PixelIndex y) const noexcept
  * @param y Row index.
  * @return Pointer to the x-th pixel element of the y-th row.
  */
+template <typename Allocator_>
 template <typename PixelType>
-PixelType* DynImage::data(PixelIndex x, PixelIndex y) noexcept
+PixelType* DynImageT<Allocator_>::data(PixelIndex x, PixelIndex y) noexcept
 {
   return view_.data<PixelType>(x, y);
 }
@@ -701,8 +764,9 @@ PixelType* DynImage::data(PixelIndex x, PixelIndex y) noexcept
  * @param y Row index.
  * @return Constant pointer to the x-th pixel element of the y-th row.
  */
+template <typename Allocator_>
 template <typename PixelType>
-const PixelType* DynImage::data(PixelIndex x, PixelIndex y) const noexcept
+const PixelType* DynImageT<Allocator_>::data(PixelIndex x, PixelIndex y) const noexcept
 {
   return view_.data<PixelType>(x, y);
 }
@@ -714,8 +778,9 @@ const PixelType* DynImage::data(PixelIndex x, PixelIndex y) const noexcept
  * @param y Row index.
  * @return Reference to the pixel element at location `(x, y)`.
  */
+template <typename Allocator_>
 template <typename PixelType>
-PixelType& DynImage::pixel(PixelIndex x, PixelIndex y) noexcept
+PixelType& DynImageT<Allocator_>::pixel(PixelIndex x, PixelIndex y) noexcept
 {
   return view_.pixel<PixelType>(x, y);
 }
@@ -727,8 +792,9 @@ PixelType& DynImage::pixel(PixelIndex x, PixelIndex y) noexcept
  * @param y Row index.
  * @return Constant reference to the pixel element at location `(x, y)`.
  */
+template <typename Allocator_>
 template <typename PixelType>
-const PixelType& DynImage::pixel(PixelIndex x, PixelIndex y) const noexcept
+const PixelType& DynImageT<Allocator_>::pixel(PixelIndex x, PixelIndex y) const noexcept
 {
   return view_.pixel<PixelType>(x, y);
 }
@@ -737,7 +803,8 @@ const PixelType& DynImage::pixel(PixelIndex x, PixelIndex y) const noexcept
  *
  * @return The underlying (mutable) dynamic image view.
  */
-inline DynImageView<ImageModifiability::Mutable>& DynImage::view() noexcept
+template <typename Allocator_>
+DynImageView<ImageModifiability::Mutable>& DynImageT<Allocator_>::view() noexcept
 {
   return view_.view();
 }
@@ -746,7 +813,8 @@ inline DynImageView<ImageModifiability::Mutable>& DynImage::view() noexcept
  *
  * @return A constant image view.
  */
-inline DynImageView<ImageModifiability::Constant> DynImage::view() const noexcept
+template <typename Allocator_>
+DynImageView<ImageModifiability::Constant> DynImageT<Allocator_>::view() const noexcept
 {
   return view_.constant_view();
 }
@@ -755,7 +823,8 @@ inline DynImageView<ImageModifiability::Constant> DynImage::view() const noexcep
  *
  * @return A constant image view.
  */
-inline DynImageView<ImageModifiability::Constant> DynImage::constant_view() const noexcept
+template <typename Allocator_>
+DynImageView<ImageModifiability::Constant> DynImageT<Allocator_>::constant_view() const noexcept
 {
   return view_.constant_view();
 }
@@ -764,50 +833,82 @@ inline DynImageView<ImageModifiability::Constant> DynImage::constant_view() cons
  *
  * All allocated memory will be deallocated.
  */
-inline void DynImage::clear()
+template <typename Allocator_>
+void DynImageT<Allocator_>::clear()
 {
   deallocate_memory();
   view_.clear();
+  capacity_bytes_ = 0;
 }
 
 /** \brief Reallocates the image data according to the specified layout and alignment.
+ *
+ * The image contents are not preserved.
  *
  * @param layout The layout for reallocation.
  * @param row_alignment_bytes The desired row alignment in bytes.
  * @param semantics The new image semantics.
- * @param shrink_to_fit If true, then a reallocation will also take place if the required memory is less than already
- *                      allocated. If false, then the already allocated memory will be kept, if the required memory is
- *                      less than already allocated.
+ * @param shrink_to_fit If false, then the allocated memory will be kept, if the required memory fits into its capacity
+ *                      (and it is sufficiently aligned). If true, then the allocated memory will only be kept if the
+ *                      required memory matches its capacity exactly.
  * @return True, if a memory reallocation took place; false otherwise.
  */
-inline bool DynImage::reallocate(
+template <typename Allocator_>
+bool DynImageT<Allocator_>::reallocate(
     UntypedLayout layout,
     ImageRowAlignment row_alignment_bytes,
     UntypedImageSemantics semantics,
     bool shrink_to_fit)
 {
-  if (layout == this->view_.layout())
+  layout.stride_bytes = impl::compute_stride_bytes(
+      std::max(layout.stride_bytes, Stride{layout.nr_bytes_per_channel * layout.nr_channels * layout.width}),
+      row_alignment_bytes);
+  const auto nr_bytes_required = layout.stride_bytes * layout.height;
+  const auto base_alignment_bytes = std::max(static_cast<std::ptrdiff_t>(row_alignment_bytes),
+                                             static_cast<std::ptrdiff_t>(default_base_alignment_bytes));
+
+  // No need to act if the required memory fits into the allocated memory
+  const auto fits = (nr_bytes_required <= capacity_bytes_)
+                    && (reinterpret_cast<std::uintptr_t>(this->byte_ptr())
+                        % static_cast<std::uintptr_t>(base_alignment_bytes) == 0);
+  const auto keep_memory = shrink_to_fit ? (fits && nr_bytes_required == capacity_bytes_) : fits;
+  if (keep_memory)
   {
+    view_ = DynImageView<ImageModifiability::Mutable>(this->byte_ptr(), layout, semantics);
     return false;
   }
 
-  layout.stride_bytes = impl::compute_stride_bytes(
-      std::max(layout.stride_bytes, Stride{layout.nr_bytes_per_channel * layout.nr_channels * layout.width}),
-      row_alignment_bytes);
-  const auto nr_bytes_to_allocate = layout.stride_bytes * layout.height;
-  const auto nr_currently_allocated_bytes = this->stride_bytes() * this->height();
+  this->deallocate_memory();
+  view_ = this->allocate_memory(layout, default_base_alignment_bytes, row_alignment_bytes, semantics);
+  capacity_bytes_ = view_.total_bytes();
+  return true;
+}
 
-  // No need to act if size parameters match
-  const auto bytes_match = shrink_to_fit ? (nr_bytes_to_allocate == nr_currently_allocated_bytes)
-                                         : (nr_bytes_to_allocate <= nr_currently_allocated_bytes);
-  if (bytes_match)
+/** \brief Reduces the allocated memory to the memory required by the current layout, preserving the image contents.
+ *
+ * @return True, if a memory reallocation took place; false otherwise.
+ */
+template <typename Allocator_>
+bool DynImageT<Allocator_>::shrink_to_fit()
+{
+  if (capacity_bytes_ == view_.total_bytes())
   {
-    view_ = DynImageView<ImageModifiability::Mutable>(this->byte_ptr(), layout);
     return false;
   }
 
+  auto new_view = this->allocate_memory(
+      view_.layout(), default_base_alignment_bytes,
+      impl::guess_row_alignment(reinterpret_cast<std::uintptr_t>(view_.byte_ptr()), view_.stride_bytes()),
+      view_.semantics());
+
+  for (PixelIndex y = 0_idx; y < view_.height(); ++y)
+  {
+    std::copy(view_.byte_ptr(y), view_.byte_ptr(y) + view_.row_bytes(), new_view.byte_ptr(y));
+  }
+
   this->deallocate_memory();
-  view_ = this->allocate_memory(layout, default_base_alignment_bytes, row_alignment_bytes, semantics);
+  view_ = new_view;
+  capacity_bytes_ = view_.total_bytes();
   return true;
 }
 
@@ -817,16 +918,20 @@ inline bool DynImage::reallocate(
  *
  * @return The owned memory block.
  */
-inline MemoryBlock<AlignedNewAllocator> DynImage::relinquish_data_ownership()
+template <typename Allocator_>
+MemoryBlock<Allocator_> DynImageT<Allocator_>::relinquish_data_ownership()
 {
   const auto ptr = this->byte_ptr();
-  const auto len = this->total_bytes();
+  const auto len = capacity_bytes_;
 
   view_.clear();
-  return construct_memory_block_from_existing_memory<AlignedNewAllocator>(ptr, static_cast<std::size_t>(len));
+  capacity_bytes_ = 0;
+  return construct_memory_block_from_existing_memory<Allocator>(ptr, static_cast<std::size_t>(len));
 }
 
-inline void DynImage::copy_rows_from(const DynImage& src)
+template <typename Allocator_>
+template <typename DynImageOrView>
+void DynImageT<Allocator_>::copy_rows_from(const DynImageOrView& src)
 {
   SELENE_ASSERT(byte_ptr() && src.byte_ptr());
   SELENE_ASSERT(width() == src.width() && height() == src.height());
@@ -837,7 +942,8 @@ inline void DynImage::copy_rows_from(const DynImage& src)
   }
 }
 
-inline DynImageView<ImageModifiability::Mutable> DynImage::allocate_memory(
+template <typename Allocator_>
+DynImageView<ImageModifiability::Mutable> DynImageT<Allocator_>::allocate_memory(
     UntypedLayout layout,
     std::ptrdiff_t base_alignment_bytes,
     std::ptrdiff_t row_alignment_bytes,
@@ -849,10 +955,9 @@ inline DynImageView<ImageModifiability::Mutable> DynImage::allocate_memory(
   const auto nr_bytes_to_allocate = stride_bytes * layout.height;
 
   base_alignment_bytes = std::max(row_alignment_bytes, base_alignment_bytes);
-  auto memory = sln::AlignedNewAllocator::allocate(
-      static_cast<std::size_t>(nr_bytes_to_allocate),
-      static_cast<std::size_t>(base_alignment_bytes));
-  SELENE_ASSERT(static_cast<std::ptrdiff_t>(memory.size()) == nr_bytes_to_allocate);
+  auto memory = allocate_memory_block<Allocator>(static_cast<std::size_t>(nr_bytes_to_allocate),
+                                                 static_cast<std::size_t>(base_alignment_bytes));
+  SELENE_ASSERT(static_cast<std::ptrdiff_t>(memory.size()) >= nr_bytes_to_allocate);
 
   return DynImageView<ImageModifiability::Mutable>{
       {memory.transfer_data()},
@@ -860,37 +965,41 @@ inline DynImageView<ImageModifiability::Mutable> DynImage::allocate_memory(
       semantics};
 }
 
-inline void DynImage::deallocate_memory()
+template <typename Allocator_>
+void DynImageT<Allocator_>::deallocate_memory()
 {
   std::uint8_t* ptr = view_.byte_ptr();
-  sln::AlignedNewAllocator::deallocate(ptr);
+  Allocator::deallocate(ptr);
 }
 
 // -----
 
-inline bool operator==(const DynImage& img0, const DynImage& img1)
+template <typename Allocator0, typename Allocator1>
+bool operator==(const DynImageT<Allocator0>& img0, const DynImageT<Allocator1>& img1)
 {
   return equal(img0.view(), img1.view());
 }
 
-inline bool operator!=(const DynImage& img0, const DynImage& img1)
+template <typename Allocator0, typename Allocator1>
+bool operator!=(const DynImageT<Allocator0>& img0, const DynImageT<Allocator1>& img1)
 {
   return !(img0 == img1);
 }
 
-inline bool equal(const DynImage& dyn_img_0, const DynImage& dyn_img_1)
+template <typename Allocator0, typename Allocator1>
+bool equal(const DynImageT<Allocator0>& dyn_img_0, const DynImageT<Allocator1>& dyn_img_1)
 {
   return equal(dyn_img_0.view(), dyn_img_1.view());
 }
 
-template <ImageModifiability modifiability>
-bool equal(const DynImage& dyn_img_0, const DynImageView<modifiability>& dyn_img_view_1)
+template <typename Allocator0, ImageModifiability modifiability>
+bool equal(const DynImageT<Allocator0>& dyn_img_0, const DynImageView<modifiability>& dyn_img_view_1)
 {
   return equal(dyn_img_0.view(), dyn_img_view_1);
 }
 
-template <ImageModifiability modifiability>
-bool equal(const DynImageView<modifiability>& dyn_img_view_0, const DynImage& dyn_img_1)
+template <typename Allocator1, ImageModifiability modifiability>
+bool equal(const DynImageView<modifiability>& dyn_img_view_0, const DynImageT<Allocator1>& dyn_img_1)
 {
   return equal(dyn_img_view_0, dyn_img_1.view());
 }
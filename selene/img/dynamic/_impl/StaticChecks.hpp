@@ -16,10 +16,20 @@ namespace sln {
 
 namespace impl {
 
+template <typename T>
+struct IsDynImage : std::false_type
+{
+};
+
+template <typename Allocator>
+struct IsDynImage<DynImageT<Allocator>> : std::true_type
+{
+};
+
 template <typename DynImageOrView>
 constexpr bool static_check_is_dyn_image()
 {
-  return std::is_same_v<DynImageOrView, DynImage>;
+  return IsDynImage<DynImageOrView>::value;
 }
 
 template <typename DynImageOrView>
@@ -17,14 +17,14 @@
 
 namespace sln {
 
-template <typename PixelType>
-Image<PixelType> to_image(DynImage&& dyn_img);
+template <typename PixelType, typename Allocator>
+Image<PixelType, Allocator> to_image(DynImageT<Allocator>&& dyn_img);
 
-template <typename PixelType>
-MutableImageView<PixelType> to_image_view(DynImage& dyn_img);
+template <typename PixelType, typename Allocator>
+MutableImageView<PixelType> to_image_view(DynImageT<Allocator>& dyn_img);
 
-template <typename PixelType>
-ConstantImageView<PixelType> to_image_view(const DynImage& dyn_img);
+template <typename PixelType, typename Allocator>
+ConstantImageView<PixelType> to_image_view(const DynImageT<Allocator>& dyn_img);
 
 template <typename PixelType, ImageModifiability modifiability>
 ImageView<PixelType, modifiability> to_image_view(const DynImageView<modifiability>& dyn_img_view);
@@ -79,18 +79,19 @@ void check_dyn_img_to_img_compatibility(const DynImageView<modifiability>& dyn_i
  * function call.
  *
  * @tparam PixelType The pixel type of the `Image<PixelType>` instance to be returned.
+ * @tparam Allocator The allocator type of the `DynImage` instance; the memory is transferred as is.
  * @param dyn_img The dynamically typed image.
  * @return An `Image<PixelType>` instance.
  */
-template <typename PixelType>
-Image<PixelType> to_image(DynImage&& dyn_img)
+template <typename PixelType, typename Allocator>
+Image<PixelType, Allocator> to_image(DynImageT<Allocator>&& dyn_img)
 {
   impl::check_dyn_img_to_img_compatibility<PixelType>(dyn_img.view());
 
   const auto dyn_img_layout = dyn_img.layout();
   auto memory = dyn_img.relinquish_data_ownership();
-  return Image<PixelType>{std::move(memory),
-                          TypedLayout{dyn_img_layout.width, dyn_img_layout.height, dyn_img_layout.stride_bytes}};
+  return Image<PixelType, Allocator>{
+      std::move(memory), TypedLayout{dyn_img_layout.width, dyn_img_layout.height, dyn_img_layout.stride_bytes}};
 }
 
 /** \brief Creates a statically typed `MutableImageView<PixelType>` view from a dynamically typed `DynImage` instance.
@@ -109,8 +110,8 @@ Image<PixelType> to_image(DynImage&& dyn_img)
  * @param dyn_img The dynamically typed image.
  * @return A `MutableImageView<PixelType>` instance.
  */
-template <typename PixelType>
-MutableImageView<PixelType> to_image_view(DynImage& dyn_img)
+template <typename PixelType, typename Allocator>
+MutableImageView<PixelType> to_image_view(DynImageT<Allocator>& dyn_img)
 {
   impl::check_dyn_img_to_img_compatibility<PixelType>(dyn_img.view());
 
@@ -134,8 +135,8 @@ MutableImageView<PixelType> to_image_view(DynImage& dyn_img)
  * @param dyn_img The dynamically typed image.
  * @return A `ConstantImageView<PixelType>` instance.
  */
-template <typename PixelType>
-ConstantImageView<PixelType> to_image_view(const DynImage& dyn_img)
+template <typename PixelType, typename Allocator>
+ConstantImageView<PixelType> to_image_view(const DynImageT<Allocator>& dyn_img)
 {
   impl::check_dyn_img_to_img_compatibility<PixelType>(dyn_img.view());
 
@@ -140,6 +140,37 @@ constexpr Pixel<T, N, pixel_format> PixelTraits<Pixel<T, N, pixel_format>>::zero
 template <typename T, std::size_t N, PixelFormat pixel_format>
 constexpr Pixel<T, N, pixel_format> PixelTraits<const Pixel<T, N, pixel_format>>::zero_element;
 
+namespace impl {
+
+// Returns the c-th channel element of a pixel; for pixel types that are plain arithmetic types, the value itself.
+template <typename PixelType>
+constexpr auto get_channel(const PixelType& px, [[maybe_unused]] std::size_t c) noexcept
+{
+  if constexpr (is_pixel_type_v<PixelType>)
+  {
+    return px[c];
+  }
+  else
+  {
+    return px;
+  }
+}
+
+template <typename PixelType>
+constexpr auto& get_channel(PixelType& px, [[maybe_unused]] std::size_t c) noexcept
+{
+  if constexpr (is_pixel_type_v<PixelType>)
+  {
+    return px[c];
+  }
+  else
+  {
+    return px;
+  }
+}
+
+}  // namespace impl
+
 }  // namespace sln
 
 #endif  // SELENE_IMG_PIXEL_PIXEL_TRAITS_HPP
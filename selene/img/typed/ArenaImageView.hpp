@@ -0,0 +1,58 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_TYPED_ARENA_IMAGE_VIEW_HPP
+#define SELENE_IMG_TYPED_ARENA_IMAGE_VIEW_HPP
+
+/// @file
+
+#include <selene/base/ImageArena.hpp>
+
+#include <selene/img/common/Types.hpp>
+
+#include <selene/img/pixel/PixelTraits.hpp>
+
+#include <selene/img/typed/ImageView.hpp>
+#include <selene/img/typed/TypedLayout.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace sln {
+
+/** \brief Allocates memory for an image with the specified layout from an arena, and returns a view onto it.
+ *
+ * The contents of the returned view are uninitialized. The view is valid until the arena is reset, released, or
+ * destroyed.
+ *
+ * @tparam PixelType The pixel type.
+ * @param arena The arena to allocate from.
+ * @param layout The image layout. If `layout.stride_bytes` is smaller than the row length (plus the tail padding
+ *               bytes), the row length (plus the tail padding bytes) is used.
+ * @param row_alignment_bytes The row alignment in bytes.
+ * @return A mutable view onto the allocated memory.
+ */
+template <typename PixelType>
+MutableImageView<PixelType> allocate_image_view(ImageArena& arena,
+                                                TypedLayout layout,
+                                                ImageRowAlignment row_alignment_bytes = ImageRowAlignment{16})
+{
+  const auto stride_bytes = impl::compute_stride_bytes(
+      std::max(layout.stride_bytes, Stride(layout.row_bytes<PixelType>() + layout.tail_padding_bytes)),
+      row_alignment_bytes);
+  const auto nr_bytes = stride_bytes * layout.height;
+  const auto alignment = std::max(static_cast<std::ptrdiff_t>(row_alignment_bytes), std::ptrdiff_t{16});
+
+  auto ptr = arena.allocate(static_cast<std::size_t>(nr_bytes), static_cast<std::size_t>(alignment));
+  if (ptr == nullptr && nr_bytes > 0)
+  {
+    throw std::runtime_error("allocate_image_view: Allocation failed.");
+  }
+
+  return MutableImageView<PixelType>{ptr, {layout.width, layout.height, stride_bytes, layout.tail_padding_bytes}};
+}
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_TYPED_ARENA_IMAGE_VIEW_HPP
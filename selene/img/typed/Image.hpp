@@ -17,34 +17,44 @@ namespace sln {
 
 /** \brief Statically typed image class.
  *
- * An instance of `Image<PixelType>` represents a statically typed image with pixel elements of type `PixelType`.
- * Since the number of channels is determined by the pixel type (e.g. `Pixel<U, N>`), the storage of multiple
- * channels/samples is always interleaved, as opposed to planar.
+ * An instance of `Image<PixelType, Allocator>` represents a statically typed image with pixel elements of type
+ * `PixelType`. Since the number of channels is determined by the pixel type (e.g. `Pixel<U, N>`), the storage of
+ * multiple channels/samples is always interleaved, as opposed to planar.
  * Images are stored row-wise contiguous, with additional space after each row due to a custom stride in bytes.
  *
- * The memory of an `Image<PixelType>` instance is always owned by the instance.
+ * The memory of an `Image<PixelType, Allocator>` instance is always owned by the instance.
  * To express a non-owning relation to the underlying data, use an `ImageView<PixelType, modifiability>`.
  *
+ * Similar to `std::vector`, an image tracks the capacity of its allocated memory separately from its layout. Changing
+ * the layout (via `reallocate()` or assignment) reuses the memory if the new layout fits into the capacity; memory is
+ * only released by `shrink_to_fit()`, `clear()`, or a reallocation with `shrink_to_fit = true`.
+ *
+ * The memory is allocated and deallocated through the `Allocator_` type, which provides the static member functions
+ * `allocate(nr_bytes, alignment)` (or `allocate(nr_bytes)`, if the allocator does not support alignment requests)
+ * and `deallocate(data)`; see `selene/base/Allocators.hpp`.
+ *
  * @tparam PixelType_ The pixel type. Usually of type `Pixel<>`.
+ * @tparam Allocator_ The allocator type, e.g. `AlignedNewAllocator` (default) or `MallocAllocator`.
  */
-template <typename PixelType_>
+template <typename PixelType_, typename Allocator_>
 class Image
-    : public ImageBase<Image<PixelType_>>
+    : public ImageBase<Image<PixelType_, Allocator_>>
 {
 public:
   using PixelType = PixelType_;
+  using Allocator = Allocator_;
   using DataPtrType = DataPtr<ImageModifiability::Mutable>::Type;
   using ConstDataPtrType = DataPtr<ImageModifiability::Mutable>::ConstType;
 
   using iterator = ImageRowIterator<PixelType, ImageModifiability::Mutable>;  ///< The iterator type.
   using const_iterator = ConstImageRowIterator<PixelType, ImageModifiability::Mutable>;  ///< The const_iterator type.
 
-  constexpr static bool is_view = impl::ImageBaseTraits<Image<PixelType>>::is_view;
-  constexpr static bool is_modifiable = impl::ImageBaseTraits<Image<PixelType>>::is_modifiable;
+  constexpr static bool is_view = impl::ImageBaseTraits<Image<PixelType, Allocator>>::is_view;
+  constexpr static bool is_modifiable = impl::ImageBaseTraits<Image<PixelType, Allocator>>::is_modifiable;
 
   constexpr static ImageModifiability modifiability()
   {
-    return impl::ImageBaseTraits<Image<PixelType>>::modifiability();
+    return impl::ImageBaseTraits<Image<PixelType, Allocator>>::modifiability();
   }
 
   Image() = default;  ///< Default constructor.
@@ -53,23 +63,23 @@ public:
 
   Image(TypedLayout layout, ImageRowAlignment row_alignment_bytes);
 
-  Image(MemoryBlock<AlignedNewAllocator>&& memory, TypedLayout layout);
+  Image(MemoryBlock<Allocator>&& memory, TypedLayout layout);
 
   ~Image();
 
-  Image(const Image<PixelType>&);
+  Image(const Image<PixelType, Allocator>&);
 
-  Image<PixelType>& operator=(const Image<PixelType>&);
+  Image<PixelType, Allocator>& operator=(const Image<PixelType, Allocator>&);
 
-  Image(Image<PixelType>&&) noexcept;
+  Image(Image<PixelType, Allocator>&&) noexcept;
 
-  Image<PixelType>& operator=(Image<PixelType>&&) noexcept;
+  Image<PixelType, Allocator>& operator=(Image<PixelType, Allocator>&&) noexcept;
 
   template <ImageModifiability modifiability>
   explicit Image(const ImageView<PixelType, modifiability>&);
 
   template <ImageModifiability modifiability>
-  Image<PixelType>& operator=(const ImageView<PixelType, modifiability>&);
+  Image<PixelType, Allocator>& operator=(const ImageView<PixelType, modifiability>&);
 
   const TypedLayout& layout() const noexcept;
 
@@ -78,6 +88,7 @@ public:
   Stride stride_bytes() const noexcept;
   std::ptrdiff_t row_bytes() const noexcept;
   std::ptrdiff_t total_bytes() const noexcept;
+  std::ptrdiff_t capacity_bytes() const noexcept;
 
   bool is_packed() const noexcept;
   bool is_empty() const noexcept;
@@ -121,14 +132,16 @@ public:
 
   void clear();
 
-  bool reallocate(TypedLayout layout, ImageRowAlignment row_alignment_bytes, bool shrink_to_fit = true);
+  bool reallocate(TypedLayout layout, ImageRowAlignment row_alignment_bytes, bool shrink_to_fit = false);
+  bool shrink_to_fit();
 
-  MemoryBlock<AlignedNewAllocator> relinquish_data_ownership();
+  MemoryBlock<Allocator> relinquish_data_ownership();
 
 private:
   constexpr static auto default_base_alignment_bytes = ImageRowAlignment{16ul};
 
   ImageView<PixelType, ImageModifiability::Mutable> view_;
+  std::ptrdiff_t capacity_bytes_ = 0;
 
   template <typename Derived>
   void copy_rows_from(const ImageBase<Derived>& src);
@@ -139,44 +152,49 @@ private:
   void deallocate_memory();
 };
 
-template <typename PixelType0, typename PixelType1>
-bool operator==(const Image<PixelType0>& img_0, const Image<PixelType1>& img_1);
+template <typename PixelType0, typename Allocator0, typename PixelType1, typename Allocator1>
+bool operator==(const Image<PixelType0, Allocator0>& img_0, const Image<PixelType1, Allocator1>& img_1);
 
-template <typename PixelType0, typename PixelType1>
-bool operator!=(const Image<PixelType0>& img_0, const Image<PixelType1>& img_1);
+template <typename PixelType0, typename Allocator0, typename PixelType1, typename Allocator1>
+bool operator!=(const Image<PixelType0, Allocator0>& img_0, const Image<PixelType1, Allocator1>& img_1);
 
-template <typename PixelType0, typename PixelType1>
-bool equal(const Image<PixelType0>& img_0, const Image<PixelType1>& img_1);
+template <typename PixelType0, typename Allocator0, typename PixelType1, typename Allocator1>
+bool equal(const Image<PixelType0, Allocator0>& img_0, const Image<PixelType1, Allocator1>& img_1);
 
-template <typename PixelType0, typename PixelType1, ImageModifiability modifiability>
-bool equal(const Image<PixelType0>& img_0, const ImageView<PixelType1, modifiability>& img_view_1);
+template <typename PixelType0, typename Allocator0, typename PixelType1, ImageModifiability modifiability>
+bool equal(const Image<PixelType0, Allocator0>& img_0, const ImageView<PixelType1, modifiability>& img_view_1);
 
-template <typename PixelType0, typename PixelType1, ImageModifiability modifiability>
-bool equal(const ImageView<PixelType0, modifiability>& img_view_0, const Image<PixelType1>& img_1);
+template <typename PixelType0, typename PixelType1, typename Allocator1, ImageModifiability modifiability>
+bool equal(const ImageView<PixelType0, modifiability>& img_view_0, const Image<PixelType1, Allocator1>& img_1);
 
 // ----------
 // Implementation:
 
 /** \brief Constructs an image with the specified layout.
+ *
+ * If the layout specifies tail padding bytes, the row stride is chosen large enough to guarantee them after each row.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @param layout The image layout.
  */
-template <typename PixelType_>
-Image<PixelType_>::Image(TypedLayout layout)
-    : view_(this->allocate_memory(layout, default_base_alignment_bytes, 0))
+template <typename PixelType_, typename Allocator_>
+Image<PixelType_, Allocator_>::Image(TypedLayout layout)
+    : view_(this->allocate_memory(layout, default_base_alignment_bytes, 0)), capacity_bytes_(view_.total_bytes())
 {
 }
 
 /** \brief Constructs an image with the specified layout and row alignment.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @param layout The image layout.
  * @param row_alignment_bytes The row alignment in bytes.
  */
-template <typename PixelType_>
-Image<PixelType_>::Image(TypedLayout layout, ImageRowAlignment row_alignment_bytes)
+template <typename PixelType_, typename Allocator_>
+Image<PixelType_, Allocator_>::Image(TypedLayout layout, ImageRowAlignment row_alignment_bytes)
     : view_(this->allocate_memory(layout, default_base_alignment_bytes, row_alignment_bytes))
+    , capacity_bytes_(view_.total_bytes())
 {
 }
 
@@ -185,12 +203,13 @@ Image<PixelType_>::Image(TypedLayout layout, ImageRowAlignment row_alignment_byt
  * On construction, the memory will be owned by the image instance.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @param memory The memory block representing the image.
  * @param layout The image layout.
  */
-template <typename PixelType_>
-Image<PixelType_>::Image(MemoryBlock<AlignedNewAllocator>&& memory, TypedLayout layout)
-    : view_(memory.transfer_data(), layout)
+template <typename PixelType_, typename Allocator_>
+Image<PixelType_, Allocator_>::Image(MemoryBlock<Allocator>&& memory, TypedLayout layout)
+    : view_(memory.transfer_data(), layout), capacity_bytes_(view_.total_bytes())
 {
 }
 
@@ -199,9 +218,10 @@ Image<PixelType_>::Image(MemoryBlock<AlignedNewAllocator>&& memory, TypedLayout
  * All owned memory will be deallocated.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  */
-template <typename PixelType_>
-Image<PixelType_>::~Image()
+template <typename PixelType_, typename Allocator_>
+Image<PixelType_, Allocator_>::~Image()
 {
   this->deallocate_memory();
 }
@@ -209,14 +229,16 @@ Image<PixelType_>::~Image()
 /** \brief Copy constructor.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @param other The image to be copied from.
  */
-template <typename PixelType_>
-Image<PixelType_>::Image(const Image<PixelType>& other)
+template <typename PixelType_, typename Allocator_>
+Image<PixelType_, Allocator_>::Image(const Image<PixelType, Allocator>& other)
     : view_(allocate_memory(other.layout(),
                             default_base_alignment_bytes,
                             impl::guess_row_alignment(reinterpret_cast<std::uintptr_t>(other.data()),
                                                       other.stride_bytes())))
+    , capacity_bytes_(view_.total_bytes())
 {
   copy_rows_from(other);
 }
@@ -224,11 +246,12 @@ Image<PixelType_>::Image(const Image<PixelType>& other)
 /** \brief Copy assignment operator.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @param other The image to be assigned from.
  * @return A reference to this image.
  */
-template <typename PixelType_>
-Image<PixelType_>& Image<PixelType_>::operator=(const Image<PixelType>& other)
+template <typename PixelType_, typename Allocator_>
+Image<PixelType_, Allocator_>& Image<PixelType_, Allocator_>::operator=(const Image<PixelType, Allocator>& other)
 {
   // Check for self-assignment
   if (this == & other)
@@ -236,22 +259,9 @@ Image<PixelType_>& Image<PixelType_>::operator=(const Image<PixelType>& other)
     return * this;
   }
 
-  const auto equal_size = (total_bytes() == other.total_bytes());
-
-  if (!equal_size)
-  {
-    // Clean up own memory
-    this->deallocate_memory();
-
-    // Allocate new memory
-    view_ = allocate_memory(
-        other.layout(),
-        default_base_alignment_bytes,
-        impl::guess_row_alignment(
-            reinterpret_cast<std::uintptr_t>(other.byte_ptr()),
-            other.stride_bytes()));
-  }
-
+  // Reuses the allocated memory, if the layout of `other` fits
+  this->reallocate(other.layout(),
+                   impl::guess_row_alignment(reinterpret_cast<std::uintptr_t>(other.byte_ptr()), other.stride_bytes()));
   copy_rows_from(other);
 
   return * this;
@@ -260,24 +270,27 @@ Image<PixelType_>& Image<PixelType_>::operator=(const Image<PixelType>& other)
 /** \brief Move constructor.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @param other The image to be moved from.
  */
-template <typename PixelType_>
-Image<PixelType_>::Image(Image<PixelType>&& other) noexcept
-    : view_(other.view_)
+template <typename PixelType_, typename Allocator_>
+Image<PixelType_, Allocator_>::Image(Image<PixelType, Allocator>&& other) noexcept
+    : view_(other.view_), capacity_bytes_(other.capacity_bytes_)
 {
   other.view_ = ImageView<PixelType, ImageModifiability::Mutable>{{nullptr},
                                                                   {PixelLength{0}, PixelLength{0}, Stride{0}}};
+  other.capacity_bytes_ = 0;
 }
 
 /** \brief Move assignment operator.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @param other The image to be move-assigned from.
  * @return A reference to this image.
  */
-template <typename PixelType_>
-Image<PixelType_>& Image<PixelType_>::operator=(Image<PixelType>&& other) noexcept
+template <typename PixelType_, typename Allocator_>
+Image<PixelType_, Allocator_>& Image<PixelType_, Allocator_>::operator=(Image<PixelType, Allocator>&& other) noexcept
 {
   // Check for self-assignment
   if (this == & other)
@@ -289,8 +302,10 @@ Image<PixelType_>& Image<PixelType_>::operator=(Image<PixelType>&& other) noexce
   this->deallocate_memory();
 
   view_ = other.view_;
+  capacity_bytes_ = other.capacity_bytes_;
   other.view_ = ImageView<PixelType, ImageModifiability::Mutable>{{nullptr},
                                                                   {PixelLength{0}, PixelLength{0}, Stride{0}}};
+  other.capacity_bytes_ = 0;
 
   return * this;
 }
@@ -298,16 +313,18 @@ Image<PixelType_>& Image<PixelType_>::operator=(Image<PixelType>&& other) noexce
 /** \brief Copy constructor taking an `ImageView` of arbitrary modifiability.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @tparam modifiability_ The modifiability value of the other image.
  * @param other The image to be copied from.
  */
-template <typename PixelType_>
+template <typename PixelType_, typename Allocator_>
 template <ImageModifiability modifiability_>
-Image<PixelType_>::Image(const ImageView<PixelType, modifiability_>& other)
+Image<PixelType_, Allocator_>::Image(const ImageView<PixelType, modifiability_>& other)
     : view_(allocate_memory(other.layout(),
                             default_base_alignment_bytes,
                             impl::guess_row_alignment(reinterpret_cast<std::uintptr_t>(other.data()),
                                                       other.stride_bytes())))
+    , capacity_bytes_(view_.total_bytes())
 {
   copy_rows_from(other);
 }
@@ -315,12 +332,14 @@ Image<PixelType_>::Image(const ImageView<PixelType, modifiability_>& other)
 /** \brief Copy assignment operator taking an `ImageView` of arbitrary modifiability.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @tparam modifiability_ The modifiability value of the other image.
  * @param other The image to be assigned from.
  */
-template <typename PixelType_>
+template <typename PixelType_, typename Allocator_>
 template <ImageModifiability modifiability_>
-Image<PixelType_>& Image<PixelType_>::operator=(const ImageView<PixelType, modifiability_>& other)
+Image<PixelType_, Allocator_>& Image<PixelType_, Allocator_>::operator=(
+    const ImageView<PixelType, modifiability_>& other)
 {
   // Check for self-assignment
   if (& this->view_ == & other)
@@ -328,20 +347,9 @@ Image<PixelType_>& Image<PixelType_>::operator=(const ImageView<PixelType, modif
     return * this;
   }
 
-  const auto equal_size = (total_bytes() == other.total_bytes());
-
-  if (!equal_size)
-  {
-    // Clean up own memory
-    this->deallocate_memory();
-
-    // Allocate new memory
-    view_ = allocate_memory(other.layout(),
-                            default_base_alignment_bytes,
-                            impl::guess_row_alignment(reinterpret_cast<std::uintptr_t>(other.byte_ptr()),
-                                                      other.stride_bytes()));
-  }
-
+  // Reuses the allocated memory, if the layout of `other` fits
+  this->reallocate(other.layout(),
+                   impl::guess_row_alignment(reinterpret_cast<std::uintptr_t>(other.byte_ptr()), other.stride_bytes()));
   copy_rows_from(other);
 
   return * this;
@@ -350,10 +358,11 @@ Image<PixelType_>& Image<PixelType_>::operator=(const ImageView<PixelType, modif
 /** \brief Returns the image layout.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @return The typed image layout.
  */
-template <typename PixelType_>
-const TypedLayout& Image<PixelType_>::layout() const noexcept
+template <typename PixelType_, typename Allocator_>
+const TypedLayout& Image<PixelType_, Allocator_>::layout() const noexcept
 {
   return view_.layout();
 }
@@ -361,10 +370,11 @@ const TypedLayout& Image<PixelType_>::layout() const noexcept
 /** \brief Returns the image width.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @return The image width.
  */
-template <typename PixelType_>
-PixelLength Image<PixelType_>::width() const noexcept
+template <typename PixelType_, typename Allocator_>
+PixelLength Image<PixelType_, Allocator_>::width() const noexcept
 {
   return view_.width();
 }
@@ -372,10 +382,11 @@ PixelLength Image<PixelType_>::width() const noexcept
 /** \brief Returns the image height.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @return The image height.
  */
-template <typename PixelType_>
-PixelLength Image<PixelType_>::height() const noexcept
+template <typename PixelType_, typename Allocator_>
+PixelLength Image<PixelType_, Allocator_>::height() const noexcept
 {
   return view_.height();
 }
@@ -388,11 +399,12 @@ PixelLength Image<PixelType_>::height() const noexcept
  * If it is equal, then `is_packed()` returns `true`, otherwise `is_packed()` returns `false`.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @tparam modifiability_ Determines whether image contents are constant or mutable.
  * @return The row stride of the image in bytes.
  */
-template <typename PixelType_>
-Stride Image<PixelType_>::stride_bytes() const noexcept
+template <typename PixelType_, typename Allocator_>
+Stride Image<PixelType_, Allocator_>::stride_bytes() const noexcept
 {
   return view_.stride_bytes();
 }
@@ -403,10 +415,11 @@ Stride Image<PixelType_>::stride_bytes() const noexcept
  * It follows that `stride_bytes() >= row_bytes()`, since `stride_bytes()` may include additional padding bytes.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @return The number of data bytes occupied by each image row.
  */
-template <typename PixelType_>
-std::ptrdiff_t Image<PixelType_>::row_bytes() const noexcept
+template <typename PixelType_, typename Allocator_>
+std::ptrdiff_t Image<PixelType_, Allocator_>::row_bytes() const noexcept
 {
   return view_.row_bytes();
 }
@@ -416,23 +429,39 @@ std::ptrdiff_t Image<PixelType_>::row_bytes() const noexcept
  * The value returned is equal to `(stride_bytes() * height())`.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @return The total number of bytes occupied by the image data in memory.
  */
-template <typename PixelType_>
-std::ptrdiff_t Image<PixelType_>::total_bytes() const noexcept
+template <typename PixelType_, typename Allocator_>
+std::ptrdiff_t Image<PixelType_, Allocator_>::total_bytes() const noexcept
 {
   return view_.total_bytes();
 }
 
+/** \brief Returns the number of bytes of allocated memory owned by the image.
+ *
+ * The value returned is greater than or equal to `total_bytes()`.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return The number of bytes of allocated memory.
+ */
+template <typename PixelType_, typename Allocator_>
+std::ptrdiff_t Image<PixelType_, Allocator_>::capacity_bytes() const noexcept
+{
+  return capacity_bytes_;
+}
+
 /** \brief Returns whether the image is stored packed in memory.
  *
  * Returns the boolean expression `(stride_bytes() == width() * PixelTraits::nr_bytes)`.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @return True, if the image data is stored packed; false otherwise.
  */
-template <typename PixelType_>
-bool Image<PixelType_>::is_packed() const noexcept
+template <typename PixelType_, typename Allocator_>
+bool Image<PixelType_, Allocator_>::is_packed() const noexcept
 {
   return view_.is_packed();
 }
@@ -443,10 +472,11 @@ bool Image<PixelType_>::is_packed() const noexcept
  * `height() == 0`, or any combination of these.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @return True, if the image is empty; false if it is non-empty.
  */
-template <typename PixelType_>
-bool Image<PixelType_>::is_empty() const noexcept
+template <typename PixelType_, typename Allocator_>
+bool Image<PixelType_, Allocator_>::is_empty() const noexcept
 {
   return view_.is_empty();
 }
@@ -456,10 +486,11 @@ bool Image<PixelType_>::is_empty() const noexcept
  * Semantically equal to `!is_empty()`.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @return True, if the image is valid; false otherwise.
  */
-template <typename PixelType_>
-bool Image<PixelType_>::is_valid() const noexcept
+template <typename PixelType_, typename Allocator_>
+bool Image<PixelType_, Allocator_>::is_valid() const noexcept
 {
   return view_.is_valid();
 }
@@ -467,10 +498,11 @@ bool Image<PixelType_>::is_valid() const noexcept
 /** \brief Returns an iterator to the first row.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @return Iterator to the first image row.
  */
-template <typename PixelType_>
-auto Image<PixelType_>::begin() noexcept -> iterator
+template <typename PixelType_, typename Allocator_>
+auto Image<PixelType_, Allocator_>::begin() noexcept -> iterator
 {
   return view_.begin();
 }
@@ -478,10 +510,11 @@ auto Image<PixelType_>::begin() noexcept -> iterator
 /** \brief Returns a constant iterator to the first row.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @return Constant iterator to the first image row.
  */
-template <typename PixelType_>
-auto Image<PixelType_>::begin() const noexcept -> const_iterator
+template <typename PixelType_, typename Allocator_>
+auto Image<PixelType_, Allocator_>::begin() const noexcept -> const_iterator
 {
   return view_.begin();
 }
@@ -489,10 +522,11 @@ auto Image<PixelType_>::begin() const noexcept -> const_iterator
 /** \brief Returns a constant iterator to the first row.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @return Constant iterator to the first image row.
  */
-template <typename PixelType_>
-auto Image<PixelType_>::cbegin() const noexcept -> const_iterator
+template <typename PixelType_, typename Allocator_>
+auto Image<PixelType_, Allocator_>::cbegin() const noexcept -> const_iterator
 {
   return view_.cbegin();
 }
@@ -500,10 +534,11 @@ auto Image<PixelType_>::cbegin() const noexcept -> const_iterator
 /** \brief Returns an iterator to the row after the last row of the image.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @return Iterator to the image row after the last row.
  */
-template <typename PixelType_>
-auto Image<PixelType_>::end() noexcept -> iterator
+template <typename PixelType_, typename Allocator_>
+auto Image<PixelType_, Allocator_>::end() noexcept -> iterator
 {
   return view_.end();
 }
@@ -511,10 +546,11 @@ auto Image<PixelType_>::end() noexcept -> iterator
 /** \brief Returns a constant iterator to the row after the last row of the image.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @return Constant iterator to the image row after the last row.
  */
-template <typename PixelType_>
-auto Image<PixelType_>::end() const noexcept -> const_iterator
+template <typename PixelType_, typename Allocator_>
+auto Image<PixelType_, Allocator_>::end() const noexcept -> const_iterator
 {
   return view_.end();
 }
@@ -522,10 +558,11 @@ auto Image<PixelType_>::end() const noexcept -> const_iterator
 /** \brief Returns a constant iterator to the row after the last row of the image.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @return Constant iterator to the image row after the last row.
  */
-template <typename PixelType_>
-auto Image<PixelType_>::cend() const noexcept -> const_iterator
+template <typename PixelType_, typename Allocator_>
+auto Image<PixelType_, Allocator_>::cend() const noexcept -> const_iterator
 {
   return view_.cend();
 }
@@ -533,10 +570,11 @@ auto Image<PixelType_>::cend() const noexcept -> const_iterator
 /** \brief Returns a pointer to the first byte storing image data (in row 0).
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @return Pointer to the first image data byte.
  */
-template <typename PixelType_>
-auto Image<PixelType_>::byte_ptr() noexcept -> DataPtrType
+template <typename PixelType_, typename Allocator_>
+auto Image<PixelType_, Allocator_>::byte_ptr() noexcept -> DataPtrType
 {
   return view_.byte_ptr();
 }
@@ -544,10 +582,11 @@ auto Image<PixelType_>::byte_ptr() noexcept -> DataPtrType
 /** \brief Returns a constant pointer to the first byte storing image data (in row 0).
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @return Constant pointer to the first image data byte.
  */
-template <typename PixelType_>
-auto Image<PixelType_>::byte_ptr() const noexcept -> ConstDataPtrType
+template <typename PixelType_, typename Allocator_>
+auto Image<PixelType_, Allocator_>::byte_ptr() const noexcept -> ConstDataPtrType
 {
   return view_.byte_ptr();
 }
@@ -555,11 +594,12 @@ auto Image<PixelType_>::byte_ptr() const noexcept -> ConstDataPtrType
 /** \brief Returns a pointer to the first byte storing image data in row `y`.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @param y Row index.
  * @return Pointer to the first image data byte of row `y`.
  */
-template <typename PixelType_>
-auto Image<PixelType_>::byte_ptr(PixelIndex y) noexcept -> DataPtrType
+template <typename PixelType_, typename Allocator_>
+auto Image<PixelType_, Allocator_>::byte_ptr(PixelIndex y) noexcept -> DataPtrType
 {
   return view_.byte_ptr(y);
 }
@@ -567,11 +607,12 @@ auto Image<PixelType_>::byte_ptr(PixelIndex y) noexcept -> DataPtrType
 /** \brief Returns a constant pointer to the first byte storing image data in row `y`.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @param y Row index.
  * @return Constant pointer to the first image data byte of row `y`.
  */
-template <typename PixelType_>
-auto Image<PixelType_>::byte_ptr(PixelIndex y) const noexcept -> ConstDataPtrType
+template <typename PixelType_, typename Allocator_>
+auto Image<PixelType_, Allocator_>::byte_ptr(PixelIndex y) const noexcept -> ConstDataPtrType
 {
   return view_.byte_ptr(y);
 }
@@ -579,12 +620,13 @@ auto Image<PixelType_>::byte_ptr(PixelIndex y) const noexcept -> ConstDataPtrTyp
 /** \brief Returns a pointer to the first byte of the pixel element at location `(x, y)`, i.e. row `y`, column `x`.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @param x Column index.
  * @param y Row index.
  * @return Pointer to the first byte of the pixel element at location `(x, y)`.
  */
-template <typename PixelType_>
-auto Image<PixelType_>::byte_ptr(PixelIndex x, PixelIndex y) noexcept -> DataPtrType
+template <typename PixelType_, typename Allocator_>
+auto Image<PixelType_, Allocator_>::byte_ptr(PixelIndex x, PixelIndex y) noexcept -> DataPtrType
 {
   return view_.byte_ptr(x, y);
 }
@@ -592,12 +634,13 @@ auto Image<PixelType_>::byte_ptr(PixelIndex x, PixelIndex y) noexcept -> DataPtr
 /** \brief Returns a constant pointer to the first byte of the pixel element at location `(x, y)`, i.e. row `y`, column `x`.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @param x Column index.
  * @param y Row index.
  * @return Constant pointer to the first byte of the pixel element at location `(x, y)`.
  */
-template <typename PixelType_>
-auto Image<PixelType_>::byte_ptr(PixelIndex x, PixelIndex y) const noexcept -> ConstDataPtrType
+template <typename PixelType_, typename Allocator_>
+auto Image<PixelType_, Allocator_>::byte_ptr(PixelIndex x, PixelIndex y) const noexcept -> ConstDataPtrType
 {
   return view_.byte_ptr(x, y);
 }
@@ -605,10 +648,11 @@ auto Image<PixelType_>::byte_ptr(PixelIndex x, PixelIndex y) const noexcept -> C
 /** \brief Returns a pointer to the first pixel element (i.e. at row 0, column 0).
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @return Pointer to the first pixel element.
  */
-template <typename PixelType_>
-auto Image<PixelType_>::data() noexcept -> PixelType*
+template <typename PixelType_, typename Allocator_>
+auto Image<PixelType_, Allocator_>::data() noexcept -> PixelType*
 {
   return view_.data();
 }
@@ -616,10 +660,11 @@ auto Image<PixelType_>::data() noexcept -> PixelType*
 /** \brief Returns a constant pointer to the first pixel element (i.e. at row 0, column 0).
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @return Constant pointer to the first pixel element.
  */
-template <typename PixelType_>
-auto Image<PixelType_>::data() const noexcept -> const PixelType*
+template <typename PixelType_, typename Allocator_>
+auto Image<PixelType_, Allocator_>::data() const noexcept -> const PixelType*
 {
   return view_.data();
 }
@@ -627,11 +672,12 @@ auto Image<PixelType_>::data() const noexcept -> const PixelType*
 /** \brief Returns a pointer to the first pixel element of the y-th row (i.e. at row y, column 0).
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @param y Row index.
  * @return Pointer to the first pixel element of the y-th row.
  */
-template <typename PixelType_>
-auto Image<PixelType_>::data(PixelIndex y) noexcept -> PixelType*
+template <typename PixelType_, typename Allocator_>
+auto Image<PixelType_, Allocator_>::data(PixelIndex y) noexcept -> PixelType*
 {
   return view_.data(y);
 }
@@ -639,11 +685,12 @@ auto Image<PixelType_>::data(PixelIndex y) noexcept -> PixelType*
 /** \brief Returns a constant pointer to the first pixel element of the y-th row (i.e. at row y, column 0).
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @param y Row index.
  * @return Constant pointer to the first pixel element of the y-th row.
  */
-template <typename PixelType_>
-auto Image<PixelType_>::data(PixelIndex y) const noexcept -> const PixelType*
+template <typename PixelType_, typename Allocator_>
+auto Image<PixelType_, Allocator_>::data(PixelIndex y) const noexcept -> const PixelType*
 {
   return view_.data(y);
 }
@@ -651,11 +698,12 @@ auto Image<PixelType_>::data(PixelIndex y) const noexcept -> const PixelType*
 /** \brief Returns a pointer to the one-past-the-last pixel element of the y-th row (i.e. at row y, column `width()`).
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @param y Row index.
  * @return Pointer to the one-past-the-last pixel element of the y-th row.
  */
-template <typename PixelType_>
-auto Image<PixelType_>::data_row_end(PixelIndex y) noexcept -> PixelType*
+template <typename PixelType_, typename Allocator_>
+auto Image<PixelType_, Allocator_>::data_row_end(PixelIndex y) noexcept -> PixelType*
 {
   return view_.data_row_end(y);
 }
@@ -663,11 +711,12 @@ auto Image<PixelType_>::data_row_end(PixelIndex y) noexcept -> PixelType*
 /** \brief Returns a constant pointer to the one-past-the-last pixel element of the y-th row (i.e. at row y, column `width()`).
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @param y Row index.
  * @return Constant pointer to the one-past-the-last pixel element of the y-th row.
  */
-template <typename PixelType_>
-auto Image<PixelType_>::data_row_end(PixelIndex y) const noexcept -> const PixelType*
+template <typename PixelType_, typename Allocator_>
+auto Image<PixelType_, Allocator_>::data_row_end(PixelIndex y) const noexcept -> const PixelType*
 {
   return view_.data_row_end(y);
 }
@@ -675,12 +724,13 @@ auto Image<PixelType_>::data_row_end(PixelIndex y) const noexcept -> const Pixel
 /** \brief Returns a pointer to the x-th pixel element of the y-th row (i.e. at row y, column x).
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @param x Column index.
  * @param y Row index.
  * @return Pointer to the x-th pixel element of the y-th row.
  */
-template <typename PixelType_>
-auto Image<PixelType_>::data(PixelIndex x, PixelIndex y) noexcept -> PixelType*
+template <typename PixelType_, typename Allocator_>
+auto Image<PixelType_, Allocator_>::data(PixelIndex x, PixelIndex y) noexcept -> PixelType*
 {
   return view_.data(x, y);
 }
@@ -688,12 +738,13 @@ auto Image<PixelType_>::data(PixelIndex x, PixelIndex y) noexcept -> PixelType*
 /** \brief Returns a constant pointer to the x-th pixel element of the y-th row (i.e. at row y, column x).
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @param x Column index.
  * @param y Row index.
  * @return Pointer to the x-th pixel element of the y-th row.
  */
-template <typename PixelType_>
-auto Image<PixelType_>::data(PixelIndex x, PixelIndex y) const noexcept -> const PixelType*
+template <typename PixelType_, typename Allocator_>
+auto Image<PixelType_, Allocator_>::data(PixelIndex x, PixelIndex y) const noexcept -> const PixelType*
 {
   return view_.data(x, y);
 }
@@ -701,12 +752,13 @@ auto Image<PixelType_>::data(PixelIndex x, PixelIndex y) const noexcept -> const
 /** \brief Returns a reference to the pixel element at location `(x, y)`, i.e. row `y`, column `x`.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @param x Column index.
  * @param y Row index.
  * @return Reference to the pixel element at location `(x, y)`.
  */
-template <typename PixelType_>
-auto Image<PixelType_>::operator()(PixelIndex x, PixelIndex y) noexcept -> PixelType&
+template <typename PixelType_, typename Allocator_>
+auto Image<PixelType_, Allocator_>::operator()(PixelIndex x, PixelIndex y) noexcept -> PixelType&
 {
   return view_.operator()(x, y);
 }
@@ -714,12 +766,13 @@ auto Image<PixelType_>::operator()(PixelIndex x, PixelIndex y) noexcept -> Pixel
 /** \brief Returns a constant reference to the pixel element at location `(x, y)`, i.e. row `y`, column `x`.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @param x Column index.
  * @param y Row index.
  * @return Constant reference to the pixel element at location `(x, y)`.
  */
-template <typename PixelType_>
-auto Image<PixelType_>::operator()(PixelIndex x, PixelIndex y) const noexcept -> const PixelType&
+template <typename PixelType_, typename Allocator_>
+auto Image<PixelType_, Allocator_>::operator()(PixelIndex x, PixelIndex y) const noexcept -> const PixelType&
 {
   return view_.operator()(x, y);
 }
@@ -727,10 +780,11 @@ auto Image<PixelType_>::operator()(PixelIndex x, PixelIndex y) const noexcept ->
 /** \brief Returns the underlying (mutable) image view.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @return The underlying (mutable) image view.
  */
-template <typename PixelType_>
-auto Image<PixelType_>::view() noexcept
+template <typename PixelType_, typename Allocator_>
+auto Image<PixelType_, Allocator_>::view() noexcept
     -> ImageView<PixelType, ImageModifiability::Mutable>&
 {
   return view_.view();
@@ -739,10 +793,11 @@ auto Image<PixelType_>::view() noexcept
 /** \brief Returns a constant image view on the underlying data.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @return A constant image view.
  */
-template <typename PixelType_>
-auto Image<PixelType_>::view() const noexcept
+template <typename PixelType_, typename Allocator_>
+auto Image<PixelType_, Allocator_>::view() const noexcept
     -> ImageView<PixelType, ImageModifiability::Constant>
 {
   return view_.constant_view();
@@ -751,10 +806,11 @@ auto Image<PixelType_>::view() const noexcept
 /** \brief Returns a constant image view on the underlying data.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @return A constant image view.
  */
-template <typename PixelType_>
-auto Image<PixelType_>::constant_view() const noexcept
+template <typename PixelType_, typename Allocator_>
+auto Image<PixelType_, Allocator_>::constant_view() const noexcept
     -> ImageView<PixelType, ImageModifiability::Constant>
 {
   return view_.constant_view();
@@ -765,49 +821,84 @@ auto Image<PixelType_>::constant_view() const noexcept
  * All allocated memory will be deallocated.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  */
-template <typename PixelType_>
-void Image<PixelType_>::clear()
+template <typename PixelType_, typename Allocator_>
+void Image<PixelType_, Allocator_>::clear()
 {
   deallocate_memory();
   view_.clear();
+  capacity_bytes_ = 0;
 }
 
 /** \brief Reallocates the image data according to the specified layout and alignment.
+ *
+ * The image contents are not preserved.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @param layout The layout for reallocation.
  * @param row_alignment_bytes The desired row alignment in bytes.
- * @param shrink_to_fit If true, then a reallocation will also take place if the required memory is less than already
- *                      allocated. If false, then the already allocated memory will be kept, if the required memory is
- *                      less than already allocated.
+ * @param shrink_to_fit If false, then the allocated memory will be kept, if the required memory fits into its capacity
+ *                      (and it is sufficiently aligned). If true, then the allocated memory will only be kept if the
+ *                      required memory matches its capacity exactly.
  * @return True, if a memory reallocation took place; false otherwise.
  */
-template <typename PixelType_>
-bool Image<PixelType_>::reallocate(TypedLayout layout, ImageRowAlignment row_alignment_bytes, bool shrink_to_fit)
+template <typename PixelType_, typename Allocator_>
+bool Image<PixelType_, Allocator_>::reallocate(TypedLayout layout,
+                                               ImageRowAlignment row_alignment_bytes,
+                                               bool shrink_to_fit)
 {
-  if (layout == this->view_.layout())
+  layout.stride_bytes = impl::compute_stride_bytes(
+      std::max(layout.stride_bytes, Stride(layout.row_bytes<PixelType>() + layout.tail_padding_bytes)),
+      row_alignment_bytes);
+  const auto nr_bytes_required = layout.stride_bytes * layout.height;
+  const auto base_alignment_bytes = std::max(static_cast<std::ptrdiff_t>(row_alignment_bytes),
+                                             static_cast<std::ptrdiff_t>(default_base_alignment_bytes));
+
+  // No need to act if the required memory fits into the allocated memory
+  const auto fits = (nr_bytes_required <= capacity_bytes_)
+                    && (reinterpret_cast<std::uintptr_t>(this->byte_ptr())
+                        % static_cast<std::uintptr_t>(base_alignment_bytes) == 0);
+  const auto keep_memory = shrink_to_fit ? (fits && nr_bytes_required == capacity_bytes_) : fits;
+  if (keep_memory)
   {
+    view_ = ImageView<PixelType, ImageModifiability::Mutable>(this->byte_ptr(), layout);
     return false;
   }
 
-  layout.stride_bytes = impl::compute_stride_bytes(
-      std::max(layout.stride_bytes, Stride(PixelTraits<PixelType>::nr_bytes * layout.width)),
-      row_alignment_bytes);
-  const auto nr_bytes_to_allocate = layout.stride_bytes * layout.height;
-  const auto nr_currently_allocated_bytes = this->stride_bytes() * this->height();
+  this->deallocate_memory();
+  view_ = this->allocate_memory(layout, default_base_alignment_bytes, row_alignment_bytes);
+  capacity_bytes_ = view_.total_bytes();
+  return true;
+}
 
-  // No need to act if size parameters match
-  const auto bytes_match = shrink_to_fit ? (nr_bytes_to_allocate == nr_currently_allocated_bytes)
-                                         : (nr_bytes_to_allocate <= nr_currently_allocated_bytes);
-  if (bytes_match)
+/** \brief Reduces the allocated memory to the memory required by the current layout, preserving the image contents.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return True, if a memory reallocation took place; false otherwise.
+ */
+template <typename PixelType_, typename Allocator_>
+bool Image<PixelType_, Allocator_>::shrink_to_fit()
+{
+  if (capacity_bytes_ == view_.total_bytes())
   {
-    view_ = ImageView<PixelType, ImageModifiability::Mutable>(this->byte_ptr(), layout);
     return false;
   }
 
+  auto new_view = this->allocate_memory(
+      view_.layout(), default_base_alignment_bytes,
+      impl::guess_row_alignment(reinterpret_cast<std::uintptr_t>(view_.byte_ptr()), view_.stride_bytes()));
+
+  for (PixelIndex y = 0_idx; y < view_.height(); ++y)
+  {
+    std::copy(view_.data(y), view_.data_row_end(y), new_view.data(y));
+  }
+
   this->deallocate_memory();
-  view_ = this->allocate_memory(layout, default_base_alignment_bytes, row_alignment_bytes);
+  view_ = new_view;
+  capacity_bytes_ = view_.total_bytes();
   return true;
 }
 
@@ -816,21 +907,23 @@ bool Image<PixelType_>::reallocate(TypedLayout layout, ImageRowAlignment row_ali
  * As a result, the image will be empty, and no memory will be owned.
  *
  * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
  * @return The owned memory block.
  */
-template <typename PixelType_>
-MemoryBlock<AlignedNewAllocator> Image<PixelType_>::relinquish_data_ownership()
+template <typename PixelType_, typename Allocator_>
+MemoryBlock<Allocator_> Image<PixelType_, Allocator_>::relinquish_data_ownership()
 {
   const auto ptr = this->byte_ptr();
-  const auto len = this->total_bytes();
+  const auto len = capacity_bytes_;
 
   view_.clear();
-  return construct_memory_block_from_existing_memory<AlignedNewAllocator>(ptr, static_cast<std::size_t>(len));
+  capacity_bytes_ = 0;
+  return construct_memory_block_from_existing_memory<Allocator>(ptr, static_cast<std::size_t>(len));
 }
 
-template <typename PixelType_>
+template <typename PixelType_, typename Allocator_>
 template <typename Derived>
-void Image<PixelType_>::copy_rows_from(const ImageBase<Derived>& src)
+void Image<PixelType_, Allocator_>::copy_rows_from(const ImageBase<Derived>& src)
 {
   SELENE_ASSERT(data() && src.data());
   SELENE_ASSERT(width() == src.width() && height() == src.height());
@@ -841,61 +934,62 @@ void Image<PixelType_>::copy_rows_from(const ImageBase<Derived>& src)
   }
 }
 
-template <typename PixelType_>
-ImageView<PixelType_, ImageModifiability::Mutable> Image<PixelType_>::allocate_memory(
+template <typename PixelType_, typename Allocator_>
+ImageView<PixelType_, ImageModifiability::Mutable> Image<PixelType_, Allocator_>::allocate_memory(
     TypedLayout layout,
     std::ptrdiff_t base_alignment_bytes,
     std::ptrdiff_t row_alignment_bytes)
 {
+  // The stride accommodates the guaranteed tail padding bytes after each row (including the last one)
   const auto stride_bytes = impl::compute_stride_bytes(
-      std::max(layout.stride_bytes, Stride(PixelTraits<PixelType>::nr_bytes * layout.width)), row_alignment_bytes);
+      std::max(layout.stride_bytes, Stride(layout.row_bytes<PixelType>() + layout.tail_padding_bytes)),
+      row_alignment_bytes);
   const auto nr_bytes_to_allocate = stride_bytes * layout.height;
 
   base_alignment_bytes = std::max(row_alignment_bytes, base_alignment_bytes);
-  auto memory = sln::AlignedNewAllocator::allocate(
-      static_cast<std::size_t>(nr_bytes_to_allocate),
-      static_cast<std::size_t>(base_alignment_bytes));
-  SELENE_ASSERT(static_cast<std::ptrdiff_t>(memory.size()) == nr_bytes_to_allocate);
+  auto memory = allocate_memory_block<Allocator>(static_cast<std::size_t>(nr_bytes_to_allocate),
+                                                 static_cast<std::size_t>(base_alignment_bytes));
+  SELENE_ASSERT(static_cast<std::ptrdiff_t>(memory.size()) >= nr_bytes_to_allocate);
 
-  return ImageView<PixelType, ImageModifiability::Mutable>{{memory.transfer_data()},
-                                                           {layout.width, layout.height, stride_bytes}};
+  return ImageView<PixelType, ImageModifiability::Mutable>{
+      {memory.transfer_data()}, {layout.width, layout.height, stride_bytes, layout.tail_padding_bytes}};
 }
 
-template <typename PixelType_>
-void Image<PixelType_>::deallocate_memory()
+template <typename PixelType_, typename Allocator_>
+void Image<PixelType_, Allocator_>::deallocate_memory()
 {
   std::uint8_t* ptr = view_.byte_ptr();
-  sln::AlignedNewAllocator::deallocate(ptr);
+  Allocator::deallocate(ptr);
 }
 
 // -----
 
-template <typename PixelType0, typename PixelType1>
-bool operator==(const Image<PixelType0>& img_0, const Image<PixelType1>& img_1)
+template <typename PixelType0, typename Allocator0, typename PixelType1, typename Allocator1>
+bool operator==(const Image<PixelType0, Allocator0>& img_0, const Image<PixelType1, Allocator1>& img_1)
 {
   return equal(img_0.view(), img_1.view());
 }
 
-template <typename PixelType0, typename PixelType1>
-bool operator!=(const Image<PixelType0>& img_0, const Image<PixelType1>& img_1)
+template <typename PixelType0, typename Allocator0, typename PixelType1, typename Allocator1>
+bool operator!=(const Image<PixelType0, Allocator0>& img_0, const Image<PixelType1, Allocator1>& img_1)
 {
   return !(img_0 == img_1);
 }
 
-template <typename PixelType0, typename PixelType1>
-bool equal(const Image<PixelType0>& img_0, const Image<PixelType1>& img_1)
+template <typename PixelType0, typename Allocator0, typename PixelType1, typename Allocator1>
+bool equal(const Image<PixelType0, Allocator0>& img_0, const Image<PixelType1, Allocator1>& img_1)
 {
   return equal(img_0.view(), img_1.view());
 }
 
-template <typename PixelType0, typename PixelType1, ImageModifiability modifiability>
-bool equal(const Image<PixelType0>& img_0, const ImageView<PixelType1, modifiability>& img_view_1)
+template <typename PixelType0, typename Allocator0, typename PixelType1, ImageModifiability modifiability>
+bool equal(const Image<PixelType0, Allocator0>& img_0, const ImageView<PixelType1, modifiability>& img_view_1)
 {
   return equal(img_0.view(), img_view_1);
 }
 
-template <typename PixelType0, typename PixelType1, ImageModifiability modifiability>
-bool equal(const ImageView<PixelType0, modifiability>& img_view_0, const Image<PixelType1>& img_1)
+template <typename PixelType0, typename PixelType1, typename Allocator1, ImageModifiability modifiability>
+bool equal(const ImageView<PixelType0, modifiability>& img_view_0, const Image<PixelType1, Allocator1>& img_1)
 {
   return equal(img_view_0, img_1.view());
 }
@@ -132,7 +132,11 @@ ImageView<PixelType_, modifiability_>::ImageView(DataPtr<modifiability_> ptr, Ty
     : ptr_(ptr), layout_(layout)
 {
   // adjust stride_bytes (may have been set to 0 in TypedLayout constructor)
-  layout_.stride_bytes = std::max(layout_.stride_bytes, Stride(PixelTraits<PixelType>::nr_bytes * layout_.width));
+  // (a stride of 0 also accommodates the guaranteed tail padding bytes, which is checked in debug builds)
+  const auto row_bytes = layout_.row_bytes<PixelType>();
+  const auto min_stride_bytes = (layout_.stride_bytes == 0) ? row_bytes + layout_.tail_padding_bytes : row_bytes;
+  layout_.stride_bytes = std::max(layout_.stride_bytes, Stride(min_stride_bytes));
+  SELENE_ASSERT(layout_.has_valid_tail_padding<PixelType>());
 }
 
 /** \brief Returns the image view layout.
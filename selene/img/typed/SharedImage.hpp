@@ -0,0 +1,890 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_TYPED_SHARED_IMAGE_HPP
+#define SELENE_IMG_TYPED_SHARED_IMAGE_HPP
+
+/// @file
+
+#include <selene/base/Allocators.hpp>
+#include <selene/base/Assert.hpp>
+
+#include <selene/img/common/BoundingBox.hpp>
+
+#include <selene/img/typed/Image.hpp>
+#include <selene/img/typed/ImageView.hpp>
+#include <selene/img/typed/TypedLayout.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace sln {
+
+namespace impl {
+
+template <typename PixelType, typename Allocator>
+struct SharedImageBuffer
+{
+  explicit SharedImageBuffer(Image<PixelType, Allocator>&& img_) : img(std::move(img_)) { }
+
+  std::atomic<std::size_t> ref_count{1};
+  Image<PixelType, Allocator> img;
+};
+
+}  // namespace impl
+
+/** \brief Statically typed image class with shared ownership of its data, and copy-on-write semantics.
+ *
+ * Copying a `SharedImage<PixelType, Allocator>` instance does not copy the image data; it increments an atomic
+ * reference count on the underlying buffer instead. This makes it cheap to pass one image (e.g. a decoded frame) to
+ * several consumers, possibly running on different threads.
+ *
+ * Sub-images (see `sub_image()`) refer to a region of the same buffer, and keep the whole buffer alive.
+ *
+ * Read access is always possible without copying. Mutable access (see `mutable_view()`) first copies the image data
+ * into a new buffer, if the current buffer is shared with other instances; modifications are therefore never visible
+ * to other instances.
+ *
+ * Different instances sharing the same buffer can be used concurrently from different threads. A single instance may
+ * not be modified concurrently.
+ *
+ * `shared_view()` returns a `SharedImageView`, which refers to the buffer and keeps it alive; it can be passed to image
+ * operations and outlive the instance it was obtained from. The plain views returned by `view()` or `mutable_view()` do
+ * not keep the buffer alive; they remain valid only as long as the instance they were obtained from is not modified or
+ * destroyed. There is intentionally no mutable counterpart to `SharedImageView`: a mutable view sharing the buffer
+ * would make modifications visible to other instances, defeating the copy-on-write semantics.
+ *
+ * @tparam PixelType_ The pixel type. Usually of type `Pixel<>`.
+ * @tparam Allocator_ The allocator type of the underlying `Image<PixelType, Allocator>`.
+ */
+template <typename PixelType_, typename Allocator_ = AlignedNewAllocator>
+class SharedImage
+{
+public:
+  using PixelType = PixelType_;
+  using Allocator = Allocator_;
+
+  SharedImage() = default;  ///< Default constructor.
+
+  explicit SharedImage(TypedLayout layout);
+
+  SharedImage(TypedLayout layout, ImageRowAlignment row_alignment_bytes);
+
+  explicit SharedImage(Image<PixelType, Allocator>&& img);
+
+  ~SharedImage();
+
+  SharedImage(const SharedImage<PixelType, Allocator>&) noexcept;
+
+  SharedImage<PixelType, Allocator>& operator=(const SharedImage<PixelType, Allocator>&) noexcept;
+
+  SharedImage(SharedImage<PixelType, Allocator>&&) noexcept;
+
+  SharedImage<PixelType, Allocator>& operator=(SharedImage<PixelType, Allocator>&&) noexcept;
+
+  const TypedLayout& layout() const noexcept;
+
+  PixelLength width() const noexcept;
+  PixelLength height() const noexcept;
+  Stride stride_bytes() const noexcept;
+  std::ptrdiff_t row_bytes() const noexcept;
+
+  bool is_packed() const noexcept;
+  bool is_empty() const noexcept;
+  bool is_valid() const noexcept;
+
+  const PixelType* data(PixelIndex y) const noexcept;
+  const PixelType& operator()(PixelIndex x, PixelIndex y) const noexcept;
+
+  ConstantImageView<PixelType> view() const noexcept;
+  MutableImageView<PixelType> mutable_view();
+  SharedImageView<PixelType, Allocator> shared_view() const noexcept;
+
+  SharedImage<PixelType, Allocator> sub_image(const BoundingBox& region) const noexcept;
+
+  bool is_unique() const noexcept;
+  std::size_t use_count() const noexcept;
+
+  void make_unique();
+  void clear() noexcept;
+
+private:
+  using Buffer = impl::SharedImageBuffer<PixelType, Allocator>;
+
+  Buffer* buffer_ = nullptr;
+  MutableImageView<PixelType> view_;
+
+  void release() noexcept;
+};
+
+/** \brief Statically typed, constant image view class, which shares ownership of the data of a `SharedImage`.
+ *
+ * Unlike a plain `ConstantImageView`, a `SharedImageView` keeps the underlying buffer alive, so it remains valid even
+ * if the `SharedImage` instance it was obtained from is modified or destroyed. The data seen through the view is never
+ * modified, since mutable access to a shared buffer copies the data first (see `SharedImage::mutable_view()`).
+ *
+ * @tparam PixelType_ The pixel type. Usually of type `Pixel<>`.
+ * @tparam Allocator_ The allocator type of the underlying `Image<PixelType, Allocator>`.
+ */
+template <typename PixelType_, typename Allocator_>
+class SharedImageView : public ImageBase<SharedImageView<PixelType_, Allocator_>>
+{
+public:
+  using PixelType = PixelType_;
+  using Allocator = Allocator_;
+  using DataPtrType = typename DataPtr<ImageModifiability::Constant>::Type;
+
+  using iterator = ConstImageRowIterator<PixelType, ImageModifiability::Constant>;  ///< The iterator type.
+  using const_iterator = ConstImageRowIterator<PixelType, ImageModifiability::Constant>;  ///< The const_iterator type.
+
+  using Traits = impl::ImageBaseTraits<SharedImageView<PixelType_, Allocator_>>;
+
+  constexpr static bool is_view = Traits::is_view;
+  constexpr static bool is_modifiable = Traits::is_modifiable;
+
+  constexpr static ImageModifiability modifiability() { return Traits::modifiability(); }
+
+  SharedImageView() = default;  ///< Default constructor.
+
+  explicit SharedImageView(const SharedImage<PixelType, Allocator>& img) noexcept;
+
+  const TypedLayout& layout() const noexcept;
+
+  PixelLength width() const noexcept;
+  PixelLength height() const noexcept;
+  Stride stride_bytes() const noexcept;
+  std::ptrdiff_t row_bytes() const noexcept;
+  std::ptrdiff_t total_bytes() const noexcept;
+
+  bool is_packed() const noexcept;
+  bool is_empty() const noexcept;
+  bool is_valid() const noexcept;
+
+  const_iterator begin() const noexcept;
+  const_iterator cbegin() const noexcept;
+  const_iterator end() const noexcept;
+  const_iterator cend() const noexcept;
+
+  DataPtrType byte_ptr() const noexcept;
+  DataPtrType byte_ptr(PixelIndex y) const noexcept;
+  DataPtrType byte_ptr(PixelIndex x, PixelIndex y) const noexcept;
+
+  const PixelType* data() const noexcept;
+  const PixelType* data(PixelIndex y) const noexcept;
+  const PixelType* data_row_end(PixelIndex y) const noexcept;
+  const PixelType* data(PixelIndex x, PixelIndex y) const noexcept;
+
+  const PixelType& operator()(PixelIndex x, PixelIndex y) const noexcept;
+
+  ConstantImageView<PixelType> view() const noexcept;
+  ConstantImageView<PixelType> constant_view() const noexcept;
+
+  void clear() noexcept;
+
+private:
+  SharedImage<PixelType, Allocator> img_;
+  ConstantImageView<PixelType> view_;
+};
+
+// ----------
+// Implementation:
+
+/** \brief Constructs a shared image with the specified layout.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @param layout The image layout.
+ */
+template <typename PixelType_, typename Allocator_>
+SharedImage<PixelType_, Allocator_>::SharedImage(TypedLayout layout)
+    : SharedImage(Image<PixelType, Allocator>(layout))
+{
+}
+
+/** \brief Constructs a shared image with the specified layout and row alignment.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @param layout The image layout.
+ * @param row_alignment_bytes The row alignment in bytes.
+ */
+template <typename PixelType_, typename Allocator_>
+SharedImage<PixelType_, Allocator_>::SharedImage(TypedLayout layout, ImageRowAlignment row_alignment_bytes)
+    : SharedImage(Image<PixelType, Allocator>(layout, row_alignment_bytes))
+{
+}
+
+/** \brief Constructs a shared image from an existing image, taking over its data without copying.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @param img The image to take over. Will be empty afterwards.
+ */
+template <typename PixelType_, typename Allocator_>
+SharedImage<PixelType_, Allocator_>::SharedImage(Image<PixelType, Allocator>&& img)
+    : buffer_(new Buffer(std::move(img))), view_(buffer_->img.view())
+{
+}
+
+/** \brief Destructor. Deallocates the image data, if this instance holds the last reference to it.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ */
+template <typename PixelType_, typename Allocator_>
+SharedImage<PixelType_, Allocator_>::~SharedImage()
+{
+  release();
+}
+
+/** \brief Copy constructor. Shares the image data of `other`.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @param other The shared image to copy from.
+ */
+template <typename PixelType_, typename Allocator_>
+SharedImage<PixelType_, Allocator_>::SharedImage(const SharedImage<PixelType, Allocator>& other) noexcept
+    : buffer_(other.buffer_), view_(other.view_)
+{
+  if (buffer_ != nullptr)
+  {
+    buffer_->ref_count.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+/** \brief Copy assignment operator. Shares the image data of `other`.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @param other The shared image to assign from.
+ * @return A reference to this shared image.
+ */
+template <typename PixelType_, typename Allocator_>
+SharedImage<PixelType_, Allocator_>& SharedImage<PixelType_, Allocator_>::operator=(
+    const SharedImage<PixelType, Allocator>& other) noexcept
+{
+  if (other.buffer_ != nullptr)
+  {
+    other.buffer_->ref_count.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  release();
+  buffer_ = other.buffer_;
+  view_ = other.view_;
+  return *this;
+}
+
+/** \brief Move constructor.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @param other The shared image to move from.
+ */
+template <typename PixelType_, typename Allocator_>
+SharedImage<PixelType_, Allocator_>::SharedImage(SharedImage<PixelType, Allocator>&& other) noexcept
+    : buffer_(std::exchange(other.buffer_, nullptr)), view_(std::exchange(other.view_, MutableImageView<PixelType>{}))
+{
+}
+
+/** \brief Move assignment operator.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @param other The shared image to move from.
+ * @return A reference to this shared image.
+ */
+template <typename PixelType_, typename Allocator_>
+SharedImage<PixelType_, Allocator_>& SharedImage<PixelType_, Allocator_>::operator=(
+    SharedImage<PixelType, Allocator>&& other) noexcept
+{
+  if (this != &other)
+  {
+    release();
+    buffer_ = std::exchange(other.buffer_, nullptr);
+    view_ = std::exchange(other.view_, MutableImageView<PixelType>{});
+  }
+
+  return *this;
+}
+
+/** \brief Returns the image layout.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return The typed image layout.
+ */
+template <typename PixelType_, typename Allocator_>
+const TypedLayout& SharedImage<PixelType_, Allocator_>::layout() const noexcept
+{
+  return view_.layout();
+}
+
+/** \brief Returns the image width.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return Width of the image in pixels.
+ */
+template <typename PixelType_, typename Allocator_>
+PixelLength SharedImage<PixelType_, Allocator_>::width() const noexcept
+{
+  return view_.width();
+}
+
+/** \brief Returns the image height.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return Height of the image in pixels.
+ */
+template <typename PixelType_, typename Allocator_>
+PixelLength SharedImage<PixelType_, Allocator_>::height() const noexcept
+{
+  return view_.height();
+}
+
+/** \brief Returns the row stride of the image in bytes.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return The row stride of the image in bytes.
+ */
+template <typename PixelType_, typename Allocator_>
+Stride SharedImage<PixelType_, Allocator_>::stride_bytes() const noexcept
+{
+  return view_.stride_bytes();
+}
+
+/** \brief Returns the number of data bytes occupied by each image row.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return The number of data bytes occupied by each image row.
+ */
+template <typename PixelType_, typename Allocator_>
+std::ptrdiff_t SharedImage<PixelType_, Allocator_>::row_bytes() const noexcept
+{
+  return view_.row_bytes();
+}
+
+/** \brief Returns whether the image data is stored packed in memory.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return True, if the image data is stored packed; false otherwise.
+ */
+template <typename PixelType_, typename Allocator_>
+bool SharedImage<PixelType_, Allocator_>::is_packed() const noexcept
+{
+  return view_.is_packed();
+}
+
+/** \brief Returns whether the image is empty.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return True, if the image is empty; false if it is non-empty.
+ */
+template <typename PixelType_, typename Allocator_>
+bool SharedImage<PixelType_, Allocator_>::is_empty() const noexcept
+{
+  return view_.is_empty();
+}
+
+/** \brief Returns whether the instance represents a valid image.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return True, if the image is valid; false otherwise.
+ */
+template <typename PixelType_, typename Allocator_>
+bool SharedImage<PixelType_, Allocator_>::is_valid() const noexcept
+{
+  return view_.is_valid();
+}
+
+/** \brief Returns a constant pointer to the first pixel element of the specified row.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @param y Row index.
+ * @return Constant pointer to the first pixel element of the y-th row.
+ */
+template <typename PixelType_, typename Allocator_>
+auto SharedImage<PixelType_, Allocator_>::data(PixelIndex y) const noexcept -> const PixelType*
+{
+  return view_.data(y);
+}
+
+/** \brief Accesses the pixel value at location (x, y).
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @param x Column index.
+ * @param y Row index.
+ * @return Constant reference to the pixel element at location (x, y).
+ */
+template <typename PixelType_, typename Allocator_>
+auto SharedImage<PixelType_, Allocator_>::operator()(PixelIndex x, PixelIndex y) const noexcept -> const PixelType&
+{
+  return view_(x, y);
+}
+
+/** \brief Returns a constant view onto the image data. No data is copied.
+ *
+ * The returned view does not keep the image data alive; use `shared_view()` for a view that does.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return A constant image view.
+ */
+template <typename PixelType_, typename Allocator_>
+ConstantImageView<PixelType_> SharedImage<PixelType_, Allocator_>::view() const noexcept
+{
+  return view_.constant_view();
+}
+
+/** \brief Returns a mutable view onto the image data.
+ *
+ * If the image data is shared with other instances, it is copied into a new buffer first (see `make_unique()`).
+ * The returned view does not keep the image data alive, and is invalidated by copying this instance and then
+ * requesting mutable access again.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return A mutable image view.
+ */
+template <typename PixelType_, typename Allocator_>
+MutableImageView<PixelType_> SharedImage<PixelType_, Allocator_>::mutable_view()
+{
+  make_unique();
+  return view_;
+}
+
+/** \brief Returns a constant view onto the image data, which keeps the image data alive. No data is copied.
+ *
+ * As long as the returned view exists, the image data is shared; mutable access to this instance will therefore copy
+ * the data (see `mutable_view()`).
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return A constant image view sharing ownership of the image data.
+ */
+template <typename PixelType_, typename Allocator_>
+SharedImageView<PixelType_, Allocator_> SharedImage<PixelType_, Allocator_>::shared_view() const noexcept
+{
+  return SharedImageView<PixelType, Allocator>(*this);
+}
+
+/** \brief Returns a shared image referring to a region of this image. No data is copied.
+ *
+ * The returned instance shares (and keeps alive) the whole underlying buffer.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @param region The region; has to lie within the image bounds.
+ * @return A shared image referring to the specified region.
+ */
+template <typename PixelType_, typename Allocator_>
+SharedImage<PixelType_, Allocator_> SharedImage<PixelType_, Allocator_>::sub_image(
+    const BoundingBox& region) const noexcept
+{
+  SELENE_ASSERT(region.x0() >= 0 && region.x1() <= view_.width());
+  SELENE_ASSERT(region.y0() >= 0 && region.y1() <= view_.height());
+
+  SharedImage<PixelType, Allocator> sub(*this);
+  sub.view_ = MutableImageView<PixelType>{
+      view_.byte_ptr(region.x0(), region.y0()),
+      {region.width(), region.height(), view_.stride_bytes(), view_.layout().tail_padding_bytes}};
+  return sub;
+}
+
+/** \brief Returns whether this instance is the only one referring to the image data.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return True, if the image data is not shared with other instances; false otherwise.
+ */
+template <typename PixelType_, typename Allocator_>
+bool SharedImage<PixelType_, Allocator_>::is_unique() const noexcept
+{
+  // Acquire ordering synchronizes with the release of other references, so that their accesses happen before any
+  // subsequent modification through this instance.
+  return buffer_ == nullptr || buffer_->ref_count.load(std::memory_order_acquire) == 1;
+}
+
+/** \brief Returns the number of instances referring to the image data.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return The number of instances sharing the image data; 0 if the instance holds no data.
+ */
+template <typename PixelType_, typename Allocator_>
+std::size_t SharedImage<PixelType_, Allocator_>::use_count() const noexcept
+{
+  return (buffer_ == nullptr) ? 0 : buffer_->ref_count.load(std::memory_order_relaxed);
+}
+
+/** \brief Copies the image data into a new buffer, if it is shared with other instances.
+ *
+ * Only the region referred to by this instance is copied, into a buffer with packed rows (apart from any guaranteed
+ * tail padding bytes).
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ */
+template <typename PixelType_, typename Allocator_>
+void SharedImage<PixelType_, Allocator_>::make_unique()
+{
+  if (is_unique())
+  {
+    return;
+  }
+
+  Image<PixelType, Allocator> img({view_.width(), view_.height(), Stride{0}, view_.layout().tail_padding_bytes});
+  for (PixelIndex y = 0_idx; y < view_.height(); ++y)
+  {
+    std::copy(view_.data(y), view_.data_row_end(y), img.data(y));
+  }
+
+  *this = SharedImage<PixelType, Allocator>(std::move(img));
+}
+
+/** \brief Releases the reference to the image data, leaving an empty image.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ */
+template <typename PixelType_, typename Allocator_>
+void SharedImage<PixelType_, Allocator_>::clear() noexcept
+{
+  release();
+  buffer_ = nullptr;
+  view_ = MutableImageView<PixelType>{};
+}
+
+template <typename PixelType_, typename Allocator_>
+void SharedImage<PixelType_, Allocator_>::release() noexcept
+{
+  if (buffer_ != nullptr && buffer_->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+  {
+    delete buffer_;
+  }
+}
+
+/** \brief Constructs a view sharing ownership of the image data of the specified shared image.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @param img The shared image.
+ */
+template <typename PixelType_, typename Allocator_>
+SharedImageView<PixelType_, Allocator_>::SharedImageView(const SharedImage<PixelType, Allocator>& img) noexcept
+    : img_(img), view_(img_.view())
+{
+}
+
+/** \brief Returns the image view layout.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return The typed image view layout.
+ */
+template <typename PixelType_, typename Allocator_>
+const TypedLayout& SharedImageView<PixelType_, Allocator_>::layout() const noexcept
+{
+  return view_.layout();
+}
+
+/** \brief Returns the image view width.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return The image view width.
+ */
+template <typename PixelType_, typename Allocator_>
+PixelLength SharedImageView<PixelType_, Allocator_>::width() const noexcept
+{
+  return view_.width();
+}
+
+/** \brief Returns the image view height.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return The image view height.
+ */
+template <typename PixelType_, typename Allocator_>
+PixelLength SharedImageView<PixelType_, Allocator_>::height() const noexcept
+{
+  return view_.height();
+}
+
+/** \brief Returns the row stride of the image view in bytes.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return The row stride of the image view in bytes.
+ */
+template <typename PixelType_, typename Allocator_>
+Stride SharedImageView<PixelType_, Allocator_>::stride_bytes() const noexcept
+{
+  return view_.stride_bytes();
+}
+
+/** \brief Returns the number of data bytes occupied by each image row.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return The number of data bytes occupied by each image row.
+ */
+template <typename PixelType_, typename Allocator_>
+std::ptrdiff_t SharedImageView<PixelType_, Allocator_>::row_bytes() const noexcept
+{
+  return view_.row_bytes();
+}
+
+/** \brief Returns the total number of bytes occupied by the image data in memory.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return The number of bytes occupied by the image data in memory.
+ */
+template <typename PixelType_, typename Allocator_>
+std::ptrdiff_t SharedImageView<PixelType_, Allocator_>::total_bytes() const noexcept
+{
+  return view_.total_bytes();
+}
+
+/** \brief Returns whether the image view is stored packed in memory.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return True, if the image view data is stored packed; false otherwise.
+ */
+template <typename PixelType_, typename Allocator_>
+bool SharedImageView<PixelType_, Allocator_>::is_packed() const noexcept
+{
+  return view_.is_packed();
+}
+
+/** \brief Returns whether the image view is empty.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return True, if the image view is empty; false if it is non-empty.
+ */
+template <typename PixelType_, typename Allocator_>
+bool SharedImageView<PixelType_, Allocator_>::is_empty() const noexcept
+{
+  return view_.is_empty();
+}
+
+/** \brief Returns whether the instance represents a valid image view.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return True, if the image view is valid; false otherwise.
+ */
+template <typename PixelType_, typename Allocator_>
+bool SharedImageView<PixelType_, Allocator_>::is_valid() const noexcept
+{
+  return view_.is_valid();
+}
+
+/** \brief Returns a constant iterator to the first row.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return A constant iterator to the first row.
+ */
+template <typename PixelType_, typename Allocator_>
+auto SharedImageView<PixelType_, Allocator_>::begin() const noexcept -> const_iterator
+{
+  return view_.cbegin();
+}
+
+/** \brief Returns a constant iterator to the first row.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return A constant iterator to the first row.
+ */
+template <typename PixelType_, typename Allocator_>
+auto SharedImageView<PixelType_, Allocator_>::cbegin() const noexcept -> const_iterator
+{
+  return view_.cbegin();
+}
+
+/** \brief Returns a constant iterator to the row after the last row of the image.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return A constant iterator to the row after the last row of the image.
+ */
+template <typename PixelType_, typename Allocator_>
+auto SharedImageView<PixelType_, Allocator_>::end() const noexcept -> const_iterator
+{
+  return view_.cend();
+}
+
+/** \brief Returns a constant iterator to the row after the last row of the image.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return A constant iterator to the row after the last row of the image.
+ */
+template <typename PixelType_, typename Allocator_>
+auto SharedImageView<PixelType_, Allocator_>::cend() const noexcept -> const_iterator
+{
+  return view_.cend();
+}
+
+/** \brief Returns a constant byte pointer to the first pixel element of the image data.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return Constant byte pointer to the image data.
+ */
+template <typename PixelType_, typename Allocator_>
+auto SharedImageView<PixelType_, Allocator_>::byte_ptr() const noexcept -> DataPtrType
+{
+  return view_.byte_ptr();
+}
+
+/** \brief Returns a constant byte pointer to the first pixel element of the y-th row.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @param y Row index.
+ * @return Constant byte pointer to the first pixel element of the y-th row.
+ */
+template <typename PixelType_, typename Allocator_>
+auto SharedImageView<PixelType_, Allocator_>::byte_ptr(PixelIndex y) const noexcept -> DataPtrType
+{
+  return view_.byte_ptr(y);
+}
+
+/** \brief Returns a constant byte pointer to the x-th pixel element of the y-th row.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @param x Column index.
+ * @param y Row index.
+ * @return Constant byte pointer to the x-th pixel element of the y-th row.
+ */
+template <typename PixelType_, typename Allocator_>
+auto SharedImageView<PixelType_, Allocator_>::byte_ptr(PixelIndex x, PixelIndex y) const noexcept -> DataPtrType
+{
+  return view_.byte_ptr(x, y);
+}
+
+/** \brief Returns a constant pointer to the first pixel element of the image data.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return Constant pointer to the image data.
+ */
+template <typename PixelType_, typename Allocator_>
+auto SharedImageView<PixelType_, Allocator_>::data() const noexcept -> const PixelType*
+{
+  return view_.data();
+}
+
+/** \brief Returns a constant pointer to the first pixel element of the y-th row.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @param y Row index.
+ * @return Constant pointer to the first pixel element of the y-th row.
+ */
+template <typename PixelType_, typename Allocator_>
+auto SharedImageView<PixelType_, Allocator_>::data(PixelIndex y) const noexcept -> const PixelType*
+{
+  return view_.data(y);
+}
+
+/** \brief Returns a constant pointer to the one-past-the-last pixel element of the y-th row.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @param y Row index.
+ * @return Constant pointer to the one-past-the-last pixel element of the y-th row.
+ */
+template <typename PixelType_, typename Allocator_>
+auto SharedImageView<PixelType_, Allocator_>::data_row_end(PixelIndex y) const noexcept -> const PixelType*
+{
+  return view_.data_row_end(y);
+}
+
+/** \brief Returns a constant pointer to the x-th pixel element of the y-th row.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @param x Column index.
+ * @param y Row index.
+ * @return Constant pointer to the x-th pixel element of the y-th row.
+ */
+template <typename PixelType_, typename Allocator_>
+auto SharedImageView<PixelType_, Allocator_>::data(PixelIndex x, PixelIndex y) const noexcept -> const PixelType*
+{
+  return view_.data(x, y);
+}
+
+/** \brief Accesses the pixel value at location (x, y).
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @param x Column index.
+ * @param y Row index.
+ * @return Constant reference to the pixel element at location (x, y).
+ */
+template <typename PixelType_, typename Allocator_>
+auto SharedImageView<PixelType_, Allocator_>::operator()(PixelIndex x, PixelIndex y) const noexcept -> const PixelType&
+{
+  return view_(x, y);
+}
+
+/** \brief Returns a plain constant view onto the image data, which does not keep the image data alive.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return A constant image view.
+ */
+template <typename PixelType_, typename Allocator_>
+auto SharedImageView<PixelType_, Allocator_>::view() const noexcept -> ConstantImageView<PixelType>
+{
+  return view_;
+}
+
+/** \brief Returns a plain constant view onto the image data, which does not keep the image data alive.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ * @return A constant image view.
+ */
+template <typename PixelType_, typename Allocator_>
+auto SharedImageView<PixelType_, Allocator_>::constant_view() const noexcept -> ConstantImageView<PixelType>
+{
+  return view_;
+}
+
+/** \brief Clears the image view, releasing its reference to the image data.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam Allocator_ The allocator type.
+ */
+template <typename PixelType_, typename Allocator_>
+void SharedImageView<PixelType_, Allocator_>::clear() noexcept
+{
+  img_.clear();
+  view_.clear();
+}
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_TYPED_SHARED_IMAGE_HPP
@@ -17,6 +17,11 @@ namespace sln {
 
 /** \brief The layout for a statically typed image, holding information about width, height, and the image's row stride
  * in bytes.
+ *
+ * Optionally, a layout can guarantee a number of readable and writable padding bytes after the data of each row,
+ * including the last one (i.e. after the end of the image data). Vectorized kernels can then process full vectors
+ * up to the end of each row, instead of handling the row tails separately. The contents of the padding bytes are
+ * unspecified; they may be used as scratch space.
  */
 class TypedLayout
 {
@@ -25,6 +30,7 @@ public:
       : width{PixelLength{0}}
       , height{PixelLength{0}}
       , stride_bytes{Stride{0}}
+      , tail_padding_bytes{0}
   { }
 
   constexpr TypedLayout(PixelLength width_,
@@ -32,6 +38,7 @@ public:
       : width(width_)
       , height(height_)
       , stride_bytes(Stride{0})  // special value: to be set later
+      , tail_padding_bytes{0}
   { }
 
   constexpr TypedLayout(PixelLength width_,
@@ -40,16 +47,29 @@ public:
       : width(width_)
       , height(height_)
       , stride_bytes(stride_bytes_)
+      , tail_padding_bytes{0}
+  { }
+
+  constexpr TypedLayout(PixelLength width_,
+                        PixelLength height_,
+                        Stride stride_bytes_,
+                        std::ptrdiff_t tail_padding_bytes_) noexcept
+      : width(width_)
+      , height(height_)
+      , stride_bytes(stride_bytes_)
+      , tail_padding_bytes(tail_padding_bytes_)
   { }
 
   PixelLength width;  ///< The image width in pixels.
   PixelLength height;  ///< The image height in pixels.
   Stride stride_bytes;  ///< The image row stride in bytes. The layout may include additional padding bytes.
+  std::ptrdiff_t tail_padding_bytes;  ///< The number of accessible bytes guaranteed after the data of each row.
 
   template <typename PixelType> constexpr std::ptrdiff_t nr_bytes_per_pixel() const noexcept;
   template <typename PixelType> constexpr std::ptrdiff_t row_bytes() const noexcept;
   template <typename PixelType> constexpr std::ptrdiff_t total_bytes() const noexcept;
   template <typename PixelType> constexpr bool is_packed() const noexcept;
+  template <typename PixelType> constexpr bool has_valid_tail_padding() const noexcept;
 };
 
 constexpr bool operator==(const TypedLayout& l, const TypedLayout& r);
@@ -104,6 +124,16 @@ template <typename PixelType> constexpr bool TypedLayout::is_packed() const noex
   return stride_bytes == PixelTraits<PixelType>::nr_bytes * width;
 }
 
+/** \brief Returns whether the row stride accommodates the guaranteed tail padding bytes after each row.
+ *
+ * @tparam PixelType The pixel type.
+ * @return True, if `stride_bytes >= row_bytes() + tail_padding_bytes`; false otherwise.
+ */
+template <typename PixelType> constexpr bool TypedLayout::has_valid_tail_padding() const noexcept
+{
+  return tail_padding_bytes >= 0 && stride_bytes >= row_bytes<PixelType>() + tail_padding_bytes;
+}
+
 /** \brief Equality comparison for two typed layouts.
  *
  * @tparam PixelType The pixel type.
@@ -113,7 +143,8 @@ template <typename PixelType> constexpr bool TypedLayout::is_packed() const noex
  */
 constexpr  bool operator==(const TypedLayout& l, const TypedLayout& r)
 {
-  return l.width == r.width && l.height == r.height && l.stride_bytes == r.stride_bytes;
+  return l.width == r.width && l.height == r.height && l.stride_bytes == r.stride_bytes
+         && l.tail_padding_bytes == r.tail_padding_bytes;
 }
 
 /** \brief Inequality comparison for two typed layouts.
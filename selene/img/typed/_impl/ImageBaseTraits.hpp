@@ -7,6 +7,8 @@
 
 /// @file
 
+#include <selene/base/Allocators.hpp>
+
 #include <selene/img/common/DataPtr.hpp>
 
 namespace sln {
@@ -14,16 +16,19 @@ namespace sln {
 template <typename PixelType_, ImageModifiability modifiability_>
 class ImageView;
 
-template <typename PixelType_>
+template <typename PixelType_, typename Allocator_ = AlignedNewAllocator>
 class Image;
 
+template <typename PixelType_, typename Allocator_ = AlignedNewAllocator>
+class SharedImageView;
+
 namespace impl {
 
 template <typename Derived>
 struct ImageBaseTraits;
 
-template <typename PixelType_>
-struct ImageBaseTraits<Image<PixelType_>>
+template <typename PixelType_, typename Allocator_>
+struct ImageBaseTraits<Image<PixelType_, Allocator_>>
 {
   using PixelType = PixelType_;
 
@@ -50,6 +55,20 @@ struct ImageBaseTraits<ImageView<PixelType_, modifiability_>>
   }
 };
 
+template <typename PixelType_, typename Allocator_>
+struct ImageBaseTraits<SharedImageView<PixelType_, Allocator_>>
+{
+  using PixelType = PixelType_;
+
+  constexpr static bool is_view = true;
+  constexpr static bool is_modifiable = false;
+
+  constexpr static ImageModifiability modifiability()
+  {
+    return ImageModifiability::Constant;
+  }
+};
+
 }  // namespace impl
 
 }  // namespace sln
@@ -90,8 +90,11 @@ struct ImageInterpolator<ImageInterpolationMode::Bilinear, AccessMode>
       std::size_t nr_channels,
       PixelFormat pixel_format,
       typename ScalarAccess = default_float_t,
-      typename ScalarOutputElement = default_float_t>
-  static auto interpolate(const Image<Pixel<T, nr_channels, pixel_format>>& img, ScalarAccess x, ScalarAccess y) noexcept;
+      typename ScalarOutputElement = default_float_t,
+      typename Allocator = AlignedNewAllocator>
+  static auto interpolate(const Image<Pixel<T, nr_channels, pixel_format>, Allocator>& img,
+                          ScalarAccess x,
+                          ScalarAccess y) noexcept;
 };
 
 
@@ -280,6 +283,7 @@ inline auto ImageInterpolator<ImageInterpolationMode::Bilinear, AccessMode>::int
  * @tparam nr_channels The number of channels for a pixel.
  * @tparam ScalarAccess The floating point type for specifying the location (x, y).
  * @tparam ScalarOutputElement The floating point type for each pixel element; i.e. the type for each channel element.
+ * @tparam Allocator The allocator type of the image.
  * @param img The image to access.
  * @param x The x-coordinate.
  * @param y The y-coordinate.
@@ -288,9 +292,9 @@ inline auto ImageInterpolator<ImageInterpolationMode::Bilinear, AccessMode>::int
  */
 template <BorderAccessMode AccessMode>
 template <typename T, std::size_t nr_channels, PixelFormat pixel_format, typename ScalarAccess,
-          typename ScalarOutputElement>
+          typename ScalarOutputElement, typename Allocator>
 inline auto ImageInterpolator<ImageInterpolationMode::Bilinear, AccessMode>::interpolate(
-    const Image<Pixel<T, nr_channels, pixel_format>>& img, ScalarAccess x, ScalarAccess y) noexcept
+    const Image<Pixel<T, nr_channels, pixel_format>, Allocator>& img, ScalarAccess x, ScalarAccess y) noexcept
 {
   static_assert(std::is_floating_point<ScalarAccess>::value, "Interpolation coordinates must be floating point.");
   static_assert(std::is_floating_point<ScalarOutputElement>::value,
@@ -33,8 +33,8 @@ enum class ImageFormat
 template <typename SourceType>
 DynImage read_image(SourceType&& source, MessageLog* messages = nullptr);
 
-template <typename SinkType>
-bool write_image(const DynImage& dyn_img,
+template <typename Allocator, typename SinkType>
+bool write_image(const DynImageT<Allocator>& dyn_img,
                  ImageFormat format,
                  SinkType&& sink,
                  MessageLog* messages = nullptr,
@@ -127,8 +127,8 @@ DynImage read_image(SourceType&& source,
   return dyn_img;
 }
 
-template <typename SinkType>
-bool write_image(const DynImage& dyn_img,
+template <typename Allocator, typename SinkType>
+bool write_image(const DynImageT<Allocator>& dyn_img,
                  ImageFormat format,
                  SinkType&& sink,
                  MessageLog* messages,
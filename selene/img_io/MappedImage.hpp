@@ -0,0 +1,196 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_IO_MAPPED_IMAGE_HPP
+#define SELENE_IMG_IO_MAPPED_IMAGE_HPP
+
+/// @file
+
+#include <selene/base/io/MemoryMappedFile.hpp>
+
+#include <selene/img/dynamic/DynImageView.hpp>
+#include <selene/img/dynamic/UntypedLayout.hpp>
+
+#include <selene/img/pixel/PixelTraits.hpp>
+
+#include <selene/img/typed/ImageView.hpp>
+#include <selene/img/typed/TypedLayout.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace sln {
+
+template <typename PixelType>
+ConstantImageView<PixelType> mapped_image_view(const MemoryMappedFile& file,
+                                               TypedLayout layout,
+                                               std::ptrdiff_t offset = 0);
+
+template <typename PixelType>
+MutableImageView<PixelType> mutable_mapped_image_view(MemoryMappedFile& file,
+                                                      TypedLayout layout,
+                                                      std::ptrdiff_t offset = 0);
+
+inline ConstantDynImageView mapped_dyn_image_view(const MemoryMappedFile& file,
+                                                  UntypedLayout layout,
+                                                  UntypedImageSemantics semantics = UntypedImageSemantics{},
+                                                  std::ptrdiff_t offset = 0);
+
+inline MutableDynImageView mutable_mapped_dyn_image_view(MemoryMappedFile& file,
+                                                         UntypedLayout layout,
+                                                         UntypedImageSemantics semantics = UntypedImageSemantics{},
+                                                         std::ptrdiff_t offset = 0);
+
+// ----------
+// Implementation:
+
+namespace impl {
+
+inline void check_mapped_image_region(const char* function_name,
+                                      const MemoryMappedFile& file,
+                                      std::ptrdiff_t offset,
+                                      std::ptrdiff_t row_bytes,
+                                      Stride stride_bytes,
+                                      PixelLength height,
+                                      std::ptrdiff_t element_alignment)
+{
+  const auto fail = [function_name](const char* message) {
+    throw std::runtime_error(std::string(function_name) + ": " + message);
+  };
+
+  if (!file.is_open())
+  {
+    fail("File is not mapped.");
+  }
+
+  if (offset < 0)
+  {
+    fail("Invalid offset.");
+  }
+
+  const auto nr_rows = static_cast<std::ptrdiff_t>(height);
+  const auto nr_bytes = (nr_rows > 0) ? static_cast<std::ptrdiff_t>(stride_bytes) * (nr_rows - 1) + row_bytes : 0;
+  if (offset + nr_bytes > static_cast<std::ptrdiff_t>(file.size()))
+  {
+    fail("Image region exceeds the file size.");
+  }
+
+  if (offset % element_alignment != 0 || static_cast<std::ptrdiff_t>(stride_bytes) % element_alignment != 0)
+  {
+    fail("Image data is not aligned to the element size.");
+  }
+}
+
+}  // namespace impl
+
+/** \brief Returns a constant view onto image data stored in a memory-mapped file.
+ *
+ * No data is read or copied; pages of the file are read on first access. The view is valid as long as the mapping
+ * stays open.
+ *
+ * @tparam PixelType The pixel type.
+ * @param file The memory-mapped file.
+ * @param layout The image layout. A stride of 0 designates packed rows (plus any tail padding bytes).
+ * @param offset The byte offset of the first image row in the file.
+ * @return A constant image view onto the mapped data.
+ */
+template <typename PixelType>
+ConstantImageView<PixelType> mapped_image_view(const MemoryMappedFile& file,
+                                               TypedLayout layout,
+                                               std::ptrdiff_t offset)
+{
+  // The guaranteed tail padding bytes have to lie within the file as well
+  const auto row_bytes = layout.row_bytes<PixelType>() + layout.tail_padding_bytes;
+  layout.stride_bytes = std::max(layout.stride_bytes, Stride{row_bytes});
+  impl::check_mapped_image_region("mapped_image_view", file, offset, row_bytes, layout.stride_bytes, layout.height,
+                                  std::ptrdiff_t{PixelTraits<PixelType>::nr_bytes_per_channel});
+  return ConstantImageView<PixelType>{file.data() + offset, layout};
+}
+
+/** \brief Returns a mutable view onto image data stored in a memory-mapped file.
+ *
+ * The mapping has to be opened with `MappingMode::ReadWrite` (to modify the file contents) or
+ * `MappingMode::CopyOnWrite` (to modify a private copy of the affected pages only).
+ *
+ * @tparam PixelType The pixel type.
+ * @param file The memory-mapped file.
+ * @param layout The image layout. A stride of 0 designates packed rows (plus any tail padding bytes).
+ * @param offset The byte offset of the first image row in the file.
+ * @return A mutable image view onto the mapped data.
+ */
+template <typename PixelType>
+MutableImageView<PixelType> mutable_mapped_image_view(MemoryMappedFile& file,
+                                                      TypedLayout layout,
+                                                      std::ptrdiff_t offset)
+{
+  if (!file.is_writable())
+  {
+    throw std::runtime_error("mutable_mapped_image_view: File mapping is not writable.");
+  }
+
+  // The guaranteed tail padding bytes have to lie within the file as well
+  const auto row_bytes = layout.row_bytes<PixelType>() + layout.tail_padding_bytes;
+  layout.stride_bytes = std::max(layout.stride_bytes, Stride{row_bytes});
+  impl::check_mapped_image_region("mutable_mapped_image_view", file, offset, row_bytes, layout.stride_bytes,
+                                  layout.height, std::ptrdiff_t{PixelTraits<PixelType>::nr_bytes_per_channel});
+  return MutableImageView<PixelType>{file.mutable_data() + offset, layout};
+}
+
+/** \brief Returns a constant dynamic view onto image data stored in a memory-mapped file.
+ *
+ * No data is read or copied; pages of the file are read on first access. The view is valid as long as the mapping
+ * stays open.
+ *
+ * @param file The memory-mapped file.
+ * @param layout The image layout. A stride of 0 designates packed rows.
+ * @param semantics The image semantics.
+ * @param offset The byte offset of the first image row in the file.
+ * @return A constant dynamic image view onto the mapped data.
+ */
+inline ConstantDynImageView mapped_dyn_image_view(const MemoryMappedFile& file,
+                                                  UntypedLayout layout,
+                                                  UntypedImageSemantics semantics,
+                                                  std::ptrdiff_t offset)
+{
+  layout.stride_bytes = std::max(layout.stride_bytes, Stride{layout.row_bytes()});
+  impl::check_mapped_image_region("mapped_dyn_image_view", file, offset, layout.row_bytes(), layout.stride_bytes,
+                                  layout.height,
+                                  std::max(std::ptrdiff_t{layout.nr_bytes_per_channel}, std::ptrdiff_t{1}));
+  return ConstantDynImageView{file.data() + offset, layout, semantics};
+}
+
+/** \brief Returns a mutable dynamic view onto image data stored in a memory-mapped file.
+ *
+ * The mapping has to be opened with `MappingMode::ReadWrite` (to modify the file contents) or
+ * `MappingMode::CopyOnWrite` (to modify a private copy of the affected pages only).
+ *
+ * @param file The memory-mapped file.
+ * @param layout The image layout. A stride of 0 designates packed rows.
+ * @param semantics The image semantics.
+ * @param offset The byte offset of the first image row in the file.
+ * @return A mutable dynamic image view onto the mapped data.
+ */
+inline MutableDynImageView mutable_mapped_dyn_image_view(MemoryMappedFile& file,
+                                                         UntypedLayout layout,
+                                                         UntypedImageSemantics semantics,
+                                                         std::ptrdiff_t offset)
+{
+  if (!file.is_writable())
+  {
+    throw std::runtime_error("mutable_mapped_dyn_image_view: File mapping is not writable.");
+  }
+
+  layout.stride_bytes = std::max(layout.stride_bytes, Stride{layout.row_bytes()});
+  impl::check_mapped_image_region("mutable_mapped_dyn_image_view", file, offset, layout.row_bytes(),
+                                  layout.stride_bytes, layout.height,
+                                  std::max(std::ptrdiff_t{layout.nr_bytes_per_channel}, std::ptrdiff_t{1}));
+  return MutableDynImageView{file.mutable_data() + offset, layout, semantics};
+}
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_IO_MAPPED_IMAGE_HPP
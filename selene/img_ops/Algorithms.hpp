@@ -7,11 +7,18 @@
 
 /// @file
 
+#include <selene/base/ExecutionPolicy.hpp>
+
 #include <selene/img/typed/Image.hpp>
 #include <selene/img/typed/ImageBase.hpp>
 
 #include <selene/img_ops/Allocate.hpp>
 
+#include <cstddef>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+
 namespace sln {
 
 /** \brief Applies a unary function to each pixel value of an image.
@@ -81,6 +88,249 @@ Image<PixelTypeDst> transform_pixels(const ImageBase<DerivedSrc>& img_src, Unary
   return img_dst;
 }
 
+// ----------
+// Overloads accepting an execution policy:
+
+namespace impl {
+
+template <bool unsequenced, typename PixelType, typename UnaryFunction>
+void for_each_pixel_in_row(PixelType* ptr, std::ptrdiff_t width, UnaryFunction& f)
+{
+  if constexpr (unsequenced)
+  {
+    SELENE_VECTORIZE_LOOP
+    for (std::ptrdiff_t x = 0; x < width; ++x)
+    {
+      f(ptr[x]);
+    }
+  }
+  else
+  {
+    for (std::ptrdiff_t x = 0; x < width; ++x)
+    {
+      f(ptr[x]);
+    }
+  }
+}
+
+template <bool unsequenced, typename PixelTypeDst, typename Operation, typename... PixelTypesSrc>
+void transform_pixels_in_row(PixelTypeDst* ptr_dst,
+                             std::ptrdiff_t width,
+                             Operation& op,
+                             const PixelTypesSrc*... ptrs_src)
+{
+  if constexpr (unsequenced)
+  {
+    SELENE_VECTORIZE_LOOP
+    for (std::ptrdiff_t x = 0; x < width; ++x)
+    {
+      ptr_dst[x] = op(ptrs_src[x]...);
+    }
+  }
+  else
+  {
+    for (std::ptrdiff_t x = 0; x < width; ++x)
+    {
+      ptr_dst[x] = op(ptrs_src[x]...);
+    }
+  }
+}
+
+inline PixelIndex to_row_index(std::ptrdiff_t y) noexcept
+{
+  return PixelIndex{static_cast<PixelIndex::value_type>(y)};
+}
+
+}  // namespace impl
+
+/** \brief Applies a unary function to each pixel value of an image, according to the specified execution policy.
+ *
+ * With a parallel execution policy (`execution::par`, `execution::par_unseq`, or a `ThreadPool`), the image rows are
+ * split into bands which are processed concurrently; `f` is hence invoked concurrently from multiple threads, and
+ * must be safe to be called that way.
+ * With `execution::par_unseq`, invocations of `f` within each row may additionally be interleaved, i.e. the row loop
+ * is marked as vectorizable; `f` must then not synchronize or depend on the order of invocations.
+ *
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam DerivedSrc The typed image type.
+ * @tparam UnaryFunction The unary function type.
+ * @param policy The execution policy.
+ * @param[in,out] img The image to apply the function on.
+ * @param f The unary function to apply to each pixel. Its signature should be `void f(PixelType&)`.
+ */
+template <typename ExecutionPolicy,
+          typename DerivedSrc,
+          typename UnaryFunction,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+void for_each_pixel(ExecutionPolicy&& policy, ImageBase<DerivedSrc>& img, UnaryFunction f)
+{
+  constexpr bool unsequenced = is_unsequenced_policy_v<ExecutionPolicy>;
+  const auto width = static_cast<std::ptrdiff_t>(img.width());
+
+  impl::parallel_for(policy, 0, static_cast<std::ptrdiff_t>(img.height()), impl::row_grain_size(width),
+                     [&](std::ptrdiff_t y_begin, std::ptrdiff_t y_end) {
+                       for (auto y = y_begin; y < y_end; ++y)
+                       {
+                         impl::for_each_pixel_in_row<unsequenced>(img.data(impl::to_row_index(y)), width, f);
+                       }
+                     });
+}
+
+/** \brief Transforms one image into another by applying a unary operation to each pixel value, according to the
+ * specified execution policy.
+ *
+ * `allocate` is called on the destination image prior to performing the operation.
+ *
+ * See the `for_each_pixel` overload accepting an execution policy for the requirements on `op`.
+ *
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam DerivedDst The typed destination image type.
+ * @tparam DerivedSrc The typed source image type.
+ * @tparam UnaryOperation The unary operation type.
+ * @param policy The execution policy.
+ * @param img_src The source image.
+ * @param[out] img_dst The destination image.
+ * @param op The unary operation. Its signature should be `PixelTypeDst f(const PixelTypeSrc&)` or `PixelTypeDst
+ * f(PixelTypeSrc)`.
+ */
+template <typename ExecutionPolicy,
+          typename DerivedDst,
+          typename DerivedSrc,
+          typename UnaryOperation,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+void transform_pixels(ExecutionPolicy&& policy,
+                      const ImageBase<DerivedSrc>& img_src,
+                      ImageBase<DerivedDst>& img_dst,
+                      UnaryOperation op)
+{
+  allocate(img_dst, img_src.layout());
+
+  constexpr bool unsequenced = is_unsequenced_policy_v<ExecutionPolicy>;
+  const auto width = static_cast<std::ptrdiff_t>(img_dst.width());
+
+  impl::parallel_for(policy, 0, static_cast<std::ptrdiff_t>(img_dst.height()), impl::row_grain_size(width),
+                     [&](std::ptrdiff_t y_begin, std::ptrdiff_t y_end) {
+                       for (auto y = y_begin; y < y_end; ++y)
+                       {
+                         const auto row = impl::to_row_index(y);
+                         impl::transform_pixels_in_row<unsequenced>(img_dst.data(row), width, op, img_src.data(row));
+                       }
+                     });
+}
+
+/** \brief Transforms one image into another by applying a unary operation to each pixel value, according to the
+ * specified execution policy.
+ *
+ * @tparam PixelTypeDst The pixel type of the destination image.
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam DerivedSrc The typed source image type.
+ * @tparam UnaryOperation The unary operation type.
+ * @param policy The execution policy.
+ * @param img_src The source image.
+ * @param op The unary operation. Its signature should be `PixelTypeDst f(const PixelTypeSrc&)` or `PixelTypeDst
+ * f(PixelTypeSrc)`.
+ * @return The destination image.
+ */
+template <typename PixelTypeDst,
+          typename ExecutionPolicy,
+          typename DerivedSrc,
+          typename UnaryOperation,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+Image<PixelTypeDst> transform_pixels(ExecutionPolicy&& policy, const ImageBase<DerivedSrc>& img_src, UnaryOperation op)
+{
+  Image<PixelTypeDst> img_dst({img_src.width(), img_src.height()});
+  transform_pixels(policy, img_src, img_dst, op);
+  return img_dst;
+}
+
+// ----------
+// N-ary transformations:
+
+namespace impl {
+
+template <typename DerivedSrc0, typename... DerivedSrcs>
+void check_transform_pixels_sizes(const ImageBase<DerivedSrc0>& img_src0, const ImageBase<DerivedSrcs>&... imgs_src)
+{
+  if (!((imgs_src.width() == img_src0.width() && imgs_src.height() == img_src0.height()) && ...))
+  {
+    throw std::runtime_error("transform_pixels: Source images are not the same size.");
+  }
+}
+
+}  // namespace impl
+
+/** \brief Transforms several source images into one destination image by applying an n-ary operation to each set of
+ * corresponding pixel values.
+ *
+ * The rows of all images are traversed in lockstep, i.e. each output pixel is computed as
+ * `img_dst(x, y) = op(imgs_src(x, y)...)`, without creating any intermediate images.
+ *
+ * All source images need to be of the same size; otherwise, an exception is thrown.
+ * `allocate` is called on the destination image prior to performing the operation, using the layout of the first
+ * source image. The destination image may be one of the source images (i.e. the operation may be performed in-place).
+ *
+ * @tparam Operation The n-ary operation type.
+ * @tparam DerivedDst The typed destination image type.
+ * @tparam DerivedSrcs The typed source image types.
+ * @param op The n-ary operation. Its signature should be `PixelTypeDst f(const PixelTypeSrc0&, const PixelTypeSrc1&,
+ * ...)`.
+ * @param[out] img_dst The destination image.
+ * @param imgs_src The source images; at least one.
+ */
+template <typename Operation,
+          typename DerivedDst,
+          typename... DerivedSrcs,
+          typename = std::enable_if_t<!is_execution_policy_v<Operation> && (sizeof...(DerivedSrcs) > 0)>>
+void transform_pixels(Operation op, ImageBase<DerivedDst>& img_dst, const ImageBase<DerivedSrcs>&... imgs_src)
+{
+  transform_pixels(execution::seq, op, img_dst, imgs_src...);
+}
+
+/** \brief Transforms several source images into one destination image by applying an n-ary operation to each set of
+ * corresponding pixel values, according to the specified execution policy.
+ *
+ * See the overload without execution policy for details, and the `for_each_pixel` overload accepting an execution
+ * policy for the requirements on `op`.
+ *
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam Operation The n-ary operation type.
+ * @tparam DerivedDst The typed destination image type.
+ * @tparam DerivedSrcs The typed source image types.
+ * @param policy The execution policy.
+ * @param op The n-ary operation. Its signature should be `PixelTypeDst f(const PixelTypeSrc0&, const PixelTypeSrc1&,
+ * ...)`.
+ * @param[out] img_dst The destination image.
+ * @param imgs_src The source images; at least one.
+ */
+template <typename ExecutionPolicy,
+          typename Operation,
+          typename DerivedDst,
+          typename... DerivedSrcs,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy> && (sizeof...(DerivedSrcs) > 0)>>
+void transform_pixels(ExecutionPolicy&& policy,
+                      Operation op,
+                      ImageBase<DerivedDst>& img_dst,
+                      const ImageBase<DerivedSrcs>&... imgs_src)
+{
+  impl::check_transform_pixels_sizes(imgs_src...);
+
+  const auto& img_src0 = std::get<0>(std::forward_as_tuple(imgs_src...));
+  allocate(img_dst, img_src0.layout());
+
+  constexpr bool unsequenced = is_unsequenced_policy_v<ExecutionPolicy>;
+  const auto width = static_cast<std::ptrdiff_t>(img_dst.width());
+
+  impl::parallel_for(policy, 0, static_cast<std::ptrdiff_t>(img_dst.height()), impl::row_grain_size(width),
+                     [&](std::ptrdiff_t y_begin, std::ptrdiff_t y_end) {
+                       for (auto y = y_begin; y < y_end; ++y)
+                       {
+                         const auto row = impl::to_row_index(y);
+                         impl::transform_pixels_in_row<unsequenced>(img_dst.data(row), width, op,
+                                                                    imgs_src.data(row)...);
+                       }
+                     });
+}
+
 }  // namespace sln
 
 #endif  // SELENE_IMG_OPS_ALGORITHMS_HPP
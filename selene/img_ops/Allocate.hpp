@@ -7,18 +7,38 @@
 
 /// @file
 
+#include <selene/img/common/StridePadding.hpp>
+
+#include <selene/img/pixel/PixelTraits.hpp>
+
 #include <selene/img/typed/ImageBase.hpp>
 #include <selene/img/typed/TypedLayout.hpp>
 
+#include <algorithm>
 #include <cstdint>
 #include <stdexcept>
 
 namespace sln {
 
+namespace impl {
+
+template <typename PixelType>
+bool is_layout_satisfied(const TypedLayout& current_layout, const TypedLayout& required_layout)
+{
+  return current_layout.width == required_layout.width && current_layout.height == required_layout.height
+         && current_layout.stride_bytes >= required_layout.row_bytes<PixelType>() + required_layout.tail_padding_bytes;
+}
+
+}  // namespace impl
+
 template <typename Derived>
 bool allocate(ImageBase<Derived>& img_dst, TypedLayout layout, bool force_layout = false, [[maybe_unused]] bool shrink_to_fit = false)
 {
-  if (!force_layout && img_dst.width() == layout.width && img_dst.height() == layout.height)
+  using PixelType = typename ImageBase<Derived>::PixelType;
+
+  // The current memory is kept if it has the requested size and room for the requested tail padding; in particular,
+  // in-place operations never lose their source data.
+  if (!force_layout && impl::is_layout_satisfied<PixelType>(img_dst.layout(), layout))
   {
     return false;
   }
@@ -29,7 +49,16 @@ bool allocate(ImageBase<Derived>& img_dst, TypedLayout layout, bool force_layout
   }
   else
   {
-    const bool did_reallocate = img_dst.derived().reallocate(layout, guess_row_alignment(reinterpret_cast<std::uintptr_t>(img_dst.byte_ptr()), img_dst.stride_bytes()), shrink_to_fit);
+    const auto row_alignment_bytes =
+        guess_row_alignment(reinterpret_cast<std::uintptr_t>(img_dst.byte_ptr()), img_dst.stride_bytes());
+
+    // Pad critical strides, according to the stride padding policy
+    const auto stride_bytes = impl::compute_stride_bytes(
+        std::max(layout.stride_bytes, Stride(layout.row_bytes<PixelType>() + layout.tail_padding_bytes)),
+        row_alignment_bytes);
+    layout.stride_bytes = padded_stride_bytes(stride_bytes, row_alignment_bytes);
+
+    const bool did_reallocate = img_dst.derived().reallocate(layout, row_alignment_bytes, shrink_to_fit);
     return did_reallocate;
   }
 }
@@ -0,0 +1,389 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_OPS_BLENDING_HPP
+#define SELENE_IMG_OPS_BLENDING_HPP
+
+/// @file
+
+#include <selene/base/Utils.hpp>
+
+#include <selene/img/common/BoundingBox.hpp>
+#include <selene/img/common/PixelFormat.hpp>
+
+#include <selene/img/pixel/PixelTraits.hpp>
+
+#include <selene/img/typed/ImageBase.hpp>
+
+#include <selene/img_ops/Allocate.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+namespace sln {
+
+/** \brief Alpha compositing operation, applied to images with premultiplied alpha.
+ *
+ * With `s`, `d` denoting (premultiplied) source and destination channel values in [0, 1], and `sa`, `da` the
+ * respective alpha values, the result values are computed as follows (identically for color and alpha channels):
+ */
+enum class BlendMode
+{
+  Over,  ///< Source over destination: `s + d * (1 - sa)`.
+  Add,  ///< Saturating addition: `min(s + d, 1)`.
+  Multiply,  ///< Multiplication: `s * d + s * (1 - da) + d * (1 - sa)`.
+};
+
+template <typename Derived>
+void premultiply_alpha(ImageBase<Derived>& img);
+
+template <typename DerivedSrc, typename DerivedDst>
+void premultiply_alpha(const ImageBase<DerivedSrc>& img_src, ImageBase<DerivedDst>& img_dst);
+
+template <typename Derived>
+void unpremultiply_alpha(ImageBase<Derived>& img);
+
+template <typename DerivedSrc, typename DerivedDst>
+void unpremultiply_alpha(const ImageBase<DerivedSrc>& img_src, ImageBase<DerivedDst>& img_dst);
+
+template <BlendMode mode, typename DerivedSrc, typename DerivedDst>
+void blend(const ImageBase<DerivedSrc>& img_src, ImageBase<DerivedDst>& img_dst);
+
+template <BlendMode mode, typename DerivedSrc, typename DerivedDst>
+void blend(const ImageBase<DerivedSrc>& img_src, ImageBase<DerivedDst>& img_dst, const BoundingBox& region_dst);
+
+// ----------
+// Implementation:
+
+namespace impl {
+
+/** \brief Computes `round(x / 255)` exactly for all values `x` in [0, 255 * 255], without division.
+ *
+ * @param x The value to divide.
+ * @return The rounded quotient.
+ */
+constexpr std::uint32_t div_255(std::uint32_t x) noexcept
+{
+  return (x + 128u + ((x + 128u) >> 8)) >> 8;
+}
+
+/// Fixed-point (8.24) reciprocals used to compute `round(c * 255 / a)` for 8-bit unpremultiplication.
+constexpr auto unpremultiply_lut_8u = make_array_from_function<std::uint64_t, 256>([](std::size_t a) {
+  return (a == 0) ? std::uint64_t{0} : ((std::uint64_t{255} << 24) + a - 1) / a;
+});
+
+template <typename PixelType>
+constexpr std::size_t alpha_channel_index() noexcept
+{
+  constexpr auto pixel_format = PixelTraits<PixelType>::pixel_format;
+  return (pixel_format == PixelFormat::ARGB || pixel_format == PixelFormat::ABGR)
+             ? std::size_t{0}
+             : static_cast<std::size_t>(PixelTraits<PixelType>::nr_channels - 1);
+}
+
+template <typename PixelType>
+constexpr void static_check_alpha_pixel_type()
+{
+  using Element = typename PixelTraits<PixelType>::Element;
+  constexpr auto pixel_format = PixelTraits<PixelType>::pixel_format;
+
+  static_assert(PixelTraits<PixelType>::nr_channels >= 2, "Pixel type needs to have an alpha channel");
+  static_assert(pixel_format == PixelFormat::Unknown || has_alpha_channel(pixel_format),
+                "Pixel type needs to have an alpha channel");
+  static_assert(std::is_same_v<Element, std::uint8_t> || std::is_floating_point_v<Element>,
+                "Alpha compositing is supported for 8-bit unsigned integer or floating point pixel elements");
+}
+
+template <typename PixelTypeSrc, typename PixelTypeDst>
+void premultiply_alpha_row(const PixelTypeSrc* src, PixelTypeDst* dst, std::ptrdiff_t width)
+{
+  using Element = typename PixelTraits<PixelTypeDst>::Element;
+  constexpr auto nr_channels = static_cast<std::size_t>(PixelTraits<PixelTypeDst>::nr_channels);
+  constexpr auto alpha_idx = alpha_channel_index<PixelTypeDst>();
+
+  for (std::ptrdiff_t x = 0; x < width; ++x)
+  {
+    const auto px = src[x];  // copy; allows in-place operation
+
+    for (std::size_t c = 0; c < nr_channels; ++c)  // nr_channels is known at compile time
+    {
+      if constexpr (std::is_integral_v<Element>)
+      {
+        const auto v = (c == alpha_idx) ? std::uint32_t{px[c]} : div_255(std::uint32_t{px[c]} * px[alpha_idx]);
+        dst[x][c] = static_cast<Element>(v);
+      }
+      else
+      {
+        dst[x][c] = (c == alpha_idx) ? px[c] : px[c] * px[alpha_idx];
+      }
+    }
+  }
+}
+
+template <typename PixelTypeSrc, typename PixelTypeDst>
+void unpremultiply_alpha_row(const PixelTypeSrc* src, PixelTypeDst* dst, std::ptrdiff_t width)
+{
+  using Element = typename PixelTraits<PixelTypeDst>::Element;
+  constexpr auto nr_channels = static_cast<std::size_t>(PixelTraits<PixelTypeDst>::nr_channels);
+  constexpr auto alpha_idx = alpha_channel_index<PixelTypeDst>();
+
+  for (std::ptrdiff_t x = 0; x < width; ++x)
+  {
+    const auto px = src[x];  // copy; allows in-place operation
+
+    if constexpr (std::is_integral_v<Element>)
+    {
+      const auto recip = unpremultiply_lut_8u[px[alpha_idx]];
+
+      for (std::size_t c = 0; c < nr_channels; ++c)  // nr_channels is known at compile time
+      {
+        const auto v = (c == alpha_idx) ? std::uint64_t{px[c]} : ((px[c] * recip + (std::uint64_t{1} << 23)) >> 24);
+        dst[x][c] = static_cast<Element>(std::min(v, std::uint64_t{255}));
+      }
+    }
+    else
+    {
+      const auto recip = (px[alpha_idx] == Element{0}) ? Element{0} : Element{1} / px[alpha_idx];
+
+      for (std::size_t c = 0; c < nr_channels; ++c)  // nr_channels is known at compile time
+      {
+        dst[x][c] = (c == alpha_idx) ? px[c] : px[c] * recip;
+      }
+    }
+  }
+}
+
+template <BlendMode mode, typename PixelTypeSrc, typename PixelTypeDst>
+void blend_row(const PixelTypeSrc* src, PixelTypeDst* dst, std::ptrdiff_t width)
+{
+  using Element = typename PixelTraits<PixelTypeDst>::Element;
+  constexpr auto nr_channels = static_cast<std::size_t>(PixelTraits<PixelTypeDst>::nr_channels);
+  constexpr auto alpha_idx = alpha_channel_index<PixelTypeDst>();
+
+  for (std::ptrdiff_t x = 0; x < width; ++x)
+  {
+    const auto s = src[x];
+    const auto d = dst[x];
+
+    for (std::size_t c = 0; c < nr_channels; ++c)  // nr_channels is known at compile time
+    {
+      if constexpr (std::is_integral_v<Element>)
+      {
+        const auto sc = std::uint32_t{s[c]};
+        const auto dc = std::uint32_t{d[c]};
+        const auto sa = std::uint32_t{s[alpha_idx]};
+        const auto da = std::uint32_t{d[alpha_idx]};
+
+        std::uint32_t v = 0;
+        if constexpr (mode == BlendMode::Over)
+        {
+          v = sc + div_255(dc * (255u - sa));
+        }
+        else if constexpr (mode == BlendMode::Add)
+        {
+          v = sc + dc;
+        }
+        else if constexpr (mode == BlendMode::Multiply)
+        {
+          v = div_255(sc * dc + sc * (255u - da) + dc * (255u - sa));
+        }
+
+        dst[x][c] = static_cast<Element>(std::min(v, 255u));
+      }
+      else
+      {
+        const auto sc = s[c];
+        const auto dc = d[c];
+        const auto sa = s[alpha_idx];
+        const auto da = d[alpha_idx];
+
+        if constexpr (mode == BlendMode::Over)
+        {
+          dst[x][c] = sc + dc * (Element{1} - sa);
+        }
+        else if constexpr (mode == BlendMode::Add)
+        {
+          dst[x][c] = std::min(sc + dc, Element{1});
+        }
+        else if constexpr (mode == BlendMode::Multiply)
+        {
+          dst[x][c] = sc * dc + sc * (Element{1} - da) + dc * (Element{1} - sa);
+        }
+      }
+    }
+  }
+}
+
+template <typename DerivedSrc, typename DerivedDst>
+void static_check_blend_compatibility()
+{
+  using PixelTypeSrc = typename ImageBase<DerivedSrc>::PixelType;
+  using PixelTypeDst = typename ImageBase<DerivedDst>::PixelType;
+
+  static_assert(ImageBase<DerivedDst>::is_modifiable, "Destination image needs to be modifiable");
+  static_assert(std::is_same_v<typename PixelTraits<PixelTypeSrc>::Element,
+                               typename PixelTraits<PixelTypeDst>::Element>,
+                "Incompatible source and target pixel types");
+  static_assert(PixelTraits<PixelTypeSrc>::nr_channels == PixelTraits<PixelTypeDst>::nr_channels,
+                "Incompatible source and target pixel types");
+  static_assert(alpha_channel_index<PixelTypeSrc>() == alpha_channel_index<PixelTypeDst>(),
+                "Incompatible source and target pixel types");
+  static_check_alpha_pixel_type<PixelTypeDst>();
+}
+
+}  // namespace impl
+
+/** \brief Premultiplies the color channels of an image by its alpha channel, in-place.
+ *
+ * The alpha channel is assumed to be the first channel for pixel formats `PixelFormat::ARGB` and `PixelFormat::ABGR`,
+ * and the last channel otherwise.
+ * For 8-bit images, each result is computed as the exactly rounded value of `c * a / 255`; for floating point images,
+ * alpha values are expected to be in [0, 1].
+ *
+ * @tparam Derived The typed image type (usually automatically deduced).
+ * @param[in,out] img The image to premultiply.
+ */
+template <typename Derived>
+void premultiply_alpha(ImageBase<Derived>& img)
+{
+  premultiply_alpha(img, img);
+}
+
+/** \brief Premultiplies the color channels of the source image by its alpha channel, and writes the result to the
+ * destination image.
+ *
+ * `allocate` is called on the destination image prior to performing the operation.
+ * See the in-place overload for details.
+ *
+ * @tparam DerivedSrc The typed source image type (usually automatically deduced).
+ * @tparam DerivedDst The typed destination image type (usually automatically deduced).
+ * @param img_src The source image, with non-premultiplied alpha.
+ * @param[out] img_dst The destination image, with premultiplied alpha.
+ */
+template <typename DerivedSrc, typename DerivedDst>
+void premultiply_alpha(const ImageBase<DerivedSrc>& img_src, ImageBase<DerivedDst>& img_dst)
+{
+  impl::static_check_blend_compatibility<DerivedSrc, DerivedDst>();
+
+  allocate(img_dst, img_src.layout());
+
+  for (auto y = 0_idx; y < img_dst.height(); ++y)
+  {
+    impl::premultiply_alpha_row(img_src.data(y), img_dst.data(y), img_dst.width());
+  }
+}
+
+/** \brief Divides the color channels of an image with premultiplied alpha by its alpha channel, in-place.
+ *
+ * Pixels with an alpha value of 0 will have all color channels set to 0.
+ * For 8-bit images, each result is computed as the exactly rounded value of `c * 255 / a`, saturated to 255.
+ *
+ * @tparam Derived The typed image type (usually automatically deduced).
+ * @param[in,out] img The image to unpremultiply.
+ */
+template <typename Derived>
+void unpremultiply_alpha(ImageBase<Derived>& img)
+{
+  unpremultiply_alpha(img, img);
+}
+
+/** \brief Divides the color channels of the source image with premultiplied alpha by its alpha channel, and writes
+ * the result to the destination image.
+ *
+ * `allocate` is called on the destination image prior to performing the operation.
+ * See the in-place overload for details.
+ *
+ * @tparam DerivedSrc The typed source image type (usually automatically deduced).
+ * @tparam DerivedDst The typed destination image type (usually automatically deduced).
+ * @param img_src The source image, with premultiplied alpha.
+ * @param[out] img_dst The destination image, with non-premultiplied alpha.
+ */
+template <typename DerivedSrc, typename DerivedDst>
+void unpremultiply_alpha(const ImageBase<DerivedSrc>& img_src, ImageBase<DerivedDst>& img_dst)
+{
+  impl::static_check_blend_compatibility<DerivedSrc, DerivedDst>();
+
+  allocate(img_dst, img_src.layout());
+
+  for (auto y = 0_idx; y < img_dst.height(); ++y)
+  {
+    impl::unpremultiply_alpha_row(img_src.data(y), img_dst.data(y), img_dst.width());
+  }
+}
+
+/** \brief Composites the source image onto the destination image, using the specified blend mode.
+ *
+ * Both images need to have premultiplied alpha (see `premultiply_alpha`), and have to be of the same size; otherwise,
+ * an exception is thrown.
+ *
+ * @tparam mode The blend mode.
+ * @tparam DerivedSrc The typed source image type (usually automatically deduced).
+ * @tparam DerivedDst The typed destination image type (usually automatically deduced).
+ * @param img_src The source image.
+ * @param[in,out] img_dst The destination image.
+ */
+template <BlendMode mode, typename DerivedSrc, typename DerivedDst>
+void blend(const ImageBase<DerivedSrc>& img_src, ImageBase<DerivedDst>& img_dst)
+{
+  if (img_src.width() != img_dst.width() || img_src.height() != img_dst.height())
+  {
+    throw std::runtime_error("blend: Images are not the same size.");
+  }
+
+  blend<mode>(img_src, img_dst, BoundingBox{0_idx, 0_idx, img_dst.width(), img_dst.height()});
+}
+
+/** \brief Composites the source image onto the specified region of the destination image, using the specified blend
+ * mode.
+ *
+ * Both images need to have premultiplied alpha (see `premultiply_alpha`).
+ * The size of the destination region has to be equal to the size of the source image; otherwise, an exception is
+ * thrown.
+ * The region may extend beyond the bounds of the destination image (e.g. have a negative offset); only the part
+ * overlapping the destination image will be composited.
+ *
+ * @tparam mode The blend mode.
+ * @tparam DerivedSrc The typed source image type (usually automatically deduced).
+ * @tparam DerivedDst The typed destination image type (usually automatically deduced).
+ * @param img_src The source image.
+ * @param[in,out] img_dst The destination image.
+ * @param region_dst The region of the destination image to composite the source image onto.
+ */
+template <BlendMode mode, typename DerivedSrc, typename DerivedDst>
+void blend(const ImageBase<DerivedSrc>& img_src, ImageBase<DerivedDst>& img_dst, const BoundingBox& region_dst)
+{
+  impl::static_check_blend_compatibility<DerivedSrc, DerivedDst>();
+
+  if (region_dst.width() != img_src.width() || region_dst.height() != img_src.height())
+  {
+    throw std::runtime_error("blend: Source image size does not match size of destination region.");
+  }
+
+  // Clip the destination region to the destination image bounds
+  const auto x0 = std::max(PixelIndex{region_dst.x0()}, 0_idx);
+  const auto y0 = std::max(PixelIndex{region_dst.y0()}, 0_idx);
+  const auto x1 = std::min(PixelIndex{region_dst.x1()}, PixelIndex{img_dst.width()});
+  const auto y1 = std::min(PixelIndex{region_dst.y1()}, PixelIndex{img_dst.height()});
+
+  if (x0 >= x1 || y0 >= y1)
+  {
+    return;
+  }
+
+  const auto src_x0 = PixelIndex{x0 - region_dst.x0()};
+  const auto width = std::ptrdiff_t{x1 - x0};
+
+  for (auto y = y0; y < y1; ++y)
+  {
+    const auto src_y = PixelIndex{y - region_dst.y0()};
+    impl::blend_row<mode>(img_src.data(src_x0, src_y), img_dst.data(x0, y), width);
+  }
+}
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_OPS_BLENDING_HPP
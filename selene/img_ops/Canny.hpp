@@ -0,0 +1,320 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_OPS_CANNY_HPP
+#define SELENE_IMG_OPS_CANNY_HPP
+
+/// @file
+
+#include <selene/base/ExecutionPolicy.hpp>
+
+#include <selene/img/common/Types.hpp>
+
+#include <selene/img/pixel/PixelTraits.hpp>
+
+#include <selene/img/typed/ImageBase.hpp>
+
+#include <selene/img_ops/Algorithms.hpp>
+#include <selene/img_ops/Allocate.hpp>
+#include <selene/img_ops/Gradients.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace sln {
+
+// ----------
+// Implementation:
+
+namespace impl {
+
+/// Edge map states during non-maximum suppression and hysteresis.
+enum CannyState : std::uint8_t
+{
+  canny_none = 0,  ///< Not an edge.
+  canny_weak = 1,  ///< Local maximum above the low threshold; edge if connected to a strong edge.
+  canny_strong = 2,  ///< Local maximum above the high threshold; always an edge.
+};
+
+/// Gradient direction, quantized to one of four sectors.
+enum CannySector : std::uint8_t
+{
+  canny_horizontal = 0,  ///< Gradient along x; compare with left and right neighbors.
+  canny_vertical = 1,  ///< Gradient along y; compare with upper and lower neighbors.
+  canny_diagonal_pos = 2,  ///< Gradient along (1, 1); compare with upper left and lower right neighbors.
+  canny_diagonal_neg = 3,  ///< Gradient along (1, -1); compare with upper right and lower left neighbors.
+};
+
+/** \brief Quantizes the gradient direction (dx, dy) into one of four sectors, without trigonometric functions.
+ *
+ * The comparisons against tan(22.5°) and tan(67.5°) are performed in 15-bit fixed point, and are branch-free.
+ * The absolute derivative values of 3x3 Sobel and Scharr kernels on 8-bit images fit into 12 bits, so none of the
+ * intermediate values overflow.
+ */
+inline std::uint8_t canny_sector(std::int32_t dx, std::int32_t dy) noexcept
+{
+  constexpr std::int32_t tan_22_5 = 13573;  // round(tan(22.5°) * 2^15)
+  const auto ax = std::abs(dx);
+  const auto ay = std::abs(dy) << 15;
+  const auto tg22x = ax * tan_22_5;
+  const auto tg67x = tg22x + (ax << 16);  // tan(67.5°) = tan(22.5°) + 2
+  const auto diagonal = static_cast<std::uint8_t>(canny_diagonal_pos + ((dx ^ dy) < 0));
+  const auto steep = (ay > tg67x) ? std::uint8_t{canny_vertical} : diagonal;
+  return (ay < tg22x) ? std::uint8_t{canny_horizontal} : steep;
+}
+
+/** \brief Fused gradient pass: computes squared gradient magnitudes and direction sectors for rows [y_begin, y_end).
+ *
+ * The magnitude buffer is padded by one pixel on each side, with the padding being zero.
+ */
+template <GradientKernel kernel, typename DerivedSrc>
+void canny_gradient_rows(const ImageBase<DerivedSrc>& img_src,
+                         std::ptrdiff_t y_begin,
+                         std::ptrdiff_t y_end,
+                         std::int32_t* magnitude,
+                         std::uint8_t* sector)
+{
+  const auto width = static_cast<std::ptrdiff_t>(img_src.width());
+  const auto height = static_cast<std::ptrdiff_t>(img_src.height());
+  const auto padded = static_cast<std::size_t>(width + 2);
+  const auto stride = width + 2;
+
+  std::vector<std::int16_t> rows(3 * padded), smooth(padded), diff(padded);
+  std::vector<std::int16_t> dx(static_cast<std::size_t>(width)), dy(static_cast<std::size_t>(width));
+
+  for (auto y = y_begin; y < y_end; ++y)
+  {
+    for (std::ptrdiff_t i = 0; i < 3; ++i)
+    {
+      const auto ys = std::min(std::max(y + i - 1, std::ptrdiff_t{0}), height - 1);
+      const auto src = img_src.data(to_row_index(ys));
+      auto row = rows.data() + static_cast<std::size_t>(i) * padded;
+
+      for (std::ptrdiff_t x = 0; x < width; ++x)
+      {
+        row[x + 1] = static_cast<std::int16_t>(get_channel(src[x], 0));
+      }
+
+      row[0] = row[1];
+      row[width + 1] = row[width];
+    }
+
+    gradient_row<kernel>(rows.data(), rows.data() + padded, rows.data() + 2 * padded, smooth.data(), diff.data(),
+                         dx.data(), dy.data(), width);
+
+    auto mag_row = magnitude + (y + 1) * stride + 1;
+    auto sector_row = sector + (y + 1) * stride + 1;
+
+    SELENE_VECTORIZE_LOOP
+    for (std::ptrdiff_t x = 0; x < width; ++x)
+    {
+      const auto gx = std::int32_t{dx[static_cast<std::size_t>(x)]};
+      const auto gy = std::int32_t{dy[static_cast<std::size_t>(x)]};
+      mag_row[x] = gx * gx + gy * gy;
+      sector_row[x] = canny_sector(gx, gy);
+    }
+  }
+}
+
+/** \brief Non-maximum suppression and double thresholding for rows [y_begin, y_end).
+ *
+ * A pixel is kept if its magnitude exceeds the low threshold and it is a maximum along the gradient direction (strictly
+ * greater than the first neighbor, and not less than the second one, to break ties on plateaus).
+ */
+inline void canny_non_maximum_suppression(const std::int32_t* magnitude,
+                                          const std::uint8_t* sector,
+                                          std::uint8_t* edges,
+                                          std::ptrdiff_t width,
+                                          std::ptrdiff_t y_begin,
+                                          std::ptrdiff_t y_end,
+                                          std::int64_t low_sq,
+                                          std::int64_t high_sq)
+{
+  const auto stride = width + 2;
+  const std::ptrdiff_t offsets[4] = {1, stride, stride + 1, stride - 1};
+
+  for (auto y = y_begin; y < y_end; ++y)
+  {
+    const auto row_offset = (y + 1) * stride + 1;
+
+    for (std::ptrdiff_t x = 0; x < width; ++x)
+    {
+      // Evaluated without branches, since the outcome is hard to predict on textured images
+      const auto idx = row_offset + x;
+      const auto m = std::int64_t{magnitude[idx]};
+      const auto off = offsets[sector[idx]];
+      const auto is_maximum = (m > low_sq) & (m > magnitude[idx - off]) & (m >= magnitude[idx + off]);
+      edges[idx] = static_cast<std::uint8_t>(is_maximum * (canny_weak + (m > high_sq)));
+    }
+  }
+}
+
+/** \brief Hysteresis: promotes all weak edge pixels connected (8-neighborhood) to strong ones, using an explicit stack.
+ *
+ * The edge map is padded by one pixel of `canny_none`, so that neighbors can be accessed without bounds checks.
+ */
+inline void canny_hysteresis(std::uint8_t* edges, std::ptrdiff_t width, std::ptrdiff_t height)
+{
+  const auto stride = width + 2;
+  const std::ptrdiff_t neighbors[8] = {-stride - 1, -stride, -stride + 1, -1, 1, stride - 1, stride, stride + 1};
+  std::vector<std::ptrdiff_t> stack;
+
+  for (std::ptrdiff_t y = 0; y < height; ++y)
+  {
+    const auto row_offset = (y + 1) * stride + 1;
+
+    for (std::ptrdiff_t x = 0; x < width; ++x)
+    {
+      if (edges[row_offset + x] != canny_strong)
+      {
+        continue;
+      }
+
+      stack.push_back(row_offset + x);
+
+      while (!stack.empty())
+      {
+        const auto idx = stack.back();
+        stack.pop_back();
+
+        for (const auto n : neighbors)
+        {
+          if (edges[idx + n] == canny_weak)
+          {
+            edges[idx + n] = canny_strong;
+            stack.push_back(idx + n);
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace impl
+
+/** \brief Detects edges in a single-channel 8-bit image using the Canny edge detector, according to the specified
+ * execution policy.
+ *
+ * The pipeline consists of
+ * - a fused gradient pass (3x3 Sobel or Scharr derivatives, squared L2 magnitude and quantized direction),
+ * - non-maximum suppression along the gradient direction with double thresholding,
+ * - hysteresis, which keeps weak edges (above `low_threshold`) only if they are connected to strong edges (above
+ *   `high_threshold`).
+ *
+ * The first two stages run in parallel by row bands; hysteresis uses an explicit stack on a padded edge map.
+ * No prior smoothing is performed.
+ *
+ * `allocate` is called on the destination image prior to performing the operation. The output contains 255 for edge
+ * pixels, and 0 otherwise.
+ *
+ * @tparam kernel The derivative kernel.
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam DerivedSrc The typed source image type; single-channel with 8-bit unsigned elements (e.g. `Image_8u1`).
+ * @tparam DerivedDst The typed destination image type; single-channel with 8-bit unsigned elements.
+ * @param policy The execution policy.
+ * @param img_src The source image.
+ * @param[out] img_dst The binary edge image.
+ * @param low_threshold The low threshold on the (L2) gradient magnitude.
+ * @param high_threshold The high threshold on the (L2) gradient magnitude.
+ */
+template <GradientKernel kernel = GradientKernel::Sobel,
+          typename ExecutionPolicy,
+          typename DerivedSrc,
+          typename DerivedDst,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+void canny(ExecutionPolicy&& policy,
+           const ImageBase<DerivedSrc>& img_src,
+           ImageBase<DerivedDst>& img_dst,
+           double low_threshold,
+           double high_threshold)
+{
+  using PixelTypeSrc = typename ImageBase<DerivedSrc>::PixelType;
+  using PixelTypeDst = typename ImageBase<DerivedDst>::PixelType;
+  static_assert(std::is_same_v<typename PixelTraits<PixelTypeSrc>::Element, std::uint8_t>
+                    && PixelTraits<PixelTypeSrc>::nr_channels == 1,
+                "Canny edge detection is only supported for single-channel 8-bit unsigned integral images");
+  static_assert(std::is_same_v<typename PixelTraits<PixelTypeDst>::Element, std::uint8_t>
+                    && PixelTraits<PixelTypeDst>::nr_channels == 1,
+                "The Canny edge image needs to be a single-channel 8-bit unsigned integral image");
+
+  if (low_threshold < 0.0 || low_threshold > high_threshold)
+  {
+    throw std::runtime_error("canny: Invalid thresholds.");
+  }
+
+  allocate(img_dst, TypedLayout{img_src.width(), img_src.height()});
+
+  const auto width = static_cast<std::ptrdiff_t>(img_src.width());
+  const auto height = static_cast<std::ptrdiff_t>(img_src.height());
+
+  if (width == 0 || height == 0)
+  {
+    return;
+  }
+
+  // Squared thresholds, to compare against squared magnitudes; rounded down, since the comparisons are strict
+  const auto low_sq = static_cast<std::int64_t>(std::floor(low_threshold * low_threshold));
+  const auto high_sq = static_cast<std::int64_t>(std::floor(high_threshold * high_threshold));
+
+  const auto padded_size = static_cast<std::size_t>((width + 2) * (height + 2));
+  std::vector<std::int32_t> magnitude(padded_size, 0);
+  std::vector<std::uint8_t> sector(padded_size, 0);
+  std::vector<std::uint8_t> edges(padded_size, impl::canny_none);
+  const auto grain_size = impl::row_grain_size(width);
+
+  impl::parallel_for(policy, 0, height, grain_size, [&](std::ptrdiff_t y_begin, std::ptrdiff_t y_end) {
+    impl::canny_gradient_rows<kernel>(img_src, y_begin, y_end, magnitude.data(), sector.data());
+  });
+
+  impl::parallel_for(policy, 0, height, grain_size, [&](std::ptrdiff_t y_begin, std::ptrdiff_t y_end) {
+    impl::canny_non_maximum_suppression(magnitude.data(), sector.data(), edges.data(), width, y_begin, y_end, low_sq,
+                                        high_sq);
+  });
+
+  impl::canny_hysteresis(edges.data(), width, height);
+
+  impl::parallel_for(policy, 0, height, grain_size, [&](std::ptrdiff_t y_begin, std::ptrdiff_t y_end) {
+    for (auto y = y_begin; y < y_end; ++y)
+    {
+      const auto edges_row = edges.data() + (y + 1) * (width + 2) + 1;
+      auto dst = img_dst.data(impl::to_row_index(y));
+
+      SELENE_VECTORIZE_LOOP
+      for (std::ptrdiff_t x = 0; x < width; ++x)
+      {
+        impl::get_channel(dst[x], 0) = static_cast<std::uint8_t>((edges_row[x] >> 1) * 255);  // strong -> 255
+      }
+    }
+  });
+}
+
+/** \brief Detects edges in a single-channel 8-bit image using the Canny edge detector.
+ *
+ * See the overload accepting an execution policy for details.
+ *
+ * @tparam kernel The derivative kernel.
+ * @tparam DerivedSrc The typed source image type; single-channel with 8-bit unsigned elements (e.g. `Image_8u1`).
+ * @tparam DerivedDst The typed destination image type; single-channel with 8-bit unsigned elements.
+ * @param img_src The source image.
+ * @param[out] img_dst The binary edge image.
+ * @param low_threshold The low threshold on the (L2) gradient magnitude.
+ * @param high_threshold The high threshold on the (L2) gradient magnitude.
+ */
+template <GradientKernel kernel = GradientKernel::Sobel, typename DerivedSrc, typename DerivedDst>
+void canny(const ImageBase<DerivedSrc>& img_src,
+           ImageBase<DerivedDst>& img_dst,
+           double low_threshold,
+           double high_threshold)
+{
+  canny<kernel>(execution::seq, img_src, img_dst, low_threshold, high_threshold);
+}
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_OPS_CANNY_HPP
@@ -0,0 +1,305 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_OPS_CLAHE_HPP
+#define SELENE_IMG_OPS_CLAHE_HPP
+
+/// @file
+
+#include <selene/base/ExecutionPolicy.hpp>
+
+#include <selene/img/common/Types.hpp>
+
+#include <selene/img/pixel/PixelTraits.hpp>
+
+#include <selene/img/typed/ImageBase.hpp>
+
+#include <selene/img_ops/Algorithms.hpp>
+#include <selene/img_ops/Allocate.hpp>
+#include <selene/img_ops/Histogram.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace sln {
+
+// ----------
+// Implementation:
+
+namespace impl {
+
+/// Geometry of the tile grid used by CLAHE, along one image dimension.
+struct ClaheTiling
+{
+  std::ptrdiff_t nr_tiles;
+  std::ptrdiff_t tile_size;
+
+  ClaheTiling(std::ptrdiff_t length, std::ptrdiff_t requested_nr_tiles)
+  {
+    const auto n = std::max(std::ptrdiff_t{1}, std::min(requested_nr_tiles, length));
+    tile_size = std::max(std::ptrdiff_t{1}, (length + n - 1) / n);
+    nr_tiles = std::max(std::ptrdiff_t{1}, (length + tile_size - 1) / tile_size);  // no empty tiles at the end
+  }
+};
+
+/// Per-position interpolation parameters: the two neighboring tiles, and the fixed-point weight of the second one.
+struct ClaheInterpolation
+{
+  std::ptrdiff_t tile_0;
+  std::ptrdiff_t tile_1;
+  std::uint32_t weight_1;
+};
+
+template <int frac_bits>
+std::vector<ClaheInterpolation> clahe_interpolation(std::ptrdiff_t length, const ClaheTiling& tiling)
+{
+  std::vector<ClaheInterpolation> params(static_cast<std::size_t>(length));
+  const auto inv_tile_size = 1.0 / static_cast<double>(tiling.tile_size);
+
+  for (std::ptrdiff_t i = 0; i < length; ++i)
+  {
+    // Position relative to the tile centers
+    const auto t = static_cast<double>(i) * inv_tile_size - 0.5;
+    const auto t_0 = static_cast<std::ptrdiff_t>(std::floor(t));
+    const auto w_1 = t - static_cast<double>(t_0);
+
+    auto& p = params[static_cast<std::size_t>(i)];
+    p.tile_0 = std::max(t_0, std::ptrdiff_t{0});
+    p.tile_1 = std::min(t_0 + 1, tiling.nr_tiles - 1);
+    p.weight_1 = static_cast<std::uint32_t>(std::lround(w_1 * double(1 << frac_bits)));
+  }
+
+  return params;
+}
+
+/** \brief Computes the clipped histogram of one tile, and from its CDF the tile's mapping (LUT).
+ */
+template <typename Element, typename DerivedSrc>
+void clahe_tile_lut(const ImageBase<DerivedSrc>& img,
+                    std::ptrdiff_t x0,
+                    std::ptrdiff_t y0,
+                    std::ptrdiff_t x1,
+                    std::ptrdiff_t y1,
+                    double clip_limit,
+                    std::vector<std::uint64_t>& hist_buffer,
+                    Element* lut)
+{
+  constexpr std::size_t nr_bins = nr_histogram_values<Element>;
+  // Interleaved sub-histograms pay off for 8-bit values only; for 16-bit values they would not fit into the cache.
+  constexpr std::size_t nr_sub_histograms = (nr_bins <= 256) ? 4 : 1;
+
+  hist_buffer.assign(nr_sub_histograms * nr_bins, 0);
+
+  for (auto y = y0; y < y1; ++y)
+  {
+    add_to_sub_histograms<nr_bins, nr_sub_histograms>(img.data(to_row_index(y)) + x0, x1 - x0, 0,
+                                                      hist_buffer.data());
+  }
+
+  for (std::size_t s = 1; s < nr_sub_histograms; ++s)
+  {
+    for (std::size_t b = 0; b < nr_bins; ++b)
+    {
+      hist_buffer[b] += hist_buffer[s * nr_bins + b];
+    }
+  }
+
+  auto* hist = hist_buffer.data();
+  const auto tile_area = static_cast<std::uint64_t>((x1 - x0) * (y1 - y0));
+
+  // Clip the histogram, and redistribute the clipped counts uniformly over all bins.
+  if (clip_limit > 0.0)
+  {
+    const auto clip = std::max(std::uint64_t{1},
+                               static_cast<std::uint64_t>(clip_limit * static_cast<double>(tile_area) / nr_bins));
+    std::uint64_t nr_clipped = 0;
+
+    for (std::size_t b = 0; b < nr_bins; ++b)
+    {
+      if (hist[b] > clip)
+      {
+        nr_clipped += hist[b] - clip;
+        hist[b] = clip;
+      }
+    }
+
+    const auto batch = nr_clipped / nr_bins;
+    auto residual = nr_clipped - batch * nr_bins;
+
+    for (std::size_t b = 0; b < nr_bins; ++b)
+    {
+      hist[b] += batch;
+    }
+
+    const auto step = std::max(std::size_t{1}, nr_bins / std::max(std::size_t{1}, static_cast<std::size_t>(residual)));
+    for (std::size_t b = 0; b < nr_bins && residual > 0; b += step, --residual)
+    {
+      ++hist[b];
+    }
+  }
+
+  // The mapping is the scaled CDF of the clipped histogram.
+  const auto scale = static_cast<double>(nr_bins - 1) / static_cast<double>(tile_area);
+  std::uint64_t cdf = 0;
+
+  for (std::size_t b = 0; b < nr_bins; ++b)
+  {
+    cdf += hist[b];
+    const auto v = std::lround(static_cast<double>(cdf) * scale);
+    lut[b] = static_cast<Element>(std::min(v, static_cast<long>(nr_bins - 1)));
+  }
+}
+
+}  // namespace impl
+
+/** \brief Performs contrast-limited adaptive histogram equalization (CLAHE) on a single-channel image, according to
+ * the specified execution policy.
+ *
+ * The image is divided into a grid of `nr_tiles_x * nr_tiles_y` tiles. For each tile, the histogram is computed and
+ * clipped at `clip_limit` times the average bin count (the clipped counts are redistributed over all bins); the CDF
+ * of the clipped histogram yields a lookup table for the tile. Each output pixel is then computed by bilinear
+ * interpolation (with fixed-point weights) between the mappings of the four nearest tiles.
+ *
+ * With a parallel execution policy, the tile mappings are computed in parallel, as are bands of output rows.
+ *
+ * `allocate` is called on the destination image prior to performing the operation.
+ *
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam DerivedSrc The typed source image type; single-channel, with 8-bit or 16-bit unsigned integer elements
+ *                    (e.g. `Image_8u1` or `Image_16u1`).
+ * @tparam DerivedDst The typed destination image type; of the same pixel type as the source.
+ * @param policy The execution policy.
+ * @param img_src The source image.
+ * @param[out] img_dst The destination image.
+ * @param clip_limit The contrast limit, relative to the average bin count. A value <= 0 disables clipping.
+ * @param nr_tiles_x The number of tiles in x-direction.
+ * @param nr_tiles_y The number of tiles in y-direction.
+ */
+template <typename ExecutionPolicy,
+          typename DerivedSrc,
+          typename DerivedDst,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+void clahe(ExecutionPolicy&& policy,
+           const ImageBase<DerivedSrc>& img_src,
+           ImageBase<DerivedDst>& img_dst,
+           double clip_limit = 40.0,
+           PixelLength nr_tiles_x = PixelLength{8},
+           PixelLength nr_tiles_y = PixelLength{8})
+{
+  using PixelType = typename ImageBase<DerivedSrc>::PixelType;
+  using Element = typename PixelTraits<PixelType>::Element;
+  impl::static_check_histogram_pixel_type<PixelType>();
+  static_assert(PixelTraits<PixelType>::nr_channels == 1, "CLAHE requires a single-channel image");
+  static_assert(std::is_same_v<typename ImageBase<DerivedDst>::PixelType, PixelType>,
+                "Source and destination images need to have the same pixel type");
+
+  if (nr_tiles_x <= 0 || nr_tiles_y <= 0)
+  {
+    throw std::runtime_error("clahe: Invalid number of tiles.");
+  }
+
+  allocate(img_dst, TypedLayout{img_src.width(), img_src.height()});
+
+  const auto width = static_cast<std::ptrdiff_t>(img_src.width());
+  const auto height = static_cast<std::ptrdiff_t>(img_src.height());
+
+  if (width == 0 || height == 0)
+  {
+    return;
+  }
+
+  constexpr auto nr_bins = static_cast<std::ptrdiff_t>(impl::nr_histogram_values<Element>);
+  const impl::ClaheTiling tiling_x(width, static_cast<std::ptrdiff_t>(nr_tiles_x));
+  const impl::ClaheTiling tiling_y(height, static_cast<std::ptrdiff_t>(nr_tiles_y));
+  const auto nr_tiles = tiling_x.nr_tiles * tiling_y.nr_tiles;
+
+  // 1. Compute the mapping of each tile.
+  std::vector<Element> luts(static_cast<std::size_t>(nr_tiles * nr_bins));
+
+  impl::parallel_for(policy, 0, nr_tiles, 1, [&](std::ptrdiff_t tile_begin, std::ptrdiff_t tile_end) {
+    std::vector<std::uint64_t> hist_buffer;
+
+    for (auto tile = tile_begin; tile < tile_end; ++tile)
+    {
+      const auto tx = tile % tiling_x.nr_tiles;
+      const auto ty = tile / tiling_x.nr_tiles;
+      const auto x0 = tx * tiling_x.tile_size;
+      const auto y0 = ty * tiling_y.tile_size;
+      const auto x1 = std::min(x0 + tiling_x.tile_size, width);
+      const auto y1 = std::min(y0 + tiling_y.tile_size, height);
+      impl::clahe_tile_lut(img_src, x0, y0, x1, y1, clip_limit, hist_buffer, luts.data() + tile * nr_bins);
+    }
+  });
+
+  // 2. Bilinearly interpolate between the mappings of the four nearest tiles, with fixed-point weights.
+  // The interpolated value (times the squared weight scale) needs to fit into the accumulator type.
+  using Acc = std::conditional_t<sizeof(Element) == 1, std::uint32_t, std::uint64_t>;
+  constexpr int frac_bits = (sizeof(Element) == 1) ? 11 : 14;
+  constexpr Acc one = Acc{1} << frac_bits;
+  constexpr Acc rounding = Acc{1} << (2 * frac_bits - 1);
+
+  const auto interp_x = impl::clahe_interpolation<frac_bits>(width, tiling_x);
+  const auto interp_y = impl::clahe_interpolation<frac_bits>(height, tiling_y);
+
+  impl::parallel_for(policy, 0, height, impl::row_grain_size(width), [&](std::ptrdiff_t y_begin, std::ptrdiff_t y_end) {
+    for (auto y = y_begin; y < y_end; ++y)
+    {
+      const auto& iy = interp_y[static_cast<std::size_t>(y)];
+      const auto wy_1 = Acc{iy.weight_1};
+      const auto wy_0 = one - wy_1;
+      const Element* lut_row_0 = luts.data() + iy.tile_0 * tiling_x.nr_tiles * nr_bins;
+      const Element* lut_row_1 = luts.data() + iy.tile_1 * tiling_x.nr_tiles * nr_bins;
+
+      const auto row = impl::to_row_index(y);
+      const auto src = img_src.data(row);
+      auto dst = img_dst.data(row);
+
+      for (std::ptrdiff_t x = 0; x < width; ++x)
+      {
+        const auto& ix = interp_x[static_cast<std::size_t>(x)];
+        const auto wx_1 = Acc{ix.weight_1};
+        const auto wx_0 = one - wx_1;
+        const auto v = static_cast<std::ptrdiff_t>(impl::get_channel(src[x], 0));
+        const auto offset_0 = ix.tile_0 * nr_bins + v;
+        const auto offset_1 = ix.tile_1 * nr_bins + v;
+
+        const auto top = Acc{lut_row_0[offset_0]} * wx_0 + Acc{lut_row_0[offset_1]} * wx_1;
+        const auto bottom = Acc{lut_row_1[offset_0]} * wx_0 + Acc{lut_row_1[offset_1]} * wx_1;
+        impl::get_channel(dst[x], 0) = static_cast<Element>((top * wy_0 + bottom * wy_1 + rounding) >> (2 * frac_bits));
+      }
+    }
+  });
+}
+
+/** \brief Performs contrast-limited adaptive histogram equalization (CLAHE) on a single-channel image.
+ *
+ * See the overload accepting an execution policy for details.
+ *
+ * @tparam DerivedSrc The typed source image type; single-channel, with 8-bit or 16-bit unsigned integer elements
+ *                    (e.g. `Image_8u1` or `Image_16u1`).
+ * @tparam DerivedDst The typed destination image type; of the same pixel type as the source.
+ * @param img_src The source image.
+ * @param[out] img_dst The destination image.
+ * @param clip_limit The contrast limit, relative to the average bin count. A value <= 0 disables clipping.
+ * @param nr_tiles_x The number of tiles in x-direction.
+ * @param nr_tiles_y The number of tiles in y-direction.
+ */
+template <typename DerivedSrc, typename DerivedDst>
+void clahe(const ImageBase<DerivedSrc>& img_src,
+           ImageBase<DerivedDst>& img_dst,
+           double clip_limit = 40.0,
+           PixelLength nr_tiles_x = PixelLength{8},
+           PixelLength nr_tiles_y = PixelLength{8})
+{
+  clahe(execution::seq, img_src, img_dst, clip_limit, nr_tiles_x, nr_tiles_y);
+}
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_OPS_CLAHE_HPP
@@ -0,0 +1,584 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_OPS_CONNECTED_COMPONENTS_HPP
+#define SELENE_IMG_OPS_CONNECTED_COMPONENTS_HPP
+
+/// @file
+
+#include <selene/base/ExecutionPolicy.hpp>
+
+#include <selene/img/common/BoundingBox.hpp>
+#include <selene/img/common/Types.hpp>
+
+#include <selene/img/pixel/PixelTraits.hpp>
+
+#include <selene/img/typed/ImageBase.hpp>
+
+#include <selene/img_ops/Algorithms.hpp>
+#include <selene/img_ops/Allocate.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace sln {
+
+/// Pixel neighborhood used to decide whether two foreground pixels are connected.
+enum class Connectivity
+{
+  Four,  ///< Horizontal and vertical neighbors.
+  Eight,  ///< Horizontal, vertical and diagonal neighbors.
+};
+
+/// Statistics of one connected component.
+struct ComponentStats
+{
+  std::size_t area;  ///< Number of pixels.
+  BoundingBox bounding_box;  ///< Tightest axis-aligned box containing all pixels.
+  double centroid_x;  ///< Mean x-coordinate of all pixels.
+  double centroid_y;  ///< Mean y-coordinate of all pixels.
+};
+
+// ----------
+// Implementation:
+
+namespace impl {
+
+/// Union-find over provisional labels; each parent is never larger than its child, which makes flattening a single
+/// linear sweep.
+class LabelEquivalences
+{
+public:
+  explicit LabelEquivalences(std::size_t nr_labels) : parents_(nr_labels)
+  {
+    for (std::size_t i = 0; i < nr_labels; ++i)
+    {
+      parents_[i] = static_cast<std::int32_t>(i);
+    }
+  }
+
+  std::int32_t merge(std::int32_t i, std::int32_t j) noexcept
+  {
+    auto root = find_root(i);
+
+    if (i != j)
+    {
+      root = std::min(root, find_root(j));
+      set_root(j, root);
+    }
+
+    set_root(i, root);
+    return root;
+  }
+
+  /// Maps each used provisional label range [begin, end) to consecutive final labels, starting from `next_label`.
+  std::int32_t flatten(std::int32_t begin, std::int32_t end, std::int32_t next_label) noexcept
+  {
+    for (auto i = begin; i < end; ++i)
+    {
+      auto& p = parents_[static_cast<std::size_t>(i)];
+      p = (p < i) ? parents_[static_cast<std::size_t>(p)] : next_label++;
+    }
+
+    return next_label;
+  }
+
+  std::int32_t operator[](std::int32_t i) const noexcept { return parents_[static_cast<std::size_t>(i)]; }
+
+private:
+  std::vector<std::int32_t> parents_;
+
+  std::int32_t find_root(std::int32_t i) const noexcept
+  {
+    while (parents_[static_cast<std::size_t>(i)] < i)
+    {
+      i = parents_[static_cast<std::size_t>(i)];
+    }
+
+    return i;
+  }
+
+  void set_root(std::int32_t i, std::int32_t root) noexcept
+  {
+    while (parents_[static_cast<std::size_t>(i)] < i)
+    {
+      const auto j = parents_[static_cast<std::size_t>(i)];
+      parents_[static_cast<std::size_t>(i)] = root;
+      i = j;
+    }
+
+    parents_[static_cast<std::size_t>(i)] = root;
+  }
+};
+
+/// Merges the label of the current pixel (or block) with the label of a neighbor; zero denotes background.
+inline std::int32_t merge_labels(LabelEquivalences& eq, std::int32_t label, std::int32_t neighbor_label) noexcept
+{
+  if (neighbor_label == 0)
+  {
+    return label;
+  }
+
+  return (label == 0) ? neighbor_label : eq.merge(label, neighbor_label);
+}
+
+template <typename PixelType>
+inline bool is_foreground(const PixelType& px) noexcept
+{
+  return get_channel(px, 0) != 0;
+}
+
+/** \brief First pass for 8-connectivity, on 2x2 blocks of the rows [y_begin, y_end).
+ *
+ * Each block receives a single provisional label, which is written to all of its foreground pixels. With the block
+ * pixels being a = (x, y), b = (x+1, y), c = (x, y+1), d = (x+1, y+1), the block is connected to the block on the left
+ * if a or c touch its right column, to the block above if a or b touch its bottom row, and to the diagonal blocks via
+ * the single corner pixels next to a and b, respectively.
+ * Neighbors above y_begin are not considered here; they are merged after all strips have been labeled.
+ */
+template <typename DerivedSrc, typename DerivedDst>
+std::int32_t label_blocks_8(const ImageBase<DerivedSrc>& img_mask,
+                            ImageBase<DerivedDst>& img_labels,
+                            std::ptrdiff_t y_begin,
+                            std::ptrdiff_t y_end,
+                            std::int32_t next_label,
+                            LabelEquivalences& eq)
+{
+  const auto width = static_cast<std::ptrdiff_t>(img_mask.width());
+
+  for (auto y = y_begin; y < y_end; y += 2)
+  {
+    const bool has_row_1 = (y + 1 < y_end);
+    const auto mask_0 = img_mask.data(to_row_index(y));
+    const auto mask_1 = has_row_1 ? img_mask.data(to_row_index(y + 1)) : nullptr;
+    auto lbl_0 = img_labels.data(to_row_index(y));
+    auto lbl_1 = has_row_1 ? img_labels.data(to_row_index(y + 1)) : nullptr;
+    const auto lbl_above = (y > y_begin) ? img_labels.data(to_row_index(y - 1)) : nullptr;
+
+    const auto above = [&](std::ptrdiff_t x) {
+      return (lbl_above != nullptr && x >= 0 && x < width) ? get_channel(lbl_above[x], 0) : std::int32_t{0};
+    };
+
+    for (std::ptrdiff_t x = 0; x < width; x += 2)
+    {
+      const bool has_col_1 = (x + 1 < width);
+      const bool a = is_foreground(mask_0[x]);
+      const bool b = has_col_1 && is_foreground(mask_0[x + 1]);
+      const bool c = has_row_1 && is_foreground(mask_1[x]);
+      const bool d = has_row_1 && has_col_1 && is_foreground(mask_1[x + 1]);
+
+      std::int32_t label = 0;
+
+      if (a || b || c || d)
+      {
+        if ((a || c) && x > 0)
+        {
+          const auto left_0 = get_channel(lbl_0[x - 1], 0);
+          const auto left_1 = has_row_1 ? get_channel(lbl_1[x - 1], 0) : std::int32_t{0};
+          label = merge_labels(eq, label, (left_0 != 0) ? left_0 : left_1);
+        }
+
+        if (a || b)
+        {
+          const auto above_0 = above(x);
+          label = merge_labels(eq, label, (above_0 != 0) ? above_0 : above(x + 1));
+        }
+
+        if (a)
+        {
+          label = merge_labels(eq, label, above(x - 1));
+        }
+
+        if (b)
+        {
+          label = merge_labels(eq, label, above(x + 2));
+        }
+
+        if (label == 0)
+        {
+          label = next_label++;
+        }
+      }
+
+      get_channel(lbl_0[x], 0) = a ? label : 0;
+      if (has_col_1)
+      {
+        get_channel(lbl_0[x + 1], 0) = b ? label : 0;
+      }
+
+      if (has_row_1)
+      {
+        get_channel(lbl_1[x], 0) = c ? label : 0;
+        if (has_col_1)
+        {
+          get_channel(lbl_1[x + 1], 0) = d ? label : 0;
+        }
+      }
+    }
+  }
+
+  return next_label;
+}
+
+/// First pass for 4-connectivity, pixel by pixel, on the rows [y_begin, y_end).
+template <typename DerivedSrc, typename DerivedDst>
+std::int32_t label_pixels_4(const ImageBase<DerivedSrc>& img_mask,
+                            ImageBase<DerivedDst>& img_labels,
+                            std::ptrdiff_t y_begin,
+                            std::ptrdiff_t y_end,
+                            std::int32_t next_label,
+                            LabelEquivalences& eq)
+{
+  const auto width = static_cast<std::ptrdiff_t>(img_mask.width());
+
+  for (auto y = y_begin; y < y_end; ++y)
+  {
+    const auto mask = img_mask.data(to_row_index(y));
+    auto lbl = img_labels.data(to_row_index(y));
+    const auto lbl_above = (y > y_begin) ? img_labels.data(to_row_index(y - 1)) : nullptr;
+
+    for (std::ptrdiff_t x = 0; x < width; ++x)
+    {
+      std::int32_t label = 0;
+
+      if (is_foreground(mask[x]))
+      {
+        if (x > 0)
+        {
+          label = get_channel(lbl[x - 1], 0);
+        }
+
+        if (lbl_above != nullptr)
+        {
+          label = merge_labels(eq, label, get_channel(lbl_above[x], 0));
+        }
+
+        if (label == 0)
+        {
+          label = next_label++;
+        }
+      }
+
+      get_channel(lbl[x], 0) = label;
+    }
+  }
+
+  return next_label;
+}
+
+/// Merges the labels across the boundary between rows y - 1 and y, after both strips have been labeled.
+template <typename DerivedDst>
+void merge_strip_boundary(const ImageBase<DerivedDst>& img_labels,
+                          std::ptrdiff_t y,
+                          Connectivity connectivity,
+                          LabelEquivalences& eq)
+{
+  const auto width = static_cast<std::ptrdiff_t>(img_labels.width());
+  const auto lbl = img_labels.data(to_row_index(y));
+  const auto lbl_above = img_labels.data(to_row_index(y - 1));
+  const auto diagonal = (connectivity == Connectivity::Eight) ? std::ptrdiff_t{1} : std::ptrdiff_t{0};
+
+  for (std::ptrdiff_t x = 0; x < width; ++x)
+  {
+    auto label = get_channel(lbl[x], 0);
+    if (label == 0)
+    {
+      continue;
+    }
+
+    const auto x_begin = std::max(x - diagonal, std::ptrdiff_t{0});
+    const auto x_end = std::min(x + diagonal + 1, width);
+    for (auto xa = x_begin; xa < x_end; ++xa)
+    {
+      label = merge_labels(eq, label, get_channel(lbl_above[xa], 0));
+    }
+  }
+}
+
+/// Accumulates component statistics; converted to `ComponentStats` at the end.
+struct ComponentStatsAccumulator
+{
+  std::size_t area = 0;
+  std::ptrdiff_t x_min = std::numeric_limits<std::ptrdiff_t>::max();
+  std::ptrdiff_t y_min = std::numeric_limits<std::ptrdiff_t>::max();
+  std::ptrdiff_t x_max = -1;
+  std::ptrdiff_t y_max = -1;
+  double sum_x = 0.0;
+  double sum_y = 0.0;
+
+  void add(std::ptrdiff_t x, std::ptrdiff_t y) noexcept
+  {
+    ++area;
+    x_min = std::min(x_min, x);
+    x_max = std::max(x_max, x);
+    y_min = std::min(y_min, y);
+    y_max = std::max(y_max, y);
+    sum_x += static_cast<double>(x);
+    sum_y += static_cast<double>(y);
+  }
+
+  void add(const ComponentStatsAccumulator& other) noexcept
+  {
+    area += other.area;
+    x_min = std::min(x_min, other.x_min);
+    x_max = std::max(x_max, other.x_max);
+    y_min = std::min(y_min, other.y_min);
+    y_max = std::max(y_max, other.y_max);
+    sum_x += other.sum_x;
+    sum_y += other.sum_y;
+  }
+
+  ComponentStats get() const noexcept
+  {
+    const auto n = static_cast<double>(area);
+    const auto idx = [](std::ptrdiff_t i) { return PixelIndex{static_cast<PixelIndex::value_type>(i)}; };
+    return ComponentStats{area, BoundingBox{idx(x_min), idx(y_min), idx(x_max + 1), idx(y_max + 1)}, sum_x / n,
+                          sum_y / n};
+  }
+};
+
+template <typename ExecutionPolicy, typename DerivedSrc, typename DerivedDst>
+std::int32_t label_connected_components(ExecutionPolicy&& policy,
+                                        const ImageBase<DerivedSrc>& img_mask,
+                                        ImageBase<DerivedDst>& img_labels,
+                                        Connectivity connectivity,
+                                        std::vector<ComponentStats>* stats)
+{
+  using PixelTypeSrc = typename ImageBase<DerivedSrc>::PixelType;
+  using PixelTypeDst = typename ImageBase<DerivedDst>::PixelType;
+  static_assert(PixelTraits<PixelTypeSrc>::nr_channels == 1, "The mask needs to be a single-channel image");
+  static_assert(std::is_same_v<typename PixelTraits<PixelTypeDst>::Element, std::int32_t>
+                    && PixelTraits<PixelTypeDst>::nr_channels == 1,
+                "The label image needs to be a single-channel image with 32-bit signed integral elements");
+
+  allocate(img_labels, TypedLayout{img_mask.width(), img_mask.height()});
+
+  const auto width = static_cast<std::ptrdiff_t>(img_mask.width());
+  const auto height = static_cast<std::ptrdiff_t>(img_mask.height());
+
+  if (stats != nullptr)
+  {
+    stats->clear();
+  }
+
+  if (width == 0 || height == 0)
+  {
+    return 0;
+  }
+
+  // Each row (4-connectivity) or row of blocks (8-connectivity) creates at most ceil(width / 2) new labels, which
+  // gives every strip a disjoint range of provisional labels, and allows the strips to be labeled independently.
+  const auto rows_per_unit = (connectivity == Connectivity::Eight) ? std::ptrdiff_t{2} : std::ptrdiff_t{1};
+  const auto labels_per_unit = (width + 1) / 2;
+  const auto nr_units = (height + rows_per_unit - 1) / rows_per_unit;
+  const auto max_labels = nr_units * labels_per_unit + 1;
+
+  if (max_labels > std::ptrdiff_t{std::numeric_limits<std::int32_t>::max()})
+  {
+    throw std::runtime_error("label_connected_components: Image is too large.");
+  }
+
+  const auto units_per_strip = (get_thread_pool(policy) == nullptr)
+                                   ? nr_units
+                                   : std::max(std::ptrdiff_t{1}, row_grain_size(width) / rows_per_unit);
+  const auto strip_rows = units_per_strip * rows_per_unit;
+  const auto nr_strips = (height + strip_rows - 1) / strip_rows;
+
+  LabelEquivalences eq(static_cast<std::size_t>(max_labels));
+  std::vector<std::int32_t> strip_end_labels(static_cast<std::size_t>(nr_strips));
+
+  const auto strip_first_label = [&](std::ptrdiff_t s) {
+    return static_cast<std::int32_t>(s * units_per_strip * labels_per_unit + 1);
+  };
+
+  // First pass: provisional labels, per strip
+  parallel_for(policy, 0, nr_strips, 1, [&](std::ptrdiff_t s_begin, std::ptrdiff_t s_end) {
+    for (auto s = s_begin; s < s_end; ++s)
+    {
+      const auto y_begin = s * strip_rows;
+      const auto y_end = std::min(y_begin + strip_rows, height);
+      strip_end_labels[static_cast<std::size_t>(s)] =
+          (connectivity == Connectivity::Eight)
+              ? label_blocks_8(img_mask, img_labels, y_begin, y_end, strip_first_label(s), eq)
+              : label_pixels_4(img_mask, img_labels, y_begin, y_end, strip_first_label(s), eq);
+    }
+  });
+
+  // Merge step: connect the labels across strip boundaries, then assign consecutive final labels
+  for (std::ptrdiff_t s = 1; s < nr_strips; ++s)
+  {
+    merge_strip_boundary(img_labels, s * strip_rows, connectivity, eq);
+  }
+
+  std::int32_t next_label = 1;
+  for (std::ptrdiff_t s = 0; s < nr_strips; ++s)
+  {
+    next_label = eq.flatten(strip_first_label(s), strip_end_labels[static_cast<std::size_t>(s)], next_label);
+  }
+
+  const auto nr_components = next_label - 1;
+
+  // Second pass: final labels, and optionally statistics. These are accumulated per parallel_for chunk (of which
+  // there are only a few per thread, independent of the number of strips), then reduced.
+  std::vector<ComponentStatsAccumulator> acc_total((stats != nullptr) ? static_cast<std::size_t>(nr_components)
+                                                                      : std::size_t{0});
+  std::mutex acc_mutex;
+
+  parallel_for(policy, 0, nr_strips, 1, [&](std::ptrdiff_t s_begin, std::ptrdiff_t s_end) {
+    const auto y_begin = s_begin * strip_rows;
+    const auto y_end = std::min(s_end * strip_rows, height);
+    std::vector<ComponentStatsAccumulator> acc(acc_total.size());
+
+    for (auto y = y_begin; y < y_end; ++y)
+    {
+      auto lbl = img_labels.data(to_row_index(y));
+
+      for (std::ptrdiff_t x = 0; x < width; ++x)
+      {
+        auto& label = get_channel(lbl[x], 0);
+        label = eq[label];
+
+        if (stats != nullptr && label != 0)
+        {
+          acc[static_cast<std::size_t>(label - 1)].add(x, y);
+        }
+      }
+    }
+
+    if (stats != nullptr)
+    {
+      std::lock_guard<std::mutex> lock(acc_mutex);
+      for (std::size_t i = 0; i < acc.size(); ++i)
+      {
+        acc_total[i].add(acc[i]);
+      }
+    }
+  });
+
+  if (stats != nullptr)
+  {
+    stats->reserve(acc_total.size());
+    for (const auto& a : acc_total)
+    {
+      stats->push_back(a.get());
+    }
+  }
+
+  return nr_components;
+}
+
+}  // namespace impl
+
+/** \brief Labels the connected components of a binary mask, according to the specified execution policy.
+ *
+ * All non-zero mask pixels are foreground. Each connected component of foreground pixels receives a label in
+ * [1, N], where N is the returned number of components; background pixels receive the label 0.
+ *
+ * The algorithm is a two-pass union-find scheme: the first pass assigns provisional labels independently (and in
+ * parallel) to horizontal strips of the image, processing 2x2 blocks of pixels at a time for 8-connectivity. A merge
+ * step then connects labels across strip boundaries, and the second pass writes the final labels.
+ * Labels are numbered by the position of the first block (or pixel, for 4-connectivity) of each component in scan
+ * order, independent of the execution policy.
+ *
+ * `allocate` is called on the label image prior to performing the operation.
+ *
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam DerivedSrc The typed mask image type; single-channel (e.g. `Image_8u1`).
+ * @tparam DerivedDst The typed label image type; single-channel with 32-bit signed elements (e.g. `Image_32s1`).
+ * @param policy The execution policy.
+ * @param img_mask The binary mask.
+ * @param[out] img_labels The label image.
+ * @param connectivity The pixel neighborhood.
+ * @return The number of connected components.
+ */
+template <typename ExecutionPolicy,
+          typename DerivedSrc,
+          typename DerivedDst,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+std::int32_t label_connected_components(ExecutionPolicy&& policy,
+                                        const ImageBase<DerivedSrc>& img_mask,
+                                        ImageBase<DerivedDst>& img_labels,
+                                        Connectivity connectivity = Connectivity::Eight)
+{
+  return impl::label_connected_components(policy, img_mask, img_labels, connectivity, nullptr);
+}
+
+/** \brief Labels the connected components of a binary mask, and computes their statistics, according to the
+ * specified execution policy.
+ *
+ * The statistics are gathered during the second labeling pass; `stats[i]` describes the component with label `i + 1`.
+ * See the overload without statistics for details.
+ *
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam DerivedSrc The typed mask image type; single-channel (e.g. `Image_8u1`).
+ * @tparam DerivedDst The typed label image type; single-channel with 32-bit signed elements (e.g. `Image_32s1`).
+ * @param policy The execution policy.
+ * @param img_mask The binary mask.
+ * @param[out] img_labels The label image.
+ * @param[out] stats The per-component statistics (area, bounding box and centroid).
+ * @param connectivity The pixel neighborhood.
+ * @return The number of connected components.
+ */
+template <typename ExecutionPolicy,
+          typename DerivedSrc,
+          typename DerivedDst,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+std::int32_t label_connected_components(ExecutionPolicy&& policy,
+                                        const ImageBase<DerivedSrc>& img_mask,
+                                        ImageBase<DerivedDst>& img_labels,
+                                        std::vector<ComponentStats>& stats,
+                                        Connectivity connectivity = Connectivity::Eight)
+{
+  return impl::label_connected_components(policy, img_mask, img_labels, connectivity, &stats);
+}
+
+/** \brief Labels the connected components of a binary mask.
+ *
+ * See the overload accepting an execution policy for details.
+ *
+ * @tparam DerivedSrc The typed mask image type; single-channel (e.g. `Image_8u1`).
+ * @tparam DerivedDst The typed label image type; single-channel with 32-bit signed elements (e.g. `Image_32s1`).
+ * @param img_mask The binary mask.
+ * @param[out] img_labels The label image.
+ * @param connectivity The pixel neighborhood.
+ * @return The number of connected components.
+ */
+template <typename DerivedSrc, typename DerivedDst>
+std::int32_t label_connected_components(const ImageBase<DerivedSrc>& img_mask,
+                                        ImageBase<DerivedDst>& img_labels,
+                                        Connectivity connectivity = Connectivity::Eight)
+{
+  return label_connected_components(execution::seq, img_mask, img_labels, connectivity);
+}
+
+/** \brief Labels the connected components of a binary mask, and computes their statistics.
+ *
+ * See the overload accepting an execution policy for details.
+ *
+ * @tparam DerivedSrc The typed mask image type; single-channel (e.g. `Image_8u1`).
+ * @tparam DerivedDst The typed label image type; single-channel with 32-bit signed elements (e.g. `Image_32s1`).
+ * @param img_mask The binary mask.
+ * @param[out] img_labels The label image.
+ * @param[out] stats The per-component statistics (area, bounding box and centroid).
+ * @param connectivity The pixel neighborhood.
+ * @return The number of connected components.
+ */
+template <typename DerivedSrc, typename DerivedDst>
+std::int32_t label_connected_components(const ImageBase<DerivedSrc>& img_mask,
+                                        ImageBase<DerivedDst>& img_labels,
+                                        std::vector<ComponentStats>& stats,
+                                        Connectivity connectivity = Connectivity::Eight)
+{
+  return label_connected_components(execution::seq, img_mask, img_labels, stats, connectivity);
+}
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_OPS_CONNECTED_COMPONENTS_HPP
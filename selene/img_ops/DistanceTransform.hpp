@@ -0,0 +1,351 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_OPS_DISTANCE_TRANSFORM_HPP
+#define SELENE_IMG_OPS_DISTANCE_TRANSFORM_HPP
+
+/// @file
+
+#include <selene/base/ExecutionPolicy.hpp>
+
+#include <selene/img/common/Types.hpp>
+
+#include <selene/img/pixel/PixelTraits.hpp>
+
+#include <selene/img/typed/ImageBase.hpp>
+
+#include <selene/img_ops/Algorithms.hpp>
+#include <selene/img_ops/Allocate.hpp>
+#include <selene/img_ops/Gradients.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace sln {
+
+// ----------
+// Implementation:
+
+namespace impl {
+
+constexpr std::int32_t edt_no_feature = -1;
+
+/** \brief First pass: for each pixel of the rows [y_begin, y_end), the horizontal distance to the nearest feature
+ * (zero) pixel in the same row, and that pixel's x-coordinate.
+ *
+ * Rows without any feature pixel receive `edt_no_feature`.
+ */
+template <typename DerivedSrc>
+void edt_rows(const ImageBase<DerivedSrc>& img_mask,
+              std::ptrdiff_t y_begin,
+              std::ptrdiff_t y_end,
+              std::int32_t* dist_x,
+              std::int32_t* nearest_x)
+{
+  const auto width = static_cast<std::ptrdiff_t>(img_mask.width());
+
+  for (auto y = y_begin; y < y_end; ++y)
+  {
+    const auto mask = img_mask.data(to_row_index(y));
+    auto nx = nearest_x + y * width;
+    auto dx = dist_x + y * width;
+
+    // Forward sweep: nearest feature on the left (or at the pixel itself)
+    std::int32_t last = edt_no_feature;
+    for (std::ptrdiff_t x = 0; x < width; ++x)
+    {
+      if (get_channel(mask[x], 0) == 0)
+      {
+        last = static_cast<std::int32_t>(x);
+      }
+
+      nx[x] = last;
+    }
+
+    if (last == edt_no_feature)
+    {
+      std::fill(dx, dx + width, edt_no_feature);
+      continue;
+    }
+
+    // Backward sweep: keep the nearest feature on the right, if it is closer
+    last = edt_no_feature;
+    for (auto x = width - 1; x >= 0; --x)
+    {
+      if (nx[x] == static_cast<std::int32_t>(x))
+      {
+        last = static_cast<std::int32_t>(x);
+      }
+      else if (last != edt_no_feature && (nx[x] == edt_no_feature || last - x < x - nx[x]))
+      {
+        nx[x] = last;
+      }
+
+      dx[x] = static_cast<std::int32_t>(std::abs(nx[x] - x));
+    }
+  }
+}
+
+/** \brief 1-D squared distance transform of a sampled function (lower envelope of parabolas, after Felzenszwalb and
+ * Huttenlocher).
+ *
+ * Samples with f[q] < 0 are treated as infinite, i.e. they contribute no parabola.
+ * If all samples are infinite, `argmin` is filled with `edt_no_feature`.
+ */
+inline void edt_1d(const std::int64_t* f,
+                   std::ptrdiff_t n,
+                   std::int64_t* d,
+                   std::int32_t* argmin,
+                   std::vector<std::ptrdiff_t>& v,
+                   std::vector<double>& z)
+{
+  v.resize(static_cast<std::size_t>(n));
+  z.resize(static_cast<std::size_t>(n) + 1);
+
+  const auto intersection = [f](std::ptrdiff_t p, std::ptrdiff_t q) {
+    const auto fp = static_cast<double>(f[p] + p * p);
+    const auto fq = static_cast<double>(f[q] + q * q);
+    return (fq - fp) / static_cast<double>(2 * (q - p));
+  };
+
+  std::ptrdiff_t k = -1;
+
+  for (std::ptrdiff_t q = 0; q < n; ++q)
+  {
+    if (f[q] < 0)
+    {
+      continue;
+    }
+
+    if (k < 0)
+    {
+      k = 0;
+      v[0] = q;
+      z[0] = -std::numeric_limits<double>::infinity();
+      z[1] = std::numeric_limits<double>::infinity();
+      continue;
+    }
+
+    auto s = intersection(v[static_cast<std::size_t>(k)], q);
+    while (s <= z[static_cast<std::size_t>(k)])
+    {
+      --k;  // z[0] is -infinity, so k does not drop below zero
+      s = intersection(v[static_cast<std::size_t>(k)], q);
+    }
+
+    ++k;
+    v[static_cast<std::size_t>(k)] = q;
+    z[static_cast<std::size_t>(k)] = s;
+    z[static_cast<std::size_t>(k) + 1] = std::numeric_limits<double>::infinity();
+  }
+
+  if (k < 0)
+  {
+    std::fill(d, d + n, std::int64_t{-1});
+    std::fill(argmin, argmin + n, edt_no_feature);
+    return;
+  }
+
+  k = 0;
+  for (std::ptrdiff_t q = 0; q < n; ++q)
+  {
+    while (z[static_cast<std::size_t>(k) + 1] < static_cast<double>(q))
+    {
+      ++k;
+    }
+
+    const auto p = v[static_cast<std::size_t>(k)];
+    d[q] = (q - p) * (q - p) + f[p];
+    argmin[q] = static_cast<std::int32_t>(p);
+  }
+}
+
+template <typename ExecutionPolicy, typename DerivedSrc, typename DerivedDst, typename NearestOutput>
+void distance_transform(ExecutionPolicy&& policy,
+                        const ImageBase<DerivedSrc>& img_mask,
+                        ImageBase<DerivedDst>& img_dist,
+                        NearestOutput& img_nearest)
+{
+  using PixelTypeSrc = typename ImageBase<DerivedSrc>::PixelType;
+  using PixelTypeDst = typename ImageBase<DerivedDst>::PixelType;
+  using DistElement = typename PixelTraits<PixelTypeDst>::Element;
+  constexpr bool output_nearest = is_requested_output_v<NearestOutput>;
+  static_assert(PixelTraits<PixelTypeSrc>::nr_channels == 1, "The mask needs to be a single-channel image");
+  static_assert(std::is_floating_point_v<DistElement> && PixelTraits<PixelTypeDst>::nr_channels == 1,
+                "The distance image needs to be a single-channel floating point image");
+
+  const auto width = static_cast<std::ptrdiff_t>(img_mask.width());
+  const auto height = static_cast<std::ptrdiff_t>(img_mask.height());
+
+  allocate(img_dist, TypedLayout{img_mask.width(), img_mask.height()});
+
+  if constexpr (output_nearest)
+  {
+    using PixelTypeNearest = typename NearestOutput::PixelType;
+    static_assert(std::is_same_v<typename PixelTraits<PixelTypeNearest>::Element, std::int32_t>
+                      && PixelTraits<PixelTypeNearest>::nr_channels == 2,
+                  "The nearest feature image needs to be a 2-channel image with 32-bit signed integral elements");
+    allocate(img_nearest, TypedLayout{img_mask.width(), img_mask.height()});
+  }
+
+  if (width == 0 || height == 0)
+  {
+    return;
+  }
+
+  const auto size = static_cast<std::size_t>(width * height);
+  std::vector<std::int32_t> dist_x(size), nearest_x(size);
+
+  // First pass: 1-D distances along each row
+  parallel_for(policy, 0, height, row_grain_size(width), [&](std::ptrdiff_t y_begin, std::ptrdiff_t y_end) {
+    edt_rows(img_mask, y_begin, y_end, dist_x.data(), nearest_x.data());
+  });
+
+  // Second pass: 1-D squared distance transform along each column, of the squared row distances
+  const auto column_grain_size = std::max(std::ptrdiff_t{8}, row_grain_size(height));
+  parallel_for(policy, 0, width, column_grain_size, [&](std::ptrdiff_t x_begin, std::ptrdiff_t x_end) {
+    const auto h = static_cast<std::size_t>(height);
+    std::vector<std::int64_t> f(h), d(h);
+    std::vector<std::int32_t> argmin(h);
+    std::vector<std::ptrdiff_t> v;
+    std::vector<double> z;
+
+    for (auto x = x_begin; x < x_end; ++x)
+    {
+      for (std::ptrdiff_t y = 0; y < height; ++y)
+      {
+        const auto g = std::int64_t{dist_x[static_cast<std::size_t>(y * width + x)]};
+        f[static_cast<std::size_t>(y)] = (g < 0) ? std::int64_t{-1} : g * g;
+      }
+
+      edt_1d(f.data(), height, d.data(), argmin.data(), v, z);
+
+      for (std::ptrdiff_t y = 0; y < height; ++y)
+      {
+        const auto row = to_row_index(y);
+        const auto d_sq = d[static_cast<std::size_t>(y)];
+        get_channel(img_dist.data(row)[x], 0) =
+            (d_sq < 0) ? std::numeric_limits<DistElement>::infinity()
+                       : static_cast<DistElement>(std::sqrt(static_cast<double>(d_sq)));
+
+        if constexpr (output_nearest)
+        {
+          const auto ny = argmin[static_cast<std::size_t>(y)];
+          auto& px = img_nearest.data(row)[x];
+          get_channel(px, 0) = (ny < 0) ? edt_no_feature : nearest_x[static_cast<std::size_t>(ny * width + x)];
+          get_channel(px, 1) = ny;
+        }
+      }
+    }
+  });
+}
+
+}  // namespace impl
+
+/** \brief Computes the exact Euclidean distance transform of a binary mask, according to the specified execution
+ * policy.
+ *
+ * The feature pixels are the zero pixels of the mask. Each output pixel receives the Euclidean distance to its nearest
+ * feature pixel; feature pixels themselves receive 0. If the mask does not contain any feature pixel, all distances
+ * are infinite.
+ *
+ * The transform is separable and runs in linear time: the first pass computes 1-D distances along each row (in
+ * parallel over rows), and the second pass computes the lower envelope of parabolas along each column (in parallel
+ * over columns), after Felzenszwalb and Huttenlocher.
+ *
+ * `allocate` is called on the distance image prior to performing the operation.
+ *
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam DerivedSrc The typed mask image type; single-channel (e.g. `Image_8u1`).
+ * @tparam DerivedDst The typed distance image type; single-channel with floating point elements (e.g. `Image_32f1`).
+ * @param policy The execution policy.
+ * @param img_mask The binary mask.
+ * @param[out] img_dist The distance image.
+ */
+template <typename ExecutionPolicy,
+          typename DerivedSrc,
+          typename DerivedDst,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+void distance_transform(ExecutionPolicy&& policy,
+                        const ImageBase<DerivedSrc>& img_mask,
+                        ImageBase<DerivedDst>& img_dist)
+{
+  NoOutput nearest;
+  impl::distance_transform(policy, img_mask, img_dist, nearest);
+}
+
+/** \brief Computes the exact Euclidean distance transform of a binary mask, and the nearest feature pixel of each
+ * pixel, according to the specified execution policy.
+ *
+ * Each pixel of the nearest feature image contains the (x, y) coordinates of the nearest zero pixel of the mask, or
+ * (-1, -1) if there is none. Among equidistant feature pixels, an arbitrary one is chosen.
+ * See the overload without nearest feature output for details.
+ *
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam DerivedSrc The typed mask image type; single-channel (e.g. `Image_8u1`).
+ * @tparam DerivedDst The typed distance image type; single-channel with floating point elements (e.g. `Image_32f1`).
+ * @tparam DerivedNearest The typed nearest feature image type; 2-channel with 32-bit signed elements
+ * (e.g. `Image_32s2`).
+ * @param policy The execution policy.
+ * @param img_mask The binary mask.
+ * @param[out] img_dist The distance image.
+ * @param[out] img_nearest The nearest feature image.
+ */
+template <typename ExecutionPolicy,
+          typename DerivedSrc,
+          typename DerivedDst,
+          typename DerivedNearest,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+void distance_transform(ExecutionPolicy&& policy,
+                        const ImageBase<DerivedSrc>& img_mask,
+                        ImageBase<DerivedDst>& img_dist,
+                        ImageBase<DerivedNearest>& img_nearest)
+{
+  impl::distance_transform(policy, img_mask, img_dist, img_nearest);
+}
+
+/** \brief Computes the exact Euclidean distance transform of a binary mask.
+ *
+ * See the overload accepting an execution policy for details.
+ *
+ * @tparam DerivedSrc The typed mask image type; single-channel (e.g. `Image_8u1`).
+ * @tparam DerivedDst The typed distance image type; single-channel with floating point elements (e.g. `Image_32f1`).
+ * @param img_mask The binary mask.
+ * @param[out] img_dist The distance image.
+ */
+template <typename DerivedSrc, typename DerivedDst>
+void distance_transform(const ImageBase<DerivedSrc>& img_mask, ImageBase<DerivedDst>& img_dist)
+{
+  distance_transform(execution::seq, img_mask, img_dist);
+}
+
+/** \brief Computes the exact Euclidean distance transform of a binary mask, and the nearest feature pixel of each
+ * pixel.
+ *
+ * See the overload accepting an execution policy for details.
+ *
+ * @tparam DerivedSrc The typed mask image type; single-channel (e.g. `Image_8u1`).
+ * @tparam DerivedDst The typed distance image type; single-channel with floating point elements (e.g. `Image_32f1`).
+ * @tparam DerivedNearest The typed nearest feature image type; 2-channel with 32-bit signed elements
+ * (e.g. `Image_32s2`).
+ * @param img_mask The binary mask.
+ * @param[out] img_dist The distance image.
+ * @param[out] img_nearest The nearest feature image.
+ */
+template <typename DerivedSrc, typename DerivedDst, typename DerivedNearest>
+void distance_transform(const ImageBase<DerivedSrc>& img_mask,
+                        ImageBase<DerivedDst>& img_dist,
+                        ImageBase<DerivedNearest>& img_nearest)
+{
+  distance_transform(execution::seq, img_mask, img_dist, img_nearest);
+}
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_OPS_DISTANCE_TRANSFORM_HPP
@@ -0,0 +1,336 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_OPS_GRADIENTS_HPP
+#define SELENE_IMG_OPS_GRADIENTS_HPP
+
+/// @file
+
+#include <selene/base/ExecutionPolicy.hpp>
+
+#include <selene/img/common/Types.hpp>
+
+#include <selene/img/pixel/PixelTraits.hpp>
+
+#include <selene/img/typed/ImageBase.hpp>
+
+#include <selene/img_ops/Algorithms.hpp>
+#include <selene/img_ops/Allocate.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace sln {
+
+/// The 3x3 derivative kernel used by `gradients`.
+enum class GradientKernel
+{
+  Sobel,  ///< Sobel kernel; smoothing weights (1, 2, 1).
+  Scharr,  ///< Scharr kernel; smoothing weights (3, 10, 3), with better rotational symmetry.
+};
+
+/// The computation of the gradient orientation used by `gradients`.
+enum class GradientOrientation
+{
+  Exact,  ///< Orientation computed using `std::atan2`.
+  Fast,  ///< Orientation computed using a polynomial approximation of atan2, with an error of about 1e-5 rad.
+};
+
+/// Tag type to denote an output of `gradients` which is not requested.
+struct NoOutput
+{
+};
+
+/// Tag value to denote an output of `gradients` which is not requested.
+constexpr NoOutput no_output{};
+
+// ----------
+// Implementation:
+
+namespace impl {
+
+template <typename Output>
+constexpr bool is_requested_output_v = !std::is_same_v<std::decay_t<Output>, NoOutput>;
+
+template <GradientKernel kernel>
+struct GradientKernelWeights;
+
+template <>
+struct GradientKernelWeights<GradientKernel::Sobel>
+{
+  static constexpr std::int16_t outer = 1;
+  static constexpr std::int16_t center = 2;
+};
+
+template <>
+struct GradientKernelWeights<GradientKernel::Scharr>
+{
+  static constexpr std::int16_t outer = 3;
+  static constexpr std::int16_t center = 10;
+};
+
+/** \brief Approximates `std::atan2(y, x)`, using a 9th degree polynomial of the arctangent on [0, 1] (Abramowitz and
+ * Stegun, 4.4.49).
+ *
+ * The function has no data-dependent branches (only selects), so it can be vectorized.
+ */
+inline float fast_atan2(float y, float x) noexcept
+{
+  constexpr float pi = 3.14159265358979f;
+  const auto ax = std::abs(x);
+  const auto ay = std::abs(y);
+  const auto mx = std::max(ax, ay);
+  const auto a = (mx > 0.0f) ? std::min(ax, ay) / mx : 0.0f;
+  const auto s = a * a;
+  auto r = a * (0.9998660f + s * (-0.3302995f + s * (0.1801410f + s * (-0.0851330f + s * 0.0208351f))));
+  r = (ay > ax) ? (pi / 2 - r) : r;
+  r = (x < 0.0f) ? (pi - r) : r;
+  return (y < 0.0f) ? -r : r;
+}
+
+/** \brief Computes the horizontal and vertical derivatives of one row, from three border-extended source rows.
+ *
+ * The derivatives are separable: a vertical smoothing (resp. difference) pass, followed by a horizontal difference
+ * (resp. smoothing) pass. All intermediates fit into 16 bits for 8-bit input.
+ */
+template <GradientKernel kernel>
+void gradient_row(const std::int16_t* row_prev,
+                  const std::int16_t* row_cur,
+                  const std::int16_t* row_next,
+                  std::int16_t* smooth,
+                  std::int16_t* diff,
+                  std::int16_t* dx,
+                  std::int16_t* dy,
+                  std::ptrdiff_t width)
+{
+  constexpr auto w_outer = GradientKernelWeights<kernel>::outer;
+  constexpr auto w_center = GradientKernelWeights<kernel>::center;
+
+  // Vertical pass, on the padded row of width + 2
+  SELENE_VECTORIZE_LOOP
+  for (std::ptrdiff_t x = 0; x < width + 2; ++x)
+  {
+    smooth[x] = static_cast<std::int16_t>(w_outer * (row_prev[x] + row_next[x]) + w_center * row_cur[x]);
+    diff[x] = static_cast<std::int16_t>(row_next[x] - row_prev[x]);
+  }
+
+  // Horizontal pass
+  SELENE_VECTORIZE_LOOP
+  for (std::ptrdiff_t x = 0; x < width; ++x)
+  {
+    dx[x] = static_cast<std::int16_t>(smooth[x + 2] - smooth[x]);
+    dy[x] = static_cast<std::int16_t>(w_outer * (diff[x] + diff[x + 2]) + w_center * diff[x + 1]);
+  }
+}
+
+template <typename Output, typename Value>
+void write_gradient_output(Output& img_out, std::ptrdiff_t y, const Value* values, std::ptrdiff_t width)
+{
+  using Element = typename PixelTraits<typename std::decay_t<Output>::PixelType>::Element;
+  auto out = img_out.data(to_row_index(y));
+
+  for (std::ptrdiff_t x = 0; x < width; ++x)
+  {
+    get_channel(out[x], 0) = static_cast<Element>(values[x]);
+  }
+}
+
+template <GradientKernel kernel,
+          GradientOrientation orientation_mode,
+          typename ExecutionPolicy,
+          typename DerivedSrc,
+          typename OutputDx,
+          typename OutputDy,
+          typename OutputMagnitude,
+          typename OutputOrientation>
+void compute_gradients(ExecutionPolicy&& policy,
+                       const ImageBase<DerivedSrc>& img_src,
+                       OutputDx& img_dx,
+                       OutputDy& img_dy,
+                       OutputMagnitude& img_magnitude,
+                       OutputOrientation& img_orientation)
+{
+  constexpr bool need_magnitude = is_requested_output_v<OutputMagnitude>;
+  constexpr bool need_orientation = is_requested_output_v<OutputOrientation>;
+
+  const auto width = static_cast<std::ptrdiff_t>(img_src.width());
+  const auto height = static_cast<std::ptrdiff_t>(img_src.height());
+
+  if (width == 0 || height == 0)
+  {
+    return;
+  }
+
+  parallel_for(policy, 0, height, row_grain_size(width), [&](std::ptrdiff_t y_begin, std::ptrdiff_t y_end) {
+    const auto padded = static_cast<std::size_t>(width + 2);
+    std::vector<std::int16_t> rows(3 * padded), smooth(padded), diff(padded);
+    std::vector<std::int16_t> dx(static_cast<std::size_t>(width)), dy(static_cast<std::size_t>(width));
+    std::vector<float> magnitude(need_magnitude ? static_cast<std::size_t>(width) : 0);
+    std::vector<float> orientation(need_orientation ? static_cast<std::size_t>(width) : 0);
+
+    for (auto y = y_begin; y < y_end; ++y)
+    {
+      // Border-extended (replicated) copies of the three source rows
+      for (std::ptrdiff_t i = 0; i < 3; ++i)
+      {
+        const auto ys = std::min(std::max(y + i - 1, std::ptrdiff_t{0}), height - 1);
+        const auto src = img_src.data(to_row_index(ys));
+        auto row = rows.data() + static_cast<std::size_t>(i) * padded;
+
+        for (std::ptrdiff_t x = 0; x < width; ++x)
+        {
+          row[x + 1] = static_cast<std::int16_t>(get_channel(src[x], 0));
+        }
+
+        row[0] = row[1];
+        row[width + 1] = row[width];
+      }
+
+      gradient_row<kernel>(rows.data(), rows.data() + padded, rows.data() + 2 * padded, smooth.data(), diff.data(),
+                           dx.data(), dy.data(), width);
+
+      if constexpr (is_requested_output_v<OutputDx>)
+      {
+        write_gradient_output(img_dx, y, dx.data(), width);
+      }
+
+      if constexpr (is_requested_output_v<OutputDy>)
+      {
+        write_gradient_output(img_dy, y, dy.data(), width);
+      }
+
+      if constexpr (need_magnitude)
+      {
+        SELENE_VECTORIZE_LOOP
+        for (std::ptrdiff_t x = 0; x < width; ++x)
+        {
+          const auto gx = static_cast<float>(dx[static_cast<std::size_t>(x)]);
+          const auto gy = static_cast<float>(dy[static_cast<std::size_t>(x)]);
+          magnitude[static_cast<std::size_t>(x)] = std::sqrt(gx * gx + gy * gy);
+        }
+
+        write_gradient_output(img_magnitude, y, magnitude.data(), width);
+      }
+
+      if constexpr (need_orientation)
+      {
+        SELENE_VECTORIZE_LOOP
+        for (std::ptrdiff_t x = 0; x < width; ++x)
+        {
+          const auto gx = static_cast<float>(dx[static_cast<std::size_t>(x)]);
+          const auto gy = static_cast<float>(dy[static_cast<std::size_t>(x)]);
+          orientation[static_cast<std::size_t>(x)]
+              = (orientation_mode == GradientOrientation::Fast) ? fast_atan2(gy, gx) : std::atan2(gy, gx);
+        }
+
+        write_gradient_output(img_orientation, y, orientation.data(), width);
+      }
+    }
+  });
+}
+
+template <typename Output>
+void allocate_gradient_output(Output& img_out, const TypedLayout& layout)
+{
+  if constexpr (is_requested_output_v<Output>)
+  {
+    static_assert(PixelTraits<typename std::decay_t<Output>::PixelType>::nr_channels == 1,
+                  "Gradient outputs need to be single-channel images");
+    allocate(img_out, layout);
+  }
+}
+
+}  // namespace impl
+
+/** \brief Computes image gradients using a 3x3 Sobel or Scharr kernel in a single sweep, according to the specified
+ * execution policy.
+ *
+ * Each of the four outputs is optional: passing `sln::no_output` instead of an image skips its computation (and any
+ * associated cost) at compile time. Requested outputs are allocated via `allocate` prior to performing the operation.
+ *
+ * - `img_dx`, `img_dy`: The horizontal and vertical derivatives. These are computed using 16-bit integer
+ *   intermediates and fit into a `std::int16_t` element type (e.g. `Image_16s1`).
+ * - `img_magnitude`: The L2 gradient magnitude, e.g. as `Image_32f1`.
+ * - `img_orientation`: The gradient orientation in radians in [-pi, pi], e.g. as `Image_32f1`.
+ *
+ * Pixels outside of the image are replicated from the border. The derivatives are not normalized, i.e. the Sobel
+ * response to a unit step is 4, and the Scharr response is 16.
+ *
+ * @tparam kernel The derivative kernel.
+ * @tparam orientation_mode Whether to compute the orientation exactly, or using a fast approximation.
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam DerivedSrc The typed source image type; single-channel with 8-bit unsigned elements (e.g. `Image_8u1`).
+ * @param policy The execution policy.
+ * @param img_src The source image.
+ * @param[out] img_dx The horizontal derivative image, or `sln::no_output`.
+ * @param[out] img_dy The vertical derivative image, or `sln::no_output`.
+ * @param[out] img_magnitude The gradient magnitude image, or `sln::no_output`.
+ * @param[out] img_orientation The gradient orientation image, or `sln::no_output`.
+ */
+template <GradientKernel kernel = GradientKernel::Sobel,
+          GradientOrientation orientation_mode = GradientOrientation::Exact,
+          typename ExecutionPolicy,
+          typename DerivedSrc,
+          typename OutputDx,
+          typename OutputDy,
+          typename OutputMagnitude,
+          typename OutputOrientation,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+void gradients(ExecutionPolicy&& policy,
+               const ImageBase<DerivedSrc>& img_src,
+               OutputDx&& img_dx,
+               OutputDy&& img_dy,
+               OutputMagnitude&& img_magnitude,
+               OutputOrientation&& img_orientation)
+{
+  using PixelType = typename ImageBase<DerivedSrc>::PixelType;
+  static_assert(std::is_same_v<typename PixelTraits<PixelType>::Element, std::uint8_t>
+                    && PixelTraits<PixelType>::nr_channels == 1,
+                "Gradients are only supported for single-channel 8-bit unsigned integral images");
+
+  const auto layout = TypedLayout{img_src.width(), img_src.height()};
+  impl::allocate_gradient_output(img_dx, layout);
+  impl::allocate_gradient_output(img_dy, layout);
+  impl::allocate_gradient_output(img_magnitude, layout);
+  impl::allocate_gradient_output(img_orientation, layout);
+
+  impl::compute_gradients<kernel, orientation_mode>(policy, img_src, img_dx, img_dy, img_magnitude, img_orientation);
+}
+
+/** \brief Computes image gradients using a 3x3 Sobel or Scharr kernel in a single sweep.
+ *
+ * See the overload accepting an execution policy for details.
+ *
+ * @tparam kernel The derivative kernel.
+ * @tparam orientation_mode Whether to compute the orientation exactly, or using a fast approximation.
+ * @tparam DerivedSrc The typed source image type; single-channel with 8-bit unsigned elements (e.g. `Image_8u1`).
+ * @param img_src The source image.
+ * @param[out] img_dx The horizontal derivative image, or `sln::no_output`.
+ * @param[out] img_dy The vertical derivative image, or `sln::no_output`.
+ * @param[out] img_magnitude The gradient magnitude image, or `sln::no_output`.
+ * @param[out] img_orientation The gradient orientation image, or `sln::no_output`.
+ */
+template <GradientKernel kernel = GradientKernel::Sobel,
+          GradientOrientation orientation_mode = GradientOrientation::Exact,
+          typename DerivedSrc,
+          typename OutputDx,
+          typename OutputDy,
+          typename OutputMagnitude,
+          typename OutputOrientation>
+void gradients(const ImageBase<DerivedSrc>& img_src,
+               OutputDx&& img_dx,
+               OutputDy&& img_dy,
+               OutputMagnitude&& img_magnitude,
+               OutputOrientation&& img_orientation)
+{
+  gradients<kernel, orientation_mode>(execution::seq, img_src, img_dx, img_dy, img_magnitude, img_orientation);
+}
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_OPS_GRADIENTS_HPP
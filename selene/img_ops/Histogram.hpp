@@ -0,0 +1,378 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_OPS_HISTOGRAM_HPP
+#define SELENE_IMG_OPS_HISTOGRAM_HPP
+
+/// @file
+
+#include <selene/base/Assert.hpp>
+#include <selene/base/ExecutionPolicy.hpp>
+
+#include <selene/img/pixel/PixelTraits.hpp>
+
+#include <selene/img/typed/ImageBase.hpp>
+
+#include <selene/img_ops/Algorithms.hpp>
+#include <selene/img_ops/Allocate.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace sln {
+
+/// A histogram; i.e. a vector of counts, one per bin.
+using Histogram = std::vector<std::uint64_t>;
+
+// ----------
+// Implementation:
+
+namespace impl {
+
+template <typename PixelType>
+constexpr void static_check_histogram_pixel_type()
+{
+  using Element = typename PixelTraits<PixelType>::Element;
+  static_assert(std::is_integral_v<Element> && std::is_unsigned_v<Element> && sizeof(Element) <= 2,
+                "Histograms are only supported for 8-bit or 16-bit unsigned integral pixel elements");
+}
+
+template <typename Element>
+constexpr std::size_t nr_histogram_values = std::size_t{1} << (8 * sizeof(Element));
+
+/** \brief Adds the values of channel `c` of an image row to the (interleaved) sub-histograms.
+ *
+ * Consecutive pixels are counted in different sub-histograms; runs of equal values (e.g. in flat image regions) then
+ * do not result in a chain of dependent increments of the same memory location.
+ */
+template <std::size_t nr_bins, std::size_t nr_sub_histograms, typename PixelType>
+void add_to_sub_histograms(const PixelType* ptr, std::ptrdiff_t width, std::size_t c, std::uint64_t* sub_histograms)
+{
+  using Element = typename PixelTraits<PixelType>::Element;
+  constexpr auto shift = 8 * sizeof(Element);
+  constexpr auto n = static_cast<std::ptrdiff_t>(nr_sub_histograms);
+
+  const auto bin = [](Element v) {
+    return static_cast<std::size_t>((std::uint64_t{v} * nr_bins) >> shift);  // reduces to a shift for powers of 2
+  };
+
+  std::ptrdiff_t x = 0;
+  for (; x + n <= width; x += n)
+  {
+    for (std::size_t s = 0; s < nr_sub_histograms; ++s)
+    {
+      ++sub_histograms[s * nr_bins + bin(get_channel(ptr[x + static_cast<std::ptrdiff_t>(s)], c))];
+    }
+  }
+
+  for (; x < width; ++x)
+  {
+    ++sub_histograms[bin(get_channel(ptr[x], c))];
+  }
+}
+
+template <std::size_t nr_bins, typename ExecutionPolicy, typename Derived>
+Histogram compute_histogram(ExecutionPolicy&& policy, const ImageBase<Derived>& img, std::size_t channel)
+{
+  constexpr std::size_t nr_sub_histograms = 4;
+
+  const auto width = static_cast<std::ptrdiff_t>(img.width());
+  const auto height = static_cast<std::ptrdiff_t>(img.height());
+
+  // One partial histogram per thread (or fewer, for small images), each consisting of interleaved sub-histograms.
+  const auto pool = get_thread_pool(policy);
+  const auto max_nr_parts = (height + row_grain_size(width) - 1) / row_grain_size(width);
+  const auto nr_parts =
+      std::max(std::ptrdiff_t{1}, std::min(static_cast<std::ptrdiff_t>(pool ? pool->nr_threads() : 1), max_nr_parts));
+
+  std::vector<std::uint64_t> partials(static_cast<std::size_t>(nr_parts) * nr_sub_histograms * nr_bins, 0);
+
+  parallel_for(policy, 0, nr_parts, 1, [&](std::ptrdiff_t part_begin, std::ptrdiff_t part_end) {
+    for (auto part = part_begin; part < part_end; ++part)
+    {
+      auto sub_histograms = partials.data() + part * static_cast<std::ptrdiff_t>(nr_sub_histograms * nr_bins);
+
+      for (auto y = (height * part) / nr_parts; y < (height * (part + 1)) / nr_parts; ++y)
+      {
+        add_to_sub_histograms<nr_bins, nr_sub_histograms>(img.data(to_row_index(y)), width, channel, sub_histograms);
+      }
+    }
+  });
+
+  // Merge all partial histograms; parallelized over ranges of bins.
+  const auto nr_partials = static_cast<std::size_t>(nr_parts) * nr_sub_histograms;
+  Histogram hist(nr_bins, 0);
+
+  constexpr std::ptrdiff_t bins_grain_size = 4096;
+  parallel_for(policy, 0, static_cast<std::ptrdiff_t>(nr_bins), bins_grain_size,
+               [&](std::ptrdiff_t b_begin, std::ptrdiff_t b_end) {
+                 for (std::size_t p = 0; p < nr_partials; ++p)
+                 {
+                   const auto partial = partials.data() + p * nr_bins;
+
+                   for (auto b = b_begin; b < b_end; ++b)
+                   {
+                     hist[static_cast<std::size_t>(b)] += partial[b];
+                   }
+                 }
+               });
+
+  return hist;
+}
+
+/// Computes the cumulative distribution (as counts) of a histogram.
+inline std::vector<std::uint64_t> cumulative_histogram(const Histogram& hist)
+{
+  std::vector<std::uint64_t> cdf(hist.size());
+  std::uint64_t acc = 0;
+
+  for (std::size_t i = 0; i < hist.size(); ++i)
+  {
+    acc += hist[i];
+    cdf[i] = acc;
+  }
+
+  return cdf;
+}
+
+}  // namespace impl
+
+/** \brief Computes the histogram of one channel of an image, according to the specified execution policy.
+ *
+ * The range of values of the pixel element type is divided uniformly into `nr_bins` bins; i.e. value `v` is counted
+ * in bin `(v * nr_bins) >> bits`, where `bits` is the number of bits of the element type.
+ *
+ * With a parallel execution policy, each thread computes a partial histogram of a band of rows; the partial histograms
+ * are merged in parallel.
+ *
+ * @tparam nr_bins The number of bins. Must be at most the number of values of the pixel element type.
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam Derived The typed image type. Its pixel elements need to be 8-bit or 16-bit unsigned integers.
+ * @param policy The execution policy.
+ * @param img The image.
+ * @param channel The channel to compute the histogram of.
+ * @return The histogram, containing `nr_bins` counts.
+ */
+template <std::size_t nr_bins = 256,
+          typename ExecutionPolicy,
+          typename Derived,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+Histogram histogram(ExecutionPolicy&& policy, const ImageBase<Derived>& img, std::size_t channel = 0)
+{
+  using PixelType = typename ImageBase<Derived>::PixelType;
+  impl::static_check_histogram_pixel_type<PixelType>();
+  static_assert(nr_bins > 0 && nr_bins <= impl::nr_histogram_values<typename PixelTraits<PixelType>::Element>,
+                "Invalid number of histogram bins");
+
+  if (channel >= static_cast<std::size_t>(PixelTraits<PixelType>::nr_channels))
+  {
+    throw std::runtime_error("histogram: Invalid channel index.");
+  }
+
+  return impl::compute_histogram<nr_bins>(policy, img, channel);
+}
+
+/** \brief Computes the histogram of one channel of an image.
+ *
+ * See the overload accepting an execution policy for details.
+ *
+ * @tparam nr_bins The number of bins. Must be at most the number of values of the pixel element type.
+ * @tparam Derived The typed image type. Its pixel elements need to be 8-bit or 16-bit unsigned integers.
+ * @param img The image.
+ * @param channel The channel to compute the histogram of.
+ * @return The histogram, containing `nr_bins` counts.
+ */
+template <std::size_t nr_bins = 256, typename Derived>
+Histogram histogram(const ImageBase<Derived>& img, std::size_t channel = 0)
+{
+  return histogram<nr_bins>(execution::seq, img, channel);
+}
+
+/** \brief Maps each pixel element of the source image through a lookup table, writing the result to the destination
+ * image.
+ *
+ * `allocate` is called on the destination image prior to performing the operation.
+ * The lookup table is applied to all channels; it needs to contain an entry for every value of the source element
+ * type (i.e. 256 entries for 8-bit, and 65536 entries for 16-bit elements); otherwise, an exception is thrown.
+ *
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam DerivedSrc The typed source image type. Its pixel elements need to be 8-bit or 16-bit unsigned integers.
+ * @tparam DerivedDst The typed destination image type. Needs to have the same number of channels as the source.
+ * @tparam LUT The lookup table type; a random access container (e.g. `std::vector` or `std::array`).
+ * @param policy The execution policy.
+ * @param img_src The source image.
+ * @param[out] img_dst The destination image.
+ * @param lut The lookup table.
+ */
+template <typename ExecutionPolicy,
+          typename DerivedSrc,
+          typename DerivedDst,
+          typename LUT,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+void apply_lut(ExecutionPolicy&& policy,
+               const ImageBase<DerivedSrc>& img_src,
+               ImageBase<DerivedDst>& img_dst,
+               const LUT& lut)
+{
+  using PixelTypeSrc = typename ImageBase<DerivedSrc>::PixelType;
+  using PixelTypeDst = typename ImageBase<DerivedDst>::PixelType;
+  using ElementSrc = typename PixelTraits<PixelTypeSrc>::Element;
+  using ElementDst = typename PixelTraits<PixelTypeDst>::Element;
+  constexpr auto nr_channels = static_cast<std::size_t>(PixelTraits<PixelTypeSrc>::nr_channels);
+
+  impl::static_check_histogram_pixel_type<PixelTypeSrc>();
+  static_assert(PixelTraits<PixelTypeSrc>::nr_channels == PixelTraits<PixelTypeDst>::nr_channels,
+                "Source and destination images have different numbers of channels");
+
+  if (static_cast<std::size_t>(std::size(lut)) < impl::nr_histogram_values<ElementSrc>)
+  {
+    throw std::runtime_error("apply_lut: Lookup table is too small.");
+  }
+
+  const auto lut_data = std::data(lut);
+  transform_pixels(policy, img_src, img_dst, [lut_data](const PixelTypeSrc& px) {
+    PixelTypeDst px_dst;
+    for (std::size_t c = 0; c < nr_channels; ++c)
+    {
+      impl::get_channel(px_dst, c) = static_cast<ElementDst>(lut_data[impl::get_channel(px, c)]);
+    }
+    return px_dst;
+  });
+}
+
+/** \brief Maps each pixel element of the source image through a lookup table, writing the result to the destination
+ * image.
+ *
+ * See the overload accepting an execution policy for details.
+ *
+ * @tparam DerivedSrc The typed source image type. Its pixel elements need to be 8-bit or 16-bit unsigned integers.
+ * @tparam DerivedDst The typed destination image type. Needs to have the same number of channels as the source.
+ * @tparam LUT The lookup table type; a random access container (e.g. `std::vector` or `std::array`).
+ * @param img_src The source image.
+ * @param[out] img_dst The destination image.
+ * @param lut The lookup table.
+ */
+template <typename DerivedSrc, typename DerivedDst, typename LUT>
+void apply_lut(const ImageBase<DerivedSrc>& img_src, ImageBase<DerivedDst>& img_dst, const LUT& lut)
+{
+  apply_lut(execution::seq, img_src, img_dst, lut);
+}
+
+/** \brief Performs histogram equalization on a single-channel image.
+ *
+ * Each value `v` is mapped to `round((cdf(v) - cdf_min) / (nr_pixels - cdf_min) * max_value)`, where `cdf` is the
+ * cumulative histogram of the source image, and `cdf_min` its first non-zero value. Images consisting of a single
+ * value are copied unchanged; for an empty source image, the destination image is allocated empty.
+ *
+ * `allocate` is called on the destination image prior to performing the operation.
+ *
+ * @tparam DerivedSrc The typed source image type; single-channel, with 8-bit or 16-bit unsigned integer elements.
+ * @tparam DerivedDst The typed destination image type; of the same pixel type as the source.
+ * @param img_src The source image.
+ * @param[out] img_dst The destination image.
+ */
+template <typename DerivedSrc, typename DerivedDst>
+void equalize_histogram(const ImageBase<DerivedSrc>& img_src, ImageBase<DerivedDst>& img_dst)
+{
+  using PixelType = typename ImageBase<DerivedSrc>::PixelType;
+  using Element = typename PixelTraits<PixelType>::Element;
+  constexpr auto nr_values = impl::nr_histogram_values<Element>;
+  static_assert(PixelTraits<PixelType>::nr_channels == 1, "Histogram equalization requires a single-channel image");
+
+  const auto cdf = impl::cumulative_histogram(histogram<nr_values>(img_src));
+  const auto nr_pixels = cdf.back();
+
+  if (nr_pixels == 0)
+  {
+    allocate(img_dst, img_src.layout());
+    return;
+  }
+
+  const auto cdf_min = *std::find_if(cdf.cbegin(), cdf.cend(), [](std::uint64_t v) { return v > 0; });
+
+  std::vector<Element> lut(nr_values);
+
+  for (std::size_t v = 0; v < nr_values; ++v)
+  {
+    if (nr_pixels == cdf_min)  // single value
+    {
+      lut[v] = static_cast<Element>(v);
+      continue;
+    }
+
+    const auto numerator = static_cast<double>(cdf[v] > cdf_min ? cdf[v] - cdf_min : 0);
+    const auto scale = static_cast<double>(nr_values - 1) / static_cast<double>(nr_pixels - cdf_min);
+    lut[v] = static_cast<Element>(std::lround(numerator * scale));
+  }
+
+  apply_lut(img_src, img_dst, lut);
+}
+
+/** \brief Maps the values of a single-channel image such that its histogram approximately matches the histogram of a
+ * reference image.
+ *
+ * Each value `v` is mapped to the smallest value `r` for which the normalized cumulative histogram of the reference
+ * image is at least the normalized cumulative histogram of the source image at `v`.
+ *
+ * `allocate` is called on the destination image prior to performing the operation.
+ * Throws an exception if the reference image is empty.
+ *
+ * @tparam DerivedSrc The typed source image type; single-channel, with 8-bit or 16-bit unsigned integer elements.
+ * @tparam DerivedRef The typed reference image type; of the same pixel type as the source.
+ * @tparam DerivedDst The typed destination image type; of the same pixel type as the source.
+ * @param img_src The source image.
+ * @param img_ref The reference image.
+ * @param[out] img_dst The destination image.
+ */
+template <typename DerivedSrc, typename DerivedRef, typename DerivedDst>
+void match_histogram(const ImageBase<DerivedSrc>& img_src,
+                     const ImageBase<DerivedRef>& img_ref,
+                     ImageBase<DerivedDst>& img_dst)
+{
+  using PixelType = typename ImageBase<DerivedSrc>::PixelType;
+  using Element = typename PixelTraits<PixelType>::Element;
+  constexpr auto nr_values = impl::nr_histogram_values<Element>;
+  static_assert(PixelTraits<PixelType>::nr_channels == 1, "Histogram matching requires a single-channel image");
+  static_assert(std::is_same_v<typename PixelTraits<typename ImageBase<DerivedRef>::PixelType>::Element, Element>,
+                "Source and reference images have different element types");
+
+  const auto cdf_src = impl::cumulative_histogram(histogram<nr_values>(img_src));
+  const auto cdf_ref = impl::cumulative_histogram(histogram<nr_values>(img_ref));
+
+  if (cdf_ref.back() == 0)
+  {
+    throw std::runtime_error("match_histogram: Reference image is empty.");
+  }
+
+  const auto n_src = static_cast<double>(std::max(cdf_src.back(), std::uint64_t{1}));
+  const auto n_ref = static_cast<double>(cdf_ref.back());
+
+  // Both CDFs are monotonic; a single joint pass over both suffices.
+  std::vector<Element> lut(nr_values);
+  std::size_t r = 0;
+
+  for (std::size_t v = 0; v < nr_values; ++v)
+  {
+    const auto target = static_cast<double>(cdf_src[v]) / n_src;
+
+    while (r < nr_values - 1 && static_cast<double>(cdf_ref[r]) / n_ref < target)
+    {
+      ++r;
+    }
+
+    lut[v] = static_cast<Element>(r);
+  }
+
+  apply_lut(img_src, img_dst, lut);
+}
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_OPS_HISTOGRAM_HPP
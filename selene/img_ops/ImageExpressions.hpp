@@ -0,0 +1,601 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_OPS_IMAGE_EXPRESSIONS_HPP
+#define SELENE_IMG_OPS_IMAGE_EXPRESSIONS_HPP
+
+/// @file
+
+#include <selene/base/ExecutionPolicy.hpp>
+
+#include <selene/img/pixel/Pixel.hpp>
+#include <selene/img/pixel/PixelTraits.hpp>
+
+#include <selene/img/typed/Image.hpp>
+#include <selene/img/typed/ImageBase.hpp>
+
+#include <selene/img_ops/Algorithms.hpp>
+#include <selene/img_ops/Allocate.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+namespace sln {
+
+/** \brief Describes how the values computed by an image expression are converted to the destination element type.
+ */
+enum class ConversionMode
+{
+  Cast,  ///< Values are converted using `static_cast` (i.e. integers wrap around, floating point values are truncated).
+  Saturate,  ///< Values are rounded to nearest (if floating point), and clamped to the range of the destination type.
+};
+
+template <typename Derived>
+class ImageExpr;
+
+template <typename PixelTypeDst, ConversionMode mode = ConversionMode::Cast, typename Expr>
+Image<PixelTypeDst> evaluate(const ImageExpr<Expr>& expr);
+
+/** \brief Base class of all lazily evaluated image expressions.
+ *
+ * Image expressions are created by applying the arithmetic operators `+`, `-`, `*`, `/` to typed images or views,
+ * scalars, pixel values, or other image expressions, where at least one operand is an image or an image expression.
+ * No computation is performed when creating an expression. The whole expression is evaluated in a single pass over the
+ * image data, without intermediate images, when it is assigned to an `Image<>` or passed to `evaluate()`.
+ *
+ * The arithmetic is performed element-wise (i.e. channel-wise), following the usual arithmetic conversions of
+ * C++; e.g. the sum of two 8-bit values is computed as `int`, and the product of an 8-bit value with a `float` is
+ * computed as `float`. Hence, intermediate results do not overflow for typical expressions over 8- and 16-bit images.
+ * Scalars are broadcast to all channels.
+ *
+ * Image expressions store references to the (non-view) images they are composed of, and copies of views, scalars and
+ * pixel values. An expression must therefore not be evaluated after any of its images has been destroyed; in
+ * particular, it is generally not advisable to store image expressions in variables declared with `auto`.
+ *
+ * @tparam Derived The derived expression type.
+ */
+template <typename Derived>
+class ImageExpr
+{
+public:
+  const Derived& derived() const noexcept { return *static_cast<const Derived*>(this); }
+
+  /** \brief Evaluates the expression into a newly allocated image.
+   *
+   * Element values are converted using `ConversionMode::Cast`.
+   *
+   * @tparam PixelType The pixel type of the destination image.
+   * @return The image containing the evaluated expression.
+   */
+  template <typename PixelType>
+  operator Image<PixelType>() const
+  {
+    return evaluate<PixelType>(derived());
+  }
+};
+
+template <typename T>
+constexpr bool is_image_expression_v = std::is_base_of_v<ImageExpr<T>, T>;
+
+template <ConversionMode mode = ConversionMode::Cast, typename Expr, typename DerivedDst>
+void evaluate(const ImageExpr<Expr>& expr, ImageBase<DerivedDst>& img_dst);
+
+template <ConversionMode mode = ConversionMode::Cast,
+          typename ExecutionPolicy,
+          typename Expr,
+          typename DerivedDst,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+void evaluate(ExecutionPolicy&& policy, const ImageExpr<Expr>& expr, ImageBase<DerivedDst>& img_dst);
+
+// ----------
+// Implementation:
+
+namespace impl {
+
+class ExpressionSize
+{
+public:
+  void add(PixelLength width, PixelLength height)
+  {
+    if (!valid_)
+    {
+      width_ = width;
+      height_ = height;
+      valid_ = true;
+    }
+    else if (width != width_ || height != height_)
+    {
+      throw std::runtime_error("evaluate: Images in expression are not the same size.");
+    }
+  }
+
+  PixelLength width() const noexcept { return width_; }
+  PixelLength height() const noexcept { return height_; }
+
+private:
+  PixelLength width_{0};
+  PixelLength height_{0};
+  bool valid_ = false;
+};
+
+// Comparison of integers of possibly different signedness, without implicit conversions.
+template <typename T, typename U>
+constexpr bool integer_less(T t, U u) noexcept
+{
+  if constexpr (std::is_signed_v<T> == std::is_signed_v<U>)
+  {
+    return t < u;
+  }
+  else if constexpr (std::is_signed_v<T>)
+  {
+    return t < 0 || static_cast<std::make_unsigned_t<T>>(t) < u;
+  }
+  else
+  {
+    return u >= 0 && t < static_cast<std::make_unsigned_t<U>>(u);
+  }
+}
+
+template <typename T, ConversionMode mode, typename U>
+constexpr T convert_element(U value) noexcept
+{
+  if constexpr (mode == ConversionMode::Cast || std::is_floating_point_v<T> || std::is_same_v<T, U>)
+  {
+    return static_cast<T>(value);
+  }
+  else if constexpr (std::is_floating_point_v<U>)
+  {
+    // Compare in double precision; the maximum of 64-bit integers is not exactly representable, hence `>=`.
+    const auto v = std::nearbyint(static_cast<double>(value));
+    constexpr auto lo = static_cast<double>(std::numeric_limits<T>::min());
+    constexpr auto hi = static_cast<double>(std::numeric_limits<T>::max());
+    return !(v > lo) ? std::numeric_limits<T>::min()  // also maps NaN to the minimum
+                     : (v >= hi ? std::numeric_limits<T>::max() : static_cast<T>(v));
+  }
+  else
+  {
+    return integer_less(value, std::numeric_limits<T>::min())
+               ? std::numeric_limits<T>::min()
+               : (integer_less(std::numeric_limits<T>::max(), value) ? std::numeric_limits<T>::max()
+                                                                      : static_cast<T>(value));
+  }
+}
+
+// Element-wise operations; operands are explicitly converted to the type of the result, following the usual
+// arithmetic conversions.
+
+struct AddOp
+{
+  template <typename T, typename U>
+  constexpr auto operator()(T a, U b) const noexcept
+  {
+    using C = decltype(a + b);
+    return static_cast<C>(a) + static_cast<C>(b);
+  }
+};
+
+struct SubtractOp
+{
+  template <typename T, typename U>
+  constexpr auto operator()(T a, U b) const noexcept
+  {
+    using C = decltype(a - b);
+    return static_cast<C>(a) - static_cast<C>(b);
+  }
+};
+
+struct MultiplyOp
+{
+  template <typename T, typename U>
+  constexpr auto operator()(T a, U b) const noexcept
+  {
+    using C = decltype(a * b);
+    return static_cast<C>(a) * static_cast<C>(b);
+  }
+};
+
+struct DivideOp
+{
+  template <typename T, typename U>
+  constexpr auto operator()(T a, U b) const noexcept
+  {
+    using C = decltype(a / b);
+    return static_cast<C>(a) / static_cast<C>(b);
+  }
+};
+
+// Expression leaves
+
+template <typename ImageType>
+class ImageOperand
+{
+public:
+  using PixelType = typename ImageType::PixelType;
+  constexpr static auto nr_channels = PixelTraits<PixelType>::nr_channels;
+
+  explicit ImageOperand(const ImageType& img) : img_(store(img)) {}
+
+  void collect_size(ExpressionSize& size) const { size.add(image().width(), image().height()); }
+
+  auto row(PixelIndex y) const noexcept
+  {
+    struct Row
+    {
+      const PixelType* ptr;
+      auto operator()(std::ptrdiff_t x, std::size_t c) const noexcept { return get_channel(ptr[x], c); }
+    };
+
+    return Row{image().data(y)};
+  }
+
+private:
+  // Views are stored by value, so that expressions over temporary views (e.g. from `view()`) remain valid.
+  using Storage = std::conditional_t<ImageType::is_view, ImageType, const ImageType*>;
+  Storage img_;
+
+  static Storage store(const ImageType& img) noexcept
+  {
+    if constexpr (ImageType::is_view)
+    {
+      return img;
+    }
+    else
+    {
+      return &img;
+    }
+  }
+
+  const ImageType& image() const noexcept
+  {
+    if constexpr (ImageType::is_view)
+    {
+      return img_;
+    }
+    else
+    {
+      return *img_;
+    }
+  }
+};
+
+template <typename T>
+class ScalarOperand
+{
+public:
+  constexpr static std::int16_t nr_channels = 0;  // broadcast to any number of channels
+
+  explicit ScalarOperand(T value) : value_(value) {}
+
+  void collect_size(ExpressionSize&) const {}
+
+  auto row(PixelIndex) const noexcept
+  {
+    struct Row
+    {
+      T value;
+      T operator()(std::ptrdiff_t, std::size_t) const noexcept { return value; }
+    };
+
+    return Row{value_};
+  }
+
+private:
+  T value_;
+};
+
+template <typename PixelType>
+class PixelOperand
+{
+public:
+  constexpr static auto nr_channels = PixelTraits<PixelType>::nr_channels;
+
+  explicit PixelOperand(const PixelType& px) : px_(px) {}
+
+  void collect_size(ExpressionSize&) const {}
+
+  auto row(PixelIndex) const noexcept
+  {
+    struct Row
+    {
+      PixelType px;
+      auto operator()(std::ptrdiff_t, std::size_t c) const noexcept { return px[c]; }
+    };
+
+    return Row{px_};
+  }
+
+private:
+  PixelType px_;
+};
+
+template <typename T>
+constexpr bool is_image_expression_operand_v = is_image_type_v<T> || is_image_expression_v<T>;
+
+template <typename T>
+constexpr bool is_image_expression_argument_v =
+    is_image_expression_operand_v<T> || std::is_arithmetic_v<T> || is_pixel_type_v<T>;
+
+template <typename L, typename R>
+constexpr bool enable_image_expression_operator_v =
+    is_image_expression_argument_v<L> && is_image_expression_argument_v<R>
+    && (is_image_expression_operand_v<L> || is_image_expression_operand_v<R>);
+
+template <typename Derived>
+auto as_operand(const ImageBase<Derived>& img)
+{
+  return ImageOperand<Derived>(img.derived());
+}
+
+template <typename Expr>
+Expr as_operand(const ImageExpr<Expr>& expr)
+{
+  return expr.derived();
+}
+
+template <typename T, std::size_t nr_channels_, PixelFormat pixel_format_>
+auto as_operand(const Pixel<T, nr_channels_, pixel_format_>& px)
+{
+  return PixelOperand<Pixel<T, nr_channels_, pixel_format_>>(px);
+}
+
+template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+auto as_operand(T value)
+{
+  return ScalarOperand<T>(value);
+}
+
+// Expression nodes
+
+template <typename Op, typename L, typename R>
+class BinaryImageExpr : public ImageExpr<BinaryImageExpr<Op, L, R>>
+{
+public:
+  static_assert(L::nr_channels == R::nr_channels || L::nr_channels == 0 || R::nr_channels == 0,
+                "Operands of image expression have different numbers of channels");
+
+  constexpr static std::int16_t nr_channels = (L::nr_channels > R::nr_channels) ? L::nr_channels : R::nr_channels;
+
+  BinaryImageExpr(const L& lhs, const R& rhs) : lhs_(lhs), rhs_(rhs) {}
+
+  void collect_size(ExpressionSize& size) const
+  {
+    lhs_.collect_size(size);
+    rhs_.collect_size(size);
+  }
+
+  auto row(PixelIndex y) const noexcept
+  {
+    using RowL = decltype(lhs_.row(y));
+    using RowR = decltype(rhs_.row(y));
+
+    struct Row
+    {
+      RowL l;
+      RowR r;
+      auto operator()(std::ptrdiff_t x, std::size_t c) const noexcept { return Op{}(l(x, c), r(x, c)); }
+    };
+
+    return Row{lhs_.row(y), rhs_.row(y)};
+  }
+
+private:
+  L lhs_;
+  R rhs_;
+};
+
+template <typename E>
+class NegateImageExpr : public ImageExpr<NegateImageExpr<E>>
+{
+public:
+  constexpr static std::int16_t nr_channels = E::nr_channels;
+
+  explicit NegateImageExpr(const E& expr) : expr_(expr) {}
+
+  void collect_size(ExpressionSize& size) const { expr_.collect_size(size); }
+
+  auto row(PixelIndex y) const noexcept
+  {
+    using RowE = decltype(expr_.row(y));
+
+    struct Row
+    {
+      RowE e;
+      auto operator()(std::ptrdiff_t x, std::size_t c) const noexcept { return -e(x, c); }
+    };
+
+    return Row{expr_.row(y)};
+  }
+
+private:
+  E expr_;
+};
+
+template <typename Op, typename L, typename R>
+auto make_binary_image_expr(const L& lhs, const R& rhs)
+{
+  using OperandL = decltype(as_operand(lhs));
+  using OperandR = decltype(as_operand(rhs));
+  return BinaryImageExpr<Op, OperandL, OperandR>(as_operand(lhs), as_operand(rhs));
+}
+
+template <bool unsequenced, ConversionMode mode, typename PixelTypeDst, typename Row>
+void evaluate_row(const Row& row, PixelTypeDst* ptr_dst, std::ptrdiff_t width)
+{
+  using ElementDst = typename PixelTraits<PixelTypeDst>::Element;
+  constexpr auto nr_channels = static_cast<std::size_t>(PixelTraits<PixelTypeDst>::nr_channels);
+
+  if constexpr (unsequenced)
+  {
+    SELENE_VECTORIZE_LOOP
+    for (std::ptrdiff_t x = 0; x < width; ++x)
+    {
+      for (std::size_t c = 0; c < nr_channels; ++c)
+      {
+        get_channel(ptr_dst[x], c) = convert_element<ElementDst, mode>(row(x, c));
+      }
+    }
+  }
+  else
+  {
+    for (std::ptrdiff_t x = 0; x < width; ++x)
+    {
+      for (std::size_t c = 0; c < nr_channels; ++c)
+      {
+        get_channel(ptr_dst[x], c) = convert_element<ElementDst, mode>(row(x, c));
+      }
+    }
+  }
+}
+
+}  // namespace impl
+
+/** \brief Evaluates an image expression into the destination image, in a single pass.
+ *
+ * `allocate` is called on the destination image prior to evaluation. If the destination is a view, it hence needs to
+ * be of the same size as the images in the expression.
+ * The destination image may be one of the images in the expression.
+ *
+ * All images in the expression need to be of the same size; otherwise, an exception is thrown.
+ *
+ * @tparam mode The conversion mode to the destination element type.
+ * @tparam Expr The expression type.
+ * @tparam DerivedDst The typed destination image type.
+ * @param expr The image expression.
+ * @param[out] img_dst The destination image.
+ */
+template <ConversionMode mode, typename Expr, typename DerivedDst>
+void evaluate(const ImageExpr<Expr>& expr, ImageBase<DerivedDst>& img_dst)
+{
+  evaluate<mode>(execution::seq, expr, img_dst);
+}
+
+/** \brief Evaluates an image expression into the destination image, in a single pass, according to the specified
+ * execution policy.
+ *
+ * See the overload without execution policy for details.
+ *
+ * @tparam mode The conversion mode to the destination element type.
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam Expr The expression type.
+ * @tparam DerivedDst The typed destination image type.
+ * @param policy The execution policy.
+ * @param expr The image expression.
+ * @param[out] img_dst The destination image.
+ */
+template <ConversionMode mode, typename ExecutionPolicy, typename Expr, typename DerivedDst, typename>
+void evaluate(ExecutionPolicy&& policy, const ImageExpr<Expr>& expr, ImageBase<DerivedDst>& img_dst)
+{
+  using PixelTypeDst = typename ImageBase<DerivedDst>::PixelType;
+  static_assert(Expr::nr_channels == PixelTraits<PixelTypeDst>::nr_channels || Expr::nr_channels == 0,
+                "Image expression and destination image have different numbers of channels");
+
+  impl::ExpressionSize size;
+  expr.derived().collect_size(size);
+  allocate(img_dst, TypedLayout{size.width(), size.height()});
+
+  constexpr bool unsequenced = is_unsequenced_policy_v<ExecutionPolicy>;
+  const auto width = static_cast<std::ptrdiff_t>(img_dst.width());
+
+  impl::parallel_for(policy, 0, static_cast<std::ptrdiff_t>(img_dst.height()), impl::row_grain_size(width),
+                     [&](std::ptrdiff_t y_begin, std::ptrdiff_t y_end) {
+                       for (auto y = y_begin; y < y_end; ++y)
+                       {
+                         const auto row = impl::to_row_index(y);
+                         impl::evaluate_row<unsequenced, mode>(expr.derived().row(row), img_dst.data(row), width);
+                       }
+                     });
+}
+
+/** \brief Evaluates an image expression into a newly allocated image.
+ *
+ * @tparam PixelTypeDst The pixel type of the destination image.
+ * @tparam mode The conversion mode to the destination element type.
+ * @tparam Expr The expression type.
+ * @param expr The image expression.
+ * @return The image containing the evaluated expression.
+ */
+template <typename PixelTypeDst, ConversionMode mode, typename Expr>
+Image<PixelTypeDst> evaluate(const ImageExpr<Expr>& expr)
+{
+  Image<PixelTypeDst> img_dst;
+  evaluate<mode>(expr, img_dst);
+  return img_dst;
+}
+
+/** \brief Creates a lazily evaluated image expression representing the element-wise sum of both operands.
+ *
+ * @tparam L The left operand type (typed image, image expression, pixel value, or scalar).
+ * @tparam R The right operand type (typed image, image expression, pixel value, or scalar).
+ * @param lhs The left operand.
+ * @param rhs The right operand.
+ * @return The image expression.
+ */
+template <typename L, typename R, typename = std::enable_if_t<impl::enable_image_expression_operator_v<L, R>>>
+auto operator+(const L& lhs, const R& rhs)
+{
+  return impl::make_binary_image_expr<impl::AddOp>(lhs, rhs);
+}
+
+/** \brief Creates a lazily evaluated image expression representing the element-wise difference of both operands.
+ *
+ * @tparam L The left operand type (typed image, image expression, pixel value, or scalar).
+ * @tparam R The right operand type (typed image, image expression, pixel value, or scalar).
+ * @param lhs The left operand.
+ * @param rhs The right operand.
+ * @return The image expression.
+ */
+template <typename L, typename R, typename = std::enable_if_t<impl::enable_image_expression_operator_v<L, R>>>
+auto operator-(const L& lhs, const R& rhs)
+{
+  return impl::make_binary_image_expr<impl::SubtractOp>(lhs, rhs);
+}
+
+/** \brief Creates a lazily evaluated image expression representing the element-wise product of both operands.
+ *
+ * @tparam L The left operand type (typed image, image expression, pixel value, or scalar).
+ * @tparam R The right operand type (typed image, image expression, pixel value, or scalar).
+ * @param lhs The left operand.
+ * @param rhs The right operand.
+ * @return The image expression.
+ */
+template <typename L, typename R, typename = std::enable_if_t<impl::enable_image_expression_operator_v<L, R>>>
+auto operator*(const L& lhs, const R& rhs)
+{
+  return impl::make_binary_image_expr<impl::MultiplyOp>(lhs, rhs);
+}
+
+/** \brief Creates a lazily evaluated image expression representing the element-wise quotient of both operands.
+ *
+ * @tparam L The left operand type (typed image, image expression, pixel value, or scalar).
+ * @tparam R The right operand type (typed image, image expression, pixel value, or scalar).
+ * @param lhs The left operand.
+ * @param rhs The right operand.
+ * @return The image expression.
+ */
+template <typename L, typename R, typename = std::enable_if_t<impl::enable_image_expression_operator_v<L, R>>>
+auto operator/(const L& lhs, const R& rhs)
+{
+  return impl::make_binary_image_expr<impl::DivideOp>(lhs, rhs);
+}
+
+/** \brief Creates a lazily evaluated image expression representing the element-wise negation of the operand.
+ *
+ * @tparam E The operand type (typed image or image expression).
+ * @param operand The operand.
+ * @return The image expression.
+ */
+template <typename E, typename = std::enable_if_t<impl::is_image_expression_operand_v<E>>>
+auto operator-(const E& operand)
+{
+  using Operand = decltype(impl::as_operand(operand));
+  return impl::NegateImageExpr<Operand>(impl::as_operand(operand));
+}
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_OPS_IMAGE_EXPRESSIONS_HPP
@@ -0,0 +1,328 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_OPS_INTEGRAL_IMAGE_HPP
+#define SELENE_IMG_OPS_INTEGRAL_IMAGE_HPP
+
+/// @file
+
+#include <selene/base/Assert.hpp>
+#include <selene/base/ExecutionPolicy.hpp>
+
+#include <selene/img/common/BoundingBox.hpp>
+#include <selene/img/common/Types.hpp>
+
+#include <selene/img/pixel/Pixel.hpp>
+#include <selene/img/pixel/PixelTraits.hpp>
+
+#include <selene/img/typed/Image.hpp>
+#include <selene/img/typed/ImageBase.hpp>
+
+#include <selene/img_ops/Algorithms.hpp>
+#include <selene/img_ops/Allocate.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+namespace sln {
+
+// ----------
+// Implementation:
+
+namespace impl {
+
+/// Default element type of an integral image: 64-bit integers for integral source elements, otherwise double.
+template <typename T>
+using IntegralElement = std::conditional_t<std::is_integral_v<T>, std::int64_t, double>;
+
+/// Default element type of a squared integral image; 64-bit integers only suffice for up to 16-bit source elements.
+template <typename T>
+using SquaredIntegralElement = std::conditional_t<std::is_integral_v<T> && (sizeof(T) <= 2), std::int64_t, double>;
+
+template <typename PixelType>
+using IntegralPixel
+    = Pixel<IntegralElement<typename PixelTraits<PixelType>::Element>, PixelTraits<PixelType>::nr_channels>;
+
+template <typename PixelType>
+using SquaredIntegralPixel
+    = Pixel<SquaredIntegralElement<typename PixelTraits<PixelType>::Element>, PixelTraits<PixelType>::nr_channels>;
+
+/** \brief Checks, for an integral destination element type, that the sum of `nr_pixels` source values raised to
+ * `power` provably fits.
+ */
+template <typename ElementDst, typename ElementSrc>
+void check_integral_image_range(std::ptrdiff_t nr_pixels, int power)
+{
+  static_assert(std::is_floating_point_v<ElementDst> || std::is_integral_v<ElementSrc>,
+                "Integral images of floating point images need to have floating point elements");
+
+  if constexpr (std::is_integral_v<ElementDst>)
+  {
+    const auto max_abs = std::max(-static_cast<long double>(std::numeric_limits<ElementSrc>::lowest()),
+                                  static_cast<long double>(std::numeric_limits<ElementSrc>::max()));
+    const auto bound = static_cast<long double>(nr_pixels) * (power == 1 ? max_abs : max_abs * max_abs);
+    const auto dst_max = static_cast<long double>(std::numeric_limits<ElementDst>::max());
+    const auto dst_min = static_cast<long double>(std::numeric_limits<ElementDst>::lowest());
+    const bool needs_sign = std::is_signed_v<ElementSrc> && power == 1;
+
+    if (bound > dst_max || (needs_sign && -bound < dst_min))
+    {
+      throw std::runtime_error("integral_image: Integral image element type is too small.");
+    }
+  }
+}
+
+/** \brief First pass: computes the horizontal prefix sums of source row `y` (of the given power) into row `y + 1` of
+ * the destination.
+ *
+ * The first column of the destination row is zero.
+ */
+template <int power, typename DerivedSrc, typename DerivedDst>
+void integral_image_row(const ImageBase<DerivedSrc>& img_src, ImageBase<DerivedDst>& img_dst, std::ptrdiff_t y)
+{
+  using PixelTypeDst = typename ImageBase<DerivedDst>::PixelType;
+  using ElementDst = typename PixelTraits<PixelTypeDst>::Element;
+  constexpr auto nr_channels = static_cast<std::size_t>(PixelTraits<PixelTypeDst>::nr_channels);
+
+  const auto src = img_src.data(to_row_index(y));
+  auto dst = img_dst.data(to_row_index(y + 1));
+  const auto width = static_cast<std::ptrdiff_t>(img_src.width());
+
+  ElementDst acc[nr_channels] = {};
+
+  for (std::size_t c = 0; c < nr_channels; ++c)
+  {
+    get_channel(dst[0], c) = ElementDst{0};
+  }
+
+  for (std::ptrdiff_t x = 0; x < width; ++x)
+  {
+    for (std::size_t c = 0; c < nr_channels; ++c)
+    {
+      const auto v = static_cast<ElementDst>(get_channel(src[x], c));
+      acc[c] += (power == 1) ? v : static_cast<ElementDst>(v * v);
+      get_channel(dst[x + 1], c) = acc[c];
+    }
+  }
+}
+
+/** \brief Second pass: accumulates the horizontal prefix sums vertically, for the columns in [col_begin, col_end).
+ *
+ * Each row is added to the next one element-wise, which is independent across columns and can be vectorized.
+ */
+template <typename DerivedDst>
+void integral_image_columns(ImageBase<DerivedDst>& img_dst, std::ptrdiff_t col_begin, std::ptrdiff_t col_end)
+{
+  using PixelTypeDst = typename ImageBase<DerivedDst>::PixelType;
+  constexpr auto nr_channels = static_cast<std::size_t>(PixelTraits<PixelTypeDst>::nr_channels);
+  const auto height = static_cast<std::ptrdiff_t>(img_dst.height());
+
+  for (std::ptrdiff_t y = 2; y < height; ++y)
+  {
+    const auto prev = img_dst.data(to_row_index(y - 1));
+    auto cur = img_dst.data(to_row_index(y));
+
+    SELENE_VECTORIZE_LOOP
+    for (auto x = col_begin; x < col_end; ++x)
+    {
+      for (std::size_t c = 0; c < nr_channels; ++c)
+      {
+        get_channel(cur[x], c) += get_channel(prev[x], c);
+      }
+    }
+  }
+}
+
+template <int power, typename ExecutionPolicy, typename DerivedSrc, typename DerivedDst>
+void compute_integral_image(ExecutionPolicy&& policy,
+                            const ImageBase<DerivedSrc>& img_src,
+                            ImageBase<DerivedDst>& img_dst)
+{
+  using ElementSrc = typename PixelTraits<typename ImageBase<DerivedSrc>::PixelType>::Element;
+  using PixelTypeDst = typename ImageBase<DerivedDst>::PixelType;
+  static_assert(PixelTraits<typename ImageBase<DerivedSrc>::PixelType>::nr_channels
+                    == PixelTraits<PixelTypeDst>::nr_channels,
+                "Source and integral images have different numbers of channels");
+
+  const auto width = static_cast<std::ptrdiff_t>(img_src.width());
+  const auto height = static_cast<std::ptrdiff_t>(img_src.height());
+  check_integral_image_range<typename PixelTraits<PixelTypeDst>::Element, ElementSrc>(width * height, power);
+
+  allocate(img_dst, TypedLayout{PixelLength{img_src.width() + 1}, PixelLength{img_src.height() + 1}});
+
+  // The first row is zero.
+  constexpr auto nr_channels = static_cast<std::size_t>(PixelTraits<PixelTypeDst>::nr_channels);
+  auto dst_row_0 = img_dst.data(PixelIndex{0});
+  for (std::ptrdiff_t x = 0; x <= width; ++x)
+  {
+    for (std::size_t c = 0; c < nr_channels; ++c)
+    {
+      get_channel(dst_row_0[x], c) = 0;
+    }
+  }
+
+  // Pass 1: horizontal prefix sums, independently per row.
+  parallel_for(policy, 0, height, row_grain_size(width), [&](std::ptrdiff_t y_begin, std::ptrdiff_t y_end) {
+    for (auto y = y_begin; y < y_end; ++y)
+    {
+      integral_image_row<power>(img_src, img_dst, y);
+    }
+  });
+
+  // Pass 2: vertical accumulation, independently per column strip.
+  constexpr std::ptrdiff_t column_grain_size = 256;
+  parallel_for(policy, 1, width + 1, column_grain_size, [&](std::ptrdiff_t x_begin, std::ptrdiff_t x_end) {
+    integral_image_columns(img_dst, x_begin, x_end);
+  });
+}
+
+}  // namespace impl
+
+/** \brief Computes the integral image (summed-area table) of an image, according to the specified execution policy.
+ *
+ * The integral image has size `(width + 1) x (height + 1)`; the value at (x, y) is the (per-channel) sum of all source
+ * pixels in the rectangle [0, x) x [0, y). The first row and column are zero.
+ *
+ * The element type of the integral image is determined by the destination image; it defaults to `std::int64_t` for
+ * integral and `double` for floating point source images (see the overload returning the integral image). A 32-bit
+ * integral type can be used when the sum provably fits, e.g. for 8-bit images of up to 2^23 pixels; otherwise, an
+ * exception is thrown.
+ *
+ * The computation is performed in two passes: horizontal prefix sums (parallel over rows), followed by a vectorizable
+ * vertical accumulation (parallel over column strips).
+ *
+ * `allocate` is called on the destination image prior to performing the operation.
+ *
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam DerivedSrc The typed source image type.
+ * @tparam DerivedDst The typed integral image type.
+ * @param policy The execution policy.
+ * @param img_src The source image.
+ * @param[out] img_sum The integral image.
+ */
+template <typename ExecutionPolicy,
+          typename DerivedSrc,
+          typename DerivedDst,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+void integral_image(ExecutionPolicy&& policy, const ImageBase<DerivedSrc>& img_src, ImageBase<DerivedDst>& img_sum)
+{
+  impl::compute_integral_image<1>(policy, img_src, img_sum);
+}
+
+/** \brief Computes the integral image and the squared integral image of an image, according to the specified
+ * execution policy.
+ *
+ * The squared integral image contains sums of squared source values, and can be used for local variance computations.
+ * Its element type defaults to `std::int64_t` for up to 16-bit integral source elements, and `double` otherwise.
+ *
+ * See the single-output overload for details.
+ *
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam DerivedSrc The typed source image type.
+ * @tparam DerivedDst The typed integral image type.
+ * @tparam DerivedDstSq The typed squared integral image type.
+ * @param policy The execution policy.
+ * @param img_src The source image.
+ * @param[out] img_sum The integral image.
+ * @param[out] img_sqsum The squared integral image.
+ */
+template <typename ExecutionPolicy,
+          typename DerivedSrc,
+          typename DerivedDst,
+          typename DerivedDstSq,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+void integral_image(ExecutionPolicy&& policy,
+                    const ImageBase<DerivedSrc>& img_src,
+                    ImageBase<DerivedDst>& img_sum,
+                    ImageBase<DerivedDstSq>& img_sqsum)
+{
+  impl::compute_integral_image<1>(policy, img_src, img_sum);
+  impl::compute_integral_image<2>(policy, img_src, img_sqsum);
+}
+
+/** \brief Computes the integral image (summed-area table) of an image.
+ *
+ * See the overload accepting an execution policy for details.
+ *
+ * @tparam DerivedSrc The typed source image type.
+ * @tparam DerivedDst The typed integral image type.
+ * @param img_src The source image.
+ * @param[out] img_sum The integral image.
+ */
+template <typename DerivedSrc, typename DerivedDst>
+void integral_image(const ImageBase<DerivedSrc>& img_src, ImageBase<DerivedDst>& img_sum)
+{
+  integral_image(execution::seq, img_src, img_sum);
+}
+
+/** \brief Computes the integral image and the squared integral image of an image.
+ *
+ * See the overload accepting an execution policy for details.
+ *
+ * @tparam DerivedSrc The typed source image type.
+ * @tparam DerivedDst The typed integral image type.
+ * @tparam DerivedDstSq The typed squared integral image type.
+ * @param img_src The source image.
+ * @param[out] img_sum The integral image.
+ * @param[out] img_sqsum The squared integral image.
+ */
+template <typename DerivedSrc, typename DerivedDst, typename DerivedDstSq>
+void integral_image(const ImageBase<DerivedSrc>& img_src,
+                    ImageBase<DerivedDst>& img_sum,
+                    ImageBase<DerivedDstSq>& img_sqsum)
+{
+  integral_image(execution::seq, img_src, img_sum, img_sqsum);
+}
+
+/** \brief Computes and returns the integral image (summed-area table) of an image, with the default element type.
+ *
+ * @tparam DerivedSrc The typed source image type.
+ * @param img_src The source image.
+ * @return The integral image, of type `Image<Pixel<std::int64_t, N>>` or `Image<Pixel<double, N>>`.
+ */
+template <typename DerivedSrc>
+auto integral_image(const ImageBase<DerivedSrc>& img_src)
+{
+  Image<impl::IntegralPixel<typename ImageBase<DerivedSrc>::PixelType>> img_sum;
+  integral_image(execution::seq, img_src, img_sum);
+  return img_sum;
+}
+
+/** \brief Returns the (per-channel) sum of the source image pixels inside the specified box, in constant time.
+ *
+ * @tparam DerivedIntegral The typed integral image type.
+ * @param img_integral An integral image (or squared integral image), as computed by `integral_image`.
+ * @param box The box, in source image coordinates. It has to be fully contained in the source image.
+ * @return The sum of all source pixels in the box.
+ */
+template <typename DerivedIntegral>
+typename ImageBase<DerivedIntegral>::PixelType box_sum(const ImageBase<DerivedIntegral>& img_integral,
+                                                       const BoundingBox& box)
+{
+  using PixelType = typename ImageBase<DerivedIntegral>::PixelType;
+  SELENE_ASSERT(static_cast<std::ptrdiff_t>(box.x1()) < static_cast<std::ptrdiff_t>(img_integral.width())
+                && static_cast<std::ptrdiff_t>(box.y1()) < static_cast<std::ptrdiff_t>(img_integral.height()));
+
+  const auto row_0 = img_integral.data(box.y0());
+  const auto row_1 = img_integral.data(box.y1());
+  const auto x0 = static_cast<std::ptrdiff_t>(box.x0());
+  const auto x1 = static_cast<std::ptrdiff_t>(box.x1());
+
+  PixelType result;
+  for (std::size_t c = 0; c < static_cast<std::size_t>(PixelTraits<PixelType>::nr_channels); ++c)
+  {
+    impl::get_channel(result, c) = impl::get_channel(row_1[x1], c) - impl::get_channel(row_1[x0], c)
+                                   - impl::get_channel(row_0[x1], c) + impl::get_channel(row_0[x0], c);
+  }
+
+  return result;
+}
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_OPS_INTEGRAL_IMAGE_HPP
@@ -0,0 +1,384 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_OPS_MEDIAN_FILTER_HPP
+#define SELENE_IMG_OPS_MEDIAN_FILTER_HPP
+
+/// @file
+
+#include <selene/base/ExecutionPolicy.hpp>
+
+#include <selene/img/common/Types.hpp>
+
+#include <selene/img/pixel/PixelTraits.hpp>
+
+#include <selene/img/typed/ImageBase.hpp>
+
+#include <selene/img_ops/Algorithms.hpp>
+#include <selene/img_ops/Allocate.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace sln {
+
+// ----------
+// Implementation:
+
+namespace impl {
+
+constexpr std::ptrdiff_t median_nr_fine_bins = 256;
+constexpr std::ptrdiff_t median_nr_coarse_bins = 16;
+constexpr std::ptrdiff_t median_max_radius = 127;  // so that all counts fit into 16 bits
+
+inline std::ptrdiff_t clamp_index(std::ptrdiff_t i, std::ptrdiff_t size) noexcept
+{
+  return std::min(std::max(i, std::ptrdiff_t{0}), size - 1);
+}
+
+/// Sorts two values, such that `a <= b` afterwards.
+template <typename T>
+inline void sort_pair(T& a, T& b) noexcept
+{
+  const auto lo = std::min(a, b);
+  b = std::max(a, b);
+  a = lo;
+}
+
+/** \brief Computes the 3x3 median of a row, using a sorting network on three padded, single-channel line buffers.
+ *
+ * The network (19 compare-exchange operations) is evaluated for all positions in lockstep; there are no data-dependent
+ * branches, so the loop can be vectorized.
+ */
+template <typename T>
+void median_3x3_row(const T* row_0, const T* row_1, const T* row_2, T* out, std::ptrdiff_t width)
+{
+  SELENE_VECTORIZE_LOOP
+  for (std::ptrdiff_t x = 0; x < width; ++x)
+  {
+    T p0 = row_0[x], p1 = row_0[x + 1], p2 = row_0[x + 2];
+    T p3 = row_1[x], p4 = row_1[x + 1], p5 = row_1[x + 2];
+    T p6 = row_2[x], p7 = row_2[x + 1], p8 = row_2[x + 2];
+
+    sort_pair(p1, p2);
+    sort_pair(p4, p5);
+    sort_pair(p7, p8);
+
+    sort_pair(p0, p1);
+    sort_pair(p3, p4);
+    sort_pair(p6, p7);
+
+    sort_pair(p1, p2);
+    sort_pair(p4, p5);
+    sort_pair(p7, p8);
+
+    sort_pair(p0, p3);
+    sort_pair(p5, p8);
+    sort_pair(p4, p7);
+
+    sort_pair(p3, p6);
+    sort_pair(p1, p4);
+    sort_pair(p2, p5);
+
+    sort_pair(p4, p7);
+    sort_pair(p4, p2);
+    sort_pair(p6, p4);
+
+    sort_pair(p4, p2);
+
+    out[x] = p4;
+  }
+}
+
+template <typename ExecutionPolicy, typename DerivedSrc, typename DerivedDst>
+void median_filter_3x3(ExecutionPolicy&& policy, const ImageBase<DerivedSrc>& img_src, ImageBase<DerivedDst>& img_dst)
+{
+  using PixelType = typename ImageBase<DerivedSrc>::PixelType;
+  constexpr auto nr_channels = static_cast<std::ptrdiff_t>(PixelTraits<PixelType>::nr_channels);
+  const auto width = static_cast<std::ptrdiff_t>(img_src.width());
+  const auto height = static_cast<std::ptrdiff_t>(img_src.height());
+
+  parallel_for(policy, 0, height, row_grain_size(width), [&](std::ptrdiff_t y_begin, std::ptrdiff_t y_end) {
+    // Planar line buffers of width + 2, with replicated borders
+    std::vector<std::uint8_t> rows(static_cast<std::size_t>(3 * (width + 2)));
+    std::vector<std::uint8_t> out(static_cast<std::size_t>(width));
+
+    for (auto y = y_begin; y < y_end; ++y)
+    {
+      for (std::ptrdiff_t c = 0; c < nr_channels; ++c)
+      {
+        for (std::ptrdiff_t i = 0; i < 3; ++i)
+        {
+          const auto src = img_src.data(to_row_index(clamp_index(y + i - 1, height)));
+          auto row = &rows[static_cast<std::size_t>(i * (width + 2))];
+          for (std::ptrdiff_t x = 0; x < width + 2; ++x)
+          {
+            row[x] = get_channel(src[clamp_index(x - 1, width)], static_cast<std::size_t>(c));
+          }
+        }
+
+        median_3x3_row(rows.data(), rows.data() + (width + 2), rows.data() + 2 * (width + 2), out.data(), width);
+
+        auto dst = img_dst.data(to_row_index(y));
+        for (std::ptrdiff_t x = 0; x < width; ++x)
+        {
+          get_channel(dst[x], static_cast<std::size_t>(c)) = out[static_cast<std::size_t>(x)];
+        }
+      }
+    }
+  });
+}
+
+/** \brief A 256-bin histogram of 8-bit values, with an additional 16-bin coarse level for fast median search.
+ */
+struct MedianHistogram
+{
+  std::array<std::uint16_t, median_nr_fine_bins> fine;
+  std::array<std::uint16_t, median_nr_coarse_bins> coarse;
+
+  void clear() noexcept
+  {
+    fine.fill(0);
+    coarse.fill(0);
+  }
+
+  void add_value(std::uint8_t v) noexcept
+  {
+    ++fine[v];
+    ++coarse[v >> 4];
+  }
+
+  void remove_value(std::uint8_t v) noexcept
+  {
+    --fine[v];
+    --coarse[v >> 4];
+  }
+
+  void add(const MedianHistogram& h) noexcept
+  {
+    SELENE_VECTORIZE_LOOP
+    for (std::size_t i = 0; i < fine.size(); ++i)
+    {
+      fine[i] = static_cast<std::uint16_t>(fine[i] + h.fine[i]);
+    }
+
+    for (std::size_t i = 0; i < coarse.size(); ++i)
+    {
+      coarse[i] = static_cast<std::uint16_t>(coarse[i] + h.coarse[i]);
+    }
+  }
+
+  /// Adds `h_add` and removes `h_remove` in a single sweep.
+  void add_remove(const MedianHistogram& h_add, const MedianHistogram& h_remove) noexcept
+  {
+    SELENE_VECTORIZE_LOOP
+    for (std::size_t i = 0; i < fine.size(); ++i)
+    {
+      fine[i] = static_cast<std::uint16_t>(fine[i] + h_add.fine[i] - h_remove.fine[i]);
+    }
+
+    for (std::size_t i = 0; i < coarse.size(); ++i)
+    {
+      coarse[i] = static_cast<std::uint16_t>(coarse[i] + h_add.coarse[i] - h_remove.coarse[i]);
+    }
+  }
+
+  /// Returns the value of 0-based rank `rank`; first locating the coarse bin, then the fine bin.
+  std::uint8_t value_of_rank(std::ptrdiff_t rank) const noexcept
+  {
+    std::ptrdiff_t acc = 0;
+    std::size_t cb = 0;
+    for (; cb + 1 < coarse.size() && acc + coarse[cb] <= rank; ++cb)
+    {
+      acc += coarse[cb];
+    }
+
+    auto b = cb * 16;
+    for (; b + 1 < (cb + 1) * 16 && acc + fine[b] <= rank; ++b)
+    {
+      acc += fine[b];
+    }
+
+    return static_cast<std::uint8_t>(b);
+  }
+};
+
+/** \brief Median filter using the constant-time algorithm of Perreault and Hébert, on a strip of output columns.
+ *
+ * One histogram is kept per (border-extended) column, covering the `2 * radius + 1` rows around the current row; it
+ * is updated with one removal and one addition when moving down. The kernel histogram is the sum of `2 * radius + 1`
+ * column histograms, and is updated with one column histogram addition and removal when moving right.
+ */
+template <typename DerivedSrc, typename DerivedDst>
+void median_filter_histogram_strip(const ImageBase<DerivedSrc>& img_src,
+                                   ImageBase<DerivedDst>& img_dst,
+                                   std::ptrdiff_t radius,
+                                   std::ptrdiff_t x0,
+                                   std::ptrdiff_t x1,
+                                   std::vector<MedianHistogram>& col_hists)
+{
+  using PixelType = typename ImageBase<DerivedSrc>::PixelType;
+  constexpr auto nr_channels = static_cast<std::ptrdiff_t>(PixelTraits<PixelType>::nr_channels);
+  const auto width = static_cast<std::ptrdiff_t>(img_src.width());
+  const auto height = static_cast<std::ptrdiff_t>(img_src.height());
+  const auto k = 2 * radius + 1;
+  const auto rank = (k * k) / 2;
+  const auto nr_cols = (x1 - x0) + 2 * radius;
+
+  col_hists.resize(static_cast<std::size_t>(nr_cols));
+  const auto col_hist = [&](std::ptrdiff_t j) -> MedianHistogram& { return col_hists[static_cast<std::size_t>(j)]; };
+  const auto value = [&](std::ptrdiff_t x, std::ptrdiff_t y, std::ptrdiff_t c) {
+    const auto src = img_src.data(to_row_index(clamp_index(y, height)));
+    return static_cast<std::uint8_t>(get_channel(src[clamp_index(x, width)], static_cast<std::size_t>(c)));
+  };
+
+  for (std::ptrdiff_t c = 0; c < nr_channels; ++c)
+  {
+    // Column histograms for the first row
+    for (std::ptrdiff_t j = 0; j < nr_cols; ++j)
+    {
+      col_hist(j).clear();
+      for (auto y = -radius; y <= radius; ++y)
+      {
+        col_hist(j).add_value(value(x0 - radius + j, y, c));
+      }
+    }
+
+    MedianHistogram kernel_hist;
+
+    for (std::ptrdiff_t y = 0; y < height; ++y)
+    {
+      if (y > 0)
+      {
+        for (std::ptrdiff_t j = 0; j < nr_cols; ++j)
+        {
+          col_hist(j).remove_value(value(x0 - radius + j, y - radius - 1, c));
+          col_hist(j).add_value(value(x0 - radius + j, y + radius, c));
+        }
+      }
+
+      kernel_hist.clear();
+      for (std::ptrdiff_t j = 0; j < k; ++j)
+      {
+        kernel_hist.add(col_hist(j));
+      }
+
+      auto dst = img_dst.data(to_row_index(y));
+      for (auto x = x0; x < x1; ++x)
+      {
+        get_channel(dst[x], static_cast<std::size_t>(c)) = kernel_hist.value_of_rank(rank);
+
+        if (x + 1 < x1)
+        {
+          const auto j = x - x0;
+          kernel_hist.add_remove(col_hist(j + k), col_hist(j));
+        }
+      }
+    }
+  }
+}
+
+}  // namespace impl
+
+/** \brief Applies a median filter with a square `(2 * radius + 1) x (2 * radius + 1)` window to an 8-bit image,
+ * according to the specified execution policy.
+ *
+ * The filter is applied independently to each channel; pixels outside of the image are replicated from the border.
+ *
+ * For `radius == 1`, a vectorizable sorting network is used. For larger radii, the constant-time algorithm by
+ * Perreault and Hébert (column histograms with a coarse/fine histogram structure) is used, run in parallel on strips
+ * of columns; the cost per pixel is independent of the radius.
+ *
+ * `allocate` is called on the destination image prior to performing the operation.
+ *
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam DerivedSrc The typed source image type, with 8-bit unsigned elements (e.g. `Image_8u1` or `Image_8u3`).
+ * @tparam DerivedDst The typed destination image type; of the same pixel type as the source.
+ * @param policy The execution policy.
+ * @param img_src The source image.
+ * @param[out] img_dst The destination image. Must not refer to the same memory as the source image.
+ * @param radius The filter radius; at most 127.
+ */
+template <typename ExecutionPolicy,
+          typename DerivedSrc,
+          typename DerivedDst,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+void median_filter(ExecutionPolicy&& policy,
+                   const ImageBase<DerivedSrc>& img_src,
+                   ImageBase<DerivedDst>& img_dst,
+                   PixelLength radius)
+{
+  using PixelType = typename ImageBase<DerivedSrc>::PixelType;
+  static_assert(std::is_same_v<typename PixelTraits<PixelType>::Element, std::uint8_t>,
+                "The median filter is only supported for 8-bit unsigned integral pixel elements");
+  static_assert(std::is_same_v<typename ImageBase<DerivedDst>::PixelType, PixelType>,
+                "Source and destination images need to have the same pixel type");
+
+  const auto r = static_cast<std::ptrdiff_t>(radius);
+  if (r < 0 || r > impl::median_max_radius)
+  {
+    throw std::runtime_error("median_filter: Invalid radius.");
+  }
+
+  allocate(img_dst, TypedLayout{img_src.width(), img_src.height()});
+
+  const auto width = static_cast<std::ptrdiff_t>(img_src.width());
+  const auto height = static_cast<std::ptrdiff_t>(img_src.height());
+
+  if (width == 0 || height == 0)
+  {
+    return;
+  }
+
+  if (r == 0)
+  {
+    transform_pixels(policy, img_src, img_dst, [](const auto& px) { return px; });
+    return;
+  }
+
+  if (r == 1)
+  {
+    impl::median_filter_3x3(policy, img_src, img_dst);
+    return;
+  }
+
+  constexpr std::ptrdiff_t strip_width = 128;
+  const auto nr_strips = (width + strip_width - 1) / strip_width;
+
+  impl::parallel_for(policy, 0, nr_strips, 1, [&](std::ptrdiff_t strip_begin, std::ptrdiff_t strip_end) {
+    std::vector<impl::MedianHistogram> col_hists;
+
+    for (auto strip = strip_begin; strip < strip_end; ++strip)
+    {
+      const auto x0 = strip * strip_width;
+      const auto x1 = std::min(x0 + strip_width, width);
+      impl::median_filter_histogram_strip(img_src, img_dst, r, x0, x1, col_hists);
+    }
+  });
+}
+
+/** \brief Applies a median filter with a square `(2 * radius + 1) x (2 * radius + 1)` window to an 8-bit image.
+ *
+ * See the overload accepting an execution policy for details.
+ *
+ * @tparam DerivedSrc The typed source image type, with 8-bit unsigned elements (e.g. `Image_8u1` or `Image_8u3`).
+ * @tparam DerivedDst The typed destination image type; of the same pixel type as the source.
+ * @param img_src The source image.
+ * @param[out] img_dst The destination image. Must not refer to the same memory as the source image.
+ * @param radius The filter radius; at most 127.
+ */
+template <typename DerivedSrc, typename DerivedDst>
+void median_filter(const ImageBase<DerivedSrc>& img_src, ImageBase<DerivedDst>& img_dst, PixelLength radius)
+{
+  median_filter(execution::seq, img_src, img_dst, radius);
+}
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_OPS_MEDIAN_FILTER_HPP
@@ -0,0 +1,552 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_OPS_MORPHOLOGY_HPP
+#define SELENE_IMG_OPS_MORPHOLOGY_HPP
+
+/// @file
+
+#include <selene/base/ExecutionPolicy.hpp>
+
+#include <selene/img/common/Types.hpp>
+
+#include <selene/img/pixel/PixelTraits.hpp>
+
+#include <selene/img/typed/Image.hpp>
+#include <selene/img/typed/ImageBase.hpp>
+
+#include <selene/img/typed/access/BorderAccessors.hpp>
+
+#include <selene/img_ops/Algorithms.hpp>
+#include <selene/img_ops/Allocate.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace sln {
+
+// ----------
+// Implementation:
+
+namespace impl {
+
+struct MorphologyMinOp
+{
+  template <typename T>
+  static constexpr T apply(T a, T b) noexcept
+  {
+    return (b < a) ? b : a;
+  }
+};
+
+struct MorphologyMaxOp
+{
+  template <typename T>
+  static constexpr T apply(T a, T b) noexcept
+  {
+    return (a < b) ? b : a;
+  }
+};
+
+/** \brief Computes a 1-D running minimum/maximum over windows of length `k` using the van Herk/Gil-Werman algorithm.
+ *
+ * The input `f` consists of `n + k - 1` positions, the output `g` of `n` positions; each position holds `m`
+ * consecutive elements, which are processed independently (channels, or a strip of columns).
+ * Per element, about three comparisons are performed, independent of `k`.
+ *
+ * @param s Buffer for the forward (prefix) results within each block of length `k`; of the same size as `f`.
+ * @param r Buffer for the backward (suffix) results within each block of length `k`; of the same size as `f`.
+ */
+template <typename Op, typename T>
+void van_herk_gil_werman(const T* f, T* g, std::ptrdiff_t n, std::ptrdiff_t k, std::ptrdiff_t m, T* s, T* r)
+{
+  const auto len = n + k - 1;
+
+  for (std::ptrdiff_t b = 0; b < len; b += k)
+  {
+    const auto e = std::min(b + k, len);
+
+    std::copy(f + b * m, f + (b + 1) * m, s + b * m);
+    for (auto i = b + 1; i < e; ++i)
+    {
+      SELENE_VECTORIZE_LOOP
+      for (std::ptrdiff_t j = 0; j < m; ++j)
+      {
+        s[i * m + j] = Op::apply(s[(i - 1) * m + j], f[i * m + j]);
+      }
+    }
+
+    std::copy(f + (e - 1) * m, f + e * m, r + (e - 1) * m);
+    for (auto i = e - 2; i >= b; --i)
+    {
+      SELENE_VECTORIZE_LOOP
+      for (std::ptrdiff_t j = 0; j < m; ++j)
+      {
+        r[i * m + j] = Op::apply(r[(i + 1) * m + j], f[i * m + j]);
+      }
+    }
+  }
+
+  for (std::ptrdiff_t i = 0; i < n; ++i)
+  {
+    SELENE_VECTORIZE_LOOP
+    for (std::ptrdiff_t j = 0; j < m; ++j)
+    {
+      g[i * m + j] = Op::apply(r[i * m + j], s[(i + k - 1) * m + j]);
+    }
+  }
+}
+
+/** \brief Computes a 1-D running minimum/maximum over windows of length `k` <= 3 directly.
+ *
+ * This is the fast path for small (e.g. 3x3) structuring elements, for which the block decomposition does not pay off.
+ */
+template <typename Op, typename T>
+void running_extremum_small(const T* f, T* g, std::ptrdiff_t n, std::ptrdiff_t k, std::ptrdiff_t m)
+{
+  const auto nm = n * m;
+
+  if (k == 1)
+  {
+    std::copy(f, f + nm, g);
+  }
+  else if (k == 2)
+  {
+    SELENE_VECTORIZE_LOOP
+    for (std::ptrdiff_t i = 0; i < nm; ++i)
+    {
+      g[i] = Op::apply(f[i], f[i + m]);
+    }
+  }
+  else
+  {
+    SELENE_VECTORIZE_LOOP
+    for (std::ptrdiff_t i = 0; i < nm; ++i)
+    {
+      g[i] = Op::apply(Op::apply(f[i], f[i + m]), f[i + 2 * m]);
+    }
+  }
+}
+
+template <typename Op, typename T>
+void running_extremum(const T* f, T* g, std::ptrdiff_t n, std::ptrdiff_t k, std::ptrdiff_t m, std::vector<T>& s,
+                      std::vector<T>& r)
+{
+  if (k <= 3)
+  {
+    running_extremum_small<Op>(f, g, n, k, m);
+    return;
+  }
+
+  const auto buffer_size = static_cast<std::size_t>((n + k - 1) * m);
+  s.resize(buffer_size);
+  r.resize(buffer_size);
+  van_herk_gil_werman<Op>(f, g, n, k, m, s.data(), r.data());
+}
+
+/** \brief Applies a rectangular erosion (`MorphologyMinOp`) or dilation (`MorphologyMaxOp`), as two separable passes.
+ *
+ * The horizontal pass is parallelized over rows, the vertical pass over column strips. Out-of-image values are
+ * obtained via `ImageBorderAccessor<access_mode>` when filling the padded line buffers.
+ */
+template <typename Op, BorderAccessMode access_mode, typename ExecutionPolicy, typename DerivedSrc,
+          typename DerivedDst>
+void morphology_rectangle(ExecutionPolicy&& policy,
+                          const ImageBase<DerivedSrc>& img_src,
+                          ImageBase<DerivedDst>& img_dst,
+                          PixelLength se_width,
+                          PixelLength se_height,
+                          const char* function_name)
+{
+  using PixelType = typename ImageBase<DerivedSrc>::PixelType;
+  using Element = typename PixelTraits<PixelType>::Element;
+  constexpr auto nr_channels = static_cast<std::ptrdiff_t>(PixelTraits<PixelType>::nr_channels);
+  static_assert(std::is_same_v<typename ImageBase<DerivedDst>::PixelType, PixelType>,
+                "Source and destination images need to have the same pixel type");
+  static_assert(access_mode != BorderAccessMode::Unchecked,
+                "Morphological operations always access pixels outside the image; choose a checked border mode");
+
+  if (se_width <= 0 || se_height <= 0)
+  {
+    throw std::runtime_error(std::string(function_name) + ": Invalid structuring element size.");
+  }
+
+  const auto width = static_cast<std::ptrdiff_t>(img_src.width());
+  const auto height = static_cast<std::ptrdiff_t>(img_src.height());
+  const auto kx = static_cast<std::ptrdiff_t>(se_width);
+  const auto ky = static_cast<std::ptrdiff_t>(se_height);
+  const auto anchor_x = (kx - 1) / 2;
+  const auto anchor_y = (ky - 1) / 2;
+
+  Image<PixelType> img_tmp({img_src.width(), img_src.height()});
+  allocate(img_dst, TypedLayout{img_src.width(), img_src.height()});
+
+  if (width == 0 || height == 0)
+  {
+    return;
+  }
+
+  const auto store_channels = [](const PixelType& px, Element* ptr) {
+    for (std::ptrdiff_t c = 0; c < nr_channels; ++c)
+    {
+      ptr[c] = get_channel(px, static_cast<std::size_t>(c));
+    }
+  };
+
+  const auto load_channels = [](const Element* ptr, PixelType& px) {
+    for (std::ptrdiff_t c = 0; c < nr_channels; ++c)
+    {
+      get_channel(px, static_cast<std::size_t>(c)) = ptr[c];
+    }
+  };
+
+  // Horizontal pass: source -> temporary image
+  parallel_for(policy, 0, height, row_grain_size(width), [&](std::ptrdiff_t y_begin, std::ptrdiff_t y_end) {
+    std::vector<Element> f(static_cast<std::size_t>((width + kx - 1) * nr_channels));
+    std::vector<Element> g(static_cast<std::size_t>(width * nr_channels));
+    std::vector<Element> s, r;
+
+    for (auto y = y_begin; y < y_end; ++y)
+    {
+      const auto yi = to_row_index(y);
+      const auto src = img_src.data(yi);
+      for (std::ptrdiff_t x = 0; x < width + kx - 1; ++x)
+      {
+        const auto xs = x - anchor_x;
+        const PixelType px = (xs >= 0 && xs < width)
+                                 ? src[xs]
+                                 : PixelType(ImageBorderAccessor<access_mode>::access(img_src, to_row_index(xs), yi));
+        store_channels(px, &f[static_cast<std::size_t>(x * nr_channels)]);
+      }
+
+      running_extremum<Op>(f.data(), g.data(), width, kx, nr_channels, s, r);
+
+      auto dst = img_tmp.data(yi);
+      for (std::ptrdiff_t x = 0; x < width; ++x)
+      {
+        load_channels(&g[static_cast<std::size_t>(x * nr_channels)], dst[x]);
+      }
+    }
+  });
+
+  // Vertical pass: temporary image -> destination, on strips of columns
+  constexpr std::ptrdiff_t strip_elements = 256;
+  const auto strip_width = std::max(std::ptrdiff_t{1}, strip_elements / nr_channels);
+  const auto nr_strips = (width + strip_width - 1) / strip_width;
+
+  parallel_for(policy, 0, nr_strips, 1, [&](std::ptrdiff_t strip_begin, std::ptrdiff_t strip_end) {
+    std::vector<Element> f, g, s, r;
+
+    for (auto strip = strip_begin; strip < strip_end; ++strip)
+    {
+      const auto x0 = strip * strip_width;
+      const auto sw = std::min(strip_width, width - x0);
+      const auto m = sw * nr_channels;
+      f.resize(static_cast<std::size_t>((height + ky - 1) * m));
+      g.resize(static_cast<std::size_t>(height * m));
+
+      for (std::ptrdiff_t y = 0; y < height + ky - 1; ++y)
+      {
+        const auto ys = y - anchor_y;
+        auto f_row = &f[static_cast<std::size_t>(y * m)];
+
+        if (ys >= 0 && ys < height)
+        {
+          const auto src = img_tmp.data(to_row_index(ys));
+          for (std::ptrdiff_t x = 0; x < sw; ++x)
+          {
+            store_channels(src[x0 + x], f_row + x * nr_channels);
+          }
+        }
+        else
+        {
+          for (std::ptrdiff_t x = 0; x < sw; ++x)
+          {
+            const PixelType px = ImageBorderAccessor<access_mode>::access(img_tmp, to_row_index(x0 + x),
+                                                                          to_row_index(ys));
+            store_channels(px, f_row + x * nr_channels);
+          }
+        }
+      }
+
+      running_extremum<Op>(f.data(), g.data(), height, ky, m, s, r);
+
+      for (std::ptrdiff_t y = 0; y < height; ++y)
+      {
+        auto dst = img_dst.data(to_row_index(y));
+        for (std::ptrdiff_t x = 0; x < sw; ++x)
+        {
+          load_channels(&g[static_cast<std::size_t>(y * m + x * nr_channels)], dst[x0 + x]);
+        }
+      }
+    }
+  });
+}
+
+}  // namespace impl
+
+/** \brief Erodes an image with a rectangular structuring element, according to the specified execution policy.
+ *
+ * Each output pixel is the (per-channel) minimum over the `se_width x se_height` window, whose anchor is at offset
+ * `((se_width - 1) / 2, (se_height - 1) / 2)`. The operation is separated into a horizontal and a vertical pass, each
+ * using the van Herk/Gil-Werman algorithm; the cost per pixel is therefore independent of the size of the structuring
+ * element. Structuring elements of size up to 3 (e.g. 3x3) use a direct, vectorizable fast path.
+ *
+ * `allocate` is called on the destination image prior to performing the operation. Source and destination may be the
+ * same image.
+ *
+ * @tparam access_mode The border access mode; `BorderAccessMode::Replicated` (the default) leaves border values
+ *                     unaffected, `BorderAccessMode::ZeroPadding` treats outside pixels as zero.
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam DerivedSrc The typed source image type.
+ * @tparam DerivedDst The typed destination image type; of the same pixel type as the source.
+ * @param policy The execution policy.
+ * @param img_src The source image.
+ * @param[out] img_dst The destination image.
+ * @param se_width The width of the structuring element.
+ * @param se_height The height of the structuring element.
+ */
+template <BorderAccessMode access_mode = BorderAccessMode::Replicated,
+          typename ExecutionPolicy,
+          typename DerivedSrc,
+          typename DerivedDst,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+void erode(ExecutionPolicy&& policy,
+           const ImageBase<DerivedSrc>& img_src,
+           ImageBase<DerivedDst>& img_dst,
+           PixelLength se_width,
+           PixelLength se_height)
+{
+  impl::morphology_rectangle<impl::MorphologyMinOp, access_mode>(policy, img_src, img_dst, se_width, se_height,
+                                                                  "erode");
+}
+
+/** \brief Erodes an image with a rectangular structuring element.
+ *
+ * See the overload accepting an execution policy for details.
+ *
+ * @tparam access_mode The border access mode.
+ * @tparam DerivedSrc The typed source image type.
+ * @tparam DerivedDst The typed destination image type; of the same pixel type as the source.
+ * @param img_src The source image.
+ * @param[out] img_dst The destination image.
+ * @param se_width The width of the structuring element.
+ * @param se_height The height of the structuring element.
+ */
+template <BorderAccessMode access_mode = BorderAccessMode::Replicated, typename DerivedSrc, typename DerivedDst>
+void erode(const ImageBase<DerivedSrc>& img_src, ImageBase<DerivedDst>& img_dst, PixelLength se_width,
+           PixelLength se_height)
+{
+  erode<access_mode>(execution::seq, img_src, img_dst, se_width, se_height);
+}
+
+/** \brief Dilates an image with a rectangular structuring element, according to the specified execution policy.
+ *
+ * Each output pixel is the (per-channel) maximum over the `se_width x se_height` window. See `erode` for details.
+ *
+ * @tparam access_mode The border access mode.
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam DerivedSrc The typed source image type.
+ * @tparam DerivedDst The typed destination image type; of the same pixel type as the source.
+ * @param policy The execution policy.
+ * @param img_src The source image.
+ * @param[out] img_dst The destination image.
+ * @param se_width The width of the structuring element.
+ * @param se_height The height of the structuring element.
+ */
+template <BorderAccessMode access_mode = BorderAccessMode::Replicated,
+          typename ExecutionPolicy,
+          typename DerivedSrc,
+          typename DerivedDst,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+void dilate(ExecutionPolicy&& policy,
+            const ImageBase<DerivedSrc>& img_src,
+            ImageBase<DerivedDst>& img_dst,
+            PixelLength se_width,
+            PixelLength se_height)
+{
+  impl::morphology_rectangle<impl::MorphologyMaxOp, access_mode>(policy, img_src, img_dst, se_width, se_height,
+                                                                  "dilate");
+}
+
+/** \brief Dilates an image with a rectangular structuring element.
+ *
+ * See the overload accepting an execution policy for details.
+ *
+ * @tparam access_mode The border access mode.
+ * @tparam DerivedSrc The typed source image type.
+ * @tparam DerivedDst The typed destination image type; of the same pixel type as the source.
+ * @param img_src The source image.
+ * @param[out] img_dst The destination image.
+ * @param se_width The width of the structuring element.
+ * @param se_height The height of the structuring element.
+ */
+template <BorderAccessMode access_mode = BorderAccessMode::Replicated, typename DerivedSrc, typename DerivedDst>
+void dilate(const ImageBase<DerivedSrc>& img_src, ImageBase<DerivedDst>& img_dst, PixelLength se_width,
+            PixelLength se_height)
+{
+  dilate<access_mode>(execution::seq, img_src, img_dst, se_width, se_height);
+}
+
+/** \brief Performs a morphological opening (erosion followed by dilation) with a rectangular structuring element,
+ * according to the specified execution policy.
+ *
+ * @tparam access_mode The border access mode.
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam DerivedSrc The typed source image type.
+ * @tparam DerivedDst The typed destination image type; of the same pixel type as the source.
+ * @param policy The execution policy.
+ * @param img_src The source image.
+ * @param[out] img_dst The destination image.
+ * @param se_width The width of the structuring element.
+ * @param se_height The height of the structuring element.
+ */
+template <BorderAccessMode access_mode = BorderAccessMode::Replicated,
+          typename ExecutionPolicy,
+          typename DerivedSrc,
+          typename DerivedDst,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+void open(ExecutionPolicy&& policy,
+          const ImageBase<DerivedSrc>& img_src,
+          ImageBase<DerivedDst>& img_dst,
+          PixelLength se_width,
+          PixelLength se_height)
+{
+  Image<typename ImageBase<DerivedSrc>::PixelType> img_tmp;
+  erode<access_mode>(policy, img_src, img_tmp, se_width, se_height);
+  dilate<access_mode>(policy, img_tmp, img_dst, se_width, se_height);
+}
+
+/** \brief Performs a morphological opening (erosion followed by dilation) with a rectangular structuring element.
+ *
+ * @tparam access_mode The border access mode.
+ * @tparam DerivedSrc The typed source image type.
+ * @tparam DerivedDst The typed destination image type; of the same pixel type as the source.
+ * @param img_src The source image.
+ * @param[out] img_dst The destination image.
+ * @param se_width The width of the structuring element.
+ * @param se_height The height of the structuring element.
+ */
+template <BorderAccessMode access_mode = BorderAccessMode::Replicated, typename DerivedSrc, typename DerivedDst>
+void open(const ImageBase<DerivedSrc>& img_src, ImageBase<DerivedDst>& img_dst, PixelLength se_width,
+          PixelLength se_height)
+{
+  open<access_mode>(execution::seq, img_src, img_dst, se_width, se_height);
+}
+
+/** \brief Performs a morphological closing (dilation followed by erosion) with a rectangular structuring element,
+ * according to the specified execution policy.
+ *
+ * @tparam access_mode The border access mode.
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam DerivedSrc The typed source image type.
+ * @tparam DerivedDst The typed destination image type; of the same pixel type as the source.
+ * @param policy The execution policy.
+ * @param img_src The source image.
+ * @param[out] img_dst The destination image.
+ * @param se_width The width of the structuring element.
+ * @param se_height The height of the structuring element.
+ */
+template <BorderAccessMode access_mode = BorderAccessMode::Replicated,
+          typename ExecutionPolicy,
+          typename DerivedSrc,
+          typename DerivedDst,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+void close(ExecutionPolicy&& policy,
+           const ImageBase<DerivedSrc>& img_src,
+           ImageBase<DerivedDst>& img_dst,
+           PixelLength se_width,
+           PixelLength se_height)
+{
+  Image<typename ImageBase<DerivedSrc>::PixelType> img_tmp;
+  dilate<access_mode>(policy, img_src, img_tmp, se_width, se_height);
+  erode<access_mode>(policy, img_tmp, img_dst, se_width, se_height);
+}
+
+/** \brief Performs a morphological closing (dilation followed by erosion) with a rectangular structuring element.
+ *
+ * @tparam access_mode The border access mode.
+ * @tparam DerivedSrc The typed source image type.
+ * @tparam DerivedDst The typed destination image type; of the same pixel type as the source.
+ * @param img_src The source image.
+ * @param[out] img_dst The destination image.
+ * @param se_width The width of the structuring element.
+ * @param se_height The height of the structuring element.
+ */
+template <BorderAccessMode access_mode = BorderAccessMode::Replicated, typename DerivedSrc, typename DerivedDst>
+void close(const ImageBase<DerivedSrc>& img_src, ImageBase<DerivedDst>& img_dst, PixelLength se_width,
+           PixelLength se_height)
+{
+  close<access_mode>(execution::seq, img_src, img_dst, se_width, se_height);
+}
+
+/** \brief Computes the morphological gradient (dilation minus erosion) with a rectangular structuring element,
+ * according to the specified execution policy.
+ *
+ * @tparam access_mode The border access mode.
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam DerivedSrc The typed source image type.
+ * @tparam DerivedDst The typed destination image type; of the same pixel type as the source.
+ * @param policy The execution policy.
+ * @param img_src The source image.
+ * @param[out] img_dst The destination image.
+ * @param se_width The width of the structuring element.
+ * @param se_height The height of the structuring element.
+ */
+template <BorderAccessMode access_mode = BorderAccessMode::Replicated,
+          typename ExecutionPolicy,
+          typename DerivedSrc,
+          typename DerivedDst,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+void morphological_gradient(ExecutionPolicy&& policy,
+                            const ImageBase<DerivedSrc>& img_src,
+                            ImageBase<DerivedDst>& img_dst,
+                            PixelLength se_width,
+                            PixelLength se_height)
+{
+  using PixelType = typename ImageBase<DerivedSrc>::PixelType;
+  using Element = typename PixelTraits<PixelType>::Element;
+
+  Image<PixelType> img_dilated;
+  Image<PixelType> img_eroded;
+  dilate<access_mode>(policy, img_src, img_dilated, se_width, se_height);
+  erode<access_mode>(policy, img_src, img_eroded, se_width, se_height);
+
+  transform_pixels(policy,
+                   [](const auto& px_dilated, const auto& px_eroded) {
+                     PixelType px;
+                     for (std::size_t c = 0; c < static_cast<std::size_t>(PixelTraits<PixelType>::nr_channels); ++c)
+                     {
+                       impl::get_channel(px, c) = static_cast<Element>(impl::get_channel(px_dilated, c)
+                                                                       - impl::get_channel(px_eroded, c));
+                     }
+                     return px;
+                   },
+                   img_dst, img_dilated, img_eroded);
+}
+
+/** \brief Computes the morphological gradient (dilation minus erosion) with a rectangular structuring element.
+ *
+ * @tparam access_mode The border access mode.
+ * @tparam DerivedSrc The typed source image type.
+ * @tparam DerivedDst The typed destination image type; of the same pixel type as the source.
+ * @param img_src The source image.
+ * @param[out] img_dst The destination image.
+ * @param se_width The width of the structuring element.
+ * @param se_height The height of the structuring element.
+ */
+template <BorderAccessMode access_mode = BorderAccessMode::Replicated, typename DerivedSrc, typename DerivedDst>
+void morphological_gradient(const ImageBase<DerivedSrc>& img_src, ImageBase<DerivedDst>& img_dst,
+                            PixelLength se_width, PixelLength se_height)
+{
+  morphological_gradient<access_mode>(execution::seq, img_src, img_dst, se_width, se_height);
+}
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_OPS_MORPHOLOGY_HPP
@@ -0,0 +1,597 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_OPS_REDUCTIONS_HPP
+#define SELENE_IMG_OPS_REDUCTIONS_HPP
+
+/// @file
+
+#include <selene/base/ExecutionPolicy.hpp>
+#include <selene/base/Promote.hpp>
+
+#include <selene/img/common/Types.hpp>
+
+#include <selene/img/pixel/Pixel.hpp>
+#include <selene/img/pixel/PixelTraits.hpp>
+
+#include <selene/img/typed/ImageBase.hpp>
+
+#include <selene/img_ops/Algorithms.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace sln {
+
+/** \brief A pixel location, i.e. a pair of (x, y) coordinates.
+ */
+struct PixelLocation
+{
+  PixelIndex x;  ///< The x-coordinate.
+  PixelIndex y;  ///< The y-coordinate.
+};
+
+/** \brief The result of `min_max_loc`: per-channel minimum and maximum values, and their locations.
+ *
+ * If a value occurs multiple times, the location of the first occurrence (in row-major order) is stored.
+ *
+ * @tparam T The pixel element type.
+ * @tparam N The number of channels.
+ */
+template <typename T, std::size_t N>
+struct MinMaxLocation
+{
+  Pixel<T, N> min_value;  ///< The minimum value, per channel.
+  Pixel<T, N> max_value;  ///< The maximum value, per channel.
+  std::array<PixelLocation, N> min_location;  ///< The location of the minimum value, per channel.
+  std::array<PixelLocation, N> max_location;  ///< The location of the maximum value, per channel.
+};
+
+// ----------
+// Implementation:
+
+namespace impl {
+
+template <typename Derived>
+using ImageElement = typename PixelTraits<typename ImageBase<Derived>::PixelType>::Element;
+
+template <typename Derived>
+constexpr std::size_t image_nr_channels = static_cast<std::size_t>(
+    PixelTraits<typename ImageBase<Derived>::PixelType>::nr_channels);
+
+/// The accumulator type for sums of elements of type `T`: the widest promoted integral type, or `double`.
+template <typename T>
+using SumAccumulator = std::conditional_t<std::is_floating_point_v<T>, double, promote_t<promote_t<promote_t<T>>>>;
+
+/// The accumulator type for sums of squares of elements of type `T`; squares of 32-bit values may overflow 64 bits.
+template <typename T>
+using SquaredSumAccumulator = std::conditional_t<std::is_integral_v<T> && (sizeof(T) <= 2), SumAccumulator<T>, double>;
+
+/** \brief Reduces each channel of an image row into `acc`, as `acc[c] = op(acc[c], transform(row[x][c]))`.
+ *
+ * Several independent partial results per channel are computed, which breaks the dependency chain of the reduction
+ * and allows the compiler to vectorize the loop (also for floating point values, where it may not reassociate the
+ * operations itself).
+ */
+template <typename Acc, std::size_t N, typename PixelType, typename Transform, typename Op>
+void reduce_row(const PixelType* ptr, std::ptrdiff_t width, std::array<Acc, N>& acc, Acc identity,
+                Transform transform, Op op)
+{
+  constexpr std::ptrdiff_t nr_lanes = 4;
+
+  std::array<std::array<Acc, N>, nr_lanes> lanes;
+  for (auto& lane : lanes)
+  {
+    lane.fill(identity);
+  }
+
+  std::ptrdiff_t x = 0;
+  for (; x + nr_lanes <= width; x += nr_lanes)
+  {
+    for (std::ptrdiff_t l = 0; l < nr_lanes; ++l)
+    {
+      for (std::size_t c = 0; c < N; ++c)
+      {
+        lanes[l][c] = op(lanes[l][c], transform(get_channel(ptr[x + l], c)));
+      }
+    }
+  }
+
+  for (; x < width; ++x)
+  {
+    for (std::size_t c = 0; c < N; ++c)
+    {
+      lanes[0][c] = op(lanes[0][c], transform(get_channel(ptr[x], c)));
+    }
+  }
+
+  for (std::ptrdiff_t l = 0; l < nr_lanes; ++l)
+  {
+    for (std::size_t c = 0; c < N; ++c)
+    {
+      acc[c] = op(acc[c], lanes[l][c]);
+    }
+  }
+}
+
+/** \brief Reduces all rows of an image, according to the specified execution policy.
+ *
+ * The image is split into bands of rows, each of which is reduced into a partial result by calling
+ * `row_func(y, row_ptr, width, partial)` on each row. The partial results are then combined pairwise (as a tree),
+ * in a fixed order; the result hence does not depend on the number of threads used.
+ */
+template <typename Result, typename ExecutionPolicy, typename Derived, typename RowFunction, typename Combine>
+Result reduce_rows(ExecutionPolicy&& policy,
+                   const ImageBase<Derived>& img,
+                   const Result& init,
+                   RowFunction row_func,
+                   Combine combine)
+{
+  const auto width = static_cast<std::ptrdiff_t>(img.width());
+  const auto height = static_cast<std::ptrdiff_t>(img.height());
+  const auto band_height = row_grain_size(width);
+  const auto nr_bands = (height + band_height - 1) / band_height;
+
+  if (nr_bands <= 0)
+  {
+    return init;
+  }
+
+  std::vector<Result> partials(static_cast<std::size_t>(nr_bands), init);
+
+  parallel_for(policy, 0, nr_bands, 1, [&](std::ptrdiff_t band_begin, std::ptrdiff_t band_end) {
+    for (auto band = band_begin; band < band_end; ++band)
+    {
+      auto& partial = partials[static_cast<std::size_t>(band)];
+      const auto y_end = std::min(height, (band + 1) * band_height);
+
+      for (auto y = band * band_height; y < y_end; ++y)
+      {
+        row_func(y, img.data(to_row_index(y)), width, partial);
+      }
+    }
+  });
+
+  for (std::size_t step = 1; step < partials.size(); step *= 2)
+  {
+    for (std::size_t i = 0; i + step < partials.size(); i += 2 * step)
+    {
+      partials[i] = combine(partials[i], partials[i + step]);
+    }
+  }
+
+  return partials[0];
+}
+
+template <typename Acc, typename ExecutionPolicy, typename Derived, typename Transform>
+std::array<Acc, image_nr_channels<Derived>> sum_channels(ExecutionPolicy&& policy,
+                                                         const ImageBase<Derived>& img,
+                                                         Transform transform)
+{
+  constexpr auto N = image_nr_channels<Derived>;
+  using Result = std::array<Acc, N>;
+  const auto add = [](Acc a, Acc b) { return static_cast<Acc>(a + b); };
+
+  return reduce_rows(
+      policy, img, make_array_n_equal<Acc, N>(Acc{0}),
+      [&](std::ptrdiff_t, const auto* ptr, std::ptrdiff_t width, Result& partial) {
+        reduce_row(ptr, width, partial, Acc{0}, transform, add);
+      },
+      [&](const Result& a, const Result& b) {
+        Result r;
+        for (std::size_t c = 0; c < N; ++c)
+        {
+          r[c] = add(a[c], b[c]);
+        }
+        return r;
+      });
+}
+
+template <typename T>
+constexpr auto absolute_value(T value) noexcept
+{
+  if constexpr (std::is_unsigned_v<T>)
+  {
+    return value;
+  }
+  else
+  {
+    return value < T{0} ? -value : value;
+  }
+}
+
+template <typename T, std::size_t N>
+struct MinMaxState
+{
+  MinMaxLocation<T, N> loc;
+  bool valid = false;
+};
+
+template <typename T, std::size_t N, typename PixelType>
+void min_max_loc_row(std::ptrdiff_t y, const PixelType* ptr, std::ptrdiff_t width, MinMaxState<T, N>& state)
+{
+  if (width == 0)
+  {
+    return;
+  }
+
+  // First, determine the row extrema (vectorizable); only if they improve on the current ones, find their location.
+  auto row_min = make_array_n_equal<T, N>(std::numeric_limits<T>::max());
+  auto row_max = make_array_n_equal<T, N>(std::numeric_limits<T>::lowest());
+  const auto identity = [](T v) { return v; };
+  reduce_row(ptr, width, row_min, std::numeric_limits<T>::max(), identity, [](T a, T b) { return b < a ? b : a; });
+  reduce_row(ptr, width, row_max, std::numeric_limits<T>::lowest(), identity, [](T a, T b) { return b > a ? b : a; });
+
+  const auto find_first = [ptr, width](std::size_t c, T value) {
+    std::ptrdiff_t x = 0;
+    while (x < width - 1 && get_channel(ptr[x], c) != value)
+    {
+      ++x;
+    }
+    return x;
+  };
+
+  const auto to_location = [y](std::ptrdiff_t x) {
+    return PixelLocation{PixelIndex{static_cast<PixelIndex::value_type>(x)},
+                         PixelIndex{static_cast<PixelIndex::value_type>(y)}};
+  };
+
+  for (std::size_t c = 0; c < N; ++c)
+  {
+    if (!state.valid || row_min[c] < state.loc.min_value[c])
+    {
+      state.loc.min_value[c] = row_min[c];
+      state.loc.min_location[c] = to_location(find_first(c, row_min[c]));
+    }
+
+    if (!state.valid || row_max[c] > state.loc.max_value[c])
+    {
+      state.loc.max_value[c] = row_max[c];
+      state.loc.max_location[c] = to_location(find_first(c, row_max[c]));
+    }
+  }
+
+  state.valid = true;
+}
+
+template <typename T, std::size_t N>
+MinMaxState<T, N> min_max_loc_combine(const MinMaxState<T, N>& a, const MinMaxState<T, N>& b)
+{
+  if (!a.valid || !b.valid)
+  {
+    return a.valid ? a : b;
+  }
+
+  // `a` always precedes `b` in row-major order; on ties, the first occurrence is kept.
+  auto r = a;
+
+  for (std::size_t c = 0; c < N; ++c)
+  {
+    if (b.loc.min_value[c] < r.loc.min_value[c])
+    {
+      r.loc.min_value[c] = b.loc.min_value[c];
+      r.loc.min_location[c] = b.loc.min_location[c];
+    }
+
+    if (b.loc.max_value[c] > r.loc.max_value[c])
+    {
+      r.loc.max_value[c] = b.loc.max_value[c];
+      r.loc.max_location[c] = b.loc.max_location[c];
+    }
+  }
+
+  return r;
+}
+
+template <typename T, std::size_t N>
+Pixel<double, N> to_double_pixel(const std::array<T, N>& arr)
+{
+  Pixel<double, N> px;
+  for (std::size_t c = 0; c < N; ++c)
+  {
+    px[c] = static_cast<double>(arr[c]);
+  }
+  return px;
+}
+
+}  // namespace impl
+
+/** \brief Computes the per-channel sum of all pixel values of an image, according to the specified execution policy.
+ *
+ * Sums are accumulated in 64-bit integers (for integral pixel elements), or in double precision.
+ * With a parallel execution policy, the image is split into bands of rows which are reduced concurrently; the partial
+ * results are combined in a fixed order.
+ *
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam Derived The typed image type.
+ * @param policy The execution policy.
+ * @param img The image.
+ * @return The per-channel sums.
+ */
+template <typename ExecutionPolicy,
+          typename Derived,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+auto sum(ExecutionPolicy&& policy, const ImageBase<Derived>& img)
+{
+  using Acc = impl::SumAccumulator<impl::ImageElement<Derived>>;
+  const auto sums = impl::sum_channels<Acc>(policy, img, [](auto v) { return static_cast<Acc>(v); });
+  return Pixel<Acc, impl::image_nr_channels<Derived>>(sums);
+}
+
+/** \brief Computes the per-channel sum of all pixel values of an image.
+ *
+ * See the overload accepting an execution policy for details.
+ *
+ * @tparam Derived The typed image type.
+ * @param img The image.
+ * @return The per-channel sums.
+ */
+template <typename Derived>
+auto sum(const ImageBase<Derived>& img)
+{
+  return sum(execution::seq, img);
+}
+
+/** \brief Computes the per-channel mean of all pixel values of an image, according to the specified execution policy.
+ *
+ * Throws an exception if the image is empty.
+ *
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam Derived The typed image type.
+ * @param policy The execution policy.
+ * @param img The image.
+ * @return The per-channel mean values.
+ */
+template <typename ExecutionPolicy,
+          typename Derived,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+Pixel<double, impl::image_nr_channels<Derived>> mean(ExecutionPolicy&& policy, const ImageBase<Derived>& img)
+{
+  if (img.width() == 0 || img.height() == 0)
+  {
+    throw std::runtime_error("mean: Image is empty.");
+  }
+
+  constexpr auto N = impl::image_nr_channels<Derived>;
+  const auto sums = sum(policy, img);
+  const auto nr_pixels = static_cast<double>(static_cast<std::ptrdiff_t>(img.width()))
+                         * static_cast<double>(static_cast<std::ptrdiff_t>(img.height()));
+
+  Pixel<double, N> means;
+  for (std::size_t c = 0; c < N; ++c)
+  {
+    means[c] = static_cast<double>(sums[c]) / nr_pixels;
+  }
+
+  return means;
+}
+
+/** \brief Computes the per-channel mean of all pixel values of an image.
+ *
+ * Throws an exception if the image is empty.
+ *
+ * @tparam Derived The typed image type.
+ * @param img The image.
+ * @return The per-channel mean values.
+ */
+template <typename Derived>
+Pixel<double, impl::image_nr_channels<Derived>> mean(const ImageBase<Derived>& img)
+{
+  return mean(execution::seq, img);
+}
+
+/** \brief Determines the per-channel minimum and maximum values of an image, as well as their locations, according to
+ * the specified execution policy.
+ *
+ * Throws an exception if the image is empty.
+ *
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam Derived The typed image type.
+ * @param policy The execution policy.
+ * @param img The image.
+ * @return The per-channel minimum and maximum values and their (first) locations.
+ */
+template <typename ExecutionPolicy,
+          typename Derived,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+MinMaxLocation<impl::ImageElement<Derived>, impl::image_nr_channels<Derived>> min_max_loc(
+    ExecutionPolicy&& policy, const ImageBase<Derived>& img)
+{
+  if (img.width() == 0 || img.height() == 0)
+  {
+    throw std::runtime_error("min_max_loc: Image is empty.");
+  }
+
+  using T = impl::ImageElement<Derived>;
+  constexpr auto N = impl::image_nr_channels<Derived>;
+  using State = impl::MinMaxState<T, N>;
+
+  const auto state = impl::reduce_rows(
+      policy, img, State{},
+      [](std::ptrdiff_t y, const auto* ptr, std::ptrdiff_t width, State& partial) {
+        impl::min_max_loc_row(y, ptr, width, partial);
+      },
+      [](const State& a, const State& b) { return impl::min_max_loc_combine(a, b); });
+
+  return state.loc;
+}
+
+/** \brief Determines the per-channel minimum and maximum values of an image, as well as their locations.
+ *
+ * Throws an exception if the image is empty.
+ *
+ * @tparam Derived The typed image type.
+ * @param img The image.
+ * @return The per-channel minimum and maximum values and their (first) locations.
+ */
+template <typename Derived>
+MinMaxLocation<impl::ImageElement<Derived>, impl::image_nr_channels<Derived>> min_max_loc(
+    const ImageBase<Derived>& img)
+{
+  return min_max_loc(execution::seq, img);
+}
+
+/** \brief Computes the per-channel L1 norm (i.e. the sum of absolute values) of an image, according to the specified
+ * execution policy.
+ *
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam Derived The typed image type.
+ * @param policy The execution policy.
+ * @param img The image.
+ * @return The per-channel L1 norms.
+ */
+template <typename ExecutionPolicy,
+          typename Derived,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+Pixel<double, impl::image_nr_channels<Derived>> norm_l1(ExecutionPolicy&& policy, const ImageBase<Derived>& img)
+{
+  using Acc = impl::SumAccumulator<impl::ImageElement<Derived>>;
+  return impl::to_double_pixel(
+      impl::sum_channels<Acc>(policy, img, [](auto v) { return impl::absolute_value(static_cast<Acc>(v)); }));
+}
+
+/** \brief Computes the per-channel L1 norm (i.e. the sum of absolute values) of an image.
+ *
+ * @tparam Derived The typed image type.
+ * @param img The image.
+ * @return The per-channel L1 norms.
+ */
+template <typename Derived>
+Pixel<double, impl::image_nr_channels<Derived>> norm_l1(const ImageBase<Derived>& img)
+{
+  return norm_l1(execution::seq, img);
+}
+
+/** \brief Computes the per-channel L2 norm (i.e. the square root of the sum of squares) of an image, according to
+ * the specified execution policy.
+ *
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam Derived The typed image type.
+ * @param policy The execution policy.
+ * @param img The image.
+ * @return The per-channel L2 norms.
+ */
+template <typename ExecutionPolicy,
+          typename Derived,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+Pixel<double, impl::image_nr_channels<Derived>> norm_l2(ExecutionPolicy&& policy, const ImageBase<Derived>& img)
+{
+  using Acc = impl::SquaredSumAccumulator<impl::ImageElement<Derived>>;
+  auto norms = impl::to_double_pixel(impl::sum_channels<Acc>(policy, img, [](auto v) {
+    const auto a = static_cast<Acc>(v);
+    return static_cast<Acc>(a * a);
+  }));
+
+  for (std::size_t c = 0; c < impl::image_nr_channels<Derived>; ++c)
+  {
+    norms[c] = std::sqrt(norms[c]);
+  }
+
+  return norms;
+}
+
+/** \brief Computes the per-channel L2 norm (i.e. the square root of the sum of squares) of an image.
+ *
+ * @tparam Derived The typed image type.
+ * @param img The image.
+ * @return The per-channel L2 norms.
+ */
+template <typename Derived>
+Pixel<double, impl::image_nr_channels<Derived>> norm_l2(const ImageBase<Derived>& img)
+{
+  return norm_l2(execution::seq, img);
+}
+
+/** \brief Computes the per-channel infinity norm (i.e. the maximum absolute value) of an image, according to the
+ * specified execution policy.
+ *
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam Derived The typed image type.
+ * @param policy The execution policy.
+ * @param img The image.
+ * @return The per-channel infinity norms; 0 for an empty image.
+ */
+template <typename ExecutionPolicy,
+          typename Derived,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+Pixel<double, impl::image_nr_channels<Derived>> norm_inf(ExecutionPolicy&& policy, const ImageBase<Derived>& img)
+{
+  using Acc = impl::SumAccumulator<impl::ImageElement<Derived>>;
+  constexpr auto N = impl::image_nr_channels<Derived>;
+  using Result = std::array<Acc, N>;
+  const auto max_op = [](Acc a, Acc b) { return b > a ? b : a; };
+
+  const auto maxima = impl::reduce_rows(
+      policy, img, make_array_n_equal<Acc, N>(Acc{0}),
+      [&](std::ptrdiff_t, const auto* ptr, std::ptrdiff_t width, Result& partial) {
+        impl::reduce_row(ptr, width, partial, Acc{0},
+                         [](auto v) { return impl::absolute_value(static_cast<Acc>(v)); }, max_op);
+      },
+      [&](const Result& a, const Result& b) {
+        Result r;
+        for (std::size_t c = 0; c < N; ++c)
+        {
+          r[c] = max_op(a[c], b[c]);
+        }
+        return r;
+      });
+
+  return impl::to_double_pixel(maxima);
+}
+
+/** \brief Computes the per-channel infinity norm (i.e. the maximum absolute value) of an image.
+ *
+ * @tparam Derived The typed image type.
+ * @param img The image.
+ * @return The per-channel infinity norms; 0 for an empty image.
+ */
+template <typename Derived>
+Pixel<double, impl::image_nr_channels<Derived>> norm_inf(const ImageBase<Derived>& img)
+{
+  return norm_inf(execution::seq, img);
+}
+
+/** \brief Counts the per-channel number of non-zero pixel values of an image, according to the specified execution
+ * policy.
+ *
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam Derived The typed image type.
+ * @param policy The execution policy.
+ * @param img The image.
+ * @return The per-channel numbers of non-zero values.
+ */
+template <typename ExecutionPolicy,
+          typename Derived,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+Pixel<std::int64_t, impl::image_nr_channels<Derived>> count_nonzero(ExecutionPolicy&& policy,
+                                                                    const ImageBase<Derived>& img)
+{
+  using T = impl::ImageElement<Derived>;
+  const auto counts = impl::sum_channels<std::int64_t>(
+      policy, img, [](auto v) { return static_cast<std::int64_t>(v != T{0}); });
+  return Pixel<std::int64_t, impl::image_nr_channels<Derived>>(counts);
+}
+
+/** \brief Counts the per-channel number of non-zero pixel values of an image.
+ *
+ * @tparam Derived The typed image type.
+ * @param img The image.
+ * @return The per-channel numbers of non-zero values.
+ */
+template <typename Derived>
+Pixel<std::int64_t, impl::image_nr_channels<Derived>> count_nonzero(const ImageBase<Derived>& img)
+{
+  return count_nonzero(execution::seq, img);
+}
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_OPS_REDUCTIONS_HPP
@@ -0,0 +1,224 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_OPS_TENSOR_PACKING_HPP
+#define SELENE_IMG_OPS_TENSOR_PACKING_HPP
+
+/// @file
+
+#include <selene/base/Assert.hpp>
+#include <selene/base/ExecutionPolicy.hpp>
+
+#include <selene/img/pixel/PixelTraits.hpp>
+
+#include <selene/img/typed/ImageBase.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+namespace sln {
+
+/** \brief The memory layout of a packed 4-D tensor of images.
+ */
+enum class TensorLayout
+{
+  NCHW,  ///< Planar: batch, channel, row, column (i.e. each channel is stored as a separate plane).
+  NHWC,  ///< Interleaved: batch, row, column, channel (i.e. the channels of each pixel are stored contiguously).
+};
+
+template <typename ImageRange, std::size_t N>
+void pack_tensor(const ImageRange& batch,
+                 float* out,
+                 const std::array<float, N>& mean,
+                 const std::array<float, N>& std_dev,
+                 TensorLayout layout = TensorLayout::NCHW);
+
+template <typename ExecutionPolicy,
+          typename ImageRange,
+          std::size_t N,
+          typename = std::enable_if_t<is_execution_policy_v<ExecutionPolicy>>>
+void pack_tensor(ExecutionPolicy&& policy,
+                 const ImageRange& batch,
+                 float* out,
+                 const std::array<float, N>& mean,
+                 const std::array<float, N>& std_dev,
+                 TensorLayout layout = TensorLayout::NCHW);
+
+// ----------
+// Implementation:
+
+namespace impl {
+
+template <TensorLayout layout, typename PixelType, std::size_t N>
+void pack_tensor_row(const PixelType* src,
+                     float* out_item,
+                     std::ptrdiff_t width,
+                     std::ptrdiff_t y,
+                     std::ptrdiff_t plane_size,
+                     const std::array<float, N>& scale,
+                     const std::array<float, N>& bias)
+{
+  // Local copies; they can be kept in registers, since they cannot alias the output.
+  const auto sc = scale;
+  const auto bi = bias;
+
+  if constexpr (layout == TensorLayout::NCHW)
+  {
+    float* dst = out_item + y * width;
+
+    for (std::ptrdiff_t x = 0; x < width; ++x)
+    {
+      for (std::size_t c = 0; c < N; ++c)  // N is known at compile time
+      {
+        dst[static_cast<std::ptrdiff_t>(c) * plane_size + x] = static_cast<float>(src[x][c]) * sc[c] + bi[c];
+      }
+    }
+  }
+  else
+  {
+    constexpr auto n = static_cast<std::ptrdiff_t>(N);
+    float* dst = out_item + y * width * n;
+
+    for (std::ptrdiff_t x = 0; x < width; ++x)
+    {
+      for (std::size_t c = 0; c < N; ++c)  // N is known at compile time
+      {
+        dst[x * n + static_cast<std::ptrdiff_t>(c)] = static_cast<float>(src[x][c]) * sc[c] + bi[c];
+      }
+    }
+  }
+}
+
+template <TensorLayout layout, typename ExecutionPolicy, typename ImageRange, std::size_t N>
+void pack_tensor(ExecutionPolicy&& policy,
+                 const ImageRange& batch,
+                 float* out,
+                 const std::array<float, N>& scale,
+                 const std::array<float, N>& bias)
+{
+  const auto first = std::begin(batch);
+  const auto nr_items = static_cast<std::ptrdiff_t>(std::distance(first, std::end(batch)));
+
+  if (nr_items == 0)
+  {
+    return;
+  }
+
+  const auto width = static_cast<std::ptrdiff_t>(first->width());
+  const auto height = static_cast<std::ptrdiff_t>(first->height());
+  const auto plane_size = width * height;
+  const auto item_size = plane_size * static_cast<std::ptrdiff_t>(N);
+
+  // Parallelize over the (item, row) pairs of the whole batch; this balances the work for both small batches of
+  // large images and large batches of small images.
+  parallel_for(policy, 0, nr_items * height, row_grain_size(width), [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+    for (auto i = begin; i < end; ++i)
+    {
+      const auto item = i / height;
+      const auto y = i % height;
+      const auto& img = *std::next(first, item);
+      pack_tensor_row<layout>(img.data(PixelIndex{static_cast<PixelIndex::value_type>(y)}),
+                              out + item * item_size, width, y, plane_size, scale, bias);
+    }
+  });
+}
+
+}  // namespace impl
+
+/** \brief Packs a batch of typed images into a contiguous, normalized single precision floating point tensor.
+ *
+ * Each pixel value `v` of channel `c` is written as `(v - mean[c]) / std_dev[c]`.
+ * Mean and standard deviation are hence to be specified in the units of the image pixel values; e.g. in [0, 255] for
+ * 8-bit images.
+ *
+ * The conversion to floating point, the normalization and the re-arrangement into the specified tensor layout are
+ * performed in a single pass over the input data, parallelized over all images and rows (using `execution::par`).
+ *
+ * All images in the batch need to be of the same size; otherwise, an exception is thrown.
+ * The output buffer needs to be large enough to hold `batch.size() * N * height * width` values.
+ *
+ * @tparam ImageRange A range of typed images or image views (e.g. `std::vector<ConstantImageView<Pixel_8u3>>`).
+ *                    Its iterators need to be random access iterators.
+ * @tparam N The number of channels of the images.
+ * @param batch The batch of images.
+ * @param out Pointer to the output tensor data.
+ * @param mean The per-channel mean value to be subtracted.
+ * @param std_dev The per-channel standard deviation to be divided by. No element may be 0.
+ * @param layout The layout of the output tensor.
+ */
+template <typename ImageRange, std::size_t N>
+void pack_tensor(const ImageRange& batch,
+                 float* out,
+                 const std::array<float, N>& mean,
+                 const std::array<float, N>& std_dev,
+                 TensorLayout layout)
+{
+  pack_tensor(execution::par, batch, out, mean, std_dev, layout);
+}
+
+/** \brief Packs a batch of typed images into a contiguous, normalized single precision floating point tensor,
+ * according to the specified execution policy.
+ *
+ * See the overload without execution policy for details.
+ *
+ * @tparam ExecutionPolicy The execution policy type.
+ * @tparam ImageRange A range of typed images or image views (e.g. `std::vector<ConstantImageView<Pixel_8u3>>`).
+ *                    Its iterators need to be random access iterators.
+ * @tparam N The number of channels of the images.
+ * @param policy The execution policy.
+ * @param batch The batch of images.
+ * @param out Pointer to the output tensor data.
+ * @param mean The per-channel mean value to be subtracted.
+ * @param std_dev The per-channel standard deviation to be divided by. No element may be 0.
+ * @param layout The layout of the output tensor.
+ */
+template <typename ExecutionPolicy, typename ImageRange, std::size_t N, typename>
+void pack_tensor(ExecutionPolicy&& policy,
+                 const ImageRange& batch,
+                 float* out,
+                 const std::array<float, N>& mean,
+                 const std::array<float, N>& std_dev,
+                 TensorLayout layout)
+{
+  using ImageType = std::decay_t<decltype(*std::begin(batch))>;
+  static_assert(is_image_type_v<ImageType>, "Need to supply a range of typed images (owning or view) to pack_tensor");
+  static_assert(PixelTraits<typename ImageType::PixelType>::nr_channels == static_cast<std::int16_t>(N),
+                "Number of normalization parameters does not match the number of image channels");
+
+  for (const auto& img : batch)
+  {
+    if (img.width() != std::begin(batch)->width() || img.height() != std::begin(batch)->height())
+    {
+      throw std::runtime_error("pack_tensor: Images are not all the same size.");
+    }
+  }
+
+  std::array<float, N> scale;
+  std::array<float, N> bias;
+
+  for (std::size_t c = 0; c < N; ++c)
+  {
+    SELENE_ASSERT(std_dev[c] != 0.0f);
+    scale[c] = 1.0f / std_dev[c];
+    bias[c] = -mean[c] / std_dev[c];
+  }
+
+  if (layout == TensorLayout::NCHW)
+  {
+    impl::pack_tensor<TensorLayout::NCHW>(policy, batch, out, scale, bias);
+  }
+  else
+  {
+    impl::pack_tensor<TensorLayout::NHWC>(policy, batch, out, scale, bias);
+  }
+}
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_OPS_TENSOR_PACKING_HPP
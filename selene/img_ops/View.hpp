@@ -85,7 +85,7 @@ auto view(const ImageBase<DerivedSrc>& img, const BoundingBox& region)
 
   const auto data_offset = Bytes(img.stride_bytes() * region.y0() + PixelTraits<PixelTypeSrc>::nr_bytes * region.x0());
   const auto byte_ptr = img.byte_ptr() + data_offset;
-  const auto layout = TypedLayout{region.width(), region.height(), img.stride_bytes()};
+  const auto layout = TypedLayout{region.width(), region.height(), img.stride_bytes(), img.layout().tail_padding_bytes};
 
   return ImageView<PixelTypeSrc, ImageModifiability::Constant>(byte_ptr, layout);
 }
@@ -105,7 +105,7 @@ auto view(ImageBase<DerivedSrc>& img, const BoundingBox& region)
 
   const auto data_offset = Bytes(img.stride_bytes() * region.y0() + PixelTraits<PixelTypeSrc>::nr_bytes * region.x0());
   const auto byte_ptr = img.byte_ptr() + data_offset;
-  const auto layout = TypedLayout{region.width(), region.height(), img.stride_bytes()};
+  const auto layout = TypedLayout{region.width(), region.height(), img.stride_bytes(), img.layout().tail_padding_bytes};
 
   return ImageView<PixelTypeSrc, modifiability>(byte_ptr, layout);
 }
@@ -205,7 +205,7 @@ auto view_with_pixel_type(const ImageBase<DerivedSrc>& img, const BoundingBox& r
 
   const auto data_offset = Bytes(img.stride_bytes() * region.y0() + PixelTraits<PixelTypeSrc>::nr_bytes * region.x0());
   const auto byte_ptr = img.byte_ptr() + data_offset;
-  const auto layout = TypedLayout{region.width(), region.height(), img.stride_bytes()};
+  const auto layout = TypedLayout{region.width(), region.height(), img.stride_bytes(), img.layout().tail_padding_bytes};
 
   return ImageView<PixelTypeDst, ImageModifiability::Constant>(byte_ptr, layout);
 }
@@ -232,7 +232,7 @@ auto view_with_pixel_type(ImageBase<DerivedSrc>& img, const BoundingBox& region)
 
   const auto data_offset = Bytes(img.stride_bytes() * region.y0() + PixelTraits<PixelTypeSrc>::nr_bytes * region.x0());
   const auto byte_ptr = img.byte_ptr() + data_offset;
-  const auto layout = TypedLayout{region.width(), region.height(), img.stride_bytes()};
+  const auto layout = TypedLayout{region.width(), region.height(), img.stride_bytes(), img.layout().tail_padding_bytes};
 
   return ImageView<PixelTypeDst, modifiability>(byte_ptr, layout);
 }
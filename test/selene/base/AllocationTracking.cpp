@@ -0,0 +1,169 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch2/catch.hpp>
+
+#include <selene/base/AllocationTracking.hpp>
+#include <selene/base/Allocators.hpp>
+#include <selene/base/MemoryBlock.hpp>
+#include <selene/base/ThreadPool.hpp>
+
+#include <selene/img/pixel/PixelTypeAliases.hpp>
+#include <selene/img/typed/Image.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+
+using namespace sln::literals;
+
+TEST_CASE("Allocation tracking", "[base]")
+{
+  REQUIRE(!sln::is_allocation_tracking_enabled());
+
+  SECTION("Disabled tracking")
+  {
+    const auto stats_before = sln::allocation_statistics();
+    {
+      auto block = sln::AlignedNewAllocator::allocate(1000, 16);
+      REQUIRE(block.data() != nullptr);
+    }
+
+    const auto stats_after = sln::allocation_statistics();
+    REQUIRE(stats_after.nr_allocations == stats_before.nr_allocations);
+    REQUIRE(stats_after.live_bytes == stats_before.live_bytes);
+  }
+
+  SECTION("Plain allocators hand out unmodified memory")
+  {
+    // Memory can be released with std::free or delete[] directly...
+    auto block_0 = sln::MallocAllocator::allocate(100);
+    std::free(block_0.transfer_data());
+    auto block_1 = sln::NewAllocator::allocate(100);
+    delete[] block_1.transfer_data();
+
+    sln::set_allocation_tracking_enabled(true);
+    const auto live_bytes_before = sln::allocation_statistics().live_bytes;
+
+    {
+      // ...and memory from std::malloc or new[] can be adopted; it is not tracked.
+      auto block_2 = sln::construct_memory_block_from_existing_memory<sln::MallocAllocator>(
+          static_cast<std::uint8_t*>(std::malloc(64)), 64);
+      auto block_3 = sln::construct_memory_block_from_existing_memory<sln::NewAllocator>(new std::uint8_t[64], 64);
+      auto block_4 = sln::MallocAllocator::allocate(200);
+      auto block_5 = sln::NewAllocator::allocate(300);
+      REQUIRE(block_2.data() != nullptr);
+      REQUIRE(block_3.data() != nullptr);
+      REQUIRE(sln::allocation_statistics().live_bytes == live_bytes_before + 500);
+    }
+
+    REQUIRE(sln::allocation_statistics().live_bytes == live_bytes_before);
+    sln::set_allocation_tracking_enabled(false);
+  }
+
+  SECTION("Counters, peak, and histogram")
+  {
+    sln::set_allocation_tracking_enabled(true);
+    sln::reset_allocation_statistics();
+    const auto live_bytes_before = sln::allocation_statistics().live_bytes;
+
+    {
+      auto block_0 = sln::AlignedNewAllocator::allocate(1000, 16);
+      auto block_1 = sln::MallocAllocator::allocate(100);
+      auto block_2 = sln::NewAllocator::allocate(5000);
+
+      const auto stats = sln::allocation_statistics();
+      REQUIRE(stats.nr_allocations == 3);
+      REQUIRE(stats.bytes_allocated == 6100);
+      REQUIRE(stats.live_bytes == live_bytes_before + 6100);
+      REQUIRE(stats.size_histogram[6] == 1);  // [64, 128)
+      REQUIRE(stats.size_histogram[9] == 1);  // [512, 1024)
+      REQUIRE(stats.size_histogram[12] == 1);  // [4096, 8192)
+    }
+
+    {
+      sln::Image<sln::Pixel_8u1> img({100_px, 10_px}, sln::ImageRowAlignment{0});
+    }
+
+    sln::set_allocation_tracking_enabled(false);
+
+    const auto stats = sln::allocation_statistics();
+    REQUIRE(stats.nr_allocations == 4);
+    REQUIRE(stats.nr_deallocations == 4);
+    REQUIRE(stats.bytes_allocated == 7100);
+    REQUIRE(stats.live_bytes == live_bytes_before);
+    REQUIRE(stats.peak_live_bytes >= live_bytes_before + 6100);
+
+    sln::reset_allocation_statistics();
+    const auto stats_reset = sln::allocation_statistics();
+    REQUIRE(stats_reset.nr_allocations == 0);
+    REQUIRE(stats_reset.bytes_allocated == 0);
+    REQUIRE(stats_reset.peak_live_bytes == stats_reset.live_bytes);
+  }
+
+  SECTION("Deallocation after disabling tracking")
+  {
+    sln::set_allocation_tracking_enabled(true);
+    const auto live_bytes_before = sln::allocation_statistics().live_bytes;
+    {
+      auto block = sln::AlignedMallocAllocator::allocate(256, 64);
+      REQUIRE(sln::allocation_statistics().live_bytes == live_bytes_before + 256);
+      sln::set_allocation_tracking_enabled(false);
+    }
+
+    REQUIRE(sln::allocation_statistics().live_bytes == live_bytes_before);
+  }
+
+  SECTION("Allocation tags")
+  {
+    sln::set_allocation_tracking_enabled(true);
+    sln::reset_allocation_statistics();
+    REQUIRE(sln::current_allocation_tag() == nullptr);
+
+    {
+      sln::AllocationTagScope tag("test output");
+      REQUIRE(std::string(sln::current_allocation_tag()) == "test output");
+      auto block_0 = sln::AlignedNewAllocator::allocate(300, 16);
+
+      {
+        sln::AllocationTagScope inner_tag("test temporary");
+        auto block_1 = sln::AlignedNewAllocator::allocate(200, 16);
+        REQUIRE(sln::allocation_statistics().tags["test temporary"].live_bytes == 200);
+      }
+
+      auto block_2 = sln::AlignedNewAllocator::allocate(300, 16);
+      const auto stats = sln::allocation_statistics();
+      REQUIRE(stats.tags.at("test output").nr_allocations == 2);
+      REQUIRE(stats.tags.at("test output").live_bytes == 600);
+      REQUIRE(stats.tags.at("test temporary").live_bytes == 0);
+      REQUIRE(stats.tags.at("test temporary").bytes_allocated == 200);
+    }
+
+    REQUIRE(sln::current_allocation_tag() == nullptr);
+    REQUIRE(sln::allocation_statistics().tags.at("test output").live_bytes == 0);
+    sln::set_allocation_tracking_enabled(false);
+  }
+
+  SECTION("Aggregation over threads")
+  {
+    sln::set_allocation_tracking_enabled(true);
+    sln::reset_allocation_statistics();
+
+    {
+      sln::ThreadPool thread_pool(4);
+      thread_pool.run(40, [](std::size_t) {
+        sln::AllocationTagScope tag("worker");
+        auto block = sln::AlignedNewAllocator::allocate(1024, 16);
+      });
+    }
+
+    sln::set_allocation_tracking_enabled(false);
+
+    // Includes the counters of the exited pool threads.
+    const auto stats = sln::allocation_statistics();
+    REQUIRE(stats.tags.at("worker").nr_allocations == 40);
+    REQUIRE(stats.tags.at("worker").bytes_allocated == 40 * 1024);
+    REQUIRE(stats.tags.at("worker").live_bytes == 0);
+    REQUIRE(stats.size_histogram[10] >= 40);
+  }
+}
@@ -61,4 +61,32 @@ TEST_CASE("Allocators", "[base]")
       REQUIRE(reinterpret_cast<std::uintptr_t>(memory_block.data()) % alignment == 0);
     }
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Memory block move semantics", "[base]")
+{
+  auto block_0 = sln::AlignedNewAllocator::allocate(256, 64);
+  const auto data_0 = block_0.data();
+  REQUIRE(data_0 != nullptr);
+
+  auto block_1 = std::move(block_0);
+  REQUIRE(block_1.data() == data_0);
+  REQUIRE(block_1.size() == 256);
+  REQUIRE(block_0.data() == nullptr);
+  REQUIRE(block_0.size() == 0);
+
+  auto block_2 = sln::AlignedNewAllocator::allocate(128, 16);
+  block_2 = std::move(block_1);
+  REQUIRE(block_2.data() == data_0);
+  REQUIRE(block_2.size() == 256);
+  REQUIRE(block_1.data() == nullptr);
+  REQUIRE(block_1.size() == 0);
+
+  auto block_3 = sln::allocate_memory_block<sln::MallocAllocator>(100, 64);
+  REQUIRE(block_3.data() != nullptr);
+  REQUIRE(block_3.size() == 100);
+
+  auto block_4 = sln::allocate_memory_block<sln::AlignedMallocAllocator>(100, 64);
+  REQUIRE(block_4.size() >= 100);
+  REQUIRE(reinterpret_cast<std::uintptr_t>(block_4.data()) % 64 == 0);
+}
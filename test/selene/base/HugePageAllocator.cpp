@@ -0,0 +1,78 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch2/catch.hpp>
+
+#include <selene/base/HugePageAllocator.hpp>
+
+#include <selene/img/dynamic/DynImage.hpp>
+#include <selene/img/pixel/PixelTypeAliases.hpp>
+#include <selene/img/typed/Image.hpp>
+
+#include <selene/img_ops/Fill.hpp>
+
+#include <algorithm>
+#include <cstdint>
+
+using namespace sln::literals;
+
+TEST_CASE("Huge page allocator", "[base]")
+{
+  SECTION("Small allocations")
+  {
+    auto block = sln::HugePageAllocator::allocate(1000, 32);
+    REQUIRE(block.data() != nullptr);
+    REQUIRE(block.size() == 1000);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(block.data()) % 32 == 0);
+    REQUIRE(sln::HugePageAllocator::backing(block.data()) == sln::HugePageBacking::None);
+    std::fill(block.data(), block.data() + block.size(), std::uint8_t{1});
+  }
+
+  SECTION("Large allocations")
+  {
+    constexpr std::size_t nr_bytes = 5 * sln::HugePageAllocator::huge_page_size + 123;
+    auto block = sln::HugePageAllocator::allocate(nr_bytes, 128);
+    REQUIRE(block.data() != nullptr);
+    REQUIRE(block.size() == nr_bytes);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(block.data()) % 128 == 0);
+#if defined(__linux__)
+    REQUIRE(sln::HugePageAllocator::backing(block.data()) != sln::HugePageBacking::None);
+#endif
+    std::fill(block.data(), block.data() + block.size(), std::uint8_t{2});
+    REQUIRE(block.data()[nr_bytes - 1] == 2);
+  }
+
+  SECTION("NUMA node placement")
+  {
+    sln::NumaNodeScope scope(0, sln::NumaPlacement::Preferred);
+    {
+      sln::NumaNodeScope inner_scope(0, sln::NumaPlacement::Bind);
+      auto block = sln::HugePageAllocator::allocate(3 * sln::HugePageAllocator::huge_page_size, 64);
+      REQUIRE(block.data() != nullptr);
+      std::fill(block.data(), block.data() + block.size(), std::uint8_t{3});
+    }
+
+    auto block = sln::HugePageAllocator::allocate(3 * sln::HugePageAllocator::huge_page_size, 64);
+    REQUIRE(block.data() != nullptr);
+    std::fill(block.data(), block.data() + block.size(), std::uint8_t{4});
+  }
+}
+
+TEST_CASE("Huge page image allocation", "[base]")
+{
+  sln::Image<sln::PixelRGBA_8u, sln::HugePageAllocator> img({1024_px, 1024_px});
+  sln::fill(img, sln::PixelRGBA_8u(1, 2, 3, 4));
+  REQUIRE(img(1023_idx, 1023_idx) == sln::PixelRGBA_8u(1, 2, 3, 4));
+
+  auto img_copy = img;
+  REQUIRE(img_copy == img);
+
+  img.reallocate({2000_px, 1500_px}, sln::ImageRowAlignment{64});
+  REQUIRE(img.stride_bytes() % 64 == 0);
+  sln::fill(img, sln::PixelRGBA_8u(5, 6, 7, 8));
+  REQUIRE(img(1999_idx, 1499_idx) == sln::PixelRGBA_8u(5, 6, 7, 8));
+
+  sln::DynImageT<sln::HugePageAllocator> dyn_img({4096_px, 1024_px, 1, 1});
+  REQUIRE(dyn_img.is_valid());
+}
@@ -0,0 +1,158 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch2/catch.hpp>
+
+#include <selene/base/ImageArena.hpp>
+#include <selene/base/ThreadPool.hpp>
+
+#include <selene/img/dynamic/DynImage.hpp>
+#include <selene/img/pixel/PixelTypeAliases.hpp>
+#include <selene/img/typed/ArenaImageView.hpp>
+#include <selene/img/typed/Image.hpp>
+
+#include <selene/img_ops/Fill.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+using namespace sln::literals;
+
+TEST_CASE("Image arena", "[base]")
+{
+  sln::ImageArena arena(4096);
+  REQUIRE(arena.capacity() == 0);
+  REQUIRE(arena.allocate(0, 16) == nullptr);
+
+  SECTION("Bump allocation")
+  {
+    auto ptr0 = arena.allocate(100, 16);
+    auto ptr1 = arena.allocate(100, 64);
+    auto ptr2 = arena.allocate(1, 1);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(ptr0) % 16 == 0);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(ptr1) % 64 == 0);
+    REQUIRE(ptr1 >= ptr0 + 100);
+    REQUIRE(ptr2 == ptr1 + 100);
+    REQUIRE(arena.nr_slabs() == 1);
+    REQUIRE(arena.capacity() == 4096);
+    REQUIRE(arena.bytes_used() >= 201);
+
+    arena.reset();
+    REQUIRE(arena.bytes_used() == 0);
+    REQUIRE(arena.allocate(100, 16) == ptr0);
+  }
+
+  SECTION("Slab growth and coalescing")
+  {
+    for (int i = 0; i < 10; ++i)
+    {
+      auto ptr = arena.allocate(3000, 64);
+      REQUIRE(ptr != nullptr);
+      std::fill(ptr, ptr + 3000, std::uint8_t(i));
+    }
+
+    REQUIRE(arena.nr_slabs() > 1);
+    const auto capacity = arena.capacity();
+
+    arena.reset();
+    REQUIRE(arena.nr_slabs() == 1);
+    REQUIRE(arena.capacity() == capacity);
+
+    // The same allocation pattern is now served from a single slab.
+    for (int i = 0; i < 10; ++i)
+    {
+      REQUIRE(arena.allocate(3000, 64) != nullptr);
+    }
+
+    REQUIRE(arena.nr_slabs() == 1);
+
+    arena.release();
+    REQUIRE(arena.nr_slabs() == 0);
+    REQUIRE(arena.capacity() == 0);
+  }
+
+  SECTION("Image views")
+  {
+    auto view = sln::allocate_image_view<sln::PixelRGB_8u>(arena, {30_px, 20_px}, sln::ImageRowAlignment{32});
+    REQUIRE(view.is_valid());
+    REQUIRE(view.width() == 30_px);
+    REQUIRE(view.height() == 20_px);
+    REQUIRE(view.stride_bytes() == 96);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(view.byte_ptr()) % 32 == 0);
+
+    sln::fill(view, sln::PixelRGB_8u(4, 5, 6));
+    REQUIRE(view(29_idx, 19_idx) == sln::PixelRGB_8u(4, 5, 6));
+  }
+}
+
+TEST_CASE("Image arena allocator", "[base]")
+{
+  sln::ImageArena arena;
+  REQUIRE(sln::current_image_arena() == nullptr);
+
+  // Without a current arena, allocation fails.
+  REQUIRE(sln::ArenaAllocator::allocate(100, 16).data() == nullptr);
+
+  {
+    sln::ImageArenaScope scope(arena);
+    REQUIRE(sln::current_image_arena() == &arena);
+
+    sln::Image<sln::PixelRGB_8u, sln::ArenaAllocator> img({64_px, 48_px});
+    sln::fill(img, sln::PixelRGB_8u(1, 2, 3));
+    REQUIRE(arena.nr_live_images() == 1);
+
+    auto img_copy = img;
+    REQUIRE(img_copy == img);
+    REQUIRE(arena.nr_live_images() == 2);
+
+    sln::DynImageT<sln::ArenaAllocator> dyn_img({32_px, 16_px, 1, 4});
+    REQUIRE(dyn_img.is_valid());
+    REQUIRE(arena.nr_live_images() == 3);
+
+    sln::ImageArena inner_arena;
+    {
+      sln::ImageArenaScope inner_scope(inner_arena);
+      REQUIRE(sln::current_image_arena() == &inner_arena);
+      sln::Image<sln::Pixel_32f1, sln::ArenaAllocator> img_inner({10_px, 10_px});
+      REQUIRE(inner_arena.nr_live_images() == 1);
+      REQUIRE(arena.nr_live_images() == 3);
+    }
+
+    REQUIRE(inner_arena.nr_live_images() == 0);
+    REQUIRE(sln::current_image_arena() == &arena);
+  }
+
+  REQUIRE(sln::current_image_arena() == nullptr);
+  REQUIRE(arena.nr_live_images() == 0);
+  REQUIRE(arena.bytes_used() > 0);
+  arena.reset();
+  REQUIRE(arena.bytes_used() == 0);
+}
+
+TEST_CASE("Image arenas per thread", "[base]")
+{
+  sln::ThreadPool thread_pool(4);
+  std::atomic<bool> all_valid{true};
+
+  thread_pool.run(32, [&all_valid](std::size_t task) {
+    sln::ImageArena arena(64 * 1024);
+    sln::ImageArenaScope scope(arena);
+
+    for (int request = 0; request < 10; ++request)
+    {
+      {
+        sln::Image<sln::Pixel_8u1, sln::ArenaAllocator> img({100_px, 50_px});
+        sln::fill(img, static_cast<std::uint8_t>(task));
+        if (img(99_idx, 49_idx) != static_cast<std::uint8_t>(task))
+        {
+          all_valid = false;
+        }
+      }
+
+      arena.reset();
+    }
+  });
+
+  REQUIRE(all_valid);
+}
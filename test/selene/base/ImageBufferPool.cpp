@@ -0,0 +1,211 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch2/catch.hpp>
+
+#include <selene/base/ImageBufferPool.hpp>
+#include <selene/base/Kernel.hpp>
+#include <selene/base/ThreadPool.hpp>
+
+#include <selene/img/dynamic/DynImage.hpp>
+#include <selene/img/pixel/PixelTypeAliases.hpp>
+#include <selene/img/typed/Image.hpp>
+#include <selene/img/typed/ImageTypeAliases.hpp>
+
+#include <selene/img_ops/Convolution.hpp>
+#include <selene/img_ops/Fill.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace sln::literals;
+
+TEST_CASE("Image buffer pool size classes", "[base]")
+{
+  REQUIRE(sln::ImageBufferPool::size_class(1) == 256);
+  REQUIRE(sln::ImageBufferPool::size_class(256) == 256);
+  REQUIRE(sln::ImageBufferPool::size_class(257) == 320);
+  REQUIRE(sln::ImageBufferPool::size_class(1024) == 1024);
+  REQUIRE(sln::ImageBufferPool::size_class(1025) == 1280);
+  REQUIRE(sln::ImageBufferPool::size_class(1920 * 1080 * 3) == 6 * 1024 * 1024);
+
+  std::mt19937 rng(13);
+  std::uniform_int_distribution<std::size_t> dist(1, 100'000'000);
+  for (int i = 0; i < 1000; ++i)
+  {
+    const auto nr_bytes = dist(rng);
+    const auto capacity = sln::ImageBufferPool::size_class(nr_bytes);
+    REQUIRE(capacity >= nr_bytes);
+    REQUIRE(capacity <= nr_bytes + nr_bytes / 4 + 256);
+  }
+}
+
+TEST_CASE("Image buffer pool", "[base]")
+{
+  sln::ImageBufferPool pool;
+
+  SECTION("Acquisition and release")
+  {
+    REQUIRE(pool.acquire(0, 16) == nullptr);
+
+    auto ptr0 = pool.acquire(1000, 64);
+    REQUIRE(ptr0 != nullptr);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(ptr0) % 64 == 0);
+    std::fill(ptr0, ptr0 + 1000, std::uint8_t{0xAB});
+
+    auto stats = pool.statistics();
+    REQUIRE(stats.nr_hits == 0);
+    REQUIRE(stats.nr_misses == 1);
+    REQUIRE(stats.nr_buffers_in_use == 1);
+    REQUIRE(stats.bytes_in_use == 1024);
+
+    sln::ImageBufferPool::release(ptr0);
+    stats = pool.statistics();
+    REQUIRE(stats.nr_buffers_in_use == 0);
+    REQUIRE(stats.nr_buffers_cached == 1);
+    REQUIRE(stats.bytes_cached == 1024);
+
+    // Same size class: reuse the cached buffer
+    auto ptr1 = pool.acquire(900, 32);
+    REQUIRE(ptr1 == ptr0);
+    stats = pool.statistics();
+    REQUIRE(stats.nr_hits == 1);
+    REQUIRE(stats.nr_misses == 1);
+
+    // Larger alignment than the cached buffer: allocate a new one
+    sln::ImageBufferPool::release(ptr1);
+    auto ptr2 = pool.acquire(900, 4096);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(ptr2) % 4096 == 0);
+    stats = pool.statistics();
+    REQUIRE(stats.nr_misses == 2);
+    REQUIRE(stats.bytes_in_use == 1024);
+    REQUIRE(stats.bytes_cached == 1024);
+    REQUIRE(stats.high_water_bytes == 2048);
+    REQUIRE(stats.peak_bytes_in_use == 1024);
+
+    sln::ImageBufferPool::release(ptr2);
+    pool.release_cached_memory();
+    stats = pool.statistics();
+    REQUIRE(stats.nr_buffers_cached == 0);
+    REQUIRE(stats.bytes_cached == 0);
+    REQUIRE(stats.high_water_bytes == 2048);
+
+    pool.reset_statistics();
+    stats = pool.statistics();
+    REQUIRE(stats.nr_hits == 0);
+    REQUIRE(stats.nr_misses == 0);
+    REQUIRE(stats.high_water_bytes == 0);
+  }
+
+  SECTION("Cache limit")
+  {
+    pool.set_max_cached_bytes(1500);
+    REQUIRE(pool.max_cached_bytes() == 1500);
+
+    auto ptr0 = pool.acquire(1024, 16);
+    auto ptr1 = pool.acquire(1024, 16);
+    sln::ImageBufferPool::release(ptr0);
+    sln::ImageBufferPool::release(ptr1);
+
+    const auto stats = pool.statistics();
+    REQUIRE(stats.nr_buffers_cached == 1);
+    REQUIRE(stats.bytes_cached == 1024);
+  }
+
+  SECTION("Concurrent use")
+  {
+    sln::ThreadPool thread_pool(4);
+    std::atomic<bool> all_acquired{true};
+    thread_pool.run(64, [&pool, &all_acquired](std::size_t task) {
+      std::vector<std::uint8_t*> buffers;
+      for (std::size_t i = 0; i < 50; ++i)
+      {
+        const auto nr_bytes = 100 + 997 * ((task + i) % 7);
+        auto ptr = pool.acquire(nr_bytes, 64);
+        if (ptr == nullptr)
+        {
+          all_acquired = false;
+          continue;
+        }
+
+        ptr[0] = ptr[nr_bytes - 1] = static_cast<std::uint8_t>(task);
+        buffers.push_back(ptr);
+      }
+
+      for (auto ptr : buffers)
+      {
+        sln::ImageBufferPool::release(ptr);
+      }
+    });
+
+    REQUIRE(all_acquired);
+    const auto stats = pool.statistics();
+    REQUIRE(stats.nr_hits + stats.nr_misses == 64 * 50);
+    REQUIRE(stats.nr_buffers_in_use == 0);
+    REQUIRE(stats.bytes_in_use == 0);
+    REQUIRE(stats.bytes_cached <= stats.high_water_bytes);
+  }
+}
+
+TEST_CASE("Pooled image allocation", "[base]")
+{
+  auto& pool = sln::default_image_buffer_pool();
+
+  {
+    // Warm up the pool for the respective size classes.
+    sln::Image<sln::PixelRGB_8u, sln::PooledAllocator> img({640_px, 480_px});
+    sln::DynImageT<sln::PooledAllocator> dyn_img({320_px, 240_px, 1, 2});
+  }
+
+  pool.reset_statistics();
+
+  for (int frame = 0; frame < 100; ++frame)
+  {
+    sln::Image<sln::PixelRGB_8u, sln::PooledAllocator> img({640_px, 480_px});
+    sln::fill(img, sln::PixelRGB_8u(1, 2, 3));
+    REQUIRE(img(639_idx, 479_idx) == sln::PixelRGB_8u(1, 2, 3));
+
+    auto img_copy = img;
+    REQUIRE(img_copy == img);
+
+    sln::DynImageT<sln::PooledAllocator> dyn_img({320_px, 240_px, 1, 2});
+    REQUIRE(dyn_img.is_valid());
+  }
+
+  // In steady state, all allocations are served by the pool.
+  const auto stats = pool.statistics();
+  REQUIRE(stats.nr_misses <= 1);
+  REQUIRE(stats.nr_hits >= 299);
+}
+
+TEST_CASE("Pooled destination images of image operations", "[base]")
+{
+  auto& pool = sln::default_image_buffer_pool();
+  const sln::Kernel<double, 3> kernel{{0.25, 0.5, 0.25}};
+
+  sln::Image_8u1 img_src({641_px, 479_px});
+  sln::fill(img_src, std::uint8_t{100});
+
+  {
+    // Warm up the pool for the respective size class.
+    sln::Image<sln::Pixel_8u1, sln::PooledAllocator> img_dst;
+    sln::convolution_x<sln::BorderAccessMode::Replicated>(img_src, img_dst, kernel);
+  }
+
+  pool.reset_statistics();
+
+  for (int frame = 0; frame < 50; ++frame)
+  {
+    sln::Image<sln::Pixel_8u1, sln::PooledAllocator> img_dst;
+    sln::convolution_x<sln::BorderAccessMode::Replicated>(img_src, img_dst, kernel);
+    REQUIRE(img_dst.width() == 641_px);
+    REQUIRE(img_dst(640_idx, 478_idx) == std::uint8_t{100});
+  }
+
+  const auto stats = pool.statistics();
+  REQUIRE(stats.nr_misses == 0);
+  REQUIRE(stats.nr_hits == 50);
+}
@@ -0,0 +1,70 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch2/catch.hpp>
+
+#include <selene/base/ThreadPool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("Thread pool", "[base]")
+{
+  for (std::size_t nr_threads : {std::size_t{1}, std::size_t{2}, std::size_t{4}})
+  {
+    sln::ThreadPool pool(nr_threads);
+    REQUIRE(pool.nr_threads() == nr_threads);
+
+    SECTION("Run tasks")
+    {
+      for (std::size_t nr_tasks : {std::size_t{0}, std::size_t{1}, std::size_t{7}, std::size_t{1000}})
+      {
+        std::vector<int> counts(nr_tasks, 0);
+        pool.run(nr_tasks, [&counts](std::size_t i) { counts[i] += 1; });
+        REQUIRE(std::all_of(counts.cbegin(), counts.cend(), [](int c) { return c == 1; }));
+      }
+    }
+
+    SECTION("Parallel for")
+    {
+      for (std::ptrdiff_t grain_size : {std::ptrdiff_t{1}, std::ptrdiff_t{10}, std::ptrdiff_t{5000}})
+      {
+        std::vector<int> counts(1234, 0);
+        pool.parallel_for(0, 1234, grain_size, [&counts](std::ptrdiff_t begin, std::ptrdiff_t end) {
+          for (auto i = begin; i < end; ++i)
+          {
+            counts[static_cast<std::size_t>(i)] += 1;
+          }
+        });
+        REQUIRE(std::all_of(counts.cbegin(), counts.cend(), [](int c) { return c == 1; }));
+      }
+    }
+
+    SECTION("Nested parallel for")
+    {
+      std::atomic<std::ptrdiff_t> sum{0};
+      pool.parallel_for(0, 16, 1, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (auto i = begin; i < end; ++i)
+        {
+          pool.parallel_for(0, 100, 1, [&](std::ptrdiff_t b, std::ptrdiff_t e) { sum += (e - b); });
+        }
+      });
+      REQUIRE(sum == 1600);
+    }
+
+    SECTION("Exception propagation")
+    {
+      REQUIRE_THROWS_AS(pool.run(100, [](std::size_t i) { if (i == 42) { throw std::runtime_error("42"); } }),
+                        std::runtime_error);
+      // The pool is still usable afterwards
+      std::atomic<std::size_t> cnt{0};
+      pool.run(100, [&cnt](std::size_t) { ++cnt; });
+      REQUIRE(cnt == 100);
+    }
+  }
+
+  REQUIRE(sln::default_thread_pool().nr_threads() == sln::ThreadPool::default_nr_threads());
+}
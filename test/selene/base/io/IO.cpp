@@ -8,6 +8,7 @@
 #include <selene/base/io/FileReader.hpp>
 #include <selene/base/io/FileUtils.hpp>
 #include <selene/base/io/FileWriter.hpp>
+#include <selene/base/io/MemoryMappedFile.hpp>
 #include <selene/base/io/MemoryReader.hpp>
 #include <selene/base/io/MemoryWriter.hpp>
 #include <selene/base/io/VectorReader.hpp>
@@ -19,6 +20,7 @@
 #include <array>
 #include <cstring>
 #include <limits>
+#include <numeric>
 #include <random>
 #include <type_traits>
 
@@ -248,3 +250,90 @@ TEST_CASE("Test binary data I/O", "[io]")
     }
   }
 }
+
+TEST_CASE("Test memory-mapped files", "[io]")
+{
+  const auto tmp_path = sln_test::get_tmp_path();
+  const auto filename = tmp_path / "test_memory_mapped_file.bin";
+
+  std::vector<std::uint8_t> data(10000);
+  std::iota(data.begin(), data.end(), std::uint8_t{0});
+  sln::write_data_contents(filename.string(), data.data(), data.size());
+
+  SECTION("Read-only mapping")
+  {
+    sln::MemoryMappedFile file(filename.string());
+    REQUIRE(file.is_open());
+    REQUIRE(!file.is_writable());
+    REQUIRE(file.mode() == sln::MappingMode::ReadOnly);
+    REQUIRE(file.size() == data.size());
+    REQUIRE(std::memcmp(file.data(), data.data(), data.size()) == 0);
+    REQUIRE(file.mutable_data() == nullptr);
+    REQUIRE(file.region().len == data.size());
+    REQUIRE(file.mutable_region().len == 0);
+    REQUIRE(!file.flush());
+
+    REQUIRE(file.advise(sln::MappingAccessHint::Sequential));
+    REQUIRE(file.advise(sln::MappingAccessHint::WillNeed, 5000, 1000));
+    REQUIRE(!file.advise(sln::MappingAccessHint::WillNeed, 20000, 1000));
+
+    sln::MemoryReader reader(file.region());
+    REQUIRE(sln::read<std::uint8_t>(reader) == 0);
+    REQUIRE(sln::read<std::uint8_t>(reader) == 1);
+
+    auto file_moved = std::move(file);
+    REQUIRE(!file.is_open());
+    REQUIRE(file.data() == nullptr);
+    REQUIRE(file_moved.is_open());
+    REQUIRE(file_moved.data()[255] == 255);
+
+    file_moved.close();
+    REQUIRE(!file_moved.is_open());
+    REQUIRE(file_moved.size() == 0);
+  }
+
+  SECTION("Read-write mapping")
+  {
+    {
+      sln::MemoryMappedFile file(filename.string(), sln::MappingMode::ReadWrite);
+      REQUIRE(file.is_writable());
+      file.mutable_data()[0] = 42;
+      REQUIRE(file.flush());
+      file.mutable_data()[9999] = 43;
+    }
+
+    const auto data_read = sln::read_file_contents(filename.string());
+    REQUIRE(data_read[0] == 42);
+    REQUIRE(data_read[1] == 1);
+    REQUIRE(data_read[9999] == 43);
+  }
+
+  SECTION("Copy-on-write mapping")
+  {
+    {
+      sln::MemoryMappedFile file(filename.string(), sln::MappingMode::CopyOnWrite);
+      REQUIRE(file.is_writable());
+      file.mutable_data()[0] = 42;
+      REQUIRE(file.data()[0] == 42);
+      REQUIRE(!file.flush());
+    }
+
+    const auto data_read = sln::read_file_contents(filename.string());
+    REQUIRE(data_read == data);
+  }
+
+  SECTION("Errors")
+  {
+    sln::MemoryMappedFile file;
+    REQUIRE(!file.is_open());
+    REQUIRE(!file.open((tmp_path / "non_existent_file.bin").string()));
+    REQUIRE(!file.is_open());
+    REQUIRE_THROWS(sln::MemoryMappedFile((tmp_path / "non_existent_file.bin").string()));
+
+    sln::write_data_contents(filename.string(), data.data(), 0);
+    REQUIRE(file.open(filename.string()));
+    REQUIRE(file.is_open());
+    REQUIRE(file.size() == 0);
+    REQUIRE(file.data() == nullptr);
+  }
+}
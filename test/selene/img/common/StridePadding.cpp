@@ -0,0 +1,50 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch2/catch.hpp>
+
+#include <selene/img/common/StridePadding.hpp>
+
+#include <thread>
+
+TEST_CASE("Stride padding", "[img]")
+{
+  REQUIRE(sln::stride_padding_policy().critical_stride_bytes == 0);
+
+  const auto policy = sln::avoid_cache_set_aliasing();
+  REQUIRE(sln::padded_stride_bytes(sln::Stride{4096}, sln::ImageRowAlignment{16}, policy) == 4096 + 64);
+  REQUIRE(sln::padded_stride_bytes(sln::Stride{3 * 4096}, sln::ImageRowAlignment{0}, policy) == 3 * 4096 + 64);
+  REQUIRE(sln::padded_stride_bytes(sln::Stride{4096 + 64}, sln::ImageRowAlignment{64}, policy) == 4096 + 64);
+  REQUIRE(sln::padded_stride_bytes(sln::Stride{2048}, sln::ImageRowAlignment{16}, policy) == 2048);
+  REQUIRE(sln::padded_stride_bytes(sln::Stride{0}, sln::ImageRowAlignment{16}, policy) == 0);
+
+  // The padding keeps the stride aligned.
+  REQUIRE(sln::padded_stride_bytes(sln::Stride{8192}, sln::ImageRowAlignment{128}, policy) == 8192 + 128);
+
+  REQUIRE(sln::padded_stride_bytes(sln::Stride{4096}, sln::ImageRowAlignment{16}, sln::no_stride_padding()) == 4096);
+  REQUIRE(sln::padded_stride_bytes(sln::Stride{4096}, sln::ImageRowAlignment{16}) == 4096);
+
+  {
+    sln::StridePaddingPolicyScope scope(policy);
+    REQUIRE(sln::stride_padding_policy().critical_stride_bytes == 4096);
+    REQUIRE(sln::stride_padding_policy().padding_bytes == 64);
+    REQUIRE(sln::padded_stride_bytes(sln::Stride{4096}, sln::ImageRowAlignment{16}) == 4096 + 64);
+  }
+
+  REQUIRE(sln::stride_padding_policy().critical_stride_bytes == 0);
+}
+
+TEST_CASE("Stride padding policy is per thread", "[img]")
+{
+  sln::StridePaddingPolicyScope scope(sln::avoid_cache_set_aliasing());
+
+  std::ptrdiff_t other_critical_stride_bytes = -1;
+  std::thread other_thread([&other_critical_stride_bytes]() {
+    other_critical_stride_bytes = sln::stride_padding_policy().critical_stride_bytes;
+  });
+  other_thread.join();
+
+  REQUIRE(other_critical_stride_bytes == 0);
+  REQUIRE(sln::stride_padding_policy().critical_stride_bytes == 4096);
+}
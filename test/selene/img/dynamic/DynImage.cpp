@@ -4,6 +4,8 @@
 
 #include <catch2/catch.hpp>
 
+#include <selene/base/Allocators.hpp>
+
 #include <selene/img/dynamic/DynImage.hpp>
 #include <selene/img/dynamic/DynImageView.hpp>
 
@@ -119,3 +121,58 @@ TEST_CASE("DynImage construction", "[img]")
   test_dyn_image_construction_over_channels<std::uint64_t>(rng);
   test_dyn_image_construction_over_channels<std::int64_t>(rng);
 }
+
+TEST_CASE("DynImage construction with different allocators", "[img]")
+{
+  sln::DynImageT<sln::MallocAllocator> dyn_img_0({21_px, 5_px, 3, 2});
+  REQUIRE(dyn_img_0.is_valid());
+  REQUIRE(dyn_img_0.is_packed());
+  std::fill(dyn_img_0.byte_ptr(), dyn_img_0.byte_ptr() + dyn_img_0.total_bytes(), std::uint8_t{0x5A});
+
+  sln::DynImageT<sln::MallocAllocator> dyn_img_1 = dyn_img_0;
+  REQUIRE(dyn_img_1.byte_ptr() != dyn_img_0.byte_ptr());
+  REQUIRE(dyn_img_1 == dyn_img_0);
+
+  const sln::DynImageT<sln::NewAllocator> dyn_img_2(dyn_img_0.view());
+  REQUIRE(dyn_img_2 == dyn_img_0);
+
+  const auto ptr_1 = dyn_img_1.byte_ptr();
+  auto dyn_img_3 = std::move(dyn_img_1);
+  REQUIRE(dyn_img_3.byte_ptr() == ptr_1);
+
+  auto memory = dyn_img_3.relinquish_data_ownership();
+  REQUIRE(memory.data() == ptr_1);
+  REQUIRE(!dyn_img_3.is_valid());
+}
+
+TEST_CASE("DynImage capacity", "[img]")
+{
+  sln::DynImage dyn_img({40_px, 30_px, 3, 1}, sln::ImageRowAlignment{16});
+  const auto data = dyn_img.byte_ptr();
+  const auto capacity = dyn_img.capacity_bytes();
+  REQUIRE(capacity == dyn_img.total_bytes());
+
+  const auto semantics = sln::UntypedImageSemantics{sln::PixelFormat::RGB, sln::SampleFormat::UnsignedInteger};
+  REQUIRE(!dyn_img.reallocate({20_px, 10_px, 3, 1}, sln::ImageRowAlignment{16}, semantics));
+  REQUIRE(dyn_img.width() == 20_px);
+  REQUIRE(dyn_img.byte_ptr() == data);
+  REQUIRE(dyn_img.pixel_format() == sln::PixelFormat::RGB);
+  REQUIRE(dyn_img.capacity_bytes() == capacity);
+
+  std::fill(dyn_img.byte_ptr(), dyn_img.byte_ptr() + dyn_img.total_bytes(), std::uint8_t{0x5A});
+  REQUIRE(dyn_img.shrink_to_fit());
+  REQUIRE(dyn_img.capacity_bytes() == dyn_img.total_bytes());
+  REQUIRE(dyn_img.pixel_format() == sln::PixelFormat::RGB);
+  REQUIRE(*dyn_img.byte_ptr(19_idx, 9_idx) == 0x5A);
+
+  // Same number of bytes, but a different layout.
+  const sln::DynImage dyn_img_src({10_px, 20_px, 3, 1});
+  dyn_img = dyn_img_src;
+  REQUIRE(dyn_img.width() == 10_px);
+  REQUIRE(dyn_img.height() == 20_px);
+  REQUIRE(dyn_img == dyn_img_src);
+
+  REQUIRE(dyn_img.reallocate({20_px, 10_px, 3, 1}, sln::ImageRowAlignment{0}, {}, true));
+  dyn_img.clear();
+  REQUIRE(dyn_img.capacity_bytes() == 0);
+}
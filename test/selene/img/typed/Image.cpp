@@ -4,9 +4,18 @@
 
 #include <catch2/catch.hpp>
 
+#include <selene/base/Allocators.hpp>
+
+#include <selene/img/interop/DynImageToImage.hpp>
+#include <selene/img/interop/ImageToDynImage.hpp>
+
+#include <selene/img/pixel/PixelTypeAliases.hpp>
+
 #include <selene/img/typed/Image.hpp>
 
+#include <selene/img_ops/Allocate.hpp>
 #include <selene/img_ops/Fill.hpp>
+#include <selene/img_ops/View.hpp>
 
 //#include <test/selene/img/typed/Utils.hpp>
 
@@ -71,6 +80,43 @@ void basic_image_tests(sln::PixelLength width, sln::PixelLength height, T fill_v
   }
 }
 
+template <typename Allocator>
+void allocator_image_tests(sln::PixelLength width, sln::PixelLength height)
+{
+  using ImageType = sln::Image<std::uint16_t, Allocator>;
+  static_assert(std::is_same_v<typename ImageType::Allocator, Allocator>);
+
+  ImageType img0({width, height});
+  REQUIRE(img0.width() == width);
+  REQUIRE(img0.height() == height);
+  REQUIRE(img0.is_packed());
+  sln::fill(img0, std::uint16_t{7});
+
+  ImageType img1 = img0;
+  REQUIRE(img1 == img0);
+  REQUIRE(img1.data() != img0.data());
+
+  const auto data_1 = img1.data();
+  ImageType img2 = std::move(img1);
+  REQUIRE(img2.data() == data_1);
+  REQUIRE(img2 == img0);
+
+  img2.reallocate({sln::PixelLength{width + 3}, height}, sln::ImageRowAlignment{0});
+  REQUIRE(img2.width() == width + 3);
+  sln::fill(img2, std::uint16_t{9});
+
+  // Memory ownership transfers retain the allocator type.
+  const auto data_0 = img0.data();
+  auto dyn_img = sln::to_dyn_image(std::move(img0));
+  static_assert(std::is_same_v<decltype(dyn_img), sln::DynImageT<Allocator>>);
+  REQUIRE(dyn_img.byte_ptr() == reinterpret_cast<const std::uint8_t*>(data_0));
+
+  auto img3 = sln::to_image<std::uint16_t>(std::move(dyn_img));
+  static_assert(std::is_same_v<decltype(img3), ImageType>);
+  REQUIRE(img3.data() == data_0);
+  REQUIRE(img3(0_idx, 0_idx) == 7);
+}
+
 }  // namespace
 
 
@@ -94,3 +140,114 @@ TEST_CASE("Image construction", "[img]")
     }
   }
 }
+
+TEST_CASE("Image construction with different allocators", "[img]")
+{
+  allocator_image_tests<sln::AlignedNewAllocator>(13_px, 7_px);
+  allocator_image_tests<sln::AlignedMallocAllocator>(13_px, 7_px);
+  allocator_image_tests<sln::NewAllocator>(13_px, 7_px);
+  allocator_image_tests<sln::MallocAllocator>(13_px, 7_px);
+}
+
+TEST_CASE("Image capacity", "[img]")
+{
+  sln::Image<std::uint16_t> img({40_px, 30_px}, sln::ImageRowAlignment{16});
+  const auto data = img.byte_ptr();
+  const auto capacity = img.capacity_bytes();
+  REQUIRE(capacity == img.total_bytes());
+
+  SECTION("Layouts that fit reuse the memory")
+  {
+    REQUIRE(!img.reallocate({20_px, 10_px}, sln::ImageRowAlignment{16}));
+    REQUIRE(img.width() == 20_px);
+    REQUIRE(img.byte_ptr() == data);
+    REQUIRE(img.capacity_bytes() == capacity);
+
+    REQUIRE(!img.reallocate({40_px, 30_px}, sln::ImageRowAlignment{16}));
+    REQUIRE(img.byte_ptr() == data);
+
+    REQUIRE(img.reallocate({41_px, 30_px}, sln::ImageRowAlignment{16}));
+    REQUIRE(img.capacity_bytes() == img.total_bytes());
+  }
+
+  SECTION("Explicit shrinking")
+  {
+    REQUIRE(img.reallocate({20_px, 10_px}, sln::ImageRowAlignment{16}, true));
+    REQUIRE(img.capacity_bytes() == img.total_bytes());
+
+    REQUIRE(img.reallocate({40_px, 30_px}, sln::ImageRowAlignment{16}));
+    sln::fill(img, std::uint16_t{3});
+    REQUIRE(!img.reallocate({20_px, 10_px}, sln::ImageRowAlignment{16}));
+    sln::fill(img, std::uint16_t{5});
+
+    REQUIRE(img.shrink_to_fit());
+    REQUIRE(img.capacity_bytes() == img.total_bytes());
+    REQUIRE(img.width() == 20_px);
+    REQUIRE(img(19_idx, 9_idx) == 5);
+    REQUIRE(!img.shrink_to_fit());
+  }
+
+  SECTION("Copy assignment")
+  {
+    sln::Image<std::uint16_t> img_src({30_px, 40_px}, sln::ImageRowAlignment{0});
+    sln::fill(img_src, std::uint16_t{7});
+
+    // Same number of bytes, but a different layout.
+    img = img_src;
+    REQUIRE(img.width() == 30_px);
+    REQUIRE(img.height() == 40_px);
+    REQUIRE(img.byte_ptr() == data);
+    REQUIRE(img == img_src);
+  }
+
+  SECTION("Clearing")
+  {
+    img.clear();
+    REQUIRE(img.capacity_bytes() == 0);
+  }
+}
+
+TEST_CASE("Image tail padding", "[img]")
+{
+  constexpr std::ptrdiff_t tail_padding_bytes = 32;
+  sln::Image<sln::PixelRGB_8u> img({10_px, 5_px, sln::Stride{0}, tail_padding_bytes});
+  REQUIRE(img.layout().tail_padding_bytes == tail_padding_bytes);
+  REQUIRE(img.stride_bytes() >= img.row_bytes() + tail_padding_bytes);
+  REQUIRE(img.layout().has_valid_tail_padding<sln::PixelRGB_8u>());
+  REQUIRE(!img.is_packed());
+
+  // The padding bytes after each row (including the last one) are accessible.
+  sln::fill(img, sln::PixelRGB_8u(1, 2, 3));
+  for (auto y = 0_idx; y < img.height(); ++y)
+  {
+    std::fill(img.byte_ptr(y) + img.row_bytes(), img.byte_ptr(y) + img.row_bytes() + tail_padding_bytes,
+              std::uint8_t{0xFF});
+  }
+  REQUIRE(img(9_idx, 4_idx) == sln::PixelRGB_8u(1, 2, 3));
+
+  // The guarantee propagates to views and copies.
+  REQUIRE(img.view().layout().tail_padding_bytes == tail_padding_bytes);
+  REQUIRE(img.constant_view().layout().tail_padding_bytes == tail_padding_bytes);
+  const auto sub_view = sln::view(img, {2_idx, 1_idx, 5_px, 3_px});
+  REQUIRE(sub_view.layout().tail_padding_bytes == tail_padding_bytes);
+  REQUIRE(sub_view.layout().has_valid_tail_padding<sln::PixelRGB_8u>());
+
+  const sln::Image<sln::PixelRGB_8u> img_copy = img;
+  REQUIRE(img_copy.layout().tail_padding_bytes == tail_padding_bytes);
+  REQUIRE(img_copy.stride_bytes() >= img_copy.row_bytes() + tail_padding_bytes);
+
+  const sln::Image<sln::PixelRGB_8u> img_sub_copy(sub_view);
+  REQUIRE(img_sub_copy.layout().tail_padding_bytes == tail_padding_bytes);
+  REQUIRE(img_sub_copy.stride_bytes() >= img_sub_copy.row_bytes() + tail_padding_bytes);
+
+  // Reallocation honors the tail padding of the new layout.
+  img.reallocate({100_px, 5_px, sln::Stride{0}, 64}, sln::ImageRowAlignment{16});
+  REQUIRE(img.layout().tail_padding_bytes == 64);
+  REQUIRE(img.stride_bytes() >= 300 + 64);
+  REQUIRE(img.stride_bytes() % 16 == 0);
+
+  sln::Image<sln::PixelRGB_8u> img_dst;
+  sln::allocate(img_dst, img.layout());
+  REQUIRE(img_dst.layout().tail_padding_bytes == 64);
+  REQUIRE(img_dst.stride_bytes() >= 300 + 64);
+}
@@ -0,0 +1,165 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch2/catch.hpp>
+
+#include <selene/base/ThreadPool.hpp>
+
+#include <selene/img/pixel/PixelTypeAliases.hpp>
+#include <selene/img/typed/SharedImage.hpp>
+
+#include <selene/img_ops/Clone.hpp>
+#include <selene/img_ops/Fill.hpp>
+
+#include <atomic>
+#include <type_traits>
+#include <vector>
+
+using namespace sln::literals;
+
+TEST_CASE("Shared image construction and copying", "[img]")
+{
+  sln::SharedImage<sln::PixelRGB_8u> empty_img;
+  REQUIRE(!empty_img.is_valid());
+  REQUIRE(empty_img.use_count() == 0);
+  REQUIRE(empty_img.is_unique());
+
+  sln::Image<sln::PixelRGB_8u> img({40_px, 30_px});
+  sln::fill(img, sln::PixelRGB_8u(10, 20, 30));
+  const auto img_data = img.byte_ptr();
+
+  // Taking over an image does not copy its data.
+  sln::SharedImage<sln::PixelRGB_8u> shared_img(std::move(img));
+  REQUIRE(shared_img.is_valid());
+  REQUIRE(shared_img.width() == 40_px);
+  REQUIRE(shared_img.height() == 30_px);
+  REQUIRE(shared_img.view().byte_ptr() == img_data);
+  REQUIRE(shared_img.is_unique());
+  REQUIRE(shared_img.use_count() == 1);
+
+  SECTION("Copies share the data")
+  {
+    auto shared_img_2 = shared_img;
+    REQUIRE(shared_img_2.view().byte_ptr() == img_data);
+    REQUIRE(shared_img.use_count() == 2);
+    REQUIRE(!shared_img.is_unique());
+
+    {
+      auto shared_img_3 = shared_img_2;
+      REQUIRE(shared_img.use_count() == 3);
+    }
+
+    REQUIRE(shared_img.use_count() == 2);
+
+    shared_img_2.clear();
+    REQUIRE(!shared_img_2.is_valid());
+    REQUIRE(shared_img.is_unique());
+  }
+
+  SECTION("Mutable access copies shared data only")
+  {
+    // The data is not shared: no copy.
+    auto view = shared_img.mutable_view();
+    REQUIRE(view.byte_ptr() == img_data);
+
+    auto shared_img_2 = shared_img;
+    auto view_2 = shared_img_2.mutable_view();
+    REQUIRE(view_2.byte_ptr() != img_data);
+    REQUIRE(shared_img.is_unique());
+    REQUIRE(shared_img_2.is_unique());
+
+    sln::fill(view_2, sln::PixelRGB_8u(1, 2, 3));
+    REQUIRE(shared_img(5_idx, 5_idx) == sln::PixelRGB_8u(10, 20, 30));
+    REQUIRE(shared_img_2(5_idx, 5_idx) == sln::PixelRGB_8u(1, 2, 3));
+
+    // Subsequent mutable access does not copy again.
+    REQUIRE(shared_img_2.mutable_view().byte_ptr() == view_2.byte_ptr());
+  }
+
+  SECTION("Sub-images keep the buffer alive")
+  {
+    auto sub_img = shared_img.sub_image(sln::BoundingBox(10_idx, 5_idx, 20_px, 10_px));
+    REQUIRE(sub_img.width() == 20_px);
+    REQUIRE(sub_img.height() == 10_px);
+    REQUIRE(sub_img.view().byte_ptr() == img_data + 5 * shared_img.stride_bytes() + 10 * 3);
+    REQUIRE(shared_img.use_count() == 2);
+
+    shared_img = sln::SharedImage<sln::PixelRGB_8u>();
+    REQUIRE(sub_img.is_unique());
+    REQUIRE(sub_img(19_idx, 9_idx) == sln::PixelRGB_8u(10, 20, 30));
+
+    // A unique sub-image is modified in place.
+    auto sub_view = sub_img.mutable_view();
+    sln::fill(sub_view, sln::PixelRGB_8u(4, 5, 6));
+    REQUIRE(sub_img.view().byte_ptr() == img_data + 5 * sub_img.stride_bytes() + 10 * 3);
+
+    // A shared sub-image is copied to a new, packed buffer.
+    auto sub_img_2 = sub_img;
+    sub_img_2.make_unique();
+    REQUIRE(sub_img_2.view().byte_ptr() != sub_img.view().byte_ptr());
+    REQUIRE(sub_img_2.width() == 20_px);
+    REQUIRE(sub_img_2.is_packed());
+    REQUIRE(sln::equal(sub_img_2.view(), sub_img.view()));
+  }
+}
+
+TEST_CASE("Shared image views", "[img]")
+{
+  sln::SharedImage<sln::Pixel_8u1> shared_img({32_px, 16_px});
+  auto shared_img_view = shared_img.mutable_view();
+  sln::fill(shared_img_view, std::uint8_t{5});
+
+  auto view = shared_img.shared_view();
+  static_assert(std::is_base_of_v<sln::ImageBase<decltype(view)>, decltype(view)>);
+  REQUIRE(view.width() == 32_px);
+  REQUIRE(view.byte_ptr() == shared_img.view().byte_ptr());
+  REQUIRE(shared_img.use_count() == 2);
+
+  // Mutable access to the instance does not modify the data seen through the view.
+  auto shared_img_view_2 = shared_img.mutable_view();
+  REQUIRE(shared_img_view_2.byte_ptr() != view.byte_ptr());
+  sln::fill(shared_img_view_2, std::uint8_t{6});
+  REQUIRE(view(31_idx, 15_idx) == 5);
+  REQUIRE(shared_img(31_idx, 15_idx) == 6);
+
+  // The view keeps the data alive, and can be used in image operations.
+  shared_img.clear();
+  const auto img_clone = sln::clone(view);
+  REQUIRE(img_clone.width() == 32_px);
+  REQUIRE(img_clone(31_idx, 15_idx) == 5);
+
+  view.clear();
+  REQUIRE(!view.is_valid());
+}
+
+TEST_CASE("Shared images across threads", "[img]")
+{
+  sln::SharedImage<sln::Pixel_8u1> frame({64_px, 48_px});
+  auto frame_view = frame.mutable_view();
+  sln::fill(frame_view, std::uint8_t{7});
+
+  sln::ThreadPool thread_pool(4);
+  std::atomic<bool> all_valid{true};
+  std::vector<sln::SharedImage<sln::Pixel_8u1>> consumers(16, frame);
+  REQUIRE(frame.use_count() == 17);
+
+  thread_pool.run(consumers.size(), [&consumers, &all_valid](std::size_t task) {
+    auto& img = consumers[task];
+    if (img(63_idx, 47_idx) != 7)
+    {
+      all_valid = false;
+    }
+
+    auto view = img.mutable_view();
+    sln::fill(view, static_cast<std::uint8_t>(task));
+    if (img(63_idx, 47_idx) != static_cast<std::uint8_t>(task))
+    {
+      all_valid = false;
+    }
+  });
+
+  REQUIRE(all_valid);
+  REQUIRE(frame(0_idx, 0_idx) == 7);
+  REQUIRE(frame.use_count() == 1);
+}
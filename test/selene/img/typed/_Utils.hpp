@@ -67,16 +67,15 @@ PixelType construct_random_pixel(RNG& rng, Distribution& dist)
   return px;
 }
 
-template <typename PixelType, typename RNG>
-sln::Image<PixelType> construct_random_image(sln::PixelLength width, sln::PixelLength height, RNG& rng)
+template <typename PixelType, typename RNG, typename Distribution>
+sln::Image<PixelType> construct_random_image(sln::PixelLength width,
+                                             sln::PixelLength height,
+                                             RNG& rng,
+                                             Distribution dist)
 {
   using namespace sln::literals;
   using Element = typename sln::PixelTraits<PixelType>::Element;
 
-  constexpr auto is_int = sln::PixelTraits<PixelType>::is_integral;
-  auto dist = sln_test::uniform_distribution<Element>(Element{0},
-                                                      is_int ? std::numeric_limits<Element>::max() : Element{1});
-
   std::uniform_int_distribution<std::uint16_t> die_stride(0, 16);
   const auto extra_stride_bytes = std::ptrdiff_t(die_stride(rng) * sizeof(Element));
   const auto stride_bytes = sln::Stride(width * sln::PixelTraits<PixelType>::nr_bytes + extra_stride_bytes);
@@ -94,6 +93,17 @@ sln::Image<PixelType> construct_random_image(sln::PixelLength width, sln::PixelL
   return img;
 }
 
+template <typename PixelType, typename RNG>
+sln::Image<PixelType> construct_random_image(sln::PixelLength width, sln::PixelLength height, RNG& rng)
+{
+  using Element = typename sln::PixelTraits<PixelType>::Element;
+
+  constexpr auto is_int = sln::PixelTraits<PixelType>::is_integral;
+  auto dist = sln_test::uniform_distribution<Element>(Element{0},
+                                                      is_int ? std::numeric_limits<Element>::max() : Element{1});
+  return construct_random_image<PixelType>(width, height, rng, dist);
+}
+
 }  // namespace sln_test
 
 #endif  // SELENE_TEST_IMG_TYPED_UTILS_HPP
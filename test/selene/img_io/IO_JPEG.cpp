@@ -459,7 +459,8 @@ TEST_CASE("JPEG image reading, through JPEGReader interface", "[img]")
     const auto info = jpeg_reader.get_output_image_info();
     REQUIRE(info.is_valid());
 
-    sln::DynImage dyn_img({sln::PixelLength{info.width + 1}, info.height, info.nr_channels, info.nr_bytes_per_channel()});
+    sln::DynImage dyn_img(
+        {sln::PixelLength{info.width + 1}, info.height, info.nr_channels, info.nr_bytes_per_channel()});
     sln::MutableDynImageView dyn_img_view{dyn_img.byte_ptr(), dyn_img.layout(), dyn_img.semantics()};
     auto res = jpeg_reader.read_image_data(dyn_img_view);
     REQUIRE(!res);
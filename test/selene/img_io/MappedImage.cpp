@@ -0,0 +1,141 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch2/catch.hpp>
+
+#include <selene/base/io/FileUtils.hpp>
+#include <selene/base/io/MemoryMappedFile.hpp>
+
+#include <selene/img/pixel/PixelTypeAliases.hpp>
+
+#include <selene/img_io/MappedImage.hpp>
+
+#include <selene/img_ops/Fill.hpp>
+
+#include <test/selene/Utils.hpp>
+
+#include <cstdint>
+#include <vector>
+
+using namespace sln::literals;
+
+namespace {
+
+constexpr std::ptrdiff_t header_bytes = 64;
+constexpr auto width = 50;
+constexpr auto height = 40;
+constexpr std::ptrdiff_t stride_bytes = 160;
+
+std::uint8_t test_value(std::ptrdiff_t x, std::ptrdiff_t y, std::ptrdiff_t c)
+{
+  return static_cast<std::uint8_t>(x + 2 * y + 3 * c);
+}
+
+sln_fs::path write_test_file()
+{
+  // A raw file with a header, followed by RGB image data with padded rows.
+  std::vector<std::uint8_t> data(header_bytes + stride_bytes * height, std::uint8_t{0xFF});
+  for (std::ptrdiff_t y = 0; y < height; ++y)
+  {
+    for (std::ptrdiff_t x = 0; x < width; ++x)
+    {
+      for (std::ptrdiff_t c = 0; c < 3; ++c)
+      {
+        data[static_cast<std::size_t>(header_bytes + y * stride_bytes + x * 3 + c)] = test_value(x, y, c);
+      }
+    }
+  }
+
+  const auto filename = sln_test::get_tmp_path() / "test_mapped_image.raw";
+  sln::write_data_contents(filename.string(), data);
+  return filename;
+}
+
+}  // namespace
+
+TEST_CASE("Memory-mapped image views", "[img]")
+{
+  const auto filename = write_test_file();
+  const auto layout = sln::TypedLayout{sln::to_pixel_length(width), sln::to_pixel_length(height),
+                                       sln::Stride{stride_bytes}};
+
+  SECTION("Typed view")
+  {
+    sln::MemoryMappedFile file(filename.string());
+    const auto view = sln::mapped_image_view<sln::PixelRGB_8u>(file, layout, header_bytes);
+    REQUIRE(view.width() == width);
+    REQUIRE(view.height() == height);
+    REQUIRE(view.stride_bytes() == stride_bytes);
+
+    for (auto y = 0_idx; y < view.height(); ++y)
+    {
+      for (auto x = 0_idx; x < view.width(); ++x)
+      {
+        REQUIRE(view(x, y) == sln::PixelRGB_8u(test_value(x, y, 0), test_value(x, y, 1), test_value(x, y, 2)));
+      }
+    }
+
+    REQUIRE_THROWS(sln::mutable_mapped_image_view<sln::PixelRGB_8u>(file, layout, header_bytes));
+  }
+
+  SECTION("Dynamic view")
+  {
+    sln::MemoryMappedFile file(filename.string());
+    const auto dyn_layout = sln::UntypedLayout{sln::to_pixel_length(width), sln::to_pixel_length(height), 3, 1,
+                                               sln::Stride{stride_bytes}};
+    const auto semantics = sln::UntypedImageSemantics{sln::PixelFormat::RGB, sln::SampleFormat::UnsignedInteger};
+    const auto view = sln::mapped_dyn_image_view(file, dyn_layout, semantics, header_bytes);
+    REQUIRE(view.width() == width);
+    REQUIRE(view.nr_channels() == 3);
+    REQUIRE(view.pixel_format() == sln::PixelFormat::RGB);
+    REQUIRE(view.pixel<sln::PixelRGB_8u>(7_idx, 5_idx)
+            == sln::PixelRGB_8u(test_value(7, 5, 0), test_value(7, 5, 1), test_value(7, 5, 2)));
+  }
+
+  SECTION("Copy-on-write view")
+  {
+    {
+      sln::MemoryMappedFile file(filename.string(), sln::MappingMode::CopyOnWrite);
+      auto view = sln::mutable_mapped_image_view<sln::PixelRGB_8u>(file, layout, header_bytes);
+      sln::fill(view, sln::PixelRGB_8u(0, 0, 0));
+      REQUIRE(view(10_idx, 10_idx) == sln::PixelRGB_8u(0, 0, 0));
+    }
+
+    sln::MemoryMappedFile file(filename.string());
+    const auto view = sln::mapped_image_view<sln::PixelRGB_8u>(file, layout, header_bytes);
+    REQUIRE(view(10_idx, 10_idx) == sln::PixelRGB_8u(test_value(10, 10, 0), test_value(10, 10, 1),
+                                                      test_value(10, 10, 2)));
+  }
+
+  SECTION("Read-write view")
+  {
+    {
+      sln::MemoryMappedFile file(filename.string(), sln::MappingMode::ReadWrite);
+      auto dyn_view = sln::mutable_mapped_dyn_image_view(
+          file, {sln::to_pixel_length(width), sln::to_pixel_length(height), 3, 1, sln::Stride{stride_bytes}}, {},
+          header_bytes);
+      dyn_view.pixel<sln::PixelRGB_8u>(3_idx, 4_idx) = sln::PixelRGB_8u(1, 2, 3);
+    }
+
+    sln::MemoryMappedFile file(filename.string());
+    const auto view = sln::mapped_image_view<sln::PixelRGB_8u>(file, layout, header_bytes);
+    REQUIRE(view(3_idx, 4_idx) == sln::PixelRGB_8u(1, 2, 3));
+  }
+
+  SECTION("Errors")
+  {
+    sln::MemoryMappedFile file;
+    REQUIRE_THROWS(sln::mapped_image_view<sln::PixelRGB_8u>(file, layout));
+
+    file.open(filename.string());
+    // Packed rows do not exceed the file...
+    REQUIRE_NOTHROW(sln::mapped_image_view<sln::PixelRGB_8u>(file, {layout.width, layout.height}, header_bytes));
+    // ...but the last padded row does, with an additional offset.
+    REQUIRE_THROWS(sln::mapped_image_view<sln::PixelRGB_8u>(file, layout, header_bytes + stride_bytes));
+    REQUIRE_THROWS(sln::mapped_image_view<sln::PixelRGB_8u>(file, layout, -1));
+    // Misaligned 16-bit elements.
+    REQUIRE_THROWS(sln::mapped_image_view<sln::Pixel_16u1>(file, {10_px, 10_px}, 1));
+    REQUIRE_NOTHROW(sln::mapped_image_view<sln::Pixel_16u1>(file, {10_px, 10_px}, 2));
+  }
+}
@@ -4,14 +4,22 @@
 
 #include <catch2/catch.hpp>
 
+#include <cstdint>
+#include <cstdlib>
+
 #include <selene/img_ops/Algorithms.hpp>
 
+#include <selene/base/ExecutionPolicy.hpp>
+#include <selene/base/ThreadPool.hpp>
+
 #include <selene/img/pixel/PixelTypeAliases.hpp>
 
 #include <selene/img/typed/Image.hpp>
 #include <selene/img/typed/ImageTypeAliases.hpp>
 
+#include <selene/img_ops/Clone.hpp>
 #include <selene/img_ops/Fill.hpp>
+#include <selene/img_ops/View.hpp>
 
 using namespace sln::literals;
 
@@ -47,3 +55,159 @@ TEST_CASE("Image algorithms", "[img]")
     }
   }
 }
+
+namespace {
+
+template <typename ExecutionPolicy>
+void test_algorithms_with_policy(ExecutionPolicy&& policy)
+{
+  // Odd size, to exercise uneven splitting into row bands.
+  sln::Image_8u1 img({sln::PixelLength{37}, sln::PixelLength{1031}});
+
+  for (auto y = 0_idx; y < img.height(); ++y)
+  {
+    for (auto x = 0_idx; x < img.width(); ++x)
+    {
+      img(x, y) = static_cast<std::uint8_t>((x + 3 * y) % 256);
+    }
+  }
+
+  auto img_inc = sln::clone(img);
+  sln::for_each_pixel(policy, img_inc, [](auto& px) { px += 1; });
+
+  sln::Image_32u1 img_dst;
+  sln::transform_pixels(policy, img, img_dst, [](const auto& px) { return sln::Pixel_32u1{px * 2u}; });
+
+  const auto img_dst2 = sln::transform_pixels<sln::Pixel_32f1>(
+      policy, img, [](const auto& px) { return sln::Pixel_32f1{static_cast<float>(px) * 0.5f}; });
+
+  REQUIRE(img_dst.width() == img.width());
+  REQUIRE(img_dst.height() == img.height());
+  REQUIRE(img_dst2.width() == img.width());
+  REQUIRE(img_dst2.height() == img.height());
+
+  for (auto y = 0_idx; y < img.height(); ++y)
+  {
+    for (auto x = 0_idx; x < img.width(); ++x)
+    {
+      REQUIRE(img_inc(x, y) == static_cast<std::uint8_t>(img(x, y) + 1));
+      REQUIRE(img_dst(x, y) == 2u * img(x, y));
+      REQUIRE(img_dst2(x, y) == static_cast<float>(img(x, y)) * 0.5f);
+    }
+  }
+}
+
+}  // namespace
+
+TEST_CASE("Image algorithms with execution policies", "[img]")
+{
+  sln::ThreadPool pool(4);
+
+  test_algorithms_with_policy(sln::execution::seq);
+  test_algorithms_with_policy(sln::execution::par);
+  test_algorithms_with_policy(sln::execution::par_unseq);
+  test_algorithms_with_policy(sln::execution::par.on(pool));
+  test_algorithms_with_policy(sln::execution::par_unseq.on(pool));
+  test_algorithms_with_policy(pool);
+}
+
+TEST_CASE("N-ary image transformations", "[img]")
+{
+  const auto w = sln::PixelLength{29};
+  const auto h = sln::PixelLength{613};
+
+  sln::Image_8u1 img_a({w, h});
+  sln::Image_8u1 img_b({w, h});
+  sln::Image_32f1 img_c({w, h});
+
+  for (auto y = 0_idx; y < h; ++y)
+  {
+    for (auto x = 0_idx; x < w; ++x)
+    {
+      img_a(x, y) = static_cast<std::uint8_t>((x + 7 * y) % 256);
+      img_b(x, y) = static_cast<std::uint8_t>((5 * x + y) % 256);
+      img_c(x, y) = static_cast<float>(x) - static_cast<float>(y);
+    }
+  }
+
+  const auto abs_diff = [](const auto& a, const auto& b) {
+    return sln::Pixel_8u1{static_cast<std::uint8_t>((a > b) ? a - b : b - a)};
+  };
+  const auto weighted_sum = [](const auto& a, const auto& b, const auto& c) {
+    return sln::Pixel_32f1{0.5f * static_cast<float>(a) + 0.25f * static_cast<float>(b) - c};
+  };
+
+  const auto check_diff = [&](const sln::Image_8u1& img_diff) {
+    REQUIRE(img_diff.width() == w);
+    REQUIRE(img_diff.height() == h);
+    for (auto y = 0_idx; y < h; ++y)
+    {
+      for (auto x = 0_idx; x < w; ++x)
+      {
+        const auto a = static_cast<int>(img_a(x, y));
+        const auto b = static_cast<int>(img_b(x, y));
+        REQUIRE(img_diff(x, y) == std::abs(a - b));
+      }
+    }
+  };
+
+  const auto check_sum = [&](const sln::Image_32f1& img_sum) {
+    REQUIRE(img_sum.width() == w);
+    REQUIRE(img_sum.height() == h);
+    for (auto y = 0_idx; y < h; ++y)
+    {
+      for (auto x = 0_idx; x < w; ++x)
+      {
+        const auto expected = 0.5f * static_cast<float>(img_a(x, y)) + 0.25f * static_cast<float>(img_b(x, y))
+                              - img_c(x, y);
+        REQUIRE(img_sum(x, y) == expected);
+      }
+    }
+  };
+
+  SECTION("Binary and ternary operations")
+  {
+    sln::Image_8u1 img_diff;
+    sln::transform_pixels(abs_diff, img_diff, img_a, img_b);
+    check_diff(img_diff);
+
+    sln::Image_32f1 img_sum;
+    sln::transform_pixels(weighted_sum, img_sum, img_a, img_b, img_c);
+    check_sum(img_sum);
+  }
+
+  SECTION("Operations with execution policies")
+  {
+    sln::ThreadPool pool(3);
+
+    sln::Image_8u1 img_diff;
+    sln::transform_pixels(sln::execution::par_unseq, abs_diff, img_diff, img_a, img_b);
+    check_diff(img_diff);
+
+    sln::Image_32f1 img_sum;
+    sln::transform_pixels(pool, weighted_sum, img_sum, img_a, img_b, img_c);
+    check_sum(img_sum);
+  }
+
+  SECTION("In-place operation and views")
+  {
+    auto img_diff = sln::clone(img_a);
+    sln::transform_pixels(abs_diff, img_diff, img_diff, img_b);
+    check_diff(img_diff);
+
+    const auto bbox = sln::BoundingBox(3_idx, 5_idx, 10_px, 20_px);
+    sln::Image_8u1 img_diff_region;
+    sln::transform_pixels(abs_diff, img_diff_region, sln::view(img_a, bbox), sln::view(img_b, bbox));
+    REQUIRE(img_diff_region.width() == 10_px);
+    REQUIRE(img_diff_region.height() == 20_px);
+    REQUIRE(img_diff_region(0_idx, 0_idx) == img_diff(3_idx, 5_idx));
+    REQUIRE(img_diff_region(9_idx, 19_idx) == img_diff(12_idx, 24_idx));
+  }
+
+  SECTION("Size mismatch")
+  {
+    sln::Image_8u1 img_small({w, sln::PixelLength{h - 1}});
+    sln::Image_8u1 img_diff;
+    REQUIRE_THROWS(sln::transform_pixels(abs_diff, img_diff, img_a, img_small));
+  }
+}
@@ -4,6 +4,127 @@
 
 #include <catch2/catch.hpp>
 
+#include <selene/img/common/StridePadding.hpp>
+
+#include <selene/img/pixel/PixelTypeAliases.hpp>
+
+#include <selene/img/typed/Image.hpp>
+
+#include <selene/img_ops/Algorithms.hpp>
 #include <selene/img_ops/Allocate.hpp>
+#include <selene/img_ops/Blending.hpp>
+#include <selene/img_ops/Clone.hpp>
+#include <selene/img_ops/Convolution.hpp>
+#include <selene/img_ops/Fill.hpp>
+#include <selene/img_ops/Morphology.hpp>
+#include <selene/img_ops/View.hpp>
+
+using namespace sln::literals;
+
+TEST_CASE("Image allocation", "[img]")
+{
+  sln::Image<sln::Pixel_8u4> img;
+  REQUIRE(sln::allocate(img, {1024_px, 16_px}));
+  REQUIRE(img.width() == 1024_px);
+  REQUIRE(img.height() == 16_px);
+  REQUIRE(img.stride_bytes() == 4096);
+
+  // Same size: no reallocation.
+  REQUIRE(!sln::allocate(img, {1024_px, 16_px}));
+
+  // Smaller size: the memory is reused.
+  const auto data = img.byte_ptr();
+  REQUIRE(!sln::allocate(img, {512_px, 16_px}));
+  REQUIRE(img.byte_ptr() == data);
+  REQUIRE(img.width() == 512_px);
+
+  sln::MutableImageView<sln::Pixel_8u4> img_view(img.byte_ptr(), img.layout());
+  REQUIRE(!sln::allocate(img_view, {512_px, 16_px}));
+  REQUIRE_THROWS(sln::allocate(img_view, {1024_px, 16_px}));
+}
+
+TEST_CASE("Image allocation with tail padding", "[img]")
+{
+  sln::Image<sln::Pixel_8u4> img;
+  sln::allocate(img, {100_px, 16_px});
+  REQUIRE(img.layout().tail_padding_bytes == 0);
+
+  // Same size, but with tail padding: the stride has to leave room for the padding.
+  sln::allocate(img, {100_px, 16_px, sln::Stride{0}, 64});
+  REQUIRE(img.width() == 100_px);
+  REQUIRE(img.stride_bytes() >= 400 + 64);
+
+  // Now, the same layout is satisfied without reallocation.
+  const auto data = img.byte_ptr();
+  REQUIRE(!sln::allocate(img, {100_px, 16_px, sln::Stride{0}, 64}));
+  REQUIRE(!sln::allocate(img, {100_px, 16_px, sln::Stride{0}, 32}));
+  REQUIRE(img.byte_ptr() == data);
+
+  // A view cannot provide more tail padding than it has.
+  sln::MutableImageView<sln::Pixel_8u4> img_view(img.byte_ptr(), img.layout());
+  REQUIRE(!sln::allocate(img_view, {100_px, 16_px, sln::Stride{0}, 64}));
+  REQUIRE_THROWS(sln::allocate(img_view, {100_px, 16_px, sln::Stride{0}, 1024}));
+}
+
+TEST_CASE("Image allocation into views", "[img]")
+{
+  // A packed destination view is large enough for a sub-view of a larger image, despite the smaller stride.
+  sln::Image<sln::Pixel_8u1> img_big({64_px, 64_px});
+  sln::fill(img_big, std::uint8_t{42});
+  sln::Image<sln::Pixel_8u1> img_packed({16_px, 16_px}, sln::ImageRowAlignment{1});
+  sln::MutableImageView<sln::Pixel_8u1> img_dst_view(img_packed.byte_ptr(), img_packed.layout());
+  REQUIRE(img_dst_view.stride_bytes() == 16);
+
+  const auto img_src_view = sln::view(img_big, {8_idx, 8_idx, 16_px, 16_px});
+  REQUIRE(!sln::allocate(img_dst_view, img_src_view.layout()));
+  sln::clone(img_src_view, img_dst_view);
+  REQUIRE(img_packed(15_idx, 15_idx) == 42);
+}
+
+TEST_CASE("Image allocation with stride padding", "[img]")
+{
+  sln::StridePaddingPolicyScope scope(sln::avoid_cache_set_aliasing(4096, 64));
+
+  sln::Image<sln::Pixel_8u4> img;
+  sln::allocate(img, {1024_px, 16_px});
+  REQUIRE(img.width() == 1024_px);
+  REQUIRE(img.stride_bytes() % 4096 != 0);
+  REQUIRE(img.stride_bytes() >= 4096 + 64);
+
+  // Strides that only become critical by rounding to the row alignment are padded as well.
+  sln::Image<sln::Pixel_8u4> img_2;
+  sln::allocate(img_2, {1000_px, 16_px});
+  REQUIRE(img_2.stride_bytes() >= 4000);
+  REQUIRE(img_2.stride_bytes() % 4096 != 0);
+
+  sln::Image<sln::Pixel_8u4> img_3;
+  sln::allocate(img_3, {500_px, 16_px});
+  REQUIRE(img_3.stride_bytes() == 2048);
+
+  // Images of the same size keep their memory, even if their stride is critical.
+  sln::Image<sln::Pixel_8u4> img_4;
+  {
+    sln::StridePaddingPolicyScope no_padding_scope(sln::no_stride_padding());
+    img_4 = sln::Image<sln::Pixel_8u4>({1024_px, 4_px});
+  }
+  REQUIRE(img_4.stride_bytes() == 4096);
+  REQUIRE(!sln::allocate(img_4, {1024_px, 4_px}));
+  REQUIRE(img_4.stride_bytes() == 4096);
+
+  // In particular, in-place operations keep their source data.
+  sln::fill(img_4, sln::Pixel_8u4(200, 100, 50, 255));
+  sln::premultiply_alpha(img_4);
+  REQUIRE(img_4(1023_idx, 3_idx) == sln::Pixel_8u4(200, 100, 50, 255));
+  sln::transform_pixels(img_4, img_4, [](const sln::Pixel_8u4& px) { return sln::Pixel_8u4(px[0], px[1], 7, px[3]); });
+  REQUIRE(img_4(0_idx, 0_idx) == sln::Pixel_8u4(200, 100, 7, 255));
+  sln::Image<sln::Pixel_8u4> img_4_eroded;
+  sln::erode(img_4, img_4_eroded, 3_px, 3_px);
+  sln::erode(img_4, img_4, 3_px, 3_px);
+  REQUIRE(img_4 == img_4_eroded);
 
-// TODO: write test case(s)
+  // Outputs of image operations are padded as well.
+  const auto kernel = sln::gaussian_kernel<3, double>(1.0);
+  const auto img_conv = sln::convolution_y<sln::BorderAccessMode::Replicated>(img, kernel);
+  REQUIRE(img_conv.width() == 1024_px);
+  REQUIRE(img_conv.stride_bytes() % 4096 != 0);
+}
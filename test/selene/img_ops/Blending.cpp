@@ -0,0 +1,170 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch2/catch.hpp>
+
+#include <selene/img_ops/Blending.hpp>
+
+#include <selene/img/pixel/PixelTypeAliases.hpp>
+
+#include <selene/img/typed/Image.hpp>
+#include <selene/img/typed/ImageTypeAliases.hpp>
+
+#include <selene/img_ops/Fill.hpp>
+
+#include <cmath>
+
+using namespace sln::literals;
+
+TEST_CASE("Alpha premultiplication", "[img]")
+{
+  SECTION("8-bit, exhaustive")
+  {
+    sln::Image_8u4 img({256_px, 256_px});
+    for (auto y = 0_idx; y < img.height(); ++y)
+    {
+      for (auto x = 0_idx; x < img.width(); ++x)
+      {
+        const auto c = static_cast<std::uint8_t>(x);
+        img(x, y) = sln::Pixel_8u4(c, c, std::uint8_t(255 - c), static_cast<std::uint8_t>(y));
+      }
+    }
+
+    sln::Image_8u4 img_pre;
+    sln::premultiply_alpha(img, img_pre);
+
+    for (auto y = 0_idx; y < img.height(); ++y)
+    {
+      for (auto x = 0_idx; x < img.width(); ++x)
+      {
+        const auto a = int(y);
+        REQUIRE(img_pre(x, y)[3] == a);
+        for (std::size_t c = 0; c < 3; ++c)
+        {
+          const auto expected = static_cast<int>(std::lround(double(img(x, y)[c]) * a / 255.0));
+          REQUIRE(int(img_pre(x, y)[c]) == expected);
+        }
+      }
+    }
+
+    // Unpremultiplication needs to be exact for all valid premultiplied values (c <= a)
+    sln::Image_8u4 img_valid({256_px, 256_px});
+    for (auto y = 0_idx; y < img_valid.height(); ++y)
+    {
+      for (auto x = 0_idx; x < img_valid.width(); ++x)
+      {
+        const auto c = static_cast<std::uint8_t>(std::min(int(x), int(y)));
+        img_valid(x, y) = sln::Pixel_8u4(c, c, c, static_cast<std::uint8_t>(y));
+      }
+    }
+
+    sln::unpremultiply_alpha(img_valid);
+
+    for (auto y = 0_idx; y < img_valid.height(); ++y)
+    {
+      for (auto x = 0_idx; x < img_valid.width(); ++x)
+      {
+        const auto a = int(y);
+        const auto c = std::min(int(x), a);
+        const auto expected = (a == 0) ? 0 : static_cast<int>(std::floor(double(c) * 255.0 / a + 0.5));
+        REQUIRE(int(img_valid(x, y)[0]) == expected);
+        REQUIRE(int(img_valid(x, y)[3]) == a);
+      }
+    }
+  }
+
+  SECTION("8-bit, ARGB")
+  {
+    sln::ImageARGB_8u img({2_px, 1_px});
+    img(0_idx, 0_idx) = sln::PixelARGB_8u(128, 255, 100, 0);
+    img(1_idx, 0_idx) = sln::PixelARGB_8u(0, 255, 100, 0);
+    sln::premultiply_alpha(img);
+    REQUIRE(img(0_idx, 0_idx) == sln::PixelARGB_8u(128, 128, 50, 0));
+    REQUIRE(img(1_idx, 0_idx) == sln::PixelARGB_8u(0, 0, 0, 0));
+  }
+
+  SECTION("Floating point")
+  {
+    sln::Image<sln::Pixel_32f4> img({3_px, 2_px});
+    sln::fill(img, sln::Pixel_32f4(0.5f, 1.0f, 0.2f, 0.5f));
+    sln::premultiply_alpha(img);
+    REQUIRE(img(2_idx, 1_idx)[0] == Approx(0.25f));
+    REQUIRE(img(2_idx, 1_idx)[1] == Approx(0.5f));
+    REQUIRE(img(2_idx, 1_idx)[2] == Approx(0.1f));
+    REQUIRE(img(2_idx, 1_idx)[3] == Approx(0.5f));
+    sln::unpremultiply_alpha(img);
+    REQUIRE(img(1_idx, 0_idx)[0] == Approx(0.5f));
+    REQUIRE(img(1_idx, 0_idx)[1] == Approx(1.0f));
+    REQUIRE(img(1_idx, 0_idx)[2] == Approx(0.2f));
+    REQUIRE(img(1_idx, 0_idx)[3] == Approx(0.5f));
+  }
+}
+
+TEST_CASE("Alpha blending", "[img]")
+{
+  sln::Image_8u4 img_src({4_px, 3_px});
+  sln::Image_8u4 img_dst({4_px, 3_px});
+  sln::fill(img_src, sln::Pixel_8u4(100, 50, 0, 128));
+  sln::fill(img_dst, sln::Pixel_8u4(20, 200, 255, 255));
+
+  SECTION("Over")
+  {
+    sln::blend<sln::BlendMode::Over>(img_src, img_dst);
+    // s + d * (255 - sa) / 255 = s + d * 127 / 255
+    REQUIRE(img_dst(3_idx, 2_idx) == sln::Pixel_8u4(110, 150, 127, 255));
+
+    // Fully opaque source replaces destination; fully transparent source leaves it unchanged
+    sln::fill(img_src, sln::Pixel_8u4(1, 2, 3, 255));
+    sln::blend<sln::BlendMode::Over>(img_src, img_dst);
+    REQUIRE(img_dst(0_idx, 0_idx) == sln::Pixel_8u4(1, 2, 3, 255));
+    sln::fill(img_src, sln::Pixel_8u4(0, 0, 0, 0));
+    sln::blend<sln::BlendMode::Over>(img_src, img_dst);
+    REQUIRE(img_dst(0_idx, 0_idx) == sln::Pixel_8u4(1, 2, 3, 255));
+  }
+
+  SECTION("Add")
+  {
+    sln::blend<sln::BlendMode::Add>(img_src, img_dst);
+    REQUIRE(img_dst(1_idx, 1_idx) == sln::Pixel_8u4(120, 250, 255, 255));
+  }
+
+  SECTION("Multiply")
+  {
+    sln::blend<sln::BlendMode::Multiply>(img_src, img_dst);
+    // s * d / 255 + s * (255 - da) / 255 + d * (255 - sa) / 255
+    REQUIRE(img_dst(1_idx, 1_idx) == sln::Pixel_8u4(18, 139, 127, 255));
+  }
+
+  SECTION("Destination region")
+  {
+    sln::Image_8u4 img_small({2_px, 2_px});
+    sln::fill(img_small, sln::Pixel_8u4(9, 9, 9, 255));
+    sln::blend<sln::BlendMode::Over>(img_small, img_dst, sln::BoundingBox{3_idx, -1_idx, 2_px, 2_px});
+
+    for (auto y = 0_idx; y < img_dst.height(); ++y)
+    {
+      for (auto x = 0_idx; x < img_dst.width(); ++x)
+      {
+        const auto expected = (x == 3 && y == 0) ? sln::Pixel_8u4(9, 9, 9, 255) : sln::Pixel_8u4(20, 200, 255, 255);
+        REQUIRE(img_dst(x, y) == expected);
+      }
+    }
+
+    REQUIRE_THROWS(sln::blend<sln::BlendMode::Over>(img_small, img_dst, sln::BoundingBox{0_idx, 0_idx, 3_px, 2_px}));
+    REQUIRE_THROWS(sln::blend<sln::BlendMode::Over>(img_small, img_dst));
+  }
+
+  SECTION("Floating point")
+  {
+    sln::Image<sln::Pixel_32f4> src_f({2_px, 2_px});
+    sln::Image<sln::Pixel_32f4> dst_f({2_px, 2_px});
+    sln::fill(src_f, sln::Pixel_32f4(0.25f, 0.0f, 0.5f, 0.5f));
+    sln::fill(dst_f, sln::Pixel_32f4(1.0f, 0.5f, 0.0f, 1.0f));
+    sln::blend<sln::BlendMode::Over>(src_f, dst_f);
+    REQUIRE(dst_f(1_idx, 1_idx)[0] == Approx(0.75f));
+    REQUIRE(dst_f(1_idx, 1_idx)[1] == Approx(0.25f));
+    REQUIRE(dst_f(1_idx, 1_idx)[2] == Approx(0.5f));
+    REQUIRE(dst_f(1_idx, 1_idx)[3] == Approx(1.0f));
+  }
+}
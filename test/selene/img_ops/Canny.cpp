@@ -0,0 +1,147 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch2/catch.hpp>
+
+#include <selene/img_ops/Canny.hpp>
+
+#include <selene/base/ThreadPool.hpp>
+
+#include <selene/img/pixel/PixelTypeAliases.hpp>
+
+#include <selene/img/typed/Image.hpp>
+#include <selene/img/typed/ImageTypeAliases.hpp>
+
+#include <selene/img_ops/Fill.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace sln::literals;
+
+namespace {
+
+sln::Image_8u1 make_square_image()
+{
+  sln::Image_8u1 img({64_px, 48_px});
+  sln::fill(img, std::uint8_t{20});
+
+  for (auto y = 10_idx; y < 30_idx; ++y)
+  {
+    for (auto x = 16_idx; x < 40_idx; ++x)
+    {
+      img(x, y) = 220;
+    }
+  }
+
+  return img;
+}
+
+std::size_t count_edge_pixels(const sln::Image_8u1& img)
+{
+  std::size_t count = 0;
+  for (auto y = 0_idx; y < img.height(); ++y)
+  {
+    for (auto x = 0_idx; x < img.width(); ++x)
+    {
+      REQUIRE((img(x, y) == 0 || img(x, y) == 255));
+      count += (img(x, y) == 255) ? 1 : 0;
+    }
+  }
+  return count;
+}
+
+}  // namespace
+
+TEST_CASE("Canny edge detection", "[img]")
+{
+  sln::ThreadPool pool(4);
+
+  SECTION("Edges of a square")
+  {
+    const auto img = make_square_image();
+    sln::Image_8u1 img_edges;
+    sln::canny(img, img_edges, 50.0, 150.0);
+    REQUIRE(img_edges.width() == img.width());
+    REQUIRE(img_edges.height() == img.height());
+
+    // Edges are one pixel wide, and lie directly next to the intensity step
+    for (auto y = 12_idx; y < 28_idx; ++y)
+    {
+      REQUIRE(img_edges(15_idx, y) + img_edges(16_idx, y) == 255);
+      REQUIRE(img_edges(39_idx, y) + img_edges(40_idx, y) == 255);
+      REQUIRE(img_edges(28_idx, y) == 0);
+      REQUIRE(img_edges(5_idx, y) == 0);
+    }
+
+    for (auto x = 18_idx; x < 38_idx; ++x)
+    {
+      REQUIRE(img_edges(x, 9_idx) + img_edges(x, 10_idx) == 255);
+      REQUIRE(img_edges(x, 29_idx) + img_edges(x, 30_idx) == 255);
+    }
+
+    // A high threshold above the maximum gradient magnitude yields no edges
+    sln::canny(img, img_edges, 50.0, 5000.0);
+    REQUIRE(count_edge_pixels(img_edges) == 0);
+  }
+
+  SECTION("Hysteresis")
+  {
+    // Padded 6x4 edge map: a weak chain connected to a strong pixel, and an isolated weak chain
+    constexpr std::ptrdiff_t w = 6, h = 4, stride = w + 2;
+    std::vector<std::uint8_t> edges(static_cast<std::size_t>(stride * (h + 2)), sln::impl::canny_none);
+    const auto at = [&](std::ptrdiff_t x, std::ptrdiff_t y) -> std::uint8_t& {
+      return edges[static_cast<std::size_t>((y + 1) * stride + x + 1)];
+    };
+
+    at(0, 0) = sln::impl::canny_strong;
+    at(1, 1) = sln::impl::canny_weak;
+    at(2, 2) = sln::impl::canny_weak;
+    at(2, 3) = sln::impl::canny_weak;
+    at(5, 0) = sln::impl::canny_weak;
+    at(5, 1) = sln::impl::canny_weak;
+
+    sln::impl::canny_hysteresis(edges.data(), w, h);
+    REQUIRE(at(1, 1) == sln::impl::canny_strong);
+    REQUIRE(at(2, 2) == sln::impl::canny_strong);
+    REQUIRE(at(2, 3) == sln::impl::canny_strong);
+    REQUIRE(at(5, 0) == sln::impl::canny_weak);
+    REQUIRE(at(5, 1) == sln::impl::canny_weak);
+    REQUIRE(at(3, 3) == sln::impl::canny_none);
+  }
+
+  SECTION("Parallel execution yields the same result")
+  {
+    std::mt19937 rng(38);
+    std::uniform_int_distribution<int> dist(0, 255);
+    sln::Image_8u1 img({157_px, 93_px});
+    for (auto y = 0_idx; y < img.height(); ++y)
+    {
+      for (auto x = 0_idx; x < img.width(); ++x)
+      {
+        img(x, y) = static_cast<std::uint8_t>(dist(rng) / 4 + ((x / 20 + y / 20) % 2) * 150);
+      }
+    }
+
+    sln::Image_8u1 img_edges, img_edges_par, img_edges_scharr, img_edges_scharr_par;
+    sln::canny(img, img_edges, 80.0, 200.0);
+    sln::canny(pool, img, img_edges_par, 80.0, 200.0);
+    REQUIRE(img_edges_par == img_edges);
+    REQUIRE(count_edge_pixels(img_edges) > 0);
+
+    sln::canny<sln::GradientKernel::Scharr>(img, img_edges_scharr, 300.0, 800.0);
+    sln::canny<sln::GradientKernel::Scharr>(sln::execution::par.on(pool), img, img_edges_scharr_par, 300.0, 800.0);
+    REQUIRE(img_edges_scharr_par == img_edges_scharr);
+  }
+
+  SECTION("Invalid thresholds")
+  {
+    const auto img = make_square_image();
+    sln::Image_8u1 img_edges;
+    REQUIRE_THROWS(sln::canny(img, img_edges, 150.0, 50.0));
+    REQUIRE_THROWS(sln::canny(img, img_edges, -1.0, 50.0));
+  }
+}
@@ -0,0 +1,220 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch2/catch.hpp>
+
+#include <selene/img_ops/Clahe.hpp>
+
+#include <selene/base/ThreadPool.hpp>
+
+#include <selene/img/pixel/PixelTypeAliases.hpp>
+
+#include <selene/img/typed/Image.hpp>
+#include <selene/img/typed/ImageTypeAliases.hpp>
+
+#include <selene/img_ops/Fill.hpp>
+#include <selene/img_ops/View.hpp>
+
+#include <test/selene/img/typed/_Utils.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace sln::literals;
+
+namespace {
+
+template <typename PixelType>
+sln::Image<PixelType> make_noisy_gradient_image(sln::PixelLength w,
+                                                sln::PixelLength h,
+                                                int max_value,
+                                                std::mt19937& rng)
+{
+  auto img = sln_test::construct_random_image<PixelType>(
+      w, h, rng, std::uniform_int_distribution<int>(0, max_value / 2));
+
+  for (auto y = 0_idx; y < h; ++y)
+  {
+    for (auto x = 0_idx; x < w; ++x)
+    {
+      // Smooth gradient plus noise, to get differing tile histograms
+      img(x, y) = static_cast<PixelType>(std::min(max_value, (max_value / 4) * (x + y) / (w + h) + int{img(x, y)}));
+    }
+  }
+
+  return img;
+}
+
+/// Straightforward floating point implementation of CLAHE, for comparison.
+template <typename PixelType>
+sln::Image<PixelType> reference_clahe(const sln::Image<PixelType>& img, double clip_limit, int tiles_x, int tiles_y)
+{
+  const int nr_bins = 1 << (8 * sizeof(PixelType));
+  const int w = static_cast<int>(img.width());
+  const int h = static_cast<int>(img.height());
+  const int tw = (w + tiles_x - 1) / tiles_x;
+  const int th = (h + tiles_y - 1) / tiles_y;
+
+  std::vector<std::vector<double>> luts(static_cast<std::size_t>(tiles_x * tiles_y));
+
+  for (int ty = 0; ty < tiles_y; ++ty)
+  {
+    for (int tx = 0; tx < tiles_x; ++tx)
+    {
+      std::vector<long> hist(static_cast<std::size_t>(nr_bins), 0);
+      const int x1 = std::min(w, (tx + 1) * tw);
+      const int y1 = std::min(h, (ty + 1) * th);
+      for (int y = ty * th; y < y1; ++y)
+      {
+        for (int x = tx * tw; x < x1; ++x)
+        {
+          ++hist[img(sln::PixelIndex{x}, sln::PixelIndex{y})];
+        }
+      }
+
+      const long area = (x1 - tx * tw) * (y1 - ty * th);
+      const long clip = std::max(1L, static_cast<long>(clip_limit * static_cast<double>(area) / nr_bins));
+      long clipped = 0;
+      for (auto& v : hist)
+      {
+        clipped += std::max(0L, v - clip);
+        v = std::min(v, clip);
+      }
+
+      long residual = clipped % nr_bins;
+      for (auto& v : hist)
+      {
+        v += clipped / nr_bins;
+      }
+
+      const long step = std::max(1L, nr_bins / std::max(1L, residual));
+      for (long b = 0; b < nr_bins && residual > 0; b += step, --residual)
+      {
+        ++hist[static_cast<std::size_t>(b)];
+      }
+
+      auto& lut = luts[static_cast<std::size_t>(ty * tiles_x + tx)];
+      long cdf = 0;
+      for (const auto v : hist)
+      {
+        cdf += v;
+        lut.push_back(std::min(double(nr_bins - 1), std::round(double(cdf) * (nr_bins - 1) / double(area))));
+      }
+    }
+  }
+
+  sln::Image<PixelType> img_dst({img.width(), img.height()});
+
+  for (int y = 0; y < h; ++y)
+  {
+    const double fy = y / double(th) - 0.5;
+    const int ty0 = static_cast<int>(std::floor(fy));
+    const double wy = fy - ty0;
+    const int ty1 = std::min(ty0 + 1, tiles_y - 1);
+
+    for (int x = 0; x < w; ++x)
+    {
+      const double fx = x / double(tw) - 0.5;
+      const int tx0 = static_cast<int>(std::floor(fx));
+      const double wx = fx - tx0;
+      const int tx1 = std::min(tx0 + 1, tiles_x - 1);
+
+      const auto v = static_cast<std::size_t>(img(sln::PixelIndex{x}, sln::PixelIndex{y}));
+      const auto lut = [&](int tx, int ty) {
+        return luts[std::size_t(std::max(ty, 0) * tiles_x + std::max(tx, 0))][v];
+      };
+      const double r = (1 - wy) * ((1 - wx) * lut(tx0, ty0) + wx * lut(tx1, ty0))
+                       + wy * ((1 - wx) * lut(tx0, ty1) + wx * lut(tx1, ty1));
+      img_dst(sln::PixelIndex{x}, sln::PixelIndex{y}) = static_cast<PixelType>(std::lround(r));
+    }
+  }
+
+  return img_dst;
+}
+
+template <typename PixelType>
+void check_close(const sln::Image<PixelType>& img_a, const sln::Image<PixelType>& img_b, int tolerance)
+{
+  REQUIRE(img_a.width() == img_b.width());
+  REQUIRE(img_a.height() == img_b.height());
+
+  for (auto y = 0_idx; y < img_a.height(); ++y)
+  {
+    for (auto x = 0_idx; x < img_a.width(); ++x)
+    {
+      REQUIRE(std::abs(int(img_a(x, y)) - int(img_b(x, y))) <= tolerance);
+    }
+  }
+}
+
+}  // namespace
+
+TEST_CASE("CLAHE", "[img]")
+{
+  std::mt19937 rng(33);
+  sln::ThreadPool pool(4);
+
+  SECTION("8-bit")
+  {
+    const auto img = make_noisy_gradient_image<sln::Pixel_8u1>(sln::PixelLength{203}, sln::PixelLength{157}, 255, rng);
+
+    for (const auto clip_limit : {2.0, 40.0})
+    {
+      const auto ref = reference_clahe(img, clip_limit, 8, 4);
+
+      sln::Image_8u1 img_seq;
+      sln::clahe(img, img_seq, clip_limit, 8_px, 4_px);
+      check_close(img_seq, ref, 1);
+
+      sln::Image_8u1 img_par;
+      sln::clahe(pool, img, img_par, clip_limit, 8_px, 4_px);
+      REQUIRE(img_par == img_seq);
+    }
+  }
+
+  SECTION("16-bit")
+  {
+    const auto img = make_noisy_gradient_image<sln::Pixel_16u1>(sln::PixelLength{96}, sln::PixelLength{80}, 4095, rng);
+    const auto ref = reference_clahe(img, 3.0, 3, 5);
+
+    sln::Image_16u1 img_dst;
+    sln::clahe(sln::execution::par.on(pool), img, img_dst, 3.0, 3_px, 5_px);
+    check_close(img_dst, ref, 2);
+  }
+
+  SECTION("Contrast enhancement")
+  {
+    // A low-contrast image is stretched to (nearly) the full range.
+    auto img = make_noisy_gradient_image<sln::Pixel_8u1>(sln::PixelLength{128}, sln::PixelLength{128}, 31, rng);
+    sln::for_each_pixel(img, [](auto& px) { px += 100; });
+
+    sln::Image_8u1 img_dst;
+    sln::clahe(img, img_dst, 0.0, 4_px, 4_px);
+    const auto hist = sln::histogram(img_dst);
+    REQUIRE(hist[255] > 0);
+    REQUIRE(std::find_if(hist.cbegin(), hist.cend(), [](auto v) { return v > 0; }) - hist.cbegin() < 32);
+  }
+
+  SECTION("Views, small images and invalid arguments")
+  {
+    const auto img = make_noisy_gradient_image<sln::Pixel_8u1>(sln::PixelLength{64}, sln::PixelLength{64}, 255, rng);
+    const auto img_view = sln::view(img, sln::BoundingBox(5_idx, 7_idx, 3_px, 2_px));
+
+    // More tiles than pixels
+    sln::Image_8u1 img_dst;
+    sln::clahe(img_view, img_dst, 40.0, 8_px, 8_px);
+    REQUIRE(img_dst.width() == 3_px);
+    REQUIRE(img_dst.height() == 2_px);
+
+    sln::Image_8u1 img_const({16_px, 16_px});
+    sln::fill(img_const, 0);
+    sln::clahe(img_const, img_dst, 0.0);
+    REQUIRE(img_dst(3_idx, 3_idx) == 255);
+
+    REQUIRE_THROWS(sln::clahe(img, img_dst, 40.0, 0_px, 8_px));
+  }
+}
@@ -0,0 +1,269 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch2/catch.hpp>
+
+#include <selene/img_ops/ConnectedComponents.hpp>
+
+#include <selene/base/ThreadPool.hpp>
+
+#include <selene/img/pixel/PixelTypeAliases.hpp>
+
+#include <selene/img/typed/Image.hpp>
+#include <selene/img/typed/ImageTypeAliases.hpp>
+
+#include <selene/img_ops/Fill.hpp>
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace sln::literals;
+
+namespace {
+
+sln::Image_8u1 make_random_mask(sln::PixelLength w, sln::PixelLength h, double density, std::mt19937& rng)
+{
+  std::bernoulli_distribution dist(density);
+  sln::Image_8u1 img({w, h});
+
+  for (auto y = 0_idx; y < h; ++y)
+  {
+    for (auto x = 0_idx; x < w; ++x)
+    {
+      img(x, y) = dist(rng) ? 255 : 0;
+    }
+  }
+
+  return img;
+}
+
+/// Reference labeling by flood fill; labels are numbered in order of discovery.
+std::int32_t reference_labels(const sln::Image_8u1& mask, sln::Connectivity connectivity, sln::Image_32s1& labels)
+{
+  const int w = static_cast<int>(mask.width());
+  const int h = static_cast<int>(mask.height());
+  labels = sln::Image_32s1({mask.width(), mask.height()});
+  sln::fill(labels, 0);
+
+  std::int32_t nr_labels = 0;
+  std::vector<std::pair<int, int>> stack;
+
+  for (int y = 0; y < h; ++y)
+  {
+    for (int x = 0; x < w; ++x)
+    {
+      if (mask(sln::PixelIndex{x}, sln::PixelIndex{y}) == 0 || labels(sln::PixelIndex{x}, sln::PixelIndex{y}) != 0)
+      {
+        continue;
+      }
+
+      ++nr_labels;
+      labels(sln::PixelIndex{x}, sln::PixelIndex{y}) = nr_labels;
+      stack.emplace_back(x, y);
+
+      while (!stack.empty())
+      {
+        const auto [px, py] = stack.back();
+        stack.pop_back();
+
+        for (int dy = -1; dy <= 1; ++dy)
+        {
+          for (int dx = -1; dx <= 1; ++dx)
+          {
+            const int nx = px + dx;
+            const int ny = py + dy;
+            if ((dx == 0 && dy == 0) || nx < 0 || ny < 0 || nx >= w || ny >= h)
+            {
+              continue;
+            }
+
+            if (connectivity == sln::Connectivity::Four && dx != 0 && dy != 0)
+            {
+              continue;
+            }
+
+            const auto ix = sln::PixelIndex{nx};
+            const auto iy = sln::PixelIndex{ny};
+            if (mask(ix, iy) != 0 && labels(ix, iy) == 0)
+            {
+              labels(ix, iy) = nr_labels;
+              stack.emplace_back(nx, ny);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  return nr_labels;
+}
+
+/// Checks that two labelings describe the same partition, i.e. that there is a bijection between their labels.
+void check_equivalent_labels(const sln::Image_32s1& labels, const sln::Image_32s1& ref_labels)
+{
+  std::map<std::int32_t, std::int32_t> to_ref, from_ref;
+
+  for (auto y = 0_idx; y < labels.height(); ++y)
+  {
+    for (auto x = 0_idx; x < labels.width(); ++x)
+    {
+      const auto l = labels(x, y);
+      const auto r = ref_labels(x, y);
+      REQUIRE((l == 0) == (r == 0));
+
+      const auto it_to = to_ref.emplace(l, r).first;
+      const auto it_from = from_ref.emplace(r, l).first;
+      REQUIRE(it_to->second == r);
+      REQUIRE(it_from->second == l);
+    }
+  }
+}
+
+}  // namespace
+
+TEST_CASE("Connected component labeling", "[img]")
+{
+  std::mt19937 rng(39);
+  sln::ThreadPool pool(4);
+
+  SECTION("Random masks")
+  {
+    for (const auto connectivity : {sln::Connectivity::Four, sln::Connectivity::Eight})
+    {
+      for (const auto density : {0.2, 0.5, 0.7})
+      {
+        // Odd dimensions, and enough rows for several strips
+        const auto mask = make_random_mask(sln::PixelLength{131}, sln::PixelLength{517}, density, rng);
+
+        sln::Image_32s1 ref_labels;
+        const auto ref_nr_labels = reference_labels(mask, connectivity, ref_labels);
+
+        sln::Image_32s1 labels;
+        const auto nr_labels = sln::label_connected_components(mask, labels, connectivity);
+        REQUIRE(nr_labels == ref_nr_labels);
+        check_equivalent_labels(labels, ref_labels);
+
+        sln::Image_32s1 labels_par;
+        const auto nr_labels_par = sln::label_connected_components(pool, mask, labels_par, connectivity);
+        REQUIRE(nr_labels_par == ref_nr_labels);
+        REQUIRE(labels_par == labels);
+      }
+    }
+  }
+
+  SECTION("Diagonal connections")
+  {
+    sln::Image_8u1 mask({5_px, 5_px});
+    sln::fill(mask, std::uint8_t{0});
+    for (auto i = 0_idx; i < 5_idx; ++i)
+    {
+      mask(i, i) = 1;
+    }
+
+    sln::Image_32s1 labels;
+    REQUIRE(sln::label_connected_components(mask, labels, sln::Connectivity::Eight) == 1);
+    REQUIRE(sln::label_connected_components(mask, labels, sln::Connectivity::Four) == 5);
+    REQUIRE(labels(0_idx, 1_idx) == 0);
+  }
+
+  SECTION("Statistics")
+  {
+    sln::Image_8u1 mask({40_px, 30_px});
+    sln::fill(mask, std::uint8_t{0});
+
+    // A filled 5x4 rectangle, and an L-shape
+    for (auto y = 3_idx; y < 7_idx; ++y)
+    {
+      for (auto x = 2_idx; x < 7_idx; ++x)
+      {
+        mask(x, y) = 1;
+      }
+    }
+
+    for (auto y = 10_idx; y < 25_idx; ++y)
+    {
+      mask(30_idx, y) = 1;
+    }
+
+    for (auto x = 20_idx; x < 30_idx; ++x)
+    {
+      mask(x, 24_idx) = 1;
+    }
+
+    for (const auto connectivity : {sln::Connectivity::Four, sln::Connectivity::Eight})
+    {
+      sln::Image_32s1 labels;
+      std::vector<sln::ComponentStats> stats;
+      REQUIRE(sln::label_connected_components(sln::execution::par.on(pool), mask, labels, stats, connectivity) == 2);
+      REQUIRE(stats.size() == 2);
+
+      const auto& rect = stats[static_cast<std::size_t>(labels(2_idx, 3_idx) - 1)];
+      REQUIRE(rect.area == 20);
+      REQUIRE(rect.bounding_box.x0() == 2_idx);
+      REQUIRE(rect.bounding_box.y0() == 3_idx);
+      REQUIRE(rect.bounding_box.width() == 5_px);
+      REQUIRE(rect.bounding_box.height() == 4_px);
+      REQUIRE(rect.centroid_x == Approx(4.0));
+      REQUIRE(rect.centroid_y == Approx(4.5));
+
+      const auto& l_shape = stats[static_cast<std::size_t>(labels(30_idx, 10_idx) - 1)];
+      REQUIRE(l_shape.area == 25);
+      REQUIRE(l_shape.bounding_box.x0() == 20_idx);
+      REQUIRE(l_shape.bounding_box.y0() == 10_idx);
+      REQUIRE(l_shape.bounding_box.width() == 11_px);
+      REQUIRE(l_shape.bounding_box.height() == 15_px);
+      REQUIRE(l_shape.centroid_x == Approx((15.0 * 30.0 + 245.0) / 25.0));
+      REQUIRE(l_shape.centroid_y == Approx((17.0 * 15.0 + 10.0 * 24.0) / 25.0));
+    }
+  }
+
+  SECTION("Statistics, many strips and components")
+  {
+    // Isolated pixels on a regular grid; narrow enough for many strips, with one component per 4 pixels
+    sln::Image_8u1 mask({512_px, 2048_px});
+    for (auto y = 0_idx; y < mask.height(); ++y)
+    {
+      for (auto x = 0_idx; x < mask.width(); ++x)
+      {
+        mask(x, y) = (x % 2 == 0 && y % 2 == 0) ? 1 : 0;
+      }
+    }
+
+    const auto nr_components = std::int32_t{256 * 1024};
+
+    for (const auto connectivity : {sln::Connectivity::Four, sln::Connectivity::Eight})
+    {
+      sln::Image_32s1 labels;
+      std::vector<sln::ComponentStats> stats;
+      REQUIRE(sln::label_connected_components(pool, mask, labels, stats, connectivity) == nr_components);
+      REQUIRE(stats.size() == static_cast<std::size_t>(nr_components));
+
+      std::size_t nr_mismatches = 0;
+      for (auto y = 0_idx; y < mask.height(); y += 2)
+      {
+        for (auto x = 0_idx; x < mask.width(); x += 2)
+        {
+          const auto& st = stats[static_cast<std::size_t>(labels(x, y) - 1)];
+          nr_mismatches += (st.area != 1 || st.bounding_box.x0() != x || st.bounding_box.y0() != y
+                            || st.centroid_x != static_cast<double>(x) || st.centroid_y != static_cast<double>(y));
+        }
+      }
+      REQUIRE(nr_mismatches == 0);
+    }
+  }
+
+  SECTION("Empty mask")
+  {
+    sln::Image_8u1 mask({17_px, 9_px});
+    sln::fill(mask, std::uint8_t{0});
+
+    sln::Image_32s1 labels;
+    std::vector<sln::ComponentStats> stats;
+    REQUIRE(sln::label_connected_components(pool, mask, labels, stats) == 0);
+    REQUIRE(stats.empty());
+  }
+}
@@ -0,0 +1,143 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch2/catch.hpp>
+
+#include <selene/img_ops/DistanceTransform.hpp>
+
+#include <selene/base/ThreadPool.hpp>
+
+#include <selene/img/pixel/PixelTypeAliases.hpp>
+
+#include <selene/img/typed/Image.hpp>
+#include <selene/img/typed/ImageTypeAliases.hpp>
+
+#include <selene/img_ops/Fill.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace sln::literals;
+
+namespace {
+
+sln::Image_8u1 make_random_mask(sln::PixelLength w, sln::PixelLength h, double feature_density, std::mt19937& rng)
+{
+  std::bernoulli_distribution dist(feature_density);
+  sln::Image_8u1 img({w, h});
+
+  for (auto y = 0_idx; y < h; ++y)
+  {
+    for (auto x = 0_idx; x < w; ++x)
+    {
+      img(x, y) = dist(rng) ? 0 : 1;
+    }
+  }
+
+  return img;
+}
+
+/// Reference squared distances, by exhaustive search over all feature pixels.
+std::vector<long> reference_squared_distances(const sln::Image_8u1& mask)
+{
+  std::vector<std::pair<long, long>> features;
+  for (auto y = 0_idx; y < mask.height(); ++y)
+  {
+    for (auto x = 0_idx; x < mask.width(); ++x)
+    {
+      if (mask(x, y) == 0)
+      {
+        features.emplace_back(long{x}, long{y});
+      }
+    }
+  }
+
+  std::vector<long> dist;
+  for (auto y = 0_idx; y < mask.height(); ++y)
+  {
+    for (auto x = 0_idx; x < mask.width(); ++x)
+    {
+      auto best = std::numeric_limits<long>::max();
+      for (const auto& [fx, fy] : features)
+      {
+        best = std::min(best, (fx - x) * (fx - x) + (fy - y) * (fy - y));
+      }
+      dist.push_back(best);
+    }
+  }
+
+  return dist;
+}
+
+}  // namespace
+
+TEST_CASE("Euclidean distance transform", "[img]")
+{
+  std::mt19937 rng(40);
+  sln::ThreadPool pool(4);
+
+  SECTION("Random masks")
+  {
+    for (const auto density : {0.002, 0.02, 0.3})
+    {
+      const auto mask = make_random_mask(sln::PixelLength{97}, sln::PixelLength{203}, density, rng);
+      const auto ref = reference_squared_distances(mask);
+
+      sln::Image_32f1 img_dist;
+      sln::Image_32s2 img_nearest;
+      sln::distance_transform(mask, img_dist, img_nearest);
+
+      sln::Image_32f1 img_dist_par;
+      sln::Image_32s2 img_nearest_par;
+      sln::distance_transform(pool, mask, img_dist_par, img_nearest_par);
+      REQUIRE(img_dist_par == img_dist);
+      REQUIRE(img_nearest_par == img_nearest);
+
+      std::size_t i = 0;
+      for (auto y = 0_idx; y < mask.height(); ++y)
+      {
+        for (auto x = 0_idx; x < mask.width(); ++x, ++i)
+        {
+          REQUIRE(img_dist(x, y) == Approx(std::sqrt(float(ref[i]))));
+
+          // The nearest feature is a feature pixel at exactly the computed distance
+          const auto nx = img_nearest(x, y)[0];
+          const auto ny = img_nearest(x, y)[1];
+          REQUIRE(mask(sln::PixelIndex{nx}, sln::PixelIndex{ny}) == 0);
+          REQUIRE(long{(nx - x) * (nx - x) + (ny - y) * (ny - y)} == ref[i]);
+        }
+      }
+    }
+  }
+
+  SECTION("Single feature pixel")
+  {
+    sln::Image_8u1 mask({30_px, 20_px});
+    sln::fill(mask, std::uint8_t{255});
+    mask(4_idx, 15_idx) = 0;
+
+    sln::Image_64f1 img_dist;
+    sln::distance_transform(sln::execution::par.on(pool), mask, img_dist);
+    REQUIRE(img_dist(4_idx, 15_idx) == 0.0);
+    REQUIRE(img_dist(4_idx, 0_idx) == 15.0);
+    REQUIRE(img_dist(29_idx, 0_idx) == Approx(std::sqrt(25.0 * 25.0 + 15.0 * 15.0)));
+  }
+
+  SECTION("No feature pixels")
+  {
+    sln::Image_8u1 mask({8_px, 5_px});
+    sln::fill(mask, std::uint8_t{1});
+
+    sln::Image_32f1 img_dist;
+    sln::Image_32s2 img_nearest;
+    sln::distance_transform(mask, img_dist, img_nearest);
+    REQUIRE(std::isinf(img_dist(3_idx, 2_idx)));
+    REQUIRE(img_nearest(3_idx, 2_idx)[0] == -1);
+    REQUIRE(img_nearest(3_idx, 2_idx)[1] == -1);
+  }
+}
@@ -0,0 +1,142 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch2/catch.hpp>
+
+#include <selene/img_ops/Gradients.hpp>
+
+#include <selene/base/ThreadPool.hpp>
+
+#include <selene/img/pixel/PixelTypeAliases.hpp>
+
+#include <selene/img/typed/Image.hpp>
+#include <selene/img/typed/ImageTypeAliases.hpp>
+
+#include <test/selene/img/typed/_Utils.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+using namespace sln::literals;
+
+namespace {
+
+/// Reference derivatives, by direct evaluation of the 3x3 kernels.
+void reference_gradients(const sln::Image_8u1& img, int w_outer, int w_center, sln::Image_32s1& img_dx,
+                         sln::Image_32s1& img_dy)
+{
+  const int w = static_cast<int>(img.width());
+  const int h = static_cast<int>(img.height());
+  img_dx = sln::Image_32s1({img.width(), img.height()});
+  img_dy = sln::Image_32s1({img.width(), img.height()});
+
+  const auto v = [&](int x, int y) {
+    return int{img(sln::PixelIndex{std::clamp(x, 0, w - 1)}, sln::PixelIndex{std::clamp(y, 0, h - 1)})};
+  };
+
+  for (int y = 0; y < h; ++y)
+  {
+    for (int x = 0; x < w; ++x)
+    {
+      const int dx = w_outer * (v(x + 1, y - 1) - v(x - 1, y - 1)) + w_center * (v(x + 1, y) - v(x - 1, y))
+                     + w_outer * (v(x + 1, y + 1) - v(x - 1, y + 1));
+      const int dy = w_outer * (v(x - 1, y + 1) - v(x - 1, y - 1)) + w_center * (v(x, y + 1) - v(x, y - 1))
+                     + w_outer * (v(x + 1, y + 1) - v(x + 1, y - 1));
+      img_dx(sln::PixelIndex{x}, sln::PixelIndex{y}) = dx;
+      img_dy(sln::PixelIndex{x}, sln::PixelIndex{y}) = dy;
+    }
+  }
+}
+
+}  // namespace
+
+TEST_CASE("Image gradients", "[img]")
+{
+  std::mt19937 rng(37);
+  sln::ThreadPool pool(4);
+  const auto img = sln_test::construct_random_image<sln::Pixel_8u1>(123_px, 77_px, rng);
+
+  SECTION("Sobel, all outputs")
+  {
+    sln::Image_32s1 ref_dx, ref_dy;
+    reference_gradients(img, 1, 2, ref_dx, ref_dy);
+
+    sln::Image_16s1 img_dx, img_dy;
+    sln::Image_32f1 img_mag, img_ori;
+    sln::gradients(img, img_dx, img_dy, img_mag, img_ori);
+
+    sln::Image_16s1 img_dx_par, img_dy_par;
+    sln::Image_32f1 img_mag_par, img_ori_par;
+    sln::gradients(pool, img, img_dx_par, img_dy_par, img_mag_par, img_ori_par);
+
+    REQUIRE(img_dx_par == img_dx);
+    REQUIRE(img_dy_par == img_dy);
+    REQUIRE(img_mag_par == img_mag);
+    REQUIRE(img_ori_par == img_ori);
+
+    for (auto y = 0_idx; y < img.height(); ++y)
+    {
+      for (auto x = 0_idx; x < img.width(); ++x)
+      {
+        const auto dx = ref_dx(x, y);
+        const auto dy = ref_dy(x, y);
+        REQUIRE(img_dx(x, y) == dx);
+        REQUIRE(img_dy(x, y) == dy);
+        REQUIRE(img_mag(x, y) == Approx(std::sqrt(float(dx * dx + dy * dy))));
+        REQUIRE(img_ori(x, y) == Approx(std::atan2(float(dy), float(dx))));
+      }
+    }
+  }
+
+  SECTION("Scharr, selected outputs, fast orientation")
+  {
+    sln::Image_32s1 ref_dx, ref_dy;
+    reference_gradients(img, 3, 10, ref_dx, ref_dy);
+
+    sln::Image_16s1 img_dy;
+    sln::Image_32f1 img_ori;
+    sln::gradients<sln::GradientKernel::Scharr, sln::GradientOrientation::Fast>(
+        sln::execution::par_unseq.on(pool), img, sln::no_output, img_dy, sln::no_output, img_ori);
+
+    for (auto y = 0_idx; y < img.height(); ++y)
+    {
+      for (auto x = 0_idx; x < img.width(); ++x)
+      {
+        REQUIRE(img_dy(x, y) == ref_dy(x, y));
+        const auto ori_exact = std::atan2(float(ref_dy(x, y)), float(ref_dx(x, y)));
+        REQUIRE(std::abs(img_ori(x, y) - ori_exact) < 2e-5f);
+      }
+    }
+  }
+
+  SECTION("Magnitude only, as integers")
+  {
+    sln::Image_32s1 ref_dx, ref_dy;
+    reference_gradients(img, 1, 2, ref_dx, ref_dy);
+
+    sln::Image_16u1 img_mag;
+    sln::gradients(img, sln::no_output, sln::no_output, img_mag, sln::no_output);
+    REQUIRE(img_mag.width() == img.width());
+    REQUIRE(img_mag.height() == img.height());
+
+    const auto dx = ref_dx(5_idx, 6_idx);
+    const auto dy = ref_dy(5_idx, 6_idx);
+    REQUIRE(img_mag(5_idx, 6_idx) == static_cast<std::uint16_t>(std::sqrt(float(dx * dx + dy * dy))));
+  }
+
+  SECTION("Fast atan2 approximation")
+  {
+    for (int i = 0; i < 1000; ++i)
+    {
+      const auto angle = -3.14159f + 6.28318f * static_cast<float>(i) / 1000.0f;
+      const auto y = 7.0f * std::sin(angle);
+      const auto x = 7.0f * std::cos(angle);
+      REQUIRE(std::abs(sln::impl::fast_atan2(y, x) - std::atan2(y, x)) < 2e-5f);
+    }
+
+    REQUIRE(sln::impl::fast_atan2(0.0f, 0.0f) == 0.0f);
+  }
+}
@@ -0,0 +1,190 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch2/catch.hpp>
+
+#include <selene/img_ops/Histogram.hpp>
+
+#include <selene/base/ThreadPool.hpp>
+
+#include <selene/img/pixel/PixelTypeAliases.hpp>
+
+#include <selene/img/typed/Image.hpp>
+#include <selene/img/typed/ImageTypeAliases.hpp>
+
+#include <selene/img_ops/Fill.hpp>
+
+#include <test/selene/img/typed/_Utils.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <random>
+
+using namespace sln::literals;
+
+namespace {
+
+template <std::size_t nr_bins, typename PixelType>
+sln::Histogram reference_histogram(const sln::Image<PixelType>& img, std::size_t channel)
+{
+  using Element = typename sln::PixelTraits<PixelType>::Element;
+  sln::Histogram hist(nr_bins, 0);
+
+  for (auto y = 0_idx; y < img.height(); ++y)
+  {
+    for (auto x = 0_idx; x < img.width(); ++x)
+    {
+      const auto v = static_cast<std::uint64_t>(sln::impl::get_channel(img(x, y), channel));
+      ++hist[(v * nr_bins) >> (8 * sizeof(Element))];
+    }
+  }
+
+  return hist;
+}
+
+}  // namespace
+
+TEST_CASE("Histogram computation", "[img]")
+{
+  std::mt19937 rng(17);
+  sln::ThreadPool pool(4);
+
+  SECTION("8-bit, multi-channel")
+  {
+    const auto img = sln_test::construct_random_image<sln::Pixel_8u3>(301_px, 211_px, rng);
+
+    for (std::size_t c = 0; c < 3; ++c)
+    {
+      const auto ref = reference_histogram<256>(img, c);
+      REQUIRE(sln::histogram(img, c) == ref);
+      REQUIRE(sln::histogram(pool, img, c) == ref);
+      REQUIRE(sln::histogram<256>(sln::execution::par, img, c) == ref);
+
+      const auto ref_16 = reference_histogram<16>(img, c);
+      REQUIRE(sln::histogram<16>(img, c) == ref_16);
+      REQUIRE(sln::histogram<16>(pool, img, c) == ref_16);
+    }
+
+    REQUIRE_THROWS(sln::histogram(img, 3));
+  }
+
+  SECTION("16-bit")
+  {
+    const auto img = sln_test::construct_random_image<sln::Pixel_16u1>(
+        97_px, 1003_px, rng, std::uniform_int_distribution<int>(0, 65535));
+    REQUIRE(sln::histogram<65536>(img) == reference_histogram<65536>(img, 0));
+    REQUIRE(sln::histogram<65536>(pool, img) == reference_histogram<65536>(img, 0));
+    REQUIRE(sln::histogram<1024>(pool, img) == reference_histogram<1024>(img, 0));
+  }
+
+  SECTION("Constant image")
+  {
+    sln::Image_8u1 img({sln::PixelLength{65}, sln::PixelLength{3}});
+    sln::fill(img, 200);
+    const auto hist = sln::histogram(img);
+    REQUIRE(hist[200] == 65 * 3);
+    REQUIRE(std::accumulate(hist.cbegin(), hist.cend(), std::uint64_t{0}) == 65 * 3);
+  }
+}
+
+TEST_CASE("Lookup tables and histogram equalization", "[img]")
+{
+  std::mt19937 rng(23);
+
+  SECTION("Apply LUT")
+  {
+    const auto img = sln_test::construct_random_image<sln::Pixel_8u3>(31_px, 29_px, rng);
+    std::array<float, 256> lut;
+    for (std::size_t i = 0; i < lut.size(); ++i)
+    {
+      lut[i] = static_cast<float>(i) * 0.5f;
+    }
+
+    sln::Image_32f3 img_dst;
+    sln::apply_lut(img, img_dst, lut);
+
+    for (auto y = 0_idx; y < img.height(); ++y)
+    {
+      for (auto x = 0_idx; x < img.width(); ++x)
+      {
+        for (std::size_t c = 0; c < 3; ++c)
+        {
+          REQUIRE(img_dst(x, y)[c] == static_cast<float>(img(x, y)[c]) * 0.5f);
+        }
+      }
+    }
+
+    std::array<std::uint8_t, 255> lut_too_small{};
+    sln::Image_8u3 img_dst_8u;
+    REQUIRE_THROWS(sln::apply_lut(img, img_dst_8u, lut_too_small));
+  }
+
+  SECTION("Equalization")
+  {
+    // Low-contrast image, with values in [100, 131]
+    auto img = sln_test::construct_random_image<sln::Pixel_8u1>(
+        128_px, 128_px, rng, std::uniform_int_distribution<int>(0, 31));
+    sln::for_each_pixel(img, [](auto& px) { px += 100; });
+
+    sln::Image_8u1 img_eq;
+    sln::equalize_histogram(img, img_eq);
+
+    const auto hist_eq = sln::histogram(img_eq);
+    const auto first = std::find_if(hist_eq.cbegin(), hist_eq.cend(), [](auto v) { return v > 0; });
+    const auto last = std::find_if(hist_eq.crbegin(), hist_eq.crend(), [](auto v) { return v > 0; });
+    REQUIRE(first - hist_eq.cbegin() == 0);
+    REQUIRE(last - hist_eq.crbegin() == 0);
+
+    // The mapping is monotonic.
+    for (auto y = 0_idx; y < img.height(); ++y)
+    {
+      for (auto x = 1_idx; x < img.width(); ++x)
+      {
+        const auto a = img(sln::PixelIndex{x - 1}, y);
+        const auto b = img(x, y);
+        if (a < b)
+        {
+          REQUIRE(img_eq(sln::PixelIndex{x - 1}, y) <= img_eq(x, y));
+        }
+      }
+    }
+
+    sln::Image_8u1 img_const({4_px, 4_px});
+    sln::fill(img_const, 77);
+    sln::Image_8u1 img_const_eq;
+    sln::equalize_histogram(img_const, img_const_eq);
+    REQUIRE(img_const_eq(2_idx, 2_idx) == 77);
+
+    const sln::Image_8u1 img_empty;
+    sln::Image_8u1 img_empty_eq({4_px, 4_px});
+    sln::equalize_histogram(img_empty, img_empty_eq);
+    REQUIRE(img_empty_eq.width() == 0);
+    REQUIRE(img_empty_eq.height() == 0);
+  }
+
+  SECTION("Matching")
+  {
+    auto img_src = sln_test::construct_random_image<sln::Pixel_8u1>(
+        64_px, 64_px, rng, std::uniform_int_distribution<int>(0, 63));
+    const auto img_ref = sln_test::construct_random_image<sln::Pixel_8u1>(50_px, 70_px, rng);
+
+    sln::Image_8u1 img_matched;
+    sln::match_histogram(img_src, img_ref, img_matched);
+
+    // Matching an image to itself is the identity.
+    sln::Image_8u1 img_self;
+    sln::match_histogram(img_src, img_src, img_self);
+    REQUIRE(sln::histogram(img_self) == sln::histogram(img_src));
+
+    // The matched image spans (approximately) the range of the reference image.
+    const auto hist = sln::histogram(img_matched);
+    const auto last = std::find_if(hist.crbegin(), hist.crend(), [](auto v) { return v > 0; });
+    REQUIRE(255 - (last - hist.crbegin()) >= 250);
+
+    sln::Image_8u1 img_empty;
+    REQUIRE_THROWS(sln::match_histogram(img_src, img_empty, img_matched));
+  }
+}
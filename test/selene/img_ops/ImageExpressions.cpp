@@ -0,0 +1,176 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch2/catch.hpp>
+
+#include <selene/img_ops/ImageExpressions.hpp>
+
+#include <selene/img/pixel/PixelTypeAliases.hpp>
+
+#include <selene/img/typed/Image.hpp>
+#include <selene/img/typed/ImageTypeAliases.hpp>
+
+#include <selene/img_ops/Fill.hpp>
+#include <selene/img_ops/View.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+using namespace sln::literals;
+
+namespace {
+
+template <typename PixelType>
+sln::Image<PixelType> make_test_image(sln::PixelLength w, sln::PixelLength h, int seed)
+{
+  sln::Image<PixelType> img({w, h});
+
+  for (auto y = 0_idx; y < h; ++y)
+  {
+    for (auto x = 0_idx; x < w; ++x)
+    {
+      for (std::size_t c = 0; c < sln::PixelTraits<PixelType>::nr_channels; ++c)
+      {
+        using Element = typename sln::PixelTraits<PixelType>::Element;
+        img(x, y)[c] = static_cast<Element>((seed * x + 3 * y + 11 * static_cast<int>(c) + seed) % 256);
+      }
+    }
+  }
+
+  return img;
+}
+
+}  // namespace
+
+TEST_CASE("Image expressions", "[img]")
+{
+  const auto w = sln::PixelLength{23};
+  const auto h = sln::PixelLength{517};
+
+  const auto img_a = make_test_image<sln::Pixel_8u3>(w, h, 5);
+  const auto img_b = make_test_image<sln::Pixel_8u3>(w, h, 7);
+  const auto img_c = make_test_image<sln::Pixel_8u3>(w, h, 13);
+
+  SECTION("Weighted sum into float image")
+  {
+    sln::Image_32f3 img_dst = img_a * 0.5f + img_b * 0.5f - img_c;
+    REQUIRE(img_dst.width() == w);
+    REQUIRE(img_dst.height() == h);
+
+    for (auto y = 0_idx; y < h; ++y)
+    {
+      for (auto x = 0_idx; x < w; ++x)
+      {
+        for (std::size_t c = 0; c < 3; ++c)
+        {
+          const auto expected = static_cast<float>(img_a(x, y)[c]) * 0.5f + static_cast<float>(img_b(x, y)[c]) * 0.5f
+                                - static_cast<float>(img_c(x, y)[c]);
+          REQUIRE(img_dst(x, y)[c] == expected);
+        }
+      }
+    }
+  }
+
+  SECTION("Integer arithmetic, cast and saturation")
+  {
+    sln::Image_8u3 img_wrap;
+    sln::evaluate(img_a + img_b, img_wrap);
+
+    sln::Image_8u3 img_sat;
+    sln::evaluate<sln::ConversionMode::Saturate>(img_a + img_b, img_sat);
+
+    const auto img_diff = sln::evaluate<sln::Pixel_8u3, sln::ConversionMode::Saturate>(img_a - img_b);
+    const auto img_neg = sln::evaluate<sln::Pixel_16s3>(-img_a);
+
+    for (auto y = 0_idx; y < h; ++y)
+    {
+      for (auto x = 0_idx; x < w; ++x)
+      {
+        for (std::size_t c = 0; c < 3; ++c)
+        {
+          const auto a = static_cast<int>(img_a(x, y)[c]);
+          const auto b = static_cast<int>(img_b(x, y)[c]);
+          REQUIRE(img_wrap(x, y)[c] == static_cast<std::uint8_t>(a + b));
+          REQUIRE(img_sat(x, y)[c] == std::min(a + b, 255));
+          REQUIRE(img_diff(x, y)[c] == std::max(a - b, 0));
+          REQUIRE(img_neg(x, y)[c] == -a);
+        }
+      }
+    }
+  }
+
+  SECTION("Saturation of floating point values")
+  {
+    sln::Image_32f1 img_f({3_px, 1_px});
+    img_f(0_idx, 0_idx) = -3.7f;
+    img_f(1_idx, 0_idx) = 100.6f;
+    img_f(2_idx, 0_idx) = 1000.0f;
+
+    const auto img_8u = sln::evaluate<sln::Pixel_8u1, sln::ConversionMode::Saturate>(img_f * 1);
+    REQUIRE(img_8u(0_idx, 0_idx) == 0);
+    REQUIRE(img_8u(1_idx, 0_idx) == 101);
+    REQUIRE(img_8u(2_idx, 0_idx) == 255);
+  }
+
+  SECTION("Pixel operands and views")
+  {
+    const auto bbox = sln::BoundingBox(2_idx, 4_idx, 10_px, 30_px);
+    const sln::Pixel_8u3 offset(1, 2, 3);
+
+    sln::Image_16u3 img_dst = (sln::view(img_a, bbox) + offset) * 2;
+    REQUIRE(img_dst.width() == 10_px);
+    REQUIRE(img_dst.height() == 30_px);
+
+    for (auto y = 0_idx; y < img_dst.height(); ++y)
+    {
+      for (auto x = 0_idx; x < img_dst.width(); ++x)
+      {
+        for (std::size_t c = 0; c < 3; ++c)
+        {
+          const auto a = img_a(sln::PixelIndex{x + bbox.x0()}, sln::PixelIndex{y + bbox.y0()})[c];
+          REQUIRE(img_dst(x, y)[c] == (a + offset[c]) * 2);
+        }
+      }
+    }
+  }
+
+  SECTION("Evaluation into views, in-place, and with execution policies")
+  {
+    sln::Image_8u3 img_big({sln::PixelLength{w + 4}, sln::PixelLength{h + 4}});
+    sln::fill(img_big, sln::Pixel_8u3(9, 9, 9));
+    auto img_big_view = sln::view(img_big, sln::BoundingBox(2_idx, 2_idx, w, h));
+    sln::evaluate(sln::execution::par, (img_a + img_b) / 2, img_big_view);
+
+    auto img_inplace = img_a;
+    sln::evaluate(sln::execution::par_unseq, (img_inplace + img_b) / 2, img_inplace);
+
+    REQUIRE(img_big(0_idx, 0_idx) == sln::Pixel_8u3(9, 9, 9));
+    REQUIRE(img_big(sln::PixelIndex{w + 3}, sln::PixelIndex{h + 3}) == sln::Pixel_8u3(9, 9, 9));
+
+    for (auto y = 0_idx; y < h; ++y)
+    {
+      for (auto x = 0_idx; x < w; ++x)
+      {
+        for (std::size_t c = 0; c < 3; ++c)
+        {
+          const auto expected = (img_a(x, y)[c] + img_b(x, y)[c]) / 2;
+          REQUIRE(img_big(sln::PixelIndex{x + 2}, sln::PixelIndex{y + 2})[c] == expected);
+          REQUIRE(img_inplace(x, y)[c] == expected);
+        }
+      }
+    }
+
+    sln::Image_8u3 img_wrong_size({w, sln::PixelLength{h + 1}});
+    auto img_wrong_size_view = sln::view(img_wrong_size);
+    REQUIRE_THROWS(sln::evaluate(img_a + img_b, img_wrong_size_view));
+  }
+
+  SECTION("Size mismatch")
+  {
+    const auto img_small = make_test_image<sln::Pixel_8u3>(w, sln::PixelLength{h - 1}, 3);
+    sln::Image_8u3 img_dst;
+    REQUIRE_THROWS(sln::evaluate(img_a + img_small, img_dst));
+  }
+}
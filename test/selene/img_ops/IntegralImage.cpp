@@ -0,0 +1,175 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch2/catch.hpp>
+
+#include <selene/img_ops/IntegralImage.hpp>
+
+#include <selene/base/ThreadPool.hpp>
+
+#include <selene/img/pixel/PixelTypeAliases.hpp>
+
+#include <selene/img/typed/Image.hpp>
+#include <selene/img/typed/ImageTypeAliases.hpp>
+
+#include <selene/img_ops/View.hpp>
+
+#include <test/selene/img/typed/_Utils.hpp>
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+using namespace sln::literals;
+
+namespace {
+
+template <typename PixelType, typename DerivedSum, typename DerivedSqSum>
+void check_integral_images(const sln::Image<PixelType>& img,
+                           const sln::ImageBase<DerivedSum>& img_sum,
+                           const sln::ImageBase<DerivedSqSum>& img_sqsum)
+{
+  constexpr auto N = static_cast<std::size_t>(sln::PixelTraits<PixelType>::nr_channels);
+  REQUIRE(img_sum.width() == img.width() + 1);
+  REQUIRE(img_sum.height() == img.height() + 1);
+  REQUIRE(img_sqsum.width() == img.width() + 1);
+  REQUIRE(img_sqsum.height() == img.height() + 1);
+
+  // Reference, by the recurrence I(x + 1, y + 1) = v(x, y) + I(x, y + 1) + I(x + 1, y) - I(x, y)
+  const auto w = static_cast<std::size_t>(img.width()) + 1;
+  const auto h = static_cast<std::size_t>(img.height()) + 1;
+  std::vector<std::array<double, N>> ref_sum(w * h, std::array<double, N>{});
+  std::vector<std::array<double, N>> ref_sqsum(w * h, std::array<double, N>{});
+
+  for (std::size_t y = 1; y < h; ++y)
+  {
+    for (std::size_t x = 1; x < w; ++x)
+    {
+      const auto px = img(sln::PixelIndex{static_cast<int>(x) - 1}, sln::PixelIndex{static_cast<int>(y) - 1});
+      for (std::size_t c = 0; c < N; ++c)
+      {
+        const auto v = static_cast<double>(px[c]);
+        ref_sum[y * w + x][c] = v + ref_sum[y * w + x - 1][c] + ref_sum[(y - 1) * w + x][c]
+                                - ref_sum[(y - 1) * w + x - 1][c];
+        ref_sqsum[y * w + x][c] = v * v + ref_sqsum[y * w + x - 1][c] + ref_sqsum[(y - 1) * w + x][c]
+                                  - ref_sqsum[(y - 1) * w + x - 1][c];
+      }
+    }
+  }
+
+  for (std::size_t y = 0; y < h; ++y)
+  {
+    for (std::size_t x = 0; x < w; ++x)
+    {
+      const auto xi = sln::PixelIndex{static_cast<int>(x)};
+      const auto yi = sln::PixelIndex{static_cast<int>(y)};
+      for (std::size_t c = 0; c < N; ++c)
+      {
+        REQUIRE(static_cast<double>(sln::impl::get_channel(img_sum(xi, yi), c)) == Approx(ref_sum[y * w + x][c]));
+        REQUIRE(static_cast<double>(sln::impl::get_channel(img_sqsum(xi, yi), c))
+                == Approx(ref_sqsum[y * w + x][c]));
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST_CASE("Integral images", "[img]")
+{
+  std::mt19937 rng(34);
+  sln::ThreadPool pool(4);
+
+  SECTION("8-bit, multi-channel")
+  {
+    const auto img = sln_test::construct_random_image<sln::Pixel_8u3>(307_px, 61_px, rng);
+
+    sln::Image<sln::Pixel<std::int64_t, 3>> img_sum;
+    sln::Image<sln::Pixel<std::int64_t, 3>> img_sqsum;
+    sln::integral_image(img, img_sum, img_sqsum);
+    check_integral_images(img, img_sum, img_sqsum);
+
+    sln::Image<sln::Pixel<std::int64_t, 3>> img_sum_par;
+    sln::Image<sln::Pixel<std::int64_t, 3>> img_sqsum_par;
+    sln::integral_image(pool, img, img_sum_par, img_sqsum_par);
+    REQUIRE(img_sum_par == img_sum);
+    REQUIRE(img_sqsum_par == img_sqsum);
+
+    const auto img_sum_default = sln::integral_image(img);
+    using DefaultSumImage = std::remove_cv_t<decltype(img_sum_default)>;
+    static_assert(std::is_same_v<DefaultSumImage, sln::Image<sln::Pixel<std::int64_t, 3>>>);
+    REQUIRE(img_sum_default == img_sum);
+  }
+
+  SECTION("32-bit integral image, where the sum fits")
+  {
+    const auto img = sln_test::construct_random_image<sln::Pixel_8u1>(100_px, 200_px, rng);
+    sln::Image<std::int32_t> img_sum;
+    sln::Image<double> img_sqsum;
+    sln::integral_image(sln::execution::par_unseq.on(pool), img, img_sum, img_sqsum);
+    check_integral_images(img, img_sum, img_sqsum);
+
+    // The squared sum of 20000 8-bit values does not provably fit into 16 bits.
+    sln::Image<std::uint16_t> img_sqsum_too_small;
+    REQUIRE_THROWS(sln::integral_image(img, img_sum, img_sqsum_too_small));
+  }
+
+  SECTION("Signed and floating point values")
+  {
+    const auto img_16s = sln_test::construct_random_image<sln::Pixel_16s1>(
+        33_px, 1000_px, rng, std::uniform_int_distribution<int>(-32768, 32767));
+    sln::Image<std::int64_t> img_sum_16s;
+    sln::Image<std::int64_t> img_sqsum_16s;
+    sln::integral_image(pool, img_16s, img_sum_16s, img_sqsum_16s);
+    check_integral_images(img_16s, img_sum_16s, img_sqsum_16s);
+
+    const auto img_32f = sln_test::construct_random_image<sln::Pixel_32f2>(
+        51_px, 52_px, rng, std::uniform_real_distribution<float>(-1.0f, 1.0f));
+    sln::Image<sln::Pixel<double, 2>> img_sum_32f;
+    sln::Image<sln::Pixel<double, 2>> img_sqsum_32f;
+    sln::integral_image(img_32f, img_sum_32f, img_sqsum_32f);
+    check_integral_images(img_32f, img_sum_32f, img_sqsum_32f);
+  }
+
+  SECTION("Box sums")
+  {
+    const auto img = sln_test::construct_random_image<sln::Pixel_8u1>(64_px, 48_px, rng);
+    const auto img_sum = sln::integral_image(img);
+
+    const auto check_box = [&](const sln::BoundingBox& box) {
+      std::int64_t ref = 0;
+      for (auto y = box.y0(); y < box.y1(); ++y)
+      {
+        for (auto x = box.x0(); x < box.x1(); ++x)
+        {
+          ref += img(x, y);
+        }
+      }
+
+      REQUIRE(sln::box_sum(img_sum, box) == ref);
+    };
+
+    check_box(sln::BoundingBox(0_idx, 0_idx, 64_px, 48_px));
+    check_box(sln::BoundingBox(0_idx, 0_idx, 1_px, 1_px));
+    check_box(sln::BoundingBox(63_idx, 47_idx, 1_px, 1_px));
+    check_box(sln::BoundingBox(10_idx, 5_idx, 17_px, 30_px));
+
+    // Integral image of a view
+    const auto img_view = sln::view(img, sln::BoundingBox(10_idx, 5_idx, 17_px, 30_px));
+    const auto img_sum_view = sln::integral_image(img_view);
+    REQUIRE(sln::box_sum(img_sum_view, sln::BoundingBox(0_idx, 0_idx, 17_px, 30_px))
+            == sln::box_sum(img_sum, sln::BoundingBox(10_idx, 5_idx, 17_px, 30_px)));
+  }
+
+  SECTION("Empty image")
+  {
+    sln::Image_8u1 img;
+    const auto img_sum = sln::integral_image(img);
+    REQUIRE(img_sum.width() == 1_px);
+    REQUIRE(img_sum.height() == 1_px);
+    REQUIRE(img_sum(0_idx, 0_idx) == 0);
+  }
+}
@@ -0,0 +1,123 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch2/catch.hpp>
+
+#include <selene/img_ops/MedianFilter.hpp>
+
+#include <selene/base/ThreadPool.hpp>
+
+#include <selene/img/pixel/PixelTypeAliases.hpp>
+
+#include <selene/img/typed/Image.hpp>
+#include <selene/img/typed/ImageTypeAliases.hpp>
+
+#include <selene/img_ops/Fill.hpp>
+
+#include <test/selene/img/typed/_Utils.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace sln::literals;
+
+namespace {
+
+template <typename PixelType>
+sln::Image<PixelType> reference_median_filter(const sln::Image<PixelType>& img, int radius)
+{
+  constexpr auto N = static_cast<std::size_t>(sln::PixelTraits<PixelType>::nr_channels);
+  const int w = static_cast<int>(img.width());
+  const int h = static_cast<int>(img.height());
+  sln::Image<PixelType> img_dst({img.width(), img.height()});
+  std::vector<std::uint8_t> values;
+
+  for (int y = 0; y < h; ++y)
+  {
+    for (int x = 0; x < w; ++x)
+    {
+      for (std::size_t c = 0; c < N; ++c)
+      {
+        values.clear();
+        for (int dy = -radius; dy <= radius; ++dy)
+        {
+          for (int dx = -radius; dx <= radius; ++dx)
+          {
+            const auto xs = sln::PixelIndex{std::clamp(x + dx, 0, w - 1)};
+            const auto ys = sln::PixelIndex{std::clamp(y + dy, 0, h - 1)};
+            values.push_back(sln::impl::get_channel(img(xs, ys), c));
+          }
+        }
+
+        std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+        sln::impl::get_channel(img_dst(sln::PixelIndex{x}, sln::PixelIndex{y}), c) = values[values.size() / 2];
+      }
+    }
+  }
+
+  return img_dst;
+}
+
+}  // namespace
+
+TEST_CASE("Median filter", "[img]")
+{
+  std::mt19937 rng(36);
+  sln::ThreadPool pool(4);
+
+  SECTION("Single channel")
+  {
+    const auto img = sln_test::construct_random_image<sln::Pixel_8u1>(150_px, 70_px, rng);
+
+    for (const auto radius : {0, 1, 2, 3, 7})
+    {
+      const auto ref = reference_median_filter(img, radius);
+
+      sln::Image_8u1 img_dst;
+      sln::median_filter(img, img_dst, sln::PixelLength{radius});
+      REQUIRE(img_dst == ref);
+
+      sln::Image_8u1 img_dst_par;
+      sln::median_filter(pool, img, img_dst_par, sln::PixelLength{radius});
+      REQUIRE(img_dst_par == ref);
+    }
+  }
+
+  SECTION("Three channels")
+  {
+    const auto img = sln_test::construct_random_image<sln::Pixel_8u3>(300_px, 31_px, rng);
+
+    for (const auto radius : {1, 4})
+    {
+      sln::Image_8u3 img_dst;
+      sln::median_filter(sln::execution::par.on(pool), img, img_dst, sln::PixelLength{radius});
+      REQUIRE(img_dst == reference_median_filter(img, radius));
+    }
+  }
+
+  SECTION("Radius larger than the image")
+  {
+    const auto img = sln_test::construct_random_image<sln::Pixel_8u1>(9_px, 5_px, rng);
+    sln::Image_8u1 img_dst;
+    sln::median_filter(img, img_dst, 15_px);
+    REQUIRE(img_dst == reference_median_filter(img, 15));
+  }
+
+  SECTION("Impulse noise removal and invalid arguments")
+  {
+    sln::Image_8u1 img({64_px, 64_px});
+    sln::fill(img, 100);
+    img(10_idx, 10_idx) = 255;
+    img(40_idx, 20_idx) = 0;
+
+    sln::Image_8u1 img_dst;
+    sln::median_filter(img, img_dst, 3_px);
+    REQUIRE(img_dst(10_idx, 10_idx) == 100);
+    REQUIRE(img_dst(40_idx, 20_idx) == 100);
+
+    REQUIRE_THROWS(sln::median_filter(img, img_dst, 128_px));
+  }
+}
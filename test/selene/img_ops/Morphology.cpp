@@ -0,0 +1,153 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch2/catch.hpp>
+
+#include <selene/img_ops/Morphology.hpp>
+
+#include <selene/base/ThreadPool.hpp>
+
+#include <selene/img/pixel/PixelTypeAliases.hpp>
+
+#include <selene/img/typed/Image.hpp>
+#include <selene/img/typed/ImageTypeAliases.hpp>
+
+#include <test/selene/img/typed/_Utils.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+
+using namespace sln::literals;
+
+namespace {
+
+template <sln::BorderAccessMode access_mode, bool is_erosion, typename PixelType>
+sln::Image<PixelType> reference_morphology(const sln::Image<PixelType>& img, int kw, int kh)
+{
+  constexpr auto N = static_cast<std::size_t>(sln::PixelTraits<PixelType>::nr_channels);
+  sln::Image<PixelType> img_dst({img.width(), img.height()});
+
+  for (auto y = 0_idx; y < img.height(); ++y)
+  {
+    for (auto x = 0_idx; x < img.width(); ++x)
+    {
+      PixelType result = img(x, y);
+
+      for (int dy = 0; dy < kh; ++dy)
+      {
+        for (int dx = 0; dx < kw; ++dx)
+        {
+          const auto xs = sln::PixelIndex{x + dx - (kw - 1) / 2};
+          const auto ys = sln::PixelIndex{y + dy - (kh - 1) / 2};
+          const PixelType px = sln::ImageBorderAccessor<access_mode>::access(img, xs, ys);
+
+          for (std::size_t c = 0; c < N; ++c)
+          {
+            auto& r = sln::impl::get_channel(result, c);
+            const auto v = sln::impl::get_channel(px, c);
+            r = is_erosion ? std::min(r, v) : std::max(r, v);
+          }
+        }
+      }
+
+      img_dst(x, y) = result;
+    }
+  }
+
+  return img_dst;
+}
+
+template <sln::BorderAccessMode access_mode, typename PixelType, typename ExecutionPolicy>
+void check_erode_dilate(const sln::Image<PixelType>& img, int kw, int kh, ExecutionPolicy&& policy)
+{
+  sln::Image<PixelType> img_eroded, img_dilated;
+  sln::erode<access_mode>(policy, img, img_eroded, sln::PixelLength{kw}, sln::PixelLength{kh});
+  sln::dilate<access_mode>(policy, img, img_dilated, sln::PixelLength{kw}, sln::PixelLength{kh});
+  REQUIRE(img_eroded == (reference_morphology<access_mode, true>(img, kw, kh)));
+  REQUIRE(img_dilated == (reference_morphology<access_mode, false>(img, kw, kh)));
+}
+
+}  // namespace
+
+TEST_CASE("Morphological erosion and dilation", "[img]")
+{
+  std::mt19937 rng(35);
+  sln::ThreadPool pool(4);
+
+  SECTION("8-bit, single channel")
+  {
+    const auto img = sln_test::construct_random_image<sln::Pixel_8u1>(67_px, 45_px, rng);
+
+    for (const auto& [kw, kh] : {std::pair{1, 1}, std::pair{3, 3}, std::pair{2, 3}, std::pair{5, 7},
+                                 std::pair{4, 1}, std::pair{1, 9}, std::pair{15, 15}, std::pair{51, 51}})
+    {
+      check_erode_dilate<sln::BorderAccessMode::Replicated>(img, kw, kh, sln::execution::seq);
+      check_erode_dilate<sln::BorderAccessMode::ZeroPadding>(img, kw, kh, pool);
+    }
+  }
+
+  SECTION("Multi-channel and floating point")
+  {
+    const auto img_8u3 = sln_test::construct_random_image<sln::Pixel_8u3>(300_px, 20_px, rng);
+    check_erode_dilate<sln::BorderAccessMode::Replicated>(img_8u3, 3, 3, sln::execution::par_unseq.on(pool));
+    check_erode_dilate<sln::BorderAccessMode::Replicated>(img_8u3, 11, 5, sln::execution::par.on(pool));
+
+    const auto img_32f = sln_test::construct_random_image<sln::Pixel_32f1>(
+        40_px, 50_px, rng, std::uniform_real_distribution<float>(-1.0f, 1.0f));
+    check_erode_dilate<sln::BorderAccessMode::Replicated>(img_32f, 9, 4, sln::execution::seq);
+  }
+
+  SECTION("In-place operation and invalid arguments")
+  {
+    auto img = sln_test::construct_random_image<sln::Pixel_8u1>(32_px, 32_px, rng);
+    const auto ref = reference_morphology<sln::BorderAccessMode::Replicated, true>(img, 7, 7);
+    sln::erode(img, img, 7_px, 7_px);
+    REQUIRE(img == ref);
+
+    sln::Image_8u1 img_dst;
+    REQUIRE_THROWS(sln::erode(img, img_dst, 0_px, 3_px));
+    REQUIRE_THROWS(sln::dilate(img, img_dst, 3_px, 0_px));
+  }
+}
+
+TEST_CASE("Morphological opening, closing and gradient", "[img]")
+{
+  std::mt19937 rng(36);
+
+  // Binary mask with noise
+  const auto img = sln_test::construct_random_image<sln::Pixel_8u1>(
+      80_px, 60_px, rng, std::bernoulli_distribution(0.3));
+  sln::Image_8u1 img_mask;
+  sln::transform_pixels(img, img_mask, [](const auto& px) {
+    return sln::Pixel_8u1(static_cast<std::uint8_t>(px == 0 ? 0 : 255));
+  });
+
+  sln::Image_8u1 img_open, img_close, img_gradient, img_eroded, img_dilated;
+  sln::open(img_mask, img_open, 3_px, 3_px);
+  sln::close(img_mask, img_close, 3_px, 3_px);
+  sln::morphological_gradient(img_mask, img_gradient, 5_px, 3_px);
+  sln::erode(img_mask, img_eroded, 5_px, 3_px);
+  sln::dilate(img_mask, img_dilated, 5_px, 3_px);
+
+  sln::Image_8u1 img_open_twice, img_close_twice;
+  sln::open(img_open, img_open_twice, 3_px, 3_px);
+  sln::close(img_close, img_close_twice, 3_px, 3_px);
+
+  // Opening and closing are idempotent.
+  REQUIRE(img_open_twice == img_open);
+  REQUIRE(img_close_twice == img_close);
+
+  for (auto y = 0_idx; y < img_mask.height(); ++y)
+  {
+    for (auto x = 0_idx; x < img_mask.width(); ++x)
+    {
+      // Opening is anti-extensive, closing is extensive.
+      REQUIRE(img_open(x, y) <= img_mask(x, y));
+      REQUIRE(img_close(x, y) >= img_mask(x, y));
+      REQUIRE(img_gradient(x, y) == img_dilated(x, y) - img_eroded(x, y));
+    }
+  }
+}
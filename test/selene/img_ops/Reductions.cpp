@@ -0,0 +1,182 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch2/catch.hpp>
+
+#include <selene/img_ops/Reductions.hpp>
+
+#include <selene/base/ThreadPool.hpp>
+
+#include <selene/img/pixel/PixelTypeAliases.hpp>
+
+#include <selene/img/typed/Image.hpp>
+#include <selene/img/typed/ImageTypeAliases.hpp>
+
+#include <selene/img_ops/Fill.hpp>
+#include <selene/img_ops/View.hpp>
+
+#include <test/selene/img/typed/_Utils.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+using namespace sln::literals;
+
+namespace {
+
+template <typename PixelType, typename ExecutionPolicy>
+void check_reductions(const sln::Image<PixelType>& img, ExecutionPolicy&& policy)
+{
+  constexpr auto N = static_cast<std::size_t>(sln::PixelTraits<PixelType>::nr_channels);
+  using Element = typename sln::PixelTraits<PixelType>::Element;
+
+  // Reference values
+  std::array<double, N> ref_sum{}, ref_l1{}, ref_l2{}, ref_inf{};
+  std::array<std::int64_t, N> ref_nonzero{};
+  std::array<Element, N> ref_min, ref_max;
+  std::array<sln::PixelLocation, N> ref_min_loc, ref_max_loc;
+
+  for (std::size_t c = 0; c < N; ++c)
+  {
+    ref_min[c] = img(0_idx, 0_idx)[c];
+    ref_max[c] = img(0_idx, 0_idx)[c];
+    ref_min_loc[c] = sln::PixelLocation{0_idx, 0_idx};
+    ref_max_loc[c] = sln::PixelLocation{0_idx, 0_idx};
+  }
+
+  for (auto y = 0_idx; y < img.height(); ++y)
+  {
+    for (auto x = 0_idx; x < img.width(); ++x)
+    {
+      for (std::size_t c = 0; c < N; ++c)
+      {
+        const auto v = img(x, y)[c];
+        const auto d = static_cast<double>(v);
+        ref_sum[c] += d;
+        ref_l1[c] += std::abs(d);
+        ref_l2[c] += d * d;
+        ref_inf[c] = std::max(ref_inf[c], std::abs(d));
+        ref_nonzero[c] += (v != 0) ? 1 : 0;
+
+        if (v < ref_min[c])
+        {
+          ref_min[c] = v;
+          ref_min_loc[c] = sln::PixelLocation{x, y};
+        }
+
+        if (v > ref_max[c])
+        {
+          ref_max[c] = v;
+          ref_max_loc[c] = sln::PixelLocation{x, y};
+        }
+      }
+    }
+  }
+
+  const auto nr_px = static_cast<double>(img.width() * img.height());
+  const auto s = sln::sum(policy, img);
+  const auto m = sln::mean(policy, img);
+  const auto l1 = sln::norm_l1(policy, img);
+  const auto l2 = sln::norm_l2(policy, img);
+  const auto inf = sln::norm_inf(policy, img);
+  const auto nz = sln::count_nonzero(policy, img);
+  const auto mml = sln::min_max_loc(policy, img);
+
+  for (std::size_t c = 0; c < N; ++c)
+  {
+    REQUIRE(static_cast<double>(s[c]) == Approx(ref_sum[c]));
+    REQUIRE(m[c] == Approx(ref_sum[c] / nr_px));
+    REQUIRE(l1[c] == Approx(ref_l1[c]));
+    REQUIRE(l2[c] == Approx(std::sqrt(ref_l2[c])));
+    REQUIRE(inf[c] == Approx(ref_inf[c]));
+    REQUIRE(nz[c] == ref_nonzero[c]);
+    REQUIRE(mml.min_value[c] == ref_min[c]);
+    REQUIRE(mml.max_value[c] == ref_max[c]);
+    REQUIRE(mml.min_location[c].x == ref_min_loc[c].x);
+    REQUIRE(mml.min_location[c].y == ref_min_loc[c].y);
+    REQUIRE(mml.max_location[c].x == ref_max_loc[c].x);
+    REQUIRE(mml.max_location[c].y == ref_max_loc[c].y);
+  }
+}
+
+}  // namespace
+
+TEST_CASE("Image reductions", "[img]")
+{
+  std::mt19937 rng(42);
+  sln::ThreadPool pool(4);
+
+  SECTION("8-bit unsigned, multi-channel")
+  {
+    const auto img = sln_test::construct_random_image<sln::Pixel_8u3>(131_px, 307_px, rng,
+                                                                      std::uniform_int_distribution<int>(0, 255));
+    check_reductions(img, sln::execution::seq);
+    check_reductions(img, sln::execution::par);
+    check_reductions(img, pool);
+
+    // The exact integer sum must not depend on the execution policy.
+    REQUIRE(sln::sum(img) == sln::sum(sln::execution::par_unseq.on(pool), img));
+  }
+
+  SECTION("16-bit signed")
+  {
+    const auto img = sln_test::construct_random_image<sln::Pixel_16s1>(
+        1000_px, 100_px, rng, std::uniform_int_distribution<int>(-32768, 32767));
+    check_reductions(img, sln::execution::seq);
+    check_reductions(img, pool);
+  }
+
+  SECTION("32-bit floating point")
+  {
+    const auto img = sln_test::construct_random_image<sln::Pixel_32f2>(
+        77_px, 513_px, rng, std::uniform_real_distribution<float>(-10.0f, 10.0f));
+    check_reductions(img, sln::execution::seq);
+    check_reductions(img, sln::execution::par_unseq.on(pool));
+
+    // Floating point results must be reproducible, independent of the number of threads.
+    sln::ThreadPool pool_2(2);
+    REQUIRE(sln::sum(pool, img) == sln::sum(pool_2, img));
+    REQUIRE(sln::sum(pool, img) == sln::sum(img));
+  }
+
+  SECTION("Views and ties")
+  {
+    sln::Image_8u1 img({sln::PixelLength{64}, sln::PixelLength{64}});
+    sln::fill(img, 7);
+    img(10_idx, 20_idx) = 2;
+    img(30_idx, 40_idx) = 2;
+    img(5_idx, 50_idx) = 9;
+    img(6_idx, 50_idx) = 9;
+
+    const auto mml = sln::min_max_loc(img);
+    REQUIRE(mml.min_value[0] == 2);
+    REQUIRE(mml.min_location[0].x == 10);
+    REQUIRE(mml.min_location[0].y == 20);
+    REQUIRE(mml.max_value[0] == 9);
+    REQUIRE(mml.max_location[0].x == 5);
+    REQUIRE(mml.max_location[0].y == 50);
+
+    const auto mml_view = sln::min_max_loc(sln::view(img, sln::BoundingBox(20_idx, 30_idx, 20_px, 20_px)));
+    REQUIRE(mml_view.min_value[0] == 2);
+    REQUIRE(mml_view.min_location[0].x == 10);
+    REQUIRE(mml_view.min_location[0].y == 10);
+    REQUIRE(mml_view.max_value[0] == 7);
+    REQUIRE(mml_view.max_location[0].x == 0);
+    REQUIRE(mml_view.max_location[0].y == 0);
+
+    REQUIRE(sln::count_nonzero(img)[0] == 64 * 64);
+    REQUIRE(sln::sum(img)[0] == 64 * 64 * 7 - 2 * 5 + 2 * 2);
+  }
+
+  SECTION("Empty images")
+  {
+    sln::Image_8u1 img;
+    REQUIRE(sln::sum(img)[0] == 0);
+    REQUIRE(sln::count_nonzero(img)[0] == 0);
+    REQUIRE_THROWS(sln::mean(img));
+    REQUIRE_THROWS(sln::min_max_loc(img));
+  }
+}
@@ -0,0 +1,113 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch2/catch.hpp>
+
+#include <selene/img_ops/TensorPacking.hpp>
+
+#include <selene/img/pixel/PixelTypeAliases.hpp>
+
+#include <selene/img/typed/Image.hpp>
+#include <selene/img/typed/ImageTypeAliases.hpp>
+
+#include <selene/img_ops/View.hpp>
+
+#include <test/selene/img/typed/_Utils.hpp>
+
+#include <random>
+#include <vector>
+
+using namespace sln::literals;
+
+TEST_CASE("Tensor packing", "[img]")
+{
+  std::mt19937 rng(42ul);
+
+  constexpr auto w = 37_px;
+  constexpr auto h = 21_px;
+  const std::array<float, 3> mean = {{123.675f, 116.28f, 103.53f}};
+  const std::array<float, 3> std_dev = {{58.395f, 57.12f, 57.375f}};
+
+  std::vector<sln::Image_8u3> images;
+  for (int i = 0; i < 5; ++i)
+  {
+    images.push_back(sln_test::construct_random_image<sln::Pixel_8u3>(w, h, rng));
+  }
+
+  // Include views with a stride different from the row length
+  const sln::Image_8u3 large_img = sln_test::construct_random_image<sln::Pixel_8u3>(60_px, 30_px, rng);
+  std::vector<sln::ConstantImageView<sln::Pixel_8u3>> views;
+  for (const auto& img : images)
+  {
+    views.push_back(img.constant_view());
+  }
+  views.push_back(sln::view(large_img, {3_idx, 5_idx, w, h}));
+
+  const auto nr_items = views.size();
+  const auto plane_size = std::size_t(w * h);
+
+  auto expected_value = [&](std::size_t n, std::size_t c, sln::PixelIndex x, sln::PixelIndex y) {
+    return (static_cast<float>(views[n](x, y)[c]) - mean[c]) / std_dev[c];
+  };
+
+  SECTION("NCHW")
+  {
+    std::vector<float> tensor(nr_items * 3 * plane_size);
+    sln::pack_tensor(views, tensor.data(), mean, std_dev);
+
+    for (std::size_t n = 0; n < nr_items; ++n)
+    {
+      for (std::size_t c = 0; c < 3; ++c)
+      {
+        for (auto y = 0_idx; y < h; ++y)
+        {
+          for (auto x = 0_idx; x < w; ++x)
+          {
+            const auto idx = ((n * 3 + c) * std::size_t(h) + std::size_t(y)) * std::size_t(w) + std::size_t(x);
+            REQUIRE(tensor[idx] == Approx(expected_value(n, c, x, y)).margin(1e-5));
+          }
+        }
+      }
+    }
+  }
+
+  SECTION("NHWC")
+  {
+    std::vector<float> tensor(nr_items * 3 * plane_size);
+    sln::ThreadPool pool(3);
+    sln::pack_tensor(sln::execution::par.on(pool), views, tensor.data(), mean, std_dev, sln::TensorLayout::NHWC);
+
+    for (std::size_t n = 0; n < nr_items; ++n)
+    {
+      for (auto y = 0_idx; y < h; ++y)
+      {
+        for (auto x = 0_idx; x < w; ++x)
+        {
+          for (std::size_t c = 0; c < 3; ++c)
+          {
+            const auto idx = ((n * std::size_t(h) + std::size_t(y)) * std::size_t(w) + std::size_t(x)) * 3 + c;
+            REQUIRE(tensor[idx] == Approx(expected_value(n, c, x, y)).margin(1e-5));
+          }
+        }
+      }
+    }
+  }
+
+  SECTION("Owning images as input")
+  {
+    std::vector<float> tensor_0(images.size() * 3 * plane_size);
+    std::vector<float> tensor_1(images.size() * 3 * plane_size);
+    sln::pack_tensor(images, tensor_0.data(), mean, std_dev);
+    views.pop_back();
+    sln::pack_tensor(sln::execution::seq, views, tensor_1.data(), mean, std_dev);
+    REQUIRE(tensor_0 == tensor_1);
+  }
+
+  SECTION("Size mismatch")
+  {
+    images.push_back(sln_test::construct_random_image<sln::Pixel_8u3>(w, 20_px, rng));
+    std::vector<float> tensor(images.size() * 3 * plane_size);
+    REQUIRE_THROWS(sln::pack_tensor(images, tensor.data(), mean, std_dev));
+  }
+}